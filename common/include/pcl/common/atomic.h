@@ -0,0 +1,79 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef PCL_COMMON_ATOMIC_H_
+#define PCL_COMMON_ATOMIC_H_
+
+#include <pcl/pcl_macros.h>
+#if defined _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Atomically replace the value at \a ptr with \a new_value if it still equals \a old_value. This is a
+      * full memory barrier on GCC and MSVC.
+      * \return true if the value was replaced
+      */
+    inline bool
+    compareAndSwap (int *ptr, int old_value, int new_value)
+    {
+#if defined __GNUC__
+      return (__sync_bool_compare_and_swap (ptr, old_value, new_value));
+#elif defined _MSC_VER
+      return (_InterlockedCompareExchange (reinterpret_cast<volatile long*> (ptr), new_value, old_value) == old_value);
+#else
+      bool swapped = false;
+#ifdef _OPENMP
+#pragma omp critical (pcl_detail_compare_and_swap)
+#endif
+      {
+        if (*ptr == old_value)
+        {
+          *ptr = new_value;
+          swapped = true;
+        }
+      }
+      return (swapped);
+#endif
+    }
+  }
+}
+
+#endif  // PCL_COMMON_ATOMIC_H_
@@ -493,6 +493,45 @@ namespace pcl
     return (computeMeanAndCovarianceMatrix<PointT, double> (cloud, indices, covariance_matrix, centroid));
   }
 
+  /** \brief Compute the normalized 3x3 covariance matrices and centroids of many point neighborhoods at once.
+    * The neighborhoods are given in compressed sparse row (CSR) form: the indices of neighborhood i are stored in
+    * indices[offsets[i]] ... indices[offsets[i+1] - 1]. Points with non-finite coordinates are skipped.
+    * \note Coordinates are accumulated relative to the first valid point of each neighborhood, which is more
+    * accurate than the single pass of computeMeanAndCovarianceMatrix for points far away from the origin.
+    * \param[in] cloud the input point cloud
+    * \param[in] indices concatenated point indices of all neighborhoods
+    * \param[in] offsets start of every neighborhood in \a indices, followed by indices.size ()
+    * \param[out] covariance_matrices the resultant 3x3 covariance matrix of every neighborhood
+    * \param[out] centroids the centroid of every neighborhood
+    * \param[out] point_counts number of valid points used for every neighborhood
+    * \ingroup common
+    */
+  template <typename PointT, typename Scalar> void
+  computeMeanAndCovarianceMatrixBatch (const pcl::PointCloud<PointT> &cloud,
+                                       const std::vector<int> &indices,
+                                       const std::vector<int> &offsets,
+                                       std::vector<Eigen::Matrix<Scalar, 3, 3> > &covariance_matrices,
+                                       std::vector<Eigen::Matrix<Scalar, 4, 1>, Eigen::aligned_allocator<Eigen::Matrix<Scalar, 4, 1> > > &centroids,
+                                       std::vector<unsigned int> &point_counts);
+
+  /** \brief Compute the normalized 3x3 covariance matrices and means of the normal vectors of many neighborhoods at once.
+    * Identical to computeMeanAndCovarianceMatrixBatch, but operates on the normal_x, normal_y and normal_z fields.
+    * \param[in] cloud the input point cloud containing normals
+    * \param[in] indices concatenated point indices of all neighborhoods
+    * \param[in] offsets start of every neighborhood in \a indices, followed by indices.size ()
+    * \param[out] covariance_matrices the resultant 3x3 covariance matrix of every neighborhood
+    * \param[out] means the mean normal vector of every neighborhood
+    * \param[out] point_counts number of valid normals used for every neighborhood
+    * \ingroup common
+    */
+  template <typename PointT, typename Scalar> void
+  computeNormalMeanAndCovarianceMatrixBatch (const pcl::PointCloud<PointT> &cloud,
+                                             const std::vector<int> &indices,
+                                             const std::vector<int> &offsets,
+                                             std::vector<Eigen::Matrix<Scalar, 3, 3> > &covariance_matrices,
+                                             std::vector<Eigen::Matrix<Scalar, 4, 1>, Eigen::aligned_allocator<Eigen::Matrix<Scalar, 4, 1> > > &means,
+                                             std::vector<unsigned int> &point_counts);
+
   /** \brief Compute the normalized 3x3 covariance matrix for a already demeaned point cloud.
     * Normalized means that every entry has been divided by the number of entries in indices.
     * For small number of points, or if you want explicitely the sample-variance, scale the covariance matrix
@@ -53,6 +53,8 @@
 #endif
 
 #include <cmath>
+#include <vector>
+#include <pcl/pcl_macros.h>
 #include <pcl/ModelCoefficients.h>
 
 #include <Eigen/StdVector>
@@ -135,6 +137,21 @@ namespace pcl
   template <typename Matrix, typename Vector> void
   eigen33 (const Matrix &mat, Matrix &evecs, Vector &evals);
 
+  /** \brief determines the eigenvalues of many symmetric positive semi definite 3x3 matrices, together with the
+    * eigenvector corresponding to one selected eigenvalue. The matrices are processed PCL_COVARIANCE_BATCH_WIDTH
+    * at a time with the same closed form solution as eigen33, so that the arithmetic vectorizes across matrices.
+    * \param[in] mats symmetric positive semi definite input matrices
+    * \param[out] evals resulting eigenvalues of every matrix in ascending order
+    * \param[out] evecs eigenvector of every matrix corresponding to the eigenvalue evals[i][eigenvector_index]
+    * \param[in] eigenvector_index selects the eigenvector: 0 for the smallest, 2 for the largest eigenvalue
+    * \ingroup common
+    */
+  template <typename Scalar> void
+  eigen33Batch (const std::vector<Eigen::Matrix<Scalar, 3, 3> > &mats,
+                std::vector<Eigen::Matrix<Scalar, 3, 1> > &evals,
+                std::vector<Eigen::Matrix<Scalar, 3, 1> > &evecs,
+                unsigned int eigenvector_index = 0);
+
   /** \brief Calculate the inverse of a 2x2 matrix
     * \param[in] matrix matrix to be inverted
     * \param[out] inverse the resultant inverted matrix
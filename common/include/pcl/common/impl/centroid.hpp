@@ -627,6 +627,186 @@ pcl::computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
   return (computeMeanAndCovarianceMatrix (cloud, indices.indices, covariance_matrix, centroid));
 }
 
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Accessor for the XYZ coordinates of a point, used by the batched covariance computation. */
+    struct CovarianceXYZAccessor
+    {
+      template <typename PointT> static inline float x (const PointT &p) { return (p.x); }
+      template <typename PointT> static inline float y (const PointT &p) { return (p.y); }
+      template <typename PointT> static inline float z (const PointT &p) { return (p.z); }
+    };
+
+    /** \brief Accessor for the normal vector of a point, used by the batched covariance computation. */
+    struct CovarianceNormalAccessor
+    {
+      template <typename PointT> static inline float x (const PointT &p) { return (p.normal_x); }
+      template <typename PointT> static inline float y (const PointT &p) { return (p.normal_y); }
+      template <typename PointT> static inline float z (const PointT &p) { return (p.normal_z); }
+    };
+
+    /** \brief Batched mean and covariance computation shared by the XYZ and normal variants. */
+    template <typename AccessorT, typename PointT, typename Scalar> void
+    computeMeanAndCovarianceMatrixBatch (const pcl::PointCloud<PointT> &cloud,
+                                         const std::vector<int> &indices,
+                                         const std::vector<int> &offsets,
+                                         std::vector<Eigen::Matrix<Scalar, 3, 3> > &covariance_matrices,
+                                         std::vector<Eigen::Matrix<Scalar, 4, 1>, Eigen::aligned_allocator<Eigen::Matrix<Scalar, 4, 1> > > &centroids,
+                                         std::vector<unsigned int> &point_counts)
+    {
+      const int width = PCL_COVARIANCE_BATCH_WIDTH;
+      const size_t count = offsets.empty () ? 0 : offsets.size () - 1;
+
+      covariance_matrices.resize (count);
+      centroids.resize (count);
+      point_counts.resize (count);
+
+      for (size_t batch = 0; batch < count; batch += width)
+      {
+        const int lanes = static_cast<int> (std::min<size_t> (width, count - batch));
+
+        int begin[PCL_COVARIANCE_BATCH_WIDTH];
+        int length[PCL_COVARIANCE_BATCH_WIDTH];
+        Scalar shift[3][PCL_COVARIANCE_BATCH_WIDTH];
+        Scalar accu[9][PCL_COVARIANCE_BATCH_WIDTH];
+        Scalar valid_count[PCL_COVARIANCE_BATCH_WIDTH];
+        int max_length = 0;
+
+        for (int l = 0; l < width; ++l)
+        {
+          begin[l] = length[l] = 0;
+          shift[0][l] = shift[1][l] = shift[2][l] = 0;
+          valid_count[l] = 0;
+          for (int a = 0; a < 9; ++a)
+            accu[a][l] = 0;
+
+          if (l >= lanes)
+            continue;
+
+          begin[l] = offsets[batch + l];
+          length[l] = offsets[batch + l + 1] - begin[l];
+          max_length = std::max (max_length, length[l]);
+
+          // accumulate relative to the first valid point to avoid cancellation
+          for (int j = 0; j < length[l]; ++j)
+          {
+            const PointT &p = cloud[indices[begin[l] + j]];
+            if (pcl_isfinite (AccessorT::x (p)) && pcl_isfinite (AccessorT::y (p)) && pcl_isfinite (AccessorT::z (p)))
+            {
+              shift[0][l] = AccessorT::x (p);
+              shift[1][l] = AccessorT::y (p);
+              shift[2][l] = AccessorT::z (p);
+              break;
+            }
+          }
+        }
+
+        Scalar px[PCL_COVARIANCE_BATCH_WIDTH];
+        Scalar py[PCL_COVARIANCE_BATCH_WIDTH];
+        Scalar pz[PCL_COVARIANCE_BATCH_WIDTH];
+        Scalar valid[PCL_COVARIANCE_BATCH_WIDTH];
+
+        for (int j = 0; j < max_length; ++j)
+        {
+          // gather the j-th neighbor of every lane
+          for (int l = 0; l < width; ++l)
+          {
+            px[l] = py[l] = pz[l] = valid[l] = 0;
+            if (j >= length[l])
+              continue;
+
+            const PointT &p = cloud[indices[begin[l] + j]];
+            const float x = AccessorT::x (p), y = AccessorT::y (p), z = AccessorT::z (p);
+            if (!pcl_isfinite (x) || !pcl_isfinite (y) || !pcl_isfinite (z))
+              continue;
+
+            px[l] = static_cast<Scalar> (x) - shift[0][l];
+            py[l] = static_cast<Scalar> (y) - shift[1][l];
+            pz[l] = static_cast<Scalar> (z) - shift[2][l];
+            valid[l] = 1;
+          }
+
+          // accumulate all lanes at once
+          for (int l = 0; l < width; ++l)
+          {
+            accu[0][l] += px[l] * px[l];
+            accu[1][l] += px[l] * py[l];
+            accu[2][l] += px[l] * pz[l];
+            accu[3][l] += py[l] * py[l];
+            accu[4][l] += py[l] * pz[l];
+            accu[5][l] += pz[l] * pz[l];
+            accu[6][l] += px[l];
+            accu[7][l] += py[l];
+            accu[8][l] += pz[l];
+            valid_count[l] += valid[l];
+          }
+        }
+
+        for (int l = 0; l < lanes; ++l)
+        {
+          Eigen::Matrix<Scalar, 3, 3> &covariance_matrix = covariance_matrices[batch + l];
+          Eigen::Matrix<Scalar, 4, 1> &centroid = centroids[batch + l];
+          point_counts[batch + l] = static_cast<unsigned int> (valid_count[l]);
+
+          if (valid_count[l] == 0)
+          {
+            covariance_matrix.setConstant (std::numeric_limits<Scalar>::quiet_NaN ());
+            centroid.setConstant (std::numeric_limits<Scalar>::quiet_NaN ());
+            continue;
+          }
+
+          const Scalar inv_count = Scalar (1) / valid_count[l];
+          const Scalar mx = accu[6][l] * inv_count;
+          const Scalar my = accu[7][l] * inv_count;
+          const Scalar mz = accu[8][l] * inv_count;
+
+          centroid[0] = mx + shift[0][l];
+          centroid[1] = my + shift[1][l];
+          centroid[2] = mz + shift[2][l];
+          centroid[3] = 1;
+          covariance_matrix.coeffRef (0) = accu[0][l] * inv_count - mx * mx;
+          covariance_matrix.coeffRef (1) = accu[1][l] * inv_count - mx * my;
+          covariance_matrix.coeffRef (2) = accu[2][l] * inv_count - mx * mz;
+          covariance_matrix.coeffRef (4) = accu[3][l] * inv_count - my * my;
+          covariance_matrix.coeffRef (5) = accu[4][l] * inv_count - my * mz;
+          covariance_matrix.coeffRef (8) = accu[5][l] * inv_count - mz * mz;
+          covariance_matrix.coeffRef (3) = covariance_matrix.coeff (1);
+          covariance_matrix.coeffRef (6) = covariance_matrix.coeff (2);
+          covariance_matrix.coeffRef (7) = covariance_matrix.coeff (5);
+        }
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Scalar> void
+pcl::computeMeanAndCovarianceMatrixBatch (const pcl::PointCloud<PointT> &cloud,
+                                          const std::vector<int> &indices,
+                                          const std::vector<int> &offsets,
+                                          std::vector<Eigen::Matrix<Scalar, 3, 3> > &covariance_matrices,
+                                          std::vector<Eigen::Matrix<Scalar, 4, 1>, Eigen::aligned_allocator<Eigen::Matrix<Scalar, 4, 1> > > &centroids,
+                                          std::vector<unsigned int> &point_counts)
+{
+  pcl::detail::computeMeanAndCovarianceMatrixBatch<pcl::detail::CovarianceXYZAccessor>
+    (cloud, indices, offsets, covariance_matrices, centroids, point_counts);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Scalar> void
+pcl::computeNormalMeanAndCovarianceMatrixBatch (const pcl::PointCloud<PointT> &cloud,
+                                                const std::vector<int> &indices,
+                                                const std::vector<int> &offsets,
+                                                std::vector<Eigen::Matrix<Scalar, 3, 3> > &covariance_matrices,
+                                                std::vector<Eigen::Matrix<Scalar, 4, 1>, Eigen::aligned_allocator<Eigen::Matrix<Scalar, 4, 1> > > &means,
+                                                std::vector<unsigned int> &point_counts)
+{
+  pcl::detail::computeMeanAndCovarianceMatrixBatch<pcl::detail::CovarianceNormalAccessor>
+    (cloud, indices, offsets, covariance_matrices, means, point_counts);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Scalar> void
 pcl::demeanPointCloud (ConstCloudIterator<PointT> &cloud_iterator,
@@ -480,6 +480,154 @@ pcl::eigen33 (const Matrix& mat, Matrix& evecs, Vector& evals)
   evals *= scale;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Normalized eigenvector of a scaled symmetric 3x3 matrix for a simple eigenvalue, taken as the
+      * longest cross product of two rows of (mat - eigenvalue * I).
+      */
+    template <typename Scalar> inline Eigen::Matrix<Scalar, 3, 1>
+    computeCrossProductEigenVector (const Eigen::Matrix<Scalar, 3, 3> &mat, Scalar eigenvalue)
+    {
+      Eigen::Matrix<Scalar, 3, 3> tmp = mat;
+      tmp.diagonal ().array () -= eigenvalue;
+
+      Eigen::Matrix<Scalar, 3, 1> vec1 = tmp.row (0).cross (tmp.row (1));
+      Eigen::Matrix<Scalar, 3, 1> vec2 = tmp.row (0).cross (tmp.row (2));
+      Eigen::Matrix<Scalar, 3, 1> vec3 = tmp.row (1).cross (tmp.row (2));
+
+      Scalar len1 = vec1.squaredNorm ();
+      Scalar len2 = vec2.squaredNorm ();
+      Scalar len3 = vec3.squaredNorm ();
+
+      if (len1 >= len2 && len1 >= len3)
+        return (vec1 / std::sqrt (len1));
+      else if (len2 >= len1 && len2 >= len3)
+        return (vec2 / std::sqrt (len2));
+      else
+        return (vec3 / std::sqrt (len3));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+template <typename Scalar> void
+pcl::eigen33Batch (const std::vector<Eigen::Matrix<Scalar, 3, 3> > &mats,
+                   std::vector<Eigen::Matrix<Scalar, 3, 1> > &evals,
+                   std::vector<Eigen::Matrix<Scalar, 3, 1> > &evecs,
+                   unsigned int eigenvector_index)
+{
+  const int width = PCL_COVARIANCE_BATCH_WIDTH;
+  const Scalar s_inv3 = Scalar (1.0 / 3.0);
+  const Scalar s_sqrt3 = std::sqrt (Scalar (3.0));
+  const size_t count = mats.size ();
+
+  evals.resize (count);
+  evecs.resize (count);
+
+  for (size_t batch = 0; batch < count; batch += width)
+  {
+    const int lanes = static_cast<int> (std::min<size_t> (width, count - batch));
+
+    // upper triangle of the scaled matrices, structure of arrays
+    Scalar m00[PCL_COVARIANCE_BATCH_WIDTH], m01[PCL_COVARIANCE_BATCH_WIDTH], m02[PCL_COVARIANCE_BATCH_WIDTH];
+    Scalar m11[PCL_COVARIANCE_BATCH_WIDTH], m12[PCL_COVARIANCE_BATCH_WIDTH], m22[PCL_COVARIANCE_BATCH_WIDTH];
+    Scalar scale[PCL_COVARIANCE_BATCH_WIDTH];
+
+    for (int l = 0; l < width; ++l)
+    {
+      // unused lanes solve the identity
+      const Eigen::Matrix<Scalar, 3, 3> mat = (l < lanes) ? mats[batch + l] : Eigen::Matrix<Scalar, 3, 3>::Identity ();
+
+      // Scale the matrix so its entries are in [-1,1]
+      scale[l] = mat.cwiseAbs ().maxCoeff ();
+      if (scale[l] <= std::numeric_limits<Scalar>::min ())
+        scale[l] = Scalar (1.0);
+
+      m00[l] = mat (0, 0) / scale[l]; m01[l] = mat (0, 1) / scale[l]; m02[l] = mat (0, 2) / scale[l];
+      m11[l] = mat (1, 1) / scale[l]; m12[l] = mat (1, 2) / scale[l]; m22[l] = mat (2, 2) / scale[l];
+    }
+
+    Scalar root0[PCL_COVARIANCE_BATCH_WIDTH], root1[PCL_COVARIANCE_BATCH_WIDTH], root2[PCL_COVARIANCE_BATCH_WIDTH];
+
+    // roots of the characteristic equation x^3 - c2*x^2 + c1*x - c0 = 0, see computeRoots
+    for (int l = 0; l < width; ++l)
+    {
+      const Scalar c0 = m00[l] * m11[l] * m22[l] + Scalar (2) * m01[l] * m02[l] * m12[l]
+                      - m00[l] * m12[l] * m12[l] - m11[l] * m02[l] * m02[l] - m22[l] * m01[l] * m01[l];
+      const Scalar c1 = m00[l] * m11[l] - m01[l] * m01[l] + m00[l] * m22[l] - m02[l] * m02[l]
+                      + m11[l] * m22[l] - m12[l] * m12[l];
+      const Scalar c2 = m00[l] + m11[l] + m22[l];
+
+      // quadratic solution, used if one root is 0
+      const Scalar d = std::max (c2 * c2 - Scalar (4) * c1, Scalar (0));
+      const Scalar sd = std::sqrt (d);
+      const Scalar q1 = Scalar (0.5) * (c2 - sd);
+      const Scalar q2 = Scalar (0.5) * (c2 + sd);
+
+      // closed form cubic solution
+      const Scalar c2_over_3 = c2 * s_inv3;
+      const Scalar a_over_3 = std::min ((c1 - c2 * c2_over_3) * s_inv3, Scalar (0));
+      const Scalar half_b = Scalar (0.5) * (c0 + c2_over_3 * (Scalar (2) * c2_over_3 * c2_over_3 - c1));
+      const Scalar q = std::min (half_b * half_b + a_over_3 * a_over_3 * a_over_3, Scalar (0));
+      const Scalar rho = std::sqrt (-a_over_3);
+      const Scalar theta = std::atan2 (std::sqrt (-q), half_b) * s_inv3;
+      const Scalar cos_theta = std::cos (theta);
+      const Scalar sin_theta = std::sin (theta);
+      const Scalar r0 = c2_over_3 + Scalar (2) * rho * cos_theta;
+      const Scalar r1 = c2_over_3 - rho * (cos_theta + s_sqrt3 * sin_theta);
+      const Scalar r2 = c2_over_3 - rho * (cos_theta - s_sqrt3 * sin_theta);
+
+      // sort in increasing order
+      const Scalar lo = std::min (r0, r1), hi = std::max (r0, r1);
+      const Scalar s0 = std::min (lo, r2);
+      const Scalar s1 = std::max (lo, std::min (hi, r2));
+      const Scalar s2 = std::max (hi, r2);
+
+      // eigenvalues of a positive semi definite matrix can not be negative
+      const bool quadratic = (std::fabs (c0) < Eigen::NumTraits<Scalar>::epsilon ()) || (s0 <= 0);
+      root0[l] = quadratic ? Scalar (0) : s0;
+      root1[l] = quadratic ? q1 : s1;
+      root2[l] = quadratic ? q2 : s2;
+    }
+
+    // eigenvector of the selected eigenvalue from the cross products of the rows of (M - lambda * I)
+    for (int l = 0; l < lanes; ++l)
+    {
+      const Eigen::Matrix<Scalar, 3, 3> scaled_mat = (Eigen::Matrix<Scalar, 3, 3> () << m00[l], m01[l], m02[l],
+                                                                                        m01[l], m11[l], m12[l],
+                                                                                        m02[l], m12[l], m22[l]).finished ();
+      const Scalar epsilon = Eigen::NumTraits<Scalar>::epsilon ();
+      Eigen::Matrix<Scalar, 3, 1> &evec = evecs[batch + l];
+
+      if ((root2[l] - root0[l]) <= epsilon)
+      {
+        // all three equal
+        evec = Eigen::Matrix<Scalar, 3, 1>::UnitX ();
+      }
+      else if (eigenvector_index < 2 && (root1[l] - root0[l]) <= epsilon)
+      {
+        // first and second equal, any vector orthogonal to the last eigenvector
+        evec = pcl::detail::computeCrossProductEigenVector (scaled_mat, root2[l]).unitOrthogonal ();
+      }
+      else if (eigenvector_index > 0 && (root2[l] - root1[l]) <= epsilon)
+      {
+        // second and third equal, any vector orthogonal to the first eigenvector
+        evec = pcl::detail::computeCrossProductEigenVector (scaled_mat, root0[l]).unitOrthogonal ();
+      }
+      else
+      {
+        const Scalar lambda = (eigenvector_index == 0) ? root0[l] : ((eigenvector_index == 1) ? root1[l] : root2[l]);
+        evec = pcl::detail::computeCrossProductEigenVector (scaled_mat, lambda);
+      }
+
+      evals[batch + l] = Eigen::Matrix<Scalar, 3, 1> (root0[l], root1[l], root2[l]) * scale[l];
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 template <typename Matrix> inline typename Matrix::Scalar
 pcl::invert2x2 (const Matrix& matrix, Matrix& inverse)
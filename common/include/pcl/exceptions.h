@@ -37,10 +37,12 @@
 #ifndef PCL_EXCEPTIONS_H_
 #define PCL_EXCEPTIONS_H_
 
+#include <new>
 #include <stdexcept>
 #include <sstream>
 #include <pcl/pcl_macros.h>
 #include <boost/current_function.hpp>
+#include <boost/shared_ptr.hpp>
 
 /** PCL_THROW_EXCEPTION a helper macro to be used for throwing exceptions.
   * This is an example on how to use:
@@ -263,6 +265,118 @@ namespace pcl
                           unsigned line_number = 0) throw ()
       : pcl::PCLException (error_description, file_name, function_name, line_number) { }
   };
+
+  namespace detail
+  {
+    /** \brief Keeps a copy of a caught exception so that it can be rethrown later, e.g. once all the threads of
+      * an OpenMP region have finished, without slicing it: PCL exceptions and std::bad_alloc keep their class,
+      * any other std::exception is rethrown as a PCLException carrying its message.
+      */
+    class CapturedException
+    {
+      public:
+        CapturedException () : holder_ () {}
+
+        /** \brief Copy the exception currently being handled. Must be called from within a catch block. */
+        void
+        capture ()
+        {
+          try
+          {
+            throw;
+          }
+          catch (const InvalidConversionException &e)
+          {
+            store (e);
+          }
+          catch (const IsNotDenseException &e)
+          {
+            store (e);
+          }
+          catch (const InvalidSACModelTypeException &e)
+          {
+            store (e);
+          }
+          catch (const IOException &e)
+          {
+            store (e);
+          }
+          catch (const InitFailedException &e)
+          {
+            store (e);
+          }
+          catch (const UnorganizedPointCloudException &e)
+          {
+            store (e);
+          }
+          catch (const KernelWidthTooSmallException &e)
+          {
+            store (e);
+          }
+          catch (const UnhandledPointTypeException &e)
+          {
+            store (e);
+          }
+          catch (const ComputeFailedException &e)
+          {
+            store (e);
+          }
+          catch (const BadArgumentException &e)
+          {
+            store (e);
+          }
+          catch (const PCLException &e)
+          {
+            store (e);
+          }
+          catch (const std::bad_alloc &e)
+          {
+            store (e);
+          }
+          catch (const std::exception &e)
+          {
+            store (PCLException (e.what ()));
+          }
+        }
+
+        /** \return true if no exception has been captured. */
+        inline bool
+        empty () const { return (!holder_); }
+
+        /** \brief Throw a copy of the captured exception, does nothing if none has been captured. */
+        inline void
+        rethrow () const
+        {
+          if (holder_)
+            holder_->rethrow ();
+        }
+
+      private:
+        struct Holder
+        {
+          virtual ~Holder () {}
+
+          virtual void
+          rethrow () const = 0;
+        };
+
+        template <typename ExceptionT>
+        struct HolderImpl : public Holder
+        {
+          HolderImpl (const ExceptionT &exception) : exception_ (exception) {}
+
+          virtual void
+          rethrow () const { throw exception_; }
+
+          ExceptionT exception_;
+        };
+
+        template <typename ExceptionT> void
+        store (const ExceptionT &exception) { holder_.reset (new HolderImpl<ExceptionT> (exception)); }
+
+        boost::shared_ptr<Holder> holder_;
+    };
+  }
 }
 
 
@@ -361,6 +361,17 @@ log2f (float x)
   #error Alignment not supported on your platform
 #endif
 
+// Number of 3x3 problems (covariance accumulation, eigen decomposition) processed side by side by the
+// batched solvers. Their per-problem state is laid out as structure of arrays of this width, so that the
+// arithmetic vectorizes across problems.
+#ifndef PCL_COVARIANCE_BATCH_WIDTH
+  #if defined (__AVX512F__)
+    #define PCL_COVARIANCE_BATCH_WIDTH 16
+  #else
+    #define PCL_COVARIANCE_BATCH_WIDTH 8
+  #endif
+#endif
+
 #if defined(__GLIBC__) && PCL_LINEAR_VERSION(__GLIBC__,__GLIBC_MINOR__,0)>PCL_LINEAR_VERSION(2,8,0)
   #define GLIBC_MALLOC_ALIGNED 1
 #else
@@ -86,6 +86,7 @@ RETf sse_xor( const __m128 x, const __m128 y ) { return _mm_xor_ps(x,y); }
 // comparison operators
 RETf sse_cmpgt( const __m128 x, const __m128 y ) { return _mm_cmpgt_ps(x,y); }
 RETi sse_cmpgt( const __m128i x, const __m128i y ) { return _mm_cmpgt_epi32(x,y); }
+RETf sse_cmple( const __m128 x, const __m128 y ) { return _mm_cmple_ps(x,y); }
 
 // conversion operators
 RETf sse_cvt( const __m128i x ) { return _mm_cvtepi32_ps(x); }
@@ -176,6 +176,27 @@ namespace pcl
       bool
       computePoint (size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc);
 
+      /** \brief Estimate a descriptor for a given point, drawing the random x axis from \a rng instead of the
+        * internal generator and searching into caller owned buffers. This variant does not modify the estimator
+        * and can be called from several threads.
+        * \param[in] index the index of the point to estimate a descriptor for
+        * \param[in] normals a pointer to the set of normals
+        * \param[in] rf the reference frame
+        * \param[out] desc the resultant estimated descriptor, accumulated into, so it must be zero on input
+        * \param[in,out] rng the random number generator to use
+        * \param[out] nn_indices buffer for the indices of the neighbors of the point
+        * \param[out] nn_dists buffer for the squared distances of the neighbors of the point
+        * \param[out] density_indices buffer for the indices of the neighbors used for the local point density
+        * \param[out] density_dists buffer for the squared distances of the neighbors used for the local point density
+        * \return true if the descriptor was computed successfully, false if there was an error
+        * (e.g. the nearest neighbor didn't return any neighbors)
+        */
+      bool
+      computePoint (size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc,
+                    boost::uniform_01<boost::mt19937> &rng,
+                    std::vector<int> &nn_indices, std::vector<float> &nn_dists,
+                    std::vector<int> &density_indices, std::vector<float> &density_dists) const;
+
       /** \brief Estimate the actual feature.
         * \param[out] output the resultant feature
         */
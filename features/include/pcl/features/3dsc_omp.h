@@ -0,0 +1,141 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#ifndef PCL_FEATURES_3DSC_OMP_H_
+#define PCL_FEATURES_3DSC_OMP_H_
+
+#include <pcl/features/3dsc.h>
+
+namespace pcl
+{
+  /** \brief ShapeContext3DEstimationOMP implements the 3D shape context descriptor as described in
+    * \ref ShapeContext3DEstimation, in parallel, using the OpenMP standard.
+    *
+    * The random x axis of every point is drawn from a generator that is seeded from the point position in the
+    * indices, so the descriptors do not depend on the number of threads. They do differ from the ones of the
+    * serial estimator, which draws all axes from a single sequence.
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT = pcl::ShapeContext1980>
+  class ShapeContext3DEstimationOMP : public ShapeContext3DEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      typedef boost::shared_ptr<ShapeContext3DEstimationOMP<PointInT, PointNT, PointOutT> > Ptr;
+      typedef boost::shared_ptr<const ShapeContext3DEstimationOMP<PointInT, PointNT, PointOutT> > ConstPtr;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::input_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::descriptor_length_;
+      using ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint;
+
+      typedef typename Feature<PointInT, PointOutT>::PointCloudOut PointCloudOut;
+      typedef typename Feature<PointInT, PointOutT>::ThreadContext ThreadContext;
+      typedef typename Feature<PointInT, PointOutT>::ThreadScratchPtr ThreadScratchPtr;
+
+      /** \brief Constructor.
+        * \param[in] random If true the random seed is set to current time, else it is
+        * set to 12345 prior to computing the descriptor (used to select X axis)
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      ShapeContext3DEstimationOMP (bool random = false, unsigned int nr_threads = 0) :
+        ShapeContext3DEstimation<PointInT, PointNT, PointOutT> (random),
+        seed_ (random ? static_cast<unsigned int> (std::time (0)) : 12345u),
+        threads_ (nr_threads)
+      {
+        feature_name_ = "ShapeContext3DEstimationOMP";
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+    protected:
+      /** \brief Estimate the descriptor of a single point.
+        * \param[in] index the position of the query point in indices_
+        * \param[in,out] context the scratch state of the calling thread
+        * \param[out] output_point the resultant descriptor
+        */
+      /** \brief Descriptor and point density buffers of one thread, the neighbors of the point are searched
+        * into the buffers of the \ref ThreadContext.
+        */
+      struct Scratch : public Feature<PointInT, PointOutT>::ThreadScratch
+      {
+        /** \brief The descriptor of the current point. */
+        std::vector<float> descriptor;
+
+        /** \brief Indices of the neighbors used for the local point density. */
+        std::vector<int> density_indices;
+
+        /** \brief Squared distances of the neighbors used for the local point density. */
+        std::vector<float> density_dists;
+      };
+
+      virtual bool
+      computePointFeature (size_t index, ThreadContext &context, PointOutT &output_point) const;
+
+      /** \brief Create the descriptor buffers of one thread. */
+      virtual ThreadScratchPtr
+      createThreadScratch () const { return (ThreadScratchPtr (new Scratch)); }
+
+    private:
+      /** \brief Estimate the actual feature in parallel.
+        * \param[out] output the resultant feature
+        */
+      void
+      computeFeature (PointCloudOut &output);
+
+      /** \brief Base seed of the per point random number generators. */
+      unsigned int seed_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/3dsc_omp.hpp>
+#endif
+
+#endif  //#ifndef PCL_FEATURES_3DSC_OMP_H_
@@ -0,0 +1,171 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_BATCH_GLOBAL_FEATURE_H_
+#define PCL_BATCH_GLOBAL_FEATURE_H_
+
+#include <pcl/features/feature.h>
+#include <pcl/search/brute_force.h>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief BatchGlobalFeatureEstimation computes a global descriptor (e.g. \ref ESFEstimation, \ref VFHEstimation,
+    * \ref CVFHEstimation or \ref OURCVFHEstimation) for many clusters concurrently.
+    *
+    * The estimator given to \ref setEstimator is used as a prototype holding all parameters. Every thread copies
+    * it once and reuses the copy, together with its scratch buffers (such as the voxel grid of ESF), for all the
+    * clusters it processes. If the prototype has no search method, each copy searches its cluster with its own
+    * \ref search::BruteForce object, since global descriptors rarely query the search method and building a
+    * kd-tree per cluster would be wasted. Estimators that do search their input should be given a search method
+    * factory (see \ref setSearchMethodFactory), so that every copy gets its own search object. A search method set
+    * on the prototype cannot be shared by several threads; without a factory the clusters are then processed by
+    * a single thread.
+    *
+    * \code
+    * pcl::VFHEstimation<pcl::PointXYZ, pcl::Normal, pcl::VFHSignature308> vfh;
+    * pcl::BatchGlobalFeatureEstimation<pcl::PointXYZ, pcl::VFHSignature308,
+    *                                   pcl::VFHEstimation<pcl::PointXYZ, pcl::Normal, pcl::VFHSignature308> > batch;
+    * batch.setEstimator (vfh);
+    * batch.setNumberOfThreads (8);
+    * std::vector<pcl::PointCloud<pcl::VFHSignature308> > descriptors;
+    * batch.compute (clusters, cluster_normals, descriptors);
+    * \endcode
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointOutT, typename FeatureT>
+  class BatchGlobalFeatureEstimation
+  {
+    public:
+      typedef typename Feature<PointInT, PointOutT>::PointCloudIn PointCloudIn;
+      typedef typename PointCloudIn::ConstPtr PointCloudInConstPtr;
+      typedef typename Feature<PointInT, PointOutT>::PointCloudOut PointCloudOut;
+      typedef typename pcl::search::Search<PointInT>::Ptr SearchPtr;
+      typedef boost::function<SearchPtr ()> SearchMethodFactory;
+
+      /** \brief Empty constructor. */
+      BatchGlobalFeatureEstimation (unsigned int nr_threads = 0) : estimator_ (), search_factory_ (), threads_ (nr_threads) {}
+
+      /** \brief Set the estimator used as a prototype for every cluster.
+        * \param[in] estimator the configured estimator; its input cloud, indices and search surface are ignored
+        */
+      inline void
+      setEstimator (const FeatureT &estimator) { estimator_ = estimator; }
+
+      /** \brief Get the prototype estimator. */
+      inline FeatureT&
+      getEstimator () { return (estimator_); }
+
+      /** \brief Provide a function creating the search method of every estimator copy, e.g.
+        * \code
+        * pcl::search::Search<pcl::PointXYZ>::Ptr
+        * makeKdTree () { return (pcl::search::Search<pcl::PointXYZ>::Ptr (new pcl::search::KdTree<pcl::PointXYZ>)); }
+        * ...
+        * batch.setSearchMethodFactory (&makeKdTree);
+        * \endcode
+        * \param[in] factory returns a new search object on every call; an empty function removes the factory
+        */
+      inline void
+      setSearchMethodFactory (const SearchMethodFactory &factory) { search_factory_ = factory; }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+      /** \brief Compute the descriptors of a set of clusters.
+        * \param[in] clouds the clusters
+        * \param[out] descriptors the descriptors, one point cloud per cluster
+        */
+      void
+      compute (const std::vector<PointCloudInConstPtr> &clouds, std::vector<PointCloudOut> &descriptors);
+
+      /** \brief Compute the descriptors of a set of clusters, for estimators that need surface normals.
+        * \param[in] clouds the clusters
+        * \param[in] normals the normals of every cluster, in the same order as \a clouds
+        * \param[out] descriptors the descriptors, one point cloud per cluster
+        */
+      template <typename NormalCloudConstPtr> void
+      compute (const std::vector<PointCloudInConstPtr> &clouds,
+               const std::vector<NormalCloudConstPtr> &normals,
+               std::vector<PointCloudOut> &descriptors);
+
+    private:
+      /** \brief Leaves the normals of the estimator untouched. */
+      struct NoNormals
+      {
+        inline void
+        operator () (FeatureT &, size_t) const {}
+      };
+
+      /** \brief Sets the normals of the given cluster on the estimator. */
+      template <typename NormalCloudConstPtr>
+      struct WithNormals
+      {
+        WithNormals (const std::vector<NormalCloudConstPtr> &normals) : normals_ (normals) {}
+
+        inline void
+        operator () (FeatureT &estimator, size_t idx) const { estimator.setInputNormals (normals_[idx]); }
+
+        const std::vector<NormalCloudConstPtr> &normals_;
+      };
+
+      /** \brief Shared implementation of both compute () methods. */
+      template <typename SetNormals> void
+      computeBatch (const std::vector<PointCloudInConstPtr> &clouds,
+                    const SetNormals &set_normals,
+                    std::vector<PointCloudOut> &descriptors);
+
+      /** \brief The prototype estimator. */
+      FeatureT estimator_;
+
+      /** \brief Creates the search method of every estimator copy, if set. */
+      SearchMethodFactory search_factory_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#include <pcl/features/impl/batch_global_feature.hpp>
+
+#endif  //#ifndef PCL_BATCH_GLOBAL_FEATURE_H_
@@ -55,7 +55,8 @@ namespace pcl
    * \attention The input normals given by setInputNormalsSmall and setInputNormalsLarge have
    * to match the input point cloud given by setInputCloud. This behavior is different than
    * feature estimation methods that extend FeatureFromNormals, which match the normals
-   * with the search surface.
+   * with the search surface. Both normal clouds can be estimated with a single neighborhood search
+   * per point using \ref MultiscaleNormalEstimation.
    *
    * \note For more information please see
    *    <b>Yani Ioannou. Automatic Urban Modelling using Mobile Urban LIDAR Data.
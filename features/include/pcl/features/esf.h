@@ -44,6 +44,8 @@
 #define GRIDSIZE 64
 #define GRIDSIZE_H GRIDSIZE/2
 #include <vector>
+#include <ctime>
+#include <boost/random/mersenne_twister.hpp>
 
 namespace pcl
 {
@@ -74,21 +76,41 @@ namespace pcl
       typedef typename Feature<PointInT, PointOutT>::PointCloudOut PointCloudOut;
 
       /** \brief Empty constructor. */
-      ESFEstimation () : lut_ (), local_cloud_ ()
+      ESFEstimation () 
+        : lut_ (GRIDSIZE * GRIDSIZE * GRIDSIZE, 0)
+        , local_cloud_ ()
+        , sample_size_ (20000)
+        , seed_ (static_cast<unsigned int> (time (0)))
+        , rng_ ()
+        , d2v_ (), d3v_ (), wt_d2_ (), wt_d3_ ()
       {
         feature_name_ = "ESFEstimation";
-        lut_.resize (GRIDSIZE);
-        for (int i = 0; i < GRIDSIZE; ++i)
-        {
-          lut_[i].resize (GRIDSIZE);
-          for (int j = 0; j < GRIDSIZE; ++j)
-            lut_[i][j].resize (GRIDSIZE);
-        }
-        //lut_.resize (boost::extents[GRIDSIZE][GRIDSIZE][GRIDSIZE]);
         search_radius_ = 0;
         k_ = 5;
       }
 
+      /** \brief Set the number of random point triplets drawn per cloud (default: 20000). Lower values trade
+        * descriptor stability for speed, e.g. when building large object databases.
+        * \param[in] nr_samples the number of samples
+        */
+      inline void
+      setNumberOfSamples (unsigned int nr_samples) { sample_size_ = nr_samples; }
+
+      /** \brief Get the number of random point triplets drawn per cloud. */
+      inline unsigned int
+      getNumberOfSamples () const { return (sample_size_); }
+
+      /** \brief Set the seed of the random number generator. The generator is reseeded at the start of
+        * every compute () call, so that identical inputs give identical signatures (default: time (0)).
+        * \param[in] seed the random seed
+        */
+      inline void
+      setSeed (unsigned int seed) { seed_ = seed; }
+
+      /** \brief Get the seed of the random number generator. */
+      inline unsigned int
+      getSeed () const { return (seed_); }
+
       /** \brief Overloaded computed method from pcl::Feature.
         * \param[out] output the resultant point cloud model dataset containing the estimated features
         */
@@ -128,11 +150,28 @@ namespace pcl
 
     private:
 
-      /** \brief ... */
-      std::vector<std::vector<std::vector<int> > > lut_;
+      /** \brief Index of voxel (x, y, z) in \a lut_. */
+      inline int
+      lutIndex (int x, int y, int z) const { return ((x * GRIDSIZE + y) * GRIDSIZE + z); }
+
+      /** \brief Occupancy of the GRIDSIZE^3 voxel grid, stored contiguously. */
+      std::vector<unsigned char> lut_;
       
       /** \brief ... */
       PointCloudIn local_cloud_;
+
+      /** \brief Number of random point triplets drawn per cloud. */
+      unsigned int sample_size_;
+
+      /** \brief Seed of \a rng_. */
+      unsigned int seed_;
+
+      /** \brief Random number generator used to draw point triplets. */
+      boost::mt19937 rng_;
+
+      /** \brief Scratch buffers for the D2/D3 samples, kept across calls to avoid reallocations. */
+      std::vector<float> d2v_, d3v_, wt_d3_;
+      std::vector<int> wt_d2_;
   };
 }
 
@@ -47,6 +47,7 @@
 
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
+#include <boost/random/mersenne_twister.hpp>
 // PCL includes
 #include <pcl/pcl_base.h>
 #include <pcl/search/search.h>
@@ -291,6 +292,68 @@ namespace pcl
         return (search_method_surface_ (cloud, index, parameter, indices, distances));
       }
 
+      /** \brief Base class of the estimator specific buffers kept in a \ref ThreadContext. Estimators derive
+        * from it and return an instance from \ref createThreadScratch.
+        */
+      struct ThreadScratch
+      {
+        virtual ~ThreadScratch () {}
+      };
+
+      typedef boost::shared_ptr<ThreadScratch> ThreadScratchPtr;
+
+      /** \brief Per thread state handed to \ref computePointFeature by \ref computeFeatureParallel. */
+      struct ThreadContext
+      {
+        ThreadContext () : thread_id (0), nn_indices (), nn_dists (), rng (), scratch () {}
+
+        /** \brief The index of the thread in the parallel region. */
+        unsigned int thread_id;
+
+        /** \brief Neighbor index buffer, reused across the points of a thread. */
+        std::vector<int> nn_indices;
+
+        /** \brief Neighbor distance buffer, reused across the points of a thread. */
+        std::vector<float> nn_dists;
+
+        /** \brief Random number generator, reseeded for every point from the seed and the point position in
+          * indices_, so that the results do not depend on the number of threads or the schedule.
+          */
+        boost::mt19937 rng;
+
+        /** \brief Estimator specific buffers from \ref createThreadScratch, reused across the points of a
+          * thread (empty if the estimator needs none).
+          */
+        ThreadScratchPtr scratch;
+      };
+
+      /** \brief Generic parallel driver for computeFeature: calls \ref computePointFeature for every point in
+        * indices_ using OpenMP, sets output.is_dense, and rethrows the first exception raised by any thread,
+        * keeping its class, once all threads have finished.
+        * \param[out] output the resultant features, already resized to indices_->size ()
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value to automatic)
+        * \param[in] seed base seed of the per point random number generators
+        */
+      void
+      computeFeatureParallel (PointCloudOut &output, unsigned int nr_threads, unsigned int seed = 12345u);
+
+      /** \brief Estimate the feature at a single point, used by \ref computeFeatureParallel. Implementations
+        * must only use \a context and local variables as scratch space, since they are called from several
+        * threads at once.
+        * \param[in] index the position of the query point in indices_
+        * \param[in,out] context the scratch state of the calling thread
+        * \param[out] output_point the resultant feature
+        * \return false if the feature is not finite
+        */
+      virtual bool
+      computePointFeature (size_t index, ThreadContext &context, PointOutT &output_point) const;
+
+      /** \brief Create the estimator specific buffers of one thread, called once per thread by
+        * \ref computeFeatureParallel before the first point. The default creates none.
+        */
+      virtual ThreadScratchPtr
+      createThreadScratch () const { return (ThreadScratchPtr ()); }
+
     private:
       /** \brief Abstract feature estimation method.
         * \param[out] output the resultant features
@@ -0,0 +1,207 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FPFH_INCREMENTAL_H_
+#define PCL_FPFH_INCREMENTAL_H_
+
+#include <pcl/features/fpfh.h>
+#include <pcl/features/boost.h>
+
+namespace pcl
+{
+  /** \brief IncrementalFPFHEstimation estimates the Fast Point Feature Histogram (FPFH) descriptor for a
+    * sequence of clouds that change only partially between calls, e.g. a sliding window map.
+    *
+    * Every point of the input cloud carries a stable identifier given by \ref setPointIds. The SPFH
+    * histogram, the neighborhood and the final FPFH signature of each point are kept per identifier between
+    * calls to compute (). On each call, points whose identifier is new are treated as inserted, and cached
+    * identifiers that are no longer present as removed. Only the SPFH signatures of points whose
+    * neighborhood contains an inserted or removed point are recomputed, and only the FPFH signatures of
+    * those points and of their neighbors are reweighted. All other signatures are copied from the cache.
+    *
+    * A point must keep its coordinates and normal for as long as it keeps its identifier; a moved point
+    * has to be given a new identifier. The cache is cleared whenever the number of bins or the search
+    * parameter changes.
+    *
+    * The incremental path requires the features to be computed for the whole input cloud (no
+    * setIndices () subset and no separate setSearchSurface ()). Otherwise, or if no identifiers are set,
+    * compute () falls back to \ref FPFHEstimation and clears the cache.
+    *
+    * \note Up to the summation order of floating point values, the result is the same as the one of
+    * \ref FPFHEstimation on the same cloud.
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT = pcl::FPFHSignature33>
+  class IncrementalFPFHEstimation : public FPFHEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      typedef boost::shared_ptr<IncrementalFPFHEstimation<PointInT, PointNT, PointOutT> > Ptr;
+      typedef boost::shared_ptr<const IncrementalFPFHEstimation<PointInT, PointNT, PointOutT> > ConstPtr;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::getClassName;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::k_;
+      using Feature<PointInT, PointOutT>::search_radius_;
+      using Feature<PointInT, PointOutT>::search_parameter_;
+      using Feature<PointInT, PointOutT>::input_;
+      using Feature<PointInT, PointOutT>::surface_;
+      using Feature<PointInT, PointOutT>::tree_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::nr_bins_f1_;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::nr_bins_f2_;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::nr_bins_f3_;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::fpfh_histogram_;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::computePointSPFHSignature;
+      using FPFHEstimation<PointInT, PointNT, PointOutT>::weightPointSPFHSignature;
+
+      typedef typename Feature<PointInT, PointOutT>::PointCloudOut PointCloudOut;
+
+      /** \brief Empty constructor. */
+      IncrementalFPFHEstimation () :
+        point_ids_ (), cache_ (),
+        cached_search_parameter_ (0), cached_radius_search_ (false),
+        cached_nr_bins_f1_ (0), cached_nr_bins_f2_ (0), cached_nr_bins_f3_ (0),
+        nr_spfh_updates_ (0), nr_fpfh_updates_ (0)
+      {
+        feature_name_ = "IncrementalFPFHEstimation";
+      }
+
+      /** \brief Provide a stable identifier for every point of the input cloud.
+        * \param[in] point_ids one identifier per point of the input cloud, unique within the cloud
+        */
+      inline void
+      setPointIds (const IndicesConstPtr &point_ids) { point_ids_ = point_ids; }
+
+      /** \brief Get the point identifiers of the input cloud. */
+      inline IndicesConstPtr
+      getPointIds () const { return (point_ids_); }
+
+      /** \brief Drop all cached signatures. The next call to compute () starts from scratch. */
+      inline void
+      reset () { cache_.clear (); }
+
+      /** \brief Get the number of SPFH signatures recomputed by the last call to compute (). */
+      inline size_t
+      getNumberOfSPFHUpdates () const { return (nr_spfh_updates_); }
+
+      /** \brief Get the number of FPFH signatures reweighted by the last call to compute (). */
+      inline size_t
+      getNumberOfFPFHUpdates () const { return (nr_fpfh_updates_); }
+
+    protected:
+      /** \brief Estimate the FPFH descriptors of all points of the input cloud, recomputing only what the changes
+        * since the previous call invalidated.
+        * \param[out] output the resultant point cloud model dataset that contains the FPFH feature estimates
+        */
+      void
+      computeFeature (PointCloudOut &output);
+
+    private:
+      /** \brief Cached state of one point, indexed by its identifier. */
+      struct PointState
+      {
+        PointState () : spfh (), fpfh (), neighbor_ids (), neighbor_dists (), referrers (),
+                        sqr_reach (0), valid (false) {}
+
+        /** \brief The SPFH histograms f1, f2 and f3, concatenated. */
+        std::vector<float> spfh;
+        /** \brief The FPFH signature. */
+        std::vector<float> fpfh;
+        /** \brief The identifiers of the points in the neighborhood, in search order. */
+        std::vector<int> neighbor_ids;
+        /** \brief The squared distances to the points in the neighborhood. */
+        std::vector<float> neighbor_dists;
+        /** \brief The identifiers of the points that have this point in their neighborhood. */
+        std::vector<int> referrers;
+        /** \brief The squared distance within which an inserted point changes the neighborhood. */
+        float sqr_reach;
+        /** \brief False if the point is not finite or has no neighbors. */
+        bool valid;
+      };
+
+      typedef boost::unordered_map<int, PointState> PointStateMap;
+
+      /** \brief Recompute the neighborhood and the SPFH signature of a point.
+        * \param[in] id the identifier of the point
+        * \param[in] index the index of the point in the input cloud
+        * \param[in] radius_search true if the search parameter is a radius, false if it is a number of neighbors
+        * \param[out] state the cached state of the point
+        */
+      void
+      updateSPFHSignature (int id, int index, bool radius_search, PointState &state);
+
+      /** \brief Reweight the FPFH signature of a point from the cached SPFH signatures of its neighborhood.
+        * \param[in,out] state the cached state of the point
+        */
+      void
+      updateFPFHSignature (PointState &state);
+
+      /** \brief Remove an identifier from the list of referrers of a cached point, if it is still cached. */
+      void
+      removeReferrer (int id, int referrer);
+
+      /** \brief The identifiers of the points of the input cloud. */
+      IndicesConstPtr point_ids_;
+
+      /** \brief The cached state of every point of the previous cloud. */
+      PointStateMap cache_;
+
+      /** \brief The search parameter the cache was computed with. */
+      double cached_search_parameter_;
+
+      /** \brief Whether the cache was computed with a radius search. */
+      bool cached_radius_search_;
+
+      /** \brief The number of bins the cache was computed with. */
+      int cached_nr_bins_f1_, cached_nr_bins_f2_, cached_nr_bins_f3_;
+
+      /** \brief The number of SPFH signatures recomputed by the last call to compute (). */
+      size_t nr_spfh_updates_;
+
+      /** \brief The number of FPFH signatures reweighted by the last call to compute (). */
+      size_t nr_fpfh_updates_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/fpfh_incremental.hpp>
+#endif
+
+#endif  //#ifndef PCL_FPFH_INCREMENTAL_H_
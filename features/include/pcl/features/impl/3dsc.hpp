@@ -129,6 +129,21 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::initCompute ()
 template <typename PointInT, typename PointNT, typename PointOutT> bool
 pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
     size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc)
+{
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dists;
+  std::vector<int> density_indices;
+  std::vector<float> density_dists;
+  return (computePoint (index, normals, rf, desc, *rng_, nn_indices, nn_dists, density_indices, density_dists));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> bool
+pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
+    size_t index, const pcl::PointCloud<PointNT> &normals, float rf[9], std::vector<float> &desc,
+    boost::uniform_01<boost::mt19937> &rng,
+    std::vector<int> &nn_indices, std::vector<float> &nn_dists,
+    std::vector<int> &density_indices, std::vector<float> &density_dists) const
 {
   // The RF is formed as this x_axis | y_axis | normal
   Eigen::Map<Eigen::Vector3f> x_axis (rf);
@@ -136,8 +151,6 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
   Eigen::Map<Eigen::Vector3f> normal (rf + 6);
 
   // Find every point within specified search_radius_
-  std::vector<int> nn_indices;
-  std::vector<float> nn_dists;
   const size_t neighb_cnt = searchForNeighbors ((*indices_)[index], search_radius_, nn_indices, nn_dists);
   if (neighb_cnt == 0)
   {
@@ -150,7 +163,7 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
 
   float minDist = std::numeric_limits<float>::max ();
   int minIndex = -1;
-  for (size_t i = 0; i < nn_indices.size (); i++)
+  for (size_t i = 0; i < neighb_cnt; i++)
   {
 	  if (nn_dists[i] < minDist)
 	  {
@@ -166,9 +179,9 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
   normal = normals[minIndex].getNormalVector3fMap ();
 
   // Compute and store the RF direction
-  x_axis[0] = static_cast<float> (rnd ());
-  x_axis[1] = static_cast<float> (rnd ());
-  x_axis[2] = static_cast<float> (rnd ());
+  x_axis[0] = static_cast<float> (rng ());
+  x_axis[1] = static_cast<float> (rng ());
+  x_axis[2] = static_cast<float> (rng ());
   if (!pcl::utils::equal (normal[2], 0.0f))
     x_axis[2] = - (normal[0]*x_axis[0] + normal[1]*x_axis[1]) / normal[2];
   else if (!pcl::utils::equal (normal[1], 0.0f))
@@ -248,9 +261,7 @@ pcl::ShapeContext3DEstimation<PointInT, PointNT, PointOutT>::computePoint (
     }
 
     // Local point density = number of points in a sphere of radius "point_density_radius_" around the current neighbour
-    std::vector<int> neighbour_indices;
-    std::vector<float> neighbour_distances;
-    int point_density = searchForNeighbors (*surface_, nn_indices[ne], point_density_radius_, neighbour_indices, neighbour_distances);
+    int point_density = searchForNeighbors (*surface_, nn_indices[ne], point_density_radius_, density_indices, density_dists);
     // point_density is NOT always bigger than 0 (on error, searchForNeighbors returns 0), so we must check for that
     if (point_density == 0)
       continue;
@@ -0,0 +1,150 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FEATURES_IMPL_BATCH_GLOBAL_FEATURE_H_
+#define PCL_FEATURES_IMPL_BATCH_GLOBAL_FEATURE_H_
+
+#include <pcl/features/batch_global_feature.h>
+#include <pcl/exceptions.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename FeatureT> void
+pcl::BatchGlobalFeatureEstimation<PointInT, PointOutT, FeatureT>::compute (
+    const std::vector<PointCloudInConstPtr> &clouds, std::vector<PointCloudOut> &descriptors)
+{
+  computeBatch (clouds, NoNormals (), descriptors);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename FeatureT> template <typename NormalCloudConstPtr> void
+pcl::BatchGlobalFeatureEstimation<PointInT, PointOutT, FeatureT>::compute (
+    const std::vector<PointCloudInConstPtr> &clouds,
+    const std::vector<NormalCloudConstPtr> &normals,
+    std::vector<PointCloudOut> &descriptors)
+{
+  if (normals.size () != clouds.size ())
+  {
+    PCL_ERROR ("[pcl::BatchGlobalFeatureEstimation::compute] The number of normal clouds (%lu) differs from the number of clouds (%lu)!\n",
+               normals.size (), clouds.size ());
+    descriptors.clear ();
+    return;
+  }
+  computeBatch (clouds, WithNormals<NormalCloudConstPtr> (normals), descriptors);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename FeatureT> template <typename SetNormals> void
+pcl::BatchGlobalFeatureEstimation<PointInT, PointOutT, FeatureT>::computeBatch (
+    const std::vector<PointCloudInConstPtr> &clouds,
+    const SetNormals &set_normals,
+    std::vector<PointCloudOut> &descriptors)
+{
+  descriptors.clear ();
+  descriptors.resize (clouds.size ());
+
+  // Exceptions must not leave an OpenMP region, keep the first one and rethrow it afterwards
+  pcl::detail::CapturedException error;
+  bool failed = false;
+
+  // A search method set on the prototype would be shared by all copies
+  unsigned int nr_threads = threads_;
+  if (estimator_.getSearchMethod () && !search_factory_ && nr_threads != 1)
+  {
+    PCL_WARN ("[pcl::BatchGlobalFeatureEstimation::compute] The estimator has a search method, which cannot be shared by several threads. Set a search method factory to compute the descriptors in parallel.\n");
+    nr_threads = 1;
+  }
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+    // One estimator per thread, reused for all of its clusters
+    FeatureT estimator (estimator_);
+    if (search_factory_)
+      estimator.setSearchMethod (search_factory_ ());
+    else if (!estimator.getSearchMethod ())
+      estimator.setSearchMethod (SearchPtr (new pcl::search::BruteForce<PointInT> ()));
+    estimator.setSearchSurface (PointCloudInConstPtr ());
+
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 1)
+#endif
+    for (int idx = 0; idx < static_cast<int> (clouds.size ()); ++idx)
+    {
+      // Skip the remaining clusters once a thread failed; the flag is shared, so it is read atomically
+      // (OpenMP 2.0 has no atomic reads, a flush is the closest it offers)
+      bool stop;
+#if defined _OPENMP && _OPENMP >= 201107
+#pragma omp atomic read
+#elif defined _OPENMP
+#pragma omp flush (failed)
+#endif
+      stop = failed;
+      if (stop)
+        continue;
+
+      try
+      {
+        estimator.setInputCloud (clouds[idx]);
+        estimator.setIndices (IndicesPtr ());
+        set_normals (estimator, idx);
+        estimator.compute (descriptors[idx]);
+      }
+      catch (const std::exception &)
+      {
+#ifdef _OPENMP
+#pragma omp critical (batch_global_feature_error)
+#endif
+        {
+          if (error.empty ())
+            error.capture ();
+#if defined _OPENMP && _OPENMP >= 201107
+#pragma omp atomic write
+#endif
+          failed = true;
+        }
+      }
+    }
+  }
+
+  error.rethrow ();
+}
+
+#endif  //#ifndef PCL_FEATURES_IMPL_BATCH_GLOBAL_FEATURE_H_
@@ -97,6 +97,8 @@ pcl::CVFHEstimation<PointInT, PointNT, PointOutT>::extractEuclideanClustersSmoot
 
   std::vector<int> nn_indices;
   std::vector<float> nn_distances;
+  // Compare normals through their dot product instead of calling acos () for every neighbor
+  const double cos_eps_angle = cos (eps_angle);
   // Process all points in the indices vector
   for (int i = 0; i < static_cast<int> (cloud.points.size ()); ++i)
   {
@@ -130,7 +132,7 @@ pcl::CVFHEstimation<PointInT, PointNT, PointOutT>::extractEuclideanClustersSmoot
                      + normals.points[seed_queue[sq_idx]].normal[1] * normals.points[nn_indices[j]].normal[1]
                      + normals.points[seed_queue[sq_idx]].normal[2] * normals.points[nn_indices[j]].normal[2];
 
-        if (fabs (acos (dot_p)) < eps_angle)
+        if (dot_p <= 1.0 && dot_p > cos_eps_angle)
         {
           processed[nn_indices[j]] = true;
           seed_queue.push_back (nn_indices[j]);
@@ -211,6 +213,7 @@ pcl::CVFHEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut
   }
 
   centroids_dominant_orientations_.clear ();
+  dominant_normals_.clear ();
 
   // ---[ Step 0: remove normals with high curvature
   std::vector<int> indices_out;
@@ -244,13 +247,11 @@ pcl::CVFHEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut
     n3d.setInputCloud (normals_filtered_cloud);
     n3d.compute (*normals_filtered_cloud);
 
-    KdTreePtr normals_tree (new pcl::search::KdTree<pcl::PointNormal> (false));
-    normals_tree->setInputCloud (normals_filtered_cloud);
-
+    // The normal estimation above only writes the normal fields, so the tree is still valid for clustering
     extractEuclideanClustersSmooth (*normals_filtered_cloud,
                                     *normals_filtered_cloud,
                                     cluster_tolerance_,
-                                    normals_tree,
+                                    normals_tree_filtered,
                                     clusters,
                                     eps_angle_threshold_,
                                     static_cast<unsigned int> (min_points_));
@@ -46,6 +46,8 @@
 #include <pcl/common/distances.h>
 #include <pcl/common/transforms.h>
 #include <vector>
+#include <boost/random/uniform_int.hpp>
+#include <boost/random/variate_generator.hpp>
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
@@ -53,14 +55,20 @@ pcl::ESFEstimation<PointInT, PointOutT>::computeESF (
     PointCloudIn &pc, std::vector<float> &hist)
 {
   const int binsize = 64;
-  unsigned int sample_size = 20000;
-  srand (static_cast<unsigned int> (time (0)));
+  const unsigned int sample_size = sample_size_;
   int maxindex = static_cast<int> (pc.points.size ());
 
+  rng_.seed (seed_);
+  boost::uniform_int<int> uniform_distrib (0, maxindex - 1);
+  boost::variate_generator<boost::mt19937&, boost::uniform_int<int> > rand_index (rng_, uniform_distrib);
+
   int index1, index2, index3;
-  std::vector<float> d2v, d1v, d3v, wt_d3;
-  std::vector<int> wt_d2;
-  d1v.reserve (sample_size);
+  std::vector<float> &d2v = d2v_, &d3v = d3v_, &wt_d3 = wt_d3_;
+  std::vector<int> &wt_d2 = wt_d2_;
+  d2v.clear ();
+  d3v.clear ();
+  wt_d2.clear ();
+  wt_d3.clear ();
   d2v.reserve (sample_size * 3);
   d3v.reserve (sample_size);
   wt_d2.reserve (sample_size * 3);
@@ -88,9 +96,9 @@ pcl::ESFEstimation<PointInT, PointOutT>::computeESF (
   for (size_t nn_idx = 0; nn_idx < sample_size; ++nn_idx)
   {
     // get a new random point
-    index1 = rand()%maxindex;
-    index2 = rand()%maxindex;
-    index3 = rand()%maxindex;
+    index1 = rand_index ();
+    index2 = rand_index ();
+    index3 = rand_index ();
 
     if (index1==index2 || index1 == index3 || index2 == index3)
     {
@@ -213,22 +221,17 @@ pcl::ESFEstimation<PointInT, PointOutT>::computeESF (
   float maxd2 = 0;
   float maxd3 = 0;
 
-  for (size_t nn_idx = 0; nn_idx < sample_size; ++nn_idx)
-  {
-    // get max of Dx
+  // Degenerate triangles are skipped without being redrawn, so there may be less than sample_size entries
+  for (size_t nn_idx = 0; nn_idx < d2v.size (); ++nn_idx)
     if (d2v[nn_idx] > maxd2)
       maxd2 = d2v[nn_idx];
-    if (d2v[sample_size + nn_idx] > maxd2)
-      maxd2 = d2v[sample_size + nn_idx];
-    if (d2v[sample_size*2 +nn_idx] > maxd2)
-      maxd2 = d2v[sample_size*2 +nn_idx];
+  for (size_t nn_idx = 0; nn_idx < d3v.size (); ++nn_idx)
     if (d3v[nn_idx] > maxd3)
       maxd3 = d3v[nn_idx];
-  }
 
   // Normalize and create histogram
   int index;
-  for (size_t nn_idx = 0; nn_idx < sample_size; ++nn_idx)
+  for (size_t nn_idx = 0; nn_idx < d3v.size (); ++nn_idx)
   {
     if (wt_d3[nn_idx] >= 0.999) // IN
     {
@@ -340,7 +343,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::lci (
     for (int i = 1; i<l; i++)
     {
       voxelcount++;;
-      voxel_in +=  static_cast<int>(lut_[act_voxel[0]][act_voxel[1]][act_voxel[2]] == 1);
+      voxel_in +=  static_cast<int>(lut_[lutIndex (act_voxel[0], act_voxel[1], act_voxel[2])] == 1);
       if (err_1 > 0)
       {
         act_voxel[1] += y_inc;
@@ -363,7 +366,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::lci (
     for (int i=1; i<m; i++)
     {
       voxelcount++;
-      voxel_in +=  static_cast<int>(lut_[act_voxel[0]][act_voxel[1]][act_voxel[2]] == 1);
+      voxel_in +=  static_cast<int>(lut_[lutIndex (act_voxel[0], act_voxel[1], act_voxel[2])] == 1);
       if (err_1 > 0)
       {
         act_voxel[0] +=  x_inc;
@@ -386,7 +389,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::lci (
     for (int i=1; i<n; i++)
     {
       voxelcount++;
-      voxel_in +=  static_cast<int>(lut_[act_voxel[0]][act_voxel[1]][act_voxel[2]] == 1);
+      voxel_in +=  static_cast<int>(lut_[lutIndex (act_voxel[0], act_voxel[1], act_voxel[2])] == 1);
       if (err_1 > 0)
       {
         act_voxel[1] += y_inc;
@@ -403,7 +406,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::lci (
     }
   }
   voxelcount++;
-  voxel_in +=  static_cast<int>(lut_[act_voxel[0]][act_voxel[1]][act_voxel[2]] == 1);
+  voxel_in +=  static_cast<int>(lut_[lutIndex (act_voxel[0], act_voxel[1], act_voxel[2])] == 1);
   incnt = voxel_in;
   pointcount = voxelcount;
 
@@ -441,7 +444,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::voxelize9 (PointCloudIn &cluster)
             ;
           }
           else
-            this->lut_[xi][yi][zi] = 1;
+            this->lut_[lutIndex (xi, yi, zi)] = 1;
         }
   }
 }
@@ -470,7 +473,7 @@ pcl::ESFEstimation<PointInT, PointOutT>::cleanup9 (PointCloudIn &cluster)
             ;
           }
           else
-            this->lut_[xi][yi][zi] = 0;
+            this->lut_[lutIndex (xi, yi, zi)] = 0;
         }
   }
 }
@@ -532,6 +535,21 @@ pcl::ESFEstimation<PointInT, PointOutT>::compute (PointCloudOut &output)
 template <typename PointInT, typename PointOutT> void
 pcl::ESFEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
 {
+  // We only output _1_ signature
+  output.points.resize (1);
+  output.width = 1;
+  output.height = 1;
+
+  // At least three distinct points are needed to draw a triangle
+  if (surface_->points.size () < 3)
+  {
+    PCL_ERROR ("[pcl::%s::computeFeature] At least 3 points are needed, %lu given!\n", getClassName ().c_str (), surface_->points.size ());
+    for (int d = 0; d < 640; ++d)
+      output.points[0].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
+    output.is_dense = false;
+    return;
+  }
+
   Eigen::Vector4f xyz_centroid;
   std::vector<float> hist;
   scale_points_unit_sphere (*surface_, static_cast<float>(GRIDSIZE_H), xyz_centroid);
@@ -539,11 +557,6 @@ pcl::ESFEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
   this->computeESF (local_cloud_, hist);
   this->cleanup9 (local_cloud_);
 
-  // We only output _1_ signature
-  output.points.resize (1);
-  output.width = 1;
-  output.height = 1;
-
   for (size_t d = 0; d < hist.size (); ++d)
     output.points[0].histogram[d] = hist[d];
 }
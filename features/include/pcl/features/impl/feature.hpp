@@ -42,6 +42,11 @@
 #define PCL_FEATURES_IMPL_FEATURE_H_
 
 #include <pcl/search/pcl_search.h>
+#include <pcl/exceptions.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 inline void
@@ -222,6 +227,80 @@ pcl::Feature<PointInT, PointOutT>::compute (PointCloudOut &output)
   deinitCompute ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::Feature<PointInT, PointOutT>::computeFeatureParallel (PointCloudOut &output, unsigned int nr_threads, unsigned int seed)
+{
+  // Exceptions must not leave an OpenMP region, keep the first one and rethrow it afterwards
+  pcl::detail::CapturedException error;
+  bool failed = false;
+  bool dense = true;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+    ThreadContext context;
+#ifdef _OPENMP
+    context.thread_id = omp_get_thread_num ();
+#endif
+    context.nn_indices.reserve (k_);
+    context.nn_dists.reserve (k_);
+    context.scratch = createThreadScratch ();
+
+#ifdef _OPENMP
+#pragma omp for reduction (&& : dense) schedule (dynamic, 16)
+#endif
+    for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+    {
+      // Skip the remaining points once a thread failed; the flag is shared, so it is read atomically
+      // (OpenMP 2.0 has no atomic reads, a flush is the closest it offers)
+      bool stop;
+#if defined _OPENMP && _OPENMP >= 201107
+#pragma omp atomic read
+#elif defined _OPENMP
+#pragma omp flush (failed)
+#endif
+      stop = failed;
+      if (stop)
+        continue;
+
+      // Seed from the point position so that the result is independent of the thread layout
+      context.rng.seed (static_cast<boost::uint32_t> (seed ^ (static_cast<boost::uint32_t> (idx) * 2654435761u)));
+      try
+      {
+        if (!computePointFeature (idx, context, output.points[idx]))
+          dense = false;
+      }
+      catch (const std::exception &)
+      {
+#ifdef _OPENMP
+#pragma omp critical (feature_parallel_error)
+#endif
+        {
+          if (error.empty ())
+            error.capture ();
+#if defined _OPENMP && _OPENMP >= 201107
+#pragma omp atomic write
+#endif
+          failed = true;
+        }
+      }
+    }
+  }
+
+  error.rethrow ();
+  output.is_dense = dense;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> bool
+pcl::Feature<PointInT, PointOutT>::computePointFeature (size_t, ThreadContext &, PointOutT &) const
+{
+  PCL_ERROR ("[pcl::%s::computePointFeature] Not implemented for this feature!\n", getClassName ().c_str ());
+  return (false);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
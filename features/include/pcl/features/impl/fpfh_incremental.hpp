@@ -0,0 +1,270 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FEATURES_IMPL_FPFH_INCREMENTAL_H_
+#define PCL_FEATURES_IMPL_FPFH_INCREMENTAL_H_
+
+#include <pcl/features/fpfh_incremental.h>
+#include <pcl/features/impl/fpfh.hpp>
+#include <boost/unordered_set.hpp>
+#include <algorithm>
+#include <limits>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::IncrementalFPFHEstimation<PointInT, PointNT, PointOutT>::removeReferrer (int id, int referrer)
+{
+  typename PointStateMap::iterator it = cache_.find (id);
+  if (it == cache_.end ())
+    return;
+  std::vector<int> &referrers = it->second.referrers;
+  std::vector<int>::iterator r_it = std::find (referrers.begin (), referrers.end (), referrer);
+  if (r_it != referrers.end ())
+  {
+    *r_it = referrers.back ();
+    referrers.pop_back ();
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::IncrementalFPFHEstimation<PointInT, PointNT, PointOutT>::updateSPFHSignature (
+    int id, int index, bool radius_search, PointState &state)
+{
+  const std::vector<int> &point_ids = *point_ids_;
+
+  // Unlink the point from its previous neighborhood
+  for (size_t i = 0; i < state.neighbor_ids.size (); ++i)
+    removeReferrer (state.neighbor_ids[i], id);
+  state.neighbor_ids.clear ();
+  state.neighbor_dists.clear ();
+  state.valid = false;
+  state.sqr_reach = radius_search ? static_cast<float> (search_parameter_ * search_parameter_)
+                                  : std::numeric_limits<float>::max ();
+
+  // An insertion can never give a neighborhood to a point that is not finite, or to a point that found no
+  // k-neighbors, so they do not reach any other point
+  std::vector<int> nn_indices (k_);
+  std::vector<float> nn_dists (k_);
+  if (!isFinite ((*input_)[index]) ||
+      this->searchForNeighbors (index, search_parameter_, nn_indices, nn_dists) == 0)
+  {
+    if (!radius_search || !isFinite ((*input_)[index]))
+      state.sqr_reach = 0.0f;
+    return;
+  }
+
+  // Estimate the SPFH signature around the point
+  Eigen::MatrixXf hist_f1 = Eigen::MatrixXf::Zero (1, nr_bins_f1_);
+  Eigen::MatrixXf hist_f2 = Eigen::MatrixXf::Zero (1, nr_bins_f2_);
+  Eigen::MatrixXf hist_f3 = Eigen::MatrixXf::Zero (1, nr_bins_f3_);
+  computePointSPFHSignature (*surface_, *normals_, index, 0, nn_indices, hist_f1, hist_f2, hist_f3);
+
+  state.spfh.resize (nr_bins_f1_ + nr_bins_f2_ + nr_bins_f3_);
+  std::copy (hist_f1.data (), hist_f1.data () + nr_bins_f1_, state.spfh.begin ());
+  std::copy (hist_f2.data (), hist_f2.data () + nr_bins_f2_, state.spfh.begin () + nr_bins_f1_);
+  std::copy (hist_f3.data (), hist_f3.data () + nr_bins_f3_, state.spfh.begin () + nr_bins_f1_ + nr_bins_f2_);
+
+  // Remember the neighborhood by identifier, and link the point to its new neighbors
+  state.neighbor_ids.resize (nn_indices.size ());
+  state.neighbor_dists = nn_dists;
+  for (size_t i = 0; i < nn_indices.size (); ++i)
+  {
+    state.neighbor_ids[i] = point_ids[nn_indices[i]];
+    cache_[state.neighbor_ids[i]].referrers.push_back (id);
+  }
+
+  // A k-neighborhood only changes if a point is inserted closer than its farthest member
+  if (!radius_search && static_cast<int> (nn_indices.size ()) >= k_)
+    state.sqr_reach = *std::max_element (nn_dists.begin (), nn_dists.end ());
+  state.valid = true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::IncrementalFPFHEstimation<PointInT, PointNT, PointOutT>::updateFPFHSignature (PointState &state)
+{
+  const int nr_bins = nr_bins_f1_ + nr_bins_f2_ + nr_bins_f3_;
+  state.fpfh.assign (nr_bins, std::numeric_limits<float>::quiet_NaN ());
+  if (!state.valid)
+    return;
+
+  // Gather the SPFH signatures of the neighborhood into rows 0..n-1
+  const size_t nr_neighbors = state.neighbor_ids.size ();
+  Eigen::MatrixXf hist_f1 (nr_neighbors, nr_bins_f1_);
+  Eigen::MatrixXf hist_f2 (nr_neighbors, nr_bins_f2_);
+  Eigen::MatrixXf hist_f3 (nr_neighbors, nr_bins_f3_);
+  std::vector<int> rows (nr_neighbors);
+  for (size_t i = 0; i < nr_neighbors; ++i)
+  {
+    const PointState &neighbor = cache_[state.neighbor_ids[i]];
+    for (int d = 0; d < nr_bins_f1_; ++d)
+      hist_f1 (i, d) = neighbor.valid ? neighbor.spfh[d] : 0.0f;
+    for (int d = 0; d < nr_bins_f2_; ++d)
+      hist_f2 (i, d) = neighbor.valid ? neighbor.spfh[nr_bins_f1_ + d] : 0.0f;
+    for (int d = 0; d < nr_bins_f3_; ++d)
+      hist_f3 (i, d) = neighbor.valid ? neighbor.spfh[nr_bins_f1_ + nr_bins_f2_ + d] : 0.0f;
+    rows[i] = static_cast<int> (i);
+  }
+
+  weightPointSPFHSignature (hist_f1, hist_f2, hist_f3, rows, state.neighbor_dists, fpfh_histogram_);
+  std::copy (fpfh_histogram_.data (), fpfh_histogram_.data () + nr_bins, state.fpfh.begin ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::IncrementalFPFHEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  nr_spfh_updates_ = nr_fpfh_updates_ = 0;
+
+  if (!point_ids_ || point_ids_->size () != input_->points.size () ||
+      surface_ != input_ || indices_->size () != input_->points.size ())
+  {
+    if (point_ids_)
+      PCL_WARN ("[pcl::%s::computeFeature] Incremental estimation needs one identifier per input point and no indices or search surface. Recomputing all signatures.\n",
+                getClassName ().c_str ());
+    cache_.clear ();
+    FPFHEstimation<PointInT, PointNT, PointOutT>::computeFeature (output);
+    nr_spfh_updates_ = nr_fpfh_updates_ = indices_->size ();
+    return;
+  }
+
+  const bool radius_search = (search_radius_ != 0.0);
+  if (search_parameter_ != cached_search_parameter_ || radius_search != cached_radius_search_ ||
+      nr_bins_f1_ != cached_nr_bins_f1_ || nr_bins_f2_ != cached_nr_bins_f2_ || nr_bins_f3_ != cached_nr_bins_f3_)
+  {
+    cache_.clear ();
+    cached_search_parameter_ = search_parameter_;
+    cached_radius_search_ = radius_search;
+    cached_nr_bins_f1_ = nr_bins_f1_;
+    cached_nr_bins_f2_ = nr_bins_f2_;
+    cached_nr_bins_f3_ = nr_bins_f3_;
+  }
+
+  const std::vector<int> &point_ids = *point_ids_;
+  boost::unordered_map<int, int> id_to_index (point_ids.size ());
+  for (size_t i = 0; i < point_ids.size (); ++i)
+    id_to_index[point_ids[i]] = static_cast<int> (i);
+
+  // Drop the removed points, and mark every point that had one of them in its neighborhood
+  boost::unordered_set<int> spfh_dirty;
+  std::vector<int> removed;
+  float max_sqr_reach = 0.0f;
+  for (typename PointStateMap::const_iterator it = cache_.begin (); it != cache_.end (); ++it)
+  {
+    if (id_to_index.find (it->first) == id_to_index.end ())
+      removed.push_back (it->first);
+    else
+      max_sqr_reach = (std::max) (max_sqr_reach, it->second.sqr_reach);
+  }
+  for (size_t i = 0; i < removed.size (); ++i)
+  {
+    typename PointStateMap::iterator it = cache_.find (removed[i]);
+    spfh_dirty.insert (it->second.referrers.begin (), it->second.referrers.end ());
+    for (size_t n = 0; n < it->second.neighbor_ids.size (); ++n)
+      removeReferrer (it->second.neighbor_ids[n], removed[i]);
+    cache_.erase (it);
+  }
+  for (size_t i = 0; i < removed.size (); ++i)
+    spfh_dirty.erase (removed[i]);
+
+  // Mark the inserted points, and every cached point that has an inserted point within its reach
+  std::vector<int> inserted;
+  for (size_t i = 0; i < point_ids.size (); ++i)
+    if (cache_.find (point_ids[i]) == cache_.end ())
+      inserted.push_back (static_cast<int> (i));
+
+  const bool mark_all = !cache_.empty () && !inserted.empty () &&
+                        max_sqr_reach == std::numeric_limits<float>::max ();
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dists;
+  for (size_t i = 0; i < inserted.size (); ++i)
+  {
+    const int index = inserted[i];
+    spfh_dirty.insert (point_ids[index]);
+    if (mark_all || cache_.empty () || !isFinite ((*input_)[index]))
+      continue;
+
+    tree_->radiusSearch (index, sqrt (max_sqr_reach), nn_indices, nn_dists);
+    for (size_t n = 0; n < nn_indices.size (); ++n)
+    {
+      typename PointStateMap::const_iterator it = cache_.find (point_ids[nn_indices[n]]);
+      if (it != cache_.end () && nn_dists[n] <= it->second.sqr_reach)
+        spfh_dirty.insert (it->first);
+    }
+  }
+  if (mark_all)
+    spfh_dirty.insert (point_ids.begin (), point_ids.end ());
+
+  // Make sure every point has a cache entry before neighborhoods link to each other
+  for (size_t i = 0; i < inserted.size (); ++i)
+    cache_[point_ids[inserted[i]]];
+
+  // Recompute the invalidated SPFH signatures
+  for (boost::unordered_set<int>::const_iterator it = spfh_dirty.begin (); it != spfh_dirty.end (); ++it)
+    updateSPFHSignature (*it, id_to_index[*it], radius_search, cache_[*it]);
+  nr_spfh_updates_ = spfh_dirty.size ();
+
+  // Reweight the FPFH signatures of those points and of every point that has one of them in its neighborhood
+  boost::unordered_set<int> fpfh_dirty (spfh_dirty.begin (), spfh_dirty.end ());
+  for (boost::unordered_set<int>::const_iterator it = spfh_dirty.begin (); it != spfh_dirty.end (); ++it)
+  {
+    const std::vector<int> &referrers = cache_[*it].referrers;
+    fpfh_dirty.insert (referrers.begin (), referrers.end ());
+  }
+  for (boost::unordered_set<int>::const_iterator it = fpfh_dirty.begin (); it != fpfh_dirty.end (); ++it)
+    updateFPFHSignature (cache_[*it]);
+  nr_fpfh_updates_ = fpfh_dirty.size ();
+
+  // Copy the signatures into the output cloud
+  output.is_dense = true;
+  for (size_t idx = 0; idx < point_ids.size (); ++idx)
+  {
+    const PointState &state = cache_[point_ids[idx]];
+    if (!state.valid)
+      output.is_dense = false;
+    for (int d = 0; d < static_cast<int> (state.fpfh.size ()); ++d)
+      output.points[idx].histogram[d] = state.fpfh[d];
+  }
+}
+
+#define PCL_INSTANTIATE_IncrementalFPFHEstimation(T,NT,OutT) template class PCL_EXPORTS pcl::IncrementalFPFHEstimation<T,NT,OutT>;
+
+#endif    // PCL_FEATURES_IMPL_FPFH_INCREMENTAL_H_
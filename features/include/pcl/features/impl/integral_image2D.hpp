@@ -41,17 +41,19 @@
 #define PCL_INTEGRAL_IMAGE2D_IMPL_H_
 
 #include <cstddef>
+#include <cstring>
+#include <algorithm>
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType, unsigned Dimension> void
-pcl::IntegralImage2D<DataType, Dimension>::setSecondOrderComputation (bool compute_second_order_integral_images)
+template <typename DataType, unsigned Dimension, typename IntegralType> void
+pcl::IntegralImage2D<DataType, Dimension, IntegralType>::setSecondOrderComputation (bool compute_second_order_integral_images)
 {
   compute_second_order_integral_images_ = compute_second_order_integral_images;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType, unsigned Dimension> void
-pcl::IntegralImage2D<DataType, Dimension>::setInput (const DataType * data, unsigned width,unsigned height, unsigned element_stride, unsigned row_stride)
+template <typename DataType, unsigned Dimension, typename IntegralType> void
+pcl::IntegralImage2D<DataType, Dimension, IntegralType>::setInput (const DataType * data, unsigned width,unsigned height, unsigned element_stride, unsigned row_stride)
 {
   if ((width + 1) * (height + 1) > first_order_integral_image_.size () )
   {
@@ -66,8 +68,8 @@ pcl::IntegralImage2D<DataType, Dimension>::setInput (const DataType * data, unsi
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType, unsigned Dimension> typename pcl::IntegralImage2D<DataType, Dimension>::ElementType
-pcl::IntegralImage2D<DataType, Dimension>::getFirstOrderSum (
+template <typename DataType, unsigned Dimension, typename IntegralType> typename pcl::IntegralImage2D<DataType, Dimension, IntegralType>::ElementType
+pcl::IntegralImage2D<DataType, Dimension, IntegralType>::getFirstOrderSum (
     unsigned start_x, unsigned start_y, unsigned width, unsigned height) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -80,8 +82,8 @@ pcl::IntegralImage2D<DataType, Dimension>::getFirstOrderSum (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType, unsigned Dimension> typename pcl::IntegralImage2D<DataType, Dimension>::SecondOrderType
-pcl::IntegralImage2D<DataType, Dimension>::getSecondOrderSum (
+template <typename DataType, unsigned Dimension, typename IntegralType> typename pcl::IntegralImage2D<DataType, Dimension, IntegralType>::SecondOrderType
+pcl::IntegralImage2D<DataType, Dimension, IntegralType>::getSecondOrderSum (
     unsigned start_x, unsigned start_y, unsigned width, unsigned height) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -94,8 +96,8 @@ pcl::IntegralImage2D<DataType, Dimension>::getSecondOrderSum (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType, unsigned Dimension> unsigned
-pcl::IntegralImage2D<DataType, Dimension>::getFiniteElementsCount (
+template <typename DataType, unsigned Dimension, typename IntegralType> unsigned
+pcl::IntegralImage2D<DataType, Dimension, IntegralType>::getFiniteElementsCount (
     unsigned start_x, unsigned start_y, unsigned width, unsigned height) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -108,8 +110,8 @@ pcl::IntegralImage2D<DataType, Dimension>::getFiniteElementsCount (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType, unsigned Dimension> typename pcl::IntegralImage2D<DataType, Dimension>::ElementType
-pcl::IntegralImage2D<DataType, Dimension>::getFirstOrderSumSE (
+template <typename DataType, unsigned Dimension, typename IntegralType> typename pcl::IntegralImage2D<DataType, Dimension, IntegralType>::ElementType
+pcl::IntegralImage2D<DataType, Dimension, IntegralType>::getFirstOrderSumSE (
     unsigned start_x, unsigned start_y, unsigned end_x, unsigned end_y) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -122,8 +124,8 @@ pcl::IntegralImage2D<DataType, Dimension>::getFirstOrderSumSE (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType, unsigned Dimension> typename pcl::IntegralImage2D<DataType, Dimension>::SecondOrderType
-pcl::IntegralImage2D<DataType, Dimension>::getSecondOrderSumSE (
+template <typename DataType, unsigned Dimension, typename IntegralType> typename pcl::IntegralImage2D<DataType, Dimension, IntegralType>::SecondOrderType
+pcl::IntegralImage2D<DataType, Dimension, IntegralType>::getSecondOrderSumSE (
     unsigned start_x, unsigned start_y, unsigned end_x, unsigned end_y) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -136,8 +138,8 @@ pcl::IntegralImage2D<DataType, Dimension>::getSecondOrderSumSE (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType, unsigned Dimension> unsigned
-pcl::IntegralImage2D<DataType, Dimension>::getFiniteElementsCountSE (
+template <typename DataType, unsigned Dimension, typename IntegralType> unsigned
+pcl::IntegralImage2D<DataType, Dimension, IntegralType>::getFiniteElementsCountSE (
     unsigned start_x, unsigned start_y, unsigned end_x, unsigned end_y) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -150,78 +152,94 @@ pcl::IntegralImage2D<DataType, Dimension>::getFiniteElementsCountSE (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType, unsigned Dimension> void
-pcl::IntegralImage2D<DataType, Dimension>::computeIntegralImages (
+template <typename DataType, unsigned Dimension, typename IntegralType> void
+pcl::IntegralImage2D<DataType, Dimension, IntegralType>::computeIntegralImages (
     const DataType *data, unsigned row_stride, unsigned element_stride)
 {
-  ElementType* previous_row = &first_order_integral_image_[0];
-  ElementType* current_row  = previous_row + (width_ + 1);
-  memset (previous_row, 0, sizeof (ElementType) * (width_ + 1));
-
-  unsigned* count_previous_row = &finite_values_integral_image_[0];
-  unsigned* count_current_row  = count_previous_row + (width_ + 1);
-  memset (count_previous_row, 0, sizeof (unsigned) * (width_ + 1));
-
-  if (!compute_second_order_integral_images_)
+  const unsigned stride = width_ + 1;
+  const int height = static_cast<int> (height_);
+  const bool second_order = compute_second_order_integral_images_;
+
+  memset (&first_order_integral_image_[0], 0, sizeof (ElementType) * stride);
+  memset (&finite_values_integral_image_[0], 0, sizeof (unsigned) * stride);
+  if (second_order)
+    memset (&second_order_integral_image_[0], 0, sizeof (SecondOrderType) * stride);
+
+  // first pass: running sums along each row. Rows are independent of each other.
+#pragma omp parallel for schedule (static) num_threads(threads_)
+  for (int row_idx = 0; row_idx < height; ++row_idx)
   {
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1))
+    const DataType* row_data = data + row_idx * row_stride;
+    ElementType* row = &first_order_integral_image_[(row_idx + 1) * stride];
+    unsigned* count_row = &finite_values_integral_image_[(row_idx + 1) * stride];
+
+    row [0].setZero ();
+    count_row [0] = 0;
+    if (!second_order)
     {
-      current_row [0].setZero ();
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      for (unsigned col_idx = 0, val_idx = 0; col_idx < width_; ++col_idx, val_idx += element_stride)
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        const InputType* element = reinterpret_cast <const InputType*> (&data [valIdx]);
+        row [col_idx + 1] = row [col_idx];
+        count_row [col_idx + 1] = count_row [col_idx];
+        const InputType* element = reinterpret_cast <const InputType*> (&row_data [val_idx]);
         if (pcl_isfinite (element->sum ()))
         {
-          current_row [colIdx + 1] += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
-          ++(count_current_row [colIdx + 1]);
+          row [col_idx + 1] += element->template cast<IntegralType> ();
+          ++(count_row [col_idx + 1]);
         }
       }
     }
-  }
-  else
-  {
-    SecondOrderType* so_previous_row = &second_order_integral_image_[0];
-    SecondOrderType* so_current_row  = so_previous_row + (width_ + 1);
-    memset (so_previous_row, 0, sizeof (SecondOrderType) * (width_ + 1));
-
-    SecondOrderType so_element;
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1),
-                                                so_previous_row = so_current_row, so_current_row += (width_ + 1))
+    else
     {
-      current_row [0].setZero ();
-      so_current_row [0].setZero ();
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      SecondOrderType* so_row = &second_order_integral_image_[(row_idx + 1) * stride];
+      so_row [0].setZero ();
+      for (unsigned col_idx = 0, val_idx = 0; col_idx < width_; ++col_idx, val_idx += element_stride)
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        so_current_row [colIdx + 1] = so_previous_row [colIdx + 1] + so_current_row [colIdx] - so_previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-
-        const InputType* element = reinterpret_cast <const InputType*> (&data [valIdx]);
+        row [col_idx + 1] = row [col_idx];
+        so_row [col_idx + 1] = so_row [col_idx];
+        count_row [col_idx + 1] = count_row [col_idx];
+        const InputType* element = reinterpret_cast <const InputType*> (&row_data [val_idx]);
         if (pcl_isfinite (element->sum ()))
         {
-          current_row [colIdx + 1] += element->template cast<typename IntegralImageTypeTraits<DataType>::IntegralType>();
-          ++(count_current_row [colIdx + 1]);
+          row [col_idx + 1] += element->template cast<IntegralType> ();
+          ++(count_row [col_idx + 1]);
           for (unsigned myIdx = 0, elIdx = 0; myIdx < Dimension; ++myIdx)
             for (unsigned mxIdx = myIdx; mxIdx < Dimension; ++mxIdx, ++elIdx)
-              so_current_row [colIdx + 1][elIdx] += (*element)[myIdx] * (*element)[mxIdx];
+              so_row [col_idx + 1][elIdx] += (*element)[myIdx] * (*element)[mxIdx];
         }
       }
     }
   }
+
+  // second pass: running sums down each column, in blocks of columns so that every
+  // thread walks contiguous memory within a row
+  const int block_size = 64;
+  const int nr_blocks = static_cast<int> (stride + block_size - 1) / block_size;
+#pragma omp parallel for schedule (static) num_threads(threads_)
+  for (int block_idx = 0; block_idx < nr_blocks; ++block_idx)
+  {
+    const unsigned col_begin = block_idx * block_size;
+    const unsigned col_end = std::min (col_begin + block_size, stride);
+    for (unsigned row_idx = 2; row_idx <= height_; ++row_idx)
+    {
+      const unsigned current = row_idx * stride;
+      const unsigned previous = current - stride;
+      for (unsigned col_idx = col_begin; col_idx < col_end; ++col_idx)
+      {
+        first_order_integral_image_[current + col_idx] += first_order_integral_image_[previous + col_idx];
+        finite_values_integral_image_[current + col_idx] += finite_values_integral_image_[previous + col_idx];
+      }
+      if (second_order)
+        for (unsigned col_idx = col_begin; col_idx < col_end; ++col_idx)
+          second_order_integral_image_[current + col_idx] += second_order_integral_image_[previous + col_idx];
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template <typename DataType> void
-pcl::IntegralImage2D<DataType, 1>::setInput (const DataType * data, unsigned width,unsigned height, unsigned element_stride, unsigned row_stride)
+template <typename DataType, typename IntegralType> void
+pcl::IntegralImage2D<DataType, 1, IntegralType>::setInput (const DataType * data, unsigned width,unsigned height, unsigned element_stride, unsigned row_stride)
 {
   if ((width + 1) * (height + 1) > first_order_integral_image_.size () )
   {
@@ -236,8 +254,8 @@ pcl::IntegralImage2D<DataType, 1>::setInput (const DataType * data, unsigned wid
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType> typename pcl::IntegralImage2D<DataType, 1>::ElementType
-pcl::IntegralImage2D<DataType, 1>::getFirstOrderSum (
+template <typename DataType, typename IntegralType> typename pcl::IntegralImage2D<DataType, 1, IntegralType>::ElementType
+pcl::IntegralImage2D<DataType, 1, IntegralType>::getFirstOrderSum (
     unsigned start_x, unsigned start_y, unsigned width, unsigned height) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -250,8 +268,8 @@ pcl::IntegralImage2D<DataType, 1>::getFirstOrderSum (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType> typename pcl::IntegralImage2D<DataType, 1>::SecondOrderType
-pcl::IntegralImage2D<DataType, 1>::getSecondOrderSum (
+template <typename DataType, typename IntegralType> typename pcl::IntegralImage2D<DataType, 1, IntegralType>::SecondOrderType
+pcl::IntegralImage2D<DataType, 1, IntegralType>::getSecondOrderSum (
     unsigned start_x, unsigned start_y, unsigned width, unsigned height) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -264,8 +282,8 @@ pcl::IntegralImage2D<DataType, 1>::getSecondOrderSum (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType> unsigned
-pcl::IntegralImage2D<DataType, 1>::getFiniteElementsCount (
+template <typename DataType, typename IntegralType> unsigned
+pcl::IntegralImage2D<DataType, 1, IntegralType>::getFiniteElementsCount (
     unsigned start_x, unsigned start_y, unsigned width, unsigned height) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -278,8 +296,8 @@ pcl::IntegralImage2D<DataType, 1>::getFiniteElementsCount (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType> typename pcl::IntegralImage2D<DataType, 1>::ElementType
-pcl::IntegralImage2D<DataType, 1>::getFirstOrderSumSE (
+template <typename DataType, typename IntegralType> typename pcl::IntegralImage2D<DataType, 1, IntegralType>::ElementType
+pcl::IntegralImage2D<DataType, 1, IntegralType>::getFirstOrderSumSE (
     unsigned start_x, unsigned start_y, unsigned end_x, unsigned end_y) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -292,8 +310,8 @@ pcl::IntegralImage2D<DataType, 1>::getFirstOrderSumSE (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType> typename pcl::IntegralImage2D<DataType, 1>::SecondOrderType
-pcl::IntegralImage2D<DataType, 1>::getSecondOrderSumSE (
+template <typename DataType, typename IntegralType> typename pcl::IntegralImage2D<DataType, 1, IntegralType>::SecondOrderType
+pcl::IntegralImage2D<DataType, 1, IntegralType>::getSecondOrderSumSE (
     unsigned start_x, unsigned start_y, unsigned end_x, unsigned end_y) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -306,8 +324,8 @@ pcl::IntegralImage2D<DataType, 1>::getSecondOrderSumSE (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType> unsigned
-pcl::IntegralImage2D<DataType, 1>::getFiniteElementsCountSE (
+template <typename DataType, typename IntegralType> unsigned
+pcl::IntegralImage2D<DataType, 1, IntegralType>::getFiniteElementsCountSE (
     unsigned start_x, unsigned start_y, unsigned end_x, unsigned end_y) const
 {
   const unsigned upper_left_idx      = start_y * (width_ + 1) + start_x;
@@ -320,66 +338,84 @@ pcl::IntegralImage2D<DataType, 1>::getFiniteElementsCountSE (
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename DataType> void
-pcl::IntegralImage2D<DataType, 1>::computeIntegralImages (
+template <typename DataType, typename IntegralType> void
+pcl::IntegralImage2D<DataType, 1, IntegralType>::computeIntegralImages (
     const DataType *data, unsigned row_stride, unsigned element_stride)
 {
-  ElementType* previous_row = &first_order_integral_image_[0];
-  ElementType* current_row  = previous_row + (width_ + 1);
-  memset (previous_row, 0, sizeof (ElementType) * (width_ + 1));
-
-  unsigned* count_previous_row = &finite_values_integral_image_[0];
-  unsigned* count_current_row  = count_previous_row + (width_ + 1);
-  memset (count_previous_row, 0, sizeof (unsigned) * (width_ + 1));
-
-  if (!compute_second_order_integral_images_)
+  const unsigned stride = width_ + 1;
+  const int height = static_cast<int> (height_);
+  const bool second_order = compute_second_order_integral_images_;
+
+  memset (&first_order_integral_image_[0], 0, sizeof (ElementType) * stride);
+  memset (&finite_values_integral_image_[0], 0, sizeof (unsigned) * stride);
+  if (second_order)
+    memset (&second_order_integral_image_[0], 0, sizeof (SecondOrderType) * stride);
+
+  // first pass: running sums along each row. Rows are independent of each other.
+#pragma omp parallel for schedule (static) num_threads(threads_)
+  for (int row_idx = 0; row_idx < height; ++row_idx)
   {
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1))
+    const DataType* row_data = data + row_idx * row_stride;
+    ElementType* row = &first_order_integral_image_[(row_idx + 1) * stride];
+    unsigned* count_row = &finite_values_integral_image_[(row_idx + 1) * stride];
+
+    row [0] = 0;
+    count_row [0] = 0;
+    if (!second_order)
     {
-      current_row [0] = 0.0;
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      for (unsigned col_idx = 0, val_idx = 0; col_idx < width_; ++col_idx, val_idx += element_stride)
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        if (pcl_isfinite (data [valIdx]))
+        row [col_idx + 1] = row [col_idx];
+        count_row [col_idx + 1] = count_row [col_idx];
+        if (pcl_isfinite (row_data [val_idx]))
         {
-          current_row [colIdx + 1] += data [valIdx];
-          ++(count_current_row [colIdx + 1]);
+          row [col_idx + 1] += row_data [val_idx];
+          ++(count_row [col_idx + 1]);
         }
       }
     }
-  }
-  else
-  {
-    SecondOrderType* so_previous_row = &second_order_integral_image_[0];
-    SecondOrderType* so_current_row  = so_previous_row + (width_ + 1);
-    memset (so_previous_row, 0, sizeof (SecondOrderType) * (width_ + 1));
-
-    for (unsigned rowIdx = 0; rowIdx < height_; ++rowIdx, data += row_stride,
-                                                previous_row = current_row, current_row += (width_ + 1),
-                                                count_previous_row = count_current_row, count_current_row += (width_ + 1),
-                                                so_previous_row = so_current_row, so_current_row += (width_ + 1))
+    else
     {
-      current_row [0] = 0.0;
-      so_current_row [0] = 0.0;
-      count_current_row [0] = 0;
-      for (unsigned colIdx = 0, valIdx = 0; colIdx < width_; ++colIdx, valIdx += element_stride)
+      SecondOrderType* so_row = &second_order_integral_image_[(row_idx + 1) * stride];
+      so_row [0] = 0;
+      for (unsigned col_idx = 0, val_idx = 0; col_idx < width_; ++col_idx, val_idx += element_stride)
       {
-        current_row [colIdx + 1] = previous_row [colIdx + 1] + current_row [colIdx] - previous_row [colIdx];
-        so_current_row [colIdx + 1] = so_previous_row [colIdx + 1] + so_current_row [colIdx] - so_previous_row [colIdx];
-        count_current_row [colIdx + 1] = count_previous_row [colIdx + 1] + count_current_row [colIdx] - count_previous_row [colIdx];
-        if (pcl_isfinite (data[valIdx]))
+        row [col_idx + 1] = row [col_idx];
+        so_row [col_idx + 1] = so_row [col_idx];
+        count_row [col_idx + 1] = count_row [col_idx];
+        if (pcl_isfinite (row_data [val_idx]))
         {
-          current_row [colIdx + 1] += data[valIdx];
-          so_current_row [colIdx + 1] += data[valIdx] * data[valIdx];
-          ++(count_current_row [colIdx + 1]);
+          row [col_idx + 1] += row_data [val_idx];
+          so_row [col_idx + 1] += row_data [val_idx] * row_data [val_idx];
+          ++(count_row [col_idx + 1]);
         }
       }
     }
   }
+
+  // second pass: running sums down each column, in blocks of columns so that every
+  // thread walks contiguous memory within a row
+  const int block_size = 64;
+  const int nr_blocks = static_cast<int> (stride + block_size - 1) / block_size;
+#pragma omp parallel for schedule (static) num_threads(threads_)
+  for (int block_idx = 0; block_idx < nr_blocks; ++block_idx)
+  {
+    const unsigned col_begin = block_idx * block_size;
+    const unsigned col_end = std::min (col_begin + block_size, stride);
+    for (unsigned row_idx = 2; row_idx <= height_; ++row_idx)
+    {
+      const unsigned current = row_idx * stride;
+      const unsigned previous = current - stride;
+      for (unsigned col_idx = col_begin; col_idx < col_end; ++col_idx)
+      {
+        first_order_integral_image_[current + col_idx] += first_order_integral_image_[previous + col_idx];
+        finite_values_integral_image_[current + col_idx] += finite_values_integral_image_[previous + col_idx];
+      }
+      if (second_order)
+        for (unsigned col_idx = col_begin; col_idx < col_end; ++col_idx)
+          second_order_integral_image_[current + col_idx] += second_order_integral_image_[previous + col_idx];
+    }
+  }
 }
 #endif    // PCL_INTEGRAL_IMAGE2D_IMPL_H_
 
@@ -53,6 +53,18 @@ pcl::NormalEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &outpu
   std::vector<float> nn_dists (k_);
 
   output.is_dense = true;
+
+  if (batch_size_ > 0)
+  {
+    for (int begin = 0; begin < static_cast<int> (indices_->size ()); begin += batch_size_)
+    {
+      int end = std::min (begin + static_cast<int> (batch_size_), static_cast<int> (indices_->size ()));
+      if (!computeFeatureBatch (begin, end, output))
+        output.is_dense = false;
+    }
+    return;
+  }
+
   // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
   if (input_->is_dense)
   {
@@ -99,6 +111,63 @@ pcl::NormalEstimation<PointInT, PointOutT>::computeFeature (PointCloudOut &outpu
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> bool
+pcl::NormalEstimation<PointInT, PointOutT>::computeFeatureBatch (int begin, int end, PointCloudOut &output) const
+{
+  std::vector<int> nn_indices (k_);
+  std::vector<float> nn_dists (k_);
+
+  // Gather all neighborhoods of the batch into one compressed index list
+  std::vector<int> batch_indices;
+  std::vector<int> offsets (1, 0);
+  batch_indices.reserve ((end - begin) * std::max (k_, 1));
+  offsets.reserve (end - begin + 1);
+  for (int idx = begin; idx < end; ++idx)
+  {
+    // Neighborhoods that can not be solved stay empty and produce NaN values
+    if ((input_->is_dense || isFinite ((*input_)[(*indices_)[idx]])) &&
+        this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) >= 3)
+      batch_indices.insert (batch_indices.end (), nn_indices.begin (), nn_indices.end ());
+    offsets.push_back (static_cast<int> (batch_indices.size ()));
+  }
+
+  std::vector<Eigen::Matrix3f> covariance_matrices;
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > centroids;
+  std::vector<unsigned int> point_counts;
+  computeMeanAndCovarianceMatrixBatch (*surface_, batch_indices, offsets, covariance_matrices, centroids, point_counts);
+
+  std::vector<Eigen::Vector3f> eigen_values, eigen_vectors;
+  eigen33Batch (covariance_matrices, eigen_values, eigen_vectors, 0);
+
+  bool dense = true;
+  for (int idx = begin; idx < end; ++idx)
+  {
+    const int b = idx - begin;
+    if (point_counts[b] == 0)
+    {
+      output.points[idx].normal[0] = output.points[idx].normal[1] = output.points[idx].normal[2] = output.points[idx].curvature = std::numeric_limits<float>::quiet_NaN ();
+      dense = false;
+      continue;
+    }
+
+    output.points[idx].normal[0] = eigen_vectors[b][0];
+    output.points[idx].normal[1] = eigen_vectors[b][1];
+    output.points[idx].normal[2] = eigen_vectors[b][2];
+
+    // Compute the curvature surface change
+    float eig_sum = covariance_matrices[b].trace ();
+    if (eig_sum != 0)
+      output.points[idx].curvature = fabsf (eigen_values[b][0] / eig_sum);
+    else
+      output.points[idx].curvature = 0;
+
+    flipNormalTowardsViewpoint (input_->points[(*indices_)[idx]], vpx_, vpy_, vpz_,
+                                output.points[idx].normal[0], output.points[idx].normal[1], output.points[idx].normal[2]);
+  }
+  return (dense);
+}
+
 #define PCL_INSTANTIATE_NormalEstimation(T,NT) template class PCL_EXPORTS pcl::NormalEstimation<T,NT>;
 
 #endif    // PCL_FEATURES_IMPL_NORMAL_3D_H_ 
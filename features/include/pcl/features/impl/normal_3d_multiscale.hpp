@@ -0,0 +1,193 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#ifndef PCL_FEATURES_IMPL_NORMAL_3D_MULTISCALE_H_
+#define PCL_FEATURES_IMPL_NORMAL_3D_MULTISCALE_H_
+
+#include <pcl/features/normal_3d_multiscale.h>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::MultiscaleNormalEstimation<PointInT, PointOutT>::compute (std::vector<PointCloudOutPtr> &outputs)
+{
+  outputs.resize (scales_.size ());
+  for (size_t s = 0; s < outputs.size (); ++s)
+    outputs[s].reset (new PointCloudOut);
+
+  if (scales_.empty ())
+  {
+    PCL_ERROR ("[pcl::%s::compute] No scales given!\n", getClassName ().c_str ());
+    return;
+  }
+
+  // Process the scales by increasing radius
+  std::vector<std::pair<float, size_t> > sorted_scales (scales_.size ());
+  for (size_t s = 0; s < scales_.size (); ++s)
+    sorted_scales[s] = std::make_pair (scales_[s], s);
+  std::sort (sorted_scales.begin (), sorted_scales.end ());
+  std::vector<size_t> order (scales_.size ());
+  for (size_t s = 0; s < scales_.size (); ++s)
+    order[s] = sorted_scales[s].second;
+
+  // Search once at the largest radius
+  const double search_radius = search_radius_;
+  const int k = k_;
+  search_radius_ = sorted_scales.back ().first;
+  k_ = 0;
+  const bool initialized = this->initCompute ();
+  search_radius_ = search_radius;
+  k_ = k;
+  if (!initialized)
+    return;
+
+  for (size_t s = 0; s < outputs.size (); ++s)
+  {
+    PointCloudOut &output = *outputs[s];
+    output.header = input_->header;
+    output.points.resize (indices_->size ());
+    if (indices_->size () != input_->points.size () || input_->width * input_->height == 0)
+    {
+      output.width = static_cast<uint32_t> (indices_->size ());
+      output.height = 1;
+    }
+    else
+    {
+      output.width = input_->width;
+      output.height = input_->height;
+    }
+    output.is_dense = true;
+  }
+
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dists;
+  std::vector<std::pair<float, int> > neighbors;
+  for (size_t idx = 0; idx < indices_->size (); ++idx)
+    computePointNormals (idx, order, nn_indices, nn_dists, neighbors, outputs);
+
+  this->deinitCompute ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::MultiscaleNormalEstimation<PointInT, PointOutT>::computePointNormals (
+    size_t index, const std::vector<size_t> &order,
+    std::vector<int> &nn_indices, std::vector<float> &nn_dists,
+    std::vector<std::pair<float, int> > &neighbors,
+    std::vector<PointCloudOutPtr> &outputs) const
+{
+  const PointInT &query = input_->points[(*indices_)[index]];
+  if ((!input_->is_dense && !isFinite (query)) ||
+      this->searchForNeighbors ((*indices_)[index], search_parameter_, nn_indices, nn_dists) == 0)
+  {
+    for (size_t s = 0; s < outputs.size (); ++s)
+    {
+      PointOutT &output_point = outputs[s]->points[index];
+      output_point.normal[0] = output_point.normal[1] = output_point.normal[2] = output_point.curvature = std::numeric_limits<float>::quiet_NaN ();
+      outputs[s]->is_dense = false;
+    }
+    return;
+  }
+
+  // Sort the neighbors by distance once, every scale then covers a prefix of them
+  neighbors.resize (nn_indices.size ());
+  for (size_t i = 0; i < nn_indices.size (); ++i)
+    neighbors[i] = std::make_pair (nn_dists[i], nn_indices[i]);
+  std::sort (neighbors.begin (), neighbors.end ());
+
+  // Accumulate the moments relative to the query point to limit the cancellation in the covariance
+  const double ox = query.x, oy = query.y, oz = query.z;
+  Eigen::Matrix<double, 1, 9, Eigen::RowMajor> accu = Eigen::Matrix<double, 1, 9, Eigen::RowMajor>::Zero ();
+  unsigned int point_count = 0;
+  size_t next = 0;
+  for (size_t s = 0; s < order.size (); ++s)
+  {
+    const size_t scale = order[s];
+    const float sqr_radius = scales_[scale] * scales_[scale];
+    for (; next < neighbors.size () && neighbors[next].first <= sqr_radius; ++next)
+    {
+      const PointInT &point = surface_->points[neighbors[next].second];
+      if (!surface_->is_dense && !isFinite (point))
+        continue;
+
+      const double x = point.x - ox, y = point.y - oy, z = point.z - oz;
+      accu [0] += x * x;
+      accu [1] += x * y;
+      accu [2] += x * z;
+      accu [3] += y * y;
+      accu [4] += y * z;
+      accu [5] += z * z;
+      accu [6] += x;
+      accu [7] += y;
+      accu [8] += z;
+      ++point_count;
+    }
+
+    PointOutT &output_point = outputs[scale]->points[index];
+    if (point_count < 3)
+    {
+      output_point.normal[0] = output_point.normal[1] = output_point.normal[2] = output_point.curvature = std::numeric_limits<float>::quiet_NaN ();
+      outputs[scale]->is_dense = false;
+      continue;
+    }
+
+    const Eigen::Matrix<double, 1, 9, Eigen::RowMajor> moments = accu / static_cast<double> (point_count);
+    EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
+    covariance_matrix.coeffRef (0) = static_cast<float> (moments [0] - moments [6] * moments [6]);
+    covariance_matrix.coeffRef (1) = static_cast<float> (moments [1] - moments [6] * moments [7]);
+    covariance_matrix.coeffRef (2) = static_cast<float> (moments [2] - moments [6] * moments [8]);
+    covariance_matrix.coeffRef (4) = static_cast<float> (moments [3] - moments [7] * moments [7]);
+    covariance_matrix.coeffRef (5) = static_cast<float> (moments [4] - moments [7] * moments [8]);
+    covariance_matrix.coeffRef (8) = static_cast<float> (moments [5] - moments [8] * moments [8]);
+    covariance_matrix.coeffRef (3) = covariance_matrix.coeff (1);
+    covariance_matrix.coeffRef (6) = covariance_matrix.coeff (2);
+    covariance_matrix.coeffRef (7) = covariance_matrix.coeff (5);
+
+    solvePlaneParameters (covariance_matrix,
+                          output_point.normal[0], output_point.normal[1], output_point.normal[2], output_point.curvature);
+    flipNormalTowardsViewpoint (query, vpx_, vpy_, vpz_,
+                                output_point.normal[0], output_point.normal[1], output_point.normal[2]);
+  }
+}
+
+#define PCL_INSTANTIATE_MultiscaleNormalEstimation(T,NT) template class PCL_EXPORTS pcl::MultiscaleNormalEstimation<T,NT>;
+
+#endif    // PCL_FEATURES_IMPL_NORMAL_3D_MULTISCALE_H_
@@ -54,6 +54,24 @@ pcl::NormalEstimationOMP<PointInT, PointOutT>::computeFeature (PointCloudOut &ou
 
   output.is_dense = true;
 
+  if (batch_size_ > 0)
+  {
+    const int nr_batches = (static_cast<int> (indices_->size ()) + batch_size_ - 1) / batch_size_;
+    bool dense = true;
+#ifdef _OPENMP
+#pragma omp parallel for shared (output) reduction (&& : dense) schedule (dynamic, 1) num_threads(threads_)
+#endif
+    for (int batch = 0; batch < nr_batches; ++batch)
+    {
+      int begin = batch * static_cast<int> (batch_size_);
+      int end = std::min (begin + static_cast<int> (batch_size_), static_cast<int> (indices_->size ()));
+      if (!this->computeFeatureBatch (begin, end, output))
+        dense = false;
+    }
+    output.is_dense = dense;
+    return;
+  }
+
   // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
   if (input_->is_dense)
   {
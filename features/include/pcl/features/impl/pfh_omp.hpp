@@ -0,0 +1,165 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2011, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_FEATURES_IMPL_PFH_OMP_H_
+#define PCL_FEATURES_IMPL_PFH_OMP_H_
+
+#include <pcl/features/pfh_omp.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::computeSharedPFHSignature (
+      const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
+      const std::vector<int> &indices, int nr_split, PFHPairFeatureCache &cache, Eigen::VectorXf &pfh_histogram)
+{
+  Eigen::Vector4f pfh_tuple;
+  int f_index[3];
+
+  // Clear the resultant point histogram
+  pfh_histogram.setZero ();
+
+  // Factorization constant
+  float hist_incr = 100.0f / static_cast<float> (indices.size () * (indices.size () - 1) / 2);
+
+  // Iterate over all the points in the neighborhood
+  for (size_t i_idx = 0; i_idx < indices.size (); ++i_idx)
+  {
+    for (size_t j_idx = 0; j_idx < i_idx; ++j_idx)
+    {
+      // If the 3D points are invalid, don't bother estimating, just continue
+      if (!isFinite (cloud.points[indices[i_idx]]) || !isFinite (cloud.points[indices[j_idx]]))
+        continue;
+
+      // Check to see if any thread already estimated this pair
+      if (!use_cache_ || !cache.find (indices[i_idx], indices[j_idx], pfh_tuple))
+      {
+        // Compute the pair NNi to NNj
+        if (!this->computePairFeatures (cloud, normals, indices[i_idx], indices[j_idx],
+                                        pfh_tuple[0], pfh_tuple[1], pfh_tuple[2], pfh_tuple[3]))
+          continue;
+
+        if (use_cache_)
+          cache.insert (indices[i_idx], indices[j_idx], pfh_tuple);
+      }
+
+      // Normalize the f1, f2, f3 features and push them in the histogram
+      f_index[0] = static_cast<int> (floor (nr_split * ((pfh_tuple[0] + M_PI) * d_pi_)));
+      if (f_index[0] < 0)         f_index[0] = 0;
+      if (f_index[0] >= nr_split) f_index[0] = nr_split - 1;
+
+      f_index[1] = static_cast<int> (floor (nr_split * ((pfh_tuple[1] + 1.0) * 0.5)));
+      if (f_index[1] < 0)         f_index[1] = 0;
+      if (f_index[1] >= nr_split) f_index[1] = nr_split - 1;
+
+      f_index[2] = static_cast<int> (floor (nr_split * ((pfh_tuple[2] + 1.0) * 0.5)));
+      if (f_index[2] < 0)         f_index[2] = 0;
+      if (f_index[2] >= nr_split) f_index[2] = nr_split - 1;
+
+      // Copy into the histogram
+      int h_index = 0;
+      int h_p     = 1;
+      for (int d = 0; d < 3; ++d)
+      {
+        h_index += h_p * f_index[d];
+        h_p     *= nr_split;
+      }
+      pfh_histogram[h_index] += hist_incr;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  const int nr_bins = nr_subdiv_ * nr_subdiv_ * nr_subdiv_;
+
+  // Size the cache after the expected number of neighbor pairs, bounded by the maximum cache size
+  PFHPairFeatureCache cache;
+  if (use_cache_)
+  {
+    size_t nr_neighbors = (k_ > 0) ? static_cast<size_t> (k_) : 64;
+    size_t nr_pairs = std::max<size_t> (indices_->size (), 1) * nr_neighbors * (nr_neighbors - 1) / 2;
+    cache.resize (std::min<size_t> (2 * nr_pairs, max_cache_size_));
+  }
+
+  std::vector<int> nn_indices (k_); // \note These resizes are irrelevant for a radiusSearch ().
+  std::vector<float> nn_dists (k_);
+  Eigen::VectorXf pfh_histogram (nr_bins);
+
+  output.is_dense = true;
+#ifdef _OPENMP
+#pragma omp parallel shared (output, cache) firstprivate (nn_indices, nn_dists, pfh_histogram) num_threads(threads_)
+#endif
+  {
+    // Iterate over the entire index vector
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 64)
+#endif
+    for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+    {
+      if ((!input_->is_dense && !isFinite ((*input_)[(*indices_)[idx]])) ||
+          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
+      {
+        for (int d = 0; d < nr_bins; ++d)
+          output.points[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
+
+        output.is_dense = false;
+        continue;
+      }
+
+      // Estimate the PFH signature at each patch
+      pfh_histogram.resize (nr_bins);
+      computeSharedPFHSignature (*surface_, *normals_, nn_indices, nr_subdiv_, cache, pfh_histogram);
+
+      // Copy into the resultant cloud
+      for (int d = 0; d < nr_bins; ++d)
+        output.points[idx].histogram[d] = pfh_histogram[d];
+    }
+  }
+}
+
+#define PCL_INSTANTIATE_PFHEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::PFHEstimationOMP<T,NT,OutT>;
+
+#endif    // PCL_FEATURES_IMPL_PFH_OMP_H_
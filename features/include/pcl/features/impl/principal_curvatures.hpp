@@ -48,6 +48,16 @@ template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computePointPrincipalCurvatures (
       const pcl::PointCloud<PointNT> &normals, int p_idx, const std::vector<int> &indices,
       float &pcx, float &pcy, float &pcz, float &pc1, float &pc2)
+{
+  computePointPrincipalCurvatures (normals, p_idx, indices, projected_normals_, pcx, pcy, pcz, pc1, pc2);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computePointPrincipalCurvatures (
+      const pcl::PointCloud<PointNT> &normals, int p_idx, const std::vector<int> &indices,
+      std::vector<Eigen::Vector3f> &projected_normals,
+      float &pcx, float &pcy, float &pcz, float &pc1, float &pc2) const
 {
   EIGEN_ALIGN16 Eigen::Matrix3f I = Eigen::Matrix3f::Identity ();
   Eigen::Vector3f n_idx (normals.points[p_idx].normal[0], normals.points[p_idx].normal[1], normals.points[p_idx].normal[2]);
@@ -55,57 +65,59 @@ pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computePointPr
 
   // Project normals into the tangent plane
   Eigen::Vector3f normal;
-  projected_normals_.resize (indices.size ());
-  xyz_centroid_.setZero ();
+  Eigen::Vector3f xyz_centroid (Eigen::Vector3f::Zero ());
+  projected_normals.resize (indices.size ());
   for (size_t idx = 0; idx < indices.size(); ++idx)
   {
     normal[0] = normals.points[indices[idx]].normal[0];
     normal[1] = normals.points[indices[idx]].normal[1];
     normal[2] = normals.points[indices[idx]].normal[2];
 
-    projected_normals_[idx] = M * normal;
-    xyz_centroid_ += projected_normals_[idx];
+    projected_normals[idx] = M * normal;
+    xyz_centroid += projected_normals[idx];
   }
 
   // Estimate the XYZ centroid
-  xyz_centroid_ /= static_cast<float> (indices.size ());
+  xyz_centroid /= static_cast<float> (indices.size ());
 
   // Initialize to 0
-  covariance_matrix_.setZero ();
+  EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix (Eigen::Matrix3f::Zero ());
 
+  Eigen::Vector3f demean;
   double demean_xy, demean_xz, demean_yz;
   // For each point in the cloud
   for (size_t idx = 0; idx < indices.size (); ++idx)
   {
-    demean_ = projected_normals_[idx] - xyz_centroid_;
+    demean = projected_normals[idx] - xyz_centroid;
 
-    demean_xy = demean_[0] * demean_[1];
-    demean_xz = demean_[0] * demean_[2];
-    demean_yz = demean_[1] * demean_[2];
+    demean_xy = demean[0] * demean[1];
+    demean_xz = demean[0] * demean[2];
+    demean_yz = demean[1] * demean[2];
 
-    covariance_matrix_(0, 0) += demean_[0] * demean_[0];
-    covariance_matrix_(0, 1) += static_cast<float> (demean_xy);
-    covariance_matrix_(0, 2) += static_cast<float> (demean_xz);
+    covariance_matrix(0, 0) += demean[0] * demean[0];
+    covariance_matrix(0, 1) += static_cast<float> (demean_xy);
+    covariance_matrix(0, 2) += static_cast<float> (demean_xz);
 
-    covariance_matrix_(1, 0) += static_cast<float> (demean_xy);
-    covariance_matrix_(1, 1) += demean_[1] * demean_[1];
-    covariance_matrix_(1, 2) += static_cast<float> (demean_yz);
+    covariance_matrix(1, 0) += static_cast<float> (demean_xy);
+    covariance_matrix(1, 1) += demean[1] * demean[1];
+    covariance_matrix(1, 2) += static_cast<float> (demean_yz);
 
-    covariance_matrix_(2, 0) += static_cast<float> (demean_xz);
-    covariance_matrix_(2, 1) += static_cast<float> (demean_yz);
-    covariance_matrix_(2, 2) += demean_[2] * demean_[2];
+    covariance_matrix(2, 0) += static_cast<float> (demean_xz);
+    covariance_matrix(2, 1) += static_cast<float> (demean_yz);
+    covariance_matrix(2, 2) += demean[2] * demean[2];
   }
 
   // Extract the eigenvalues and eigenvectors
-  pcl::eigen33 (covariance_matrix_, eigenvalues_);
-  pcl::computeCorrespondingEigenVector (covariance_matrix_, eigenvalues_ [2], eigenvector_);
+  Eigen::Vector3f eigenvalues, eigenvector;
+  pcl::eigen33 (covariance_matrix, eigenvalues);
+  pcl::computeCorrespondingEigenVector (covariance_matrix, eigenvalues [2], eigenvector);
 
-  pcx = eigenvector_ [0];
-  pcy = eigenvector_ [1];
-  pcz = eigenvector_ [2];
+  pcx = eigenvector [0];
+  pcy = eigenvector [1];
+  pcz = eigenvector [2];
   float indices_size = 1.0f / static_cast<float> (indices.size ());
-  pc1 = eigenvalues_ [2] * indices_size;
-  pc2 = eigenvalues_ [1] * indices_size;
+  pc1 = eigenvalues [2] * indices_size;
+  pc2 = eigenvalues [1] * indices_size;
 }
 
 
@@ -119,6 +131,18 @@ pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computeFeature
   std::vector<float> nn_dists (k_);
 
   output.is_dense = true;
+
+  if (batch_size_ > 0)
+  {
+    for (int begin = 0; begin < static_cast<int> (indices_->size ()); begin += batch_size_)
+    {
+      int end = std::min (begin + static_cast<int> (batch_size_), static_cast<int> (indices_->size ()));
+      if (!computeFeatureBatch (begin, end, output))
+        output.is_dense = false;
+    }
+    return;
+  }
+
   // Save a few cycles by not checking every point for NaN/Inf values if the cloud is set to dense
   if (input_->is_dense)
   {
@@ -161,6 +185,68 @@ pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computeFeature
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> bool
+pcl::PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computeFeatureBatch (
+      int begin, int end, PointCloudOut &output) const
+{
+  std::vector<int> nn_indices (k_);
+  std::vector<float> nn_dists (k_);
+
+  // Gather all neighborhoods of the batch into one compressed index list
+  std::vector<int> batch_indices;
+  std::vector<int> offsets (1, 0);
+  batch_indices.reserve ((end - begin) * std::max (k_, 1));
+  offsets.reserve (end - begin + 1);
+  for (int idx = begin; idx < end; ++idx)
+  {
+    if ((input_->is_dense || isFinite ((*input_)[(*indices_)[idx]])) &&
+        this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) != 0)
+      batch_indices.insert (batch_indices.end (), nn_indices.begin (), nn_indices.end ());
+    offsets.push_back (static_cast<int> (batch_indices.size ()));
+  }
+
+  std::vector<Eigen::Matrix3f> covariance_matrices;
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > means;
+  std::vector<unsigned int> point_counts;
+  computeNormalMeanAndCovarianceMatrixBatch (*normals_, batch_indices, offsets, covariance_matrices, means, point_counts);
+
+  // The covariance of the normals projected into the tangent plane is M * C * M^T
+  for (int idx = begin; idx < end; ++idx)
+  {
+    const int b = idx - begin;
+    if (point_counts[b] == 0)
+      continue;
+    const PointNT &n = normals_->points[(*indices_)[idx]];
+    Eigen::Vector3f n_idx (n.normal[0], n.normal[1], n.normal[2]);
+    Eigen::Matrix3f M = Eigen::Matrix3f::Identity () - n_idx * n_idx.transpose ();
+    covariance_matrices[b] = M * covariance_matrices[b] * M.transpose ();
+  }
+
+  std::vector<Eigen::Vector3f> eigen_values, eigen_vectors;
+  eigen33Batch (covariance_matrices, eigen_values, eigen_vectors, 2);
+
+  bool dense = true;
+  for (int idx = begin; idx < end; ++idx)
+  {
+    const int b = idx - begin;
+    if (point_counts[b] == 0)
+    {
+      output.points[idx].principal_curvature[0] = output.points[idx].principal_curvature[1] = output.points[idx].principal_curvature[2] =
+        output.points[idx].pc1 = output.points[idx].pc2 = std::numeric_limits<float>::quiet_NaN ();
+      dense = false;
+      continue;
+    }
+
+    output.points[idx].principal_curvature[0] = eigen_vectors[b][0];
+    output.points[idx].principal_curvature[1] = eigen_vectors[b][1];
+    output.points[idx].principal_curvature[2] = eigen_vectors[b][2];
+    output.points[idx].pc1 = eigen_values[b][2];
+    output.points[idx].pc2 = eigen_values[b][1];
+  }
+  return (dense);
+}
+
 #define PCL_INSTANTIATE_PrincipalCurvaturesEstimation(T,NT,OutT) template class PCL_EXPORTS pcl::PrincipalCurvaturesEstimation<T,NT,OutT>;
 
 #endif    // PCL_FEATURES_IMPL_PRINCIPAL_CURVATURES_H_
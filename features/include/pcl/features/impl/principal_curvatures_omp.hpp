@@ -0,0 +1,77 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#ifndef PCL_FEATURES_IMPL_PRINCIPAL_CURVATURES_OMP_H_
+#define PCL_FEATURES_IMPL_PRINCIPAL_CURVATURES_OMP_H_
+
+#include <pcl/features/principal_curvatures_omp.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PrincipalCurvaturesEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  this->computeFeatureParallel (output, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> bool
+pcl::PrincipalCurvaturesEstimationOMP<PointInT, PointNT, PointOutT>::computePointFeature (
+    size_t index, ThreadContext &context, PointOutT &output_point) const
+{
+  if (!isFinite ((*input_)[(*indices_)[index]]) ||
+      this->searchForNeighbors ((*indices_)[index], search_parameter_, context.nn_indices, context.nn_dists) == 0)
+  {
+    output_point.principal_curvature[0] = output_point.principal_curvature[1] = output_point.principal_curvature[2] =
+      output_point.pc1 = output_point.pc2 = std::numeric_limits<float>::quiet_NaN ();
+    return (false);
+  }
+
+  // Estimate the principal curvatures at the patch
+  Scratch &scratch = static_cast<Scratch&> (*context.scratch);
+  computePointPrincipalCurvatures (*normals_, (*indices_)[index], context.nn_indices, scratch.projected_normals,
+                                   output_point.principal_curvature[0], output_point.principal_curvature[1], output_point.principal_curvature[2],
+                                   output_point.pc1, output_point.pc2);
+  return (true);
+}
+
+#define PCL_INSTANTIATE_PrincipalCurvaturesEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::PrincipalCurvaturesEstimationOMP<T,NT,OutT>;
+
+#endif    // PCL_FEATURES_IMPL_PRINCIPAL_CURVATURES_OMP_H_
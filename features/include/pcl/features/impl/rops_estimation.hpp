@@ -140,66 +140,85 @@ pcl::ROPSEstimation <PointInT, PointOutT>::computeFeature (PointCloudOut &output
 
   buildListOfPointsTriangles ();
 
-  //feature size = number_of_rotations * number_of_axis_to_rotate_around * number_of_projections * number_of_central_moments
-  unsigned int feature_size = number_of_rotations_ * 3 * 3 * 5;
   unsigned int number_of_points = static_cast <unsigned int> (indices_->size ());
   output.points.resize (number_of_points, PointOutT ());
 
   for (unsigned int i_point = 0; i_point < number_of_points; i_point++)
+    computePointDescriptor (input_->points[(*indices_)[i_point]], output.points[i_point]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::ROPSEstimation <PointInT, PointOutT>::computePointDescriptor (const PointInT& point, PointOutT& output_point) const
+{
+  std::vector <int> local_points;
+  std::vector <float> distances;
+  DescriptorBuffers buffers;
+  computePointDescriptor (point, local_points, distances, buffers, output_point);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::ROPSEstimation <PointInT, PointOutT>::computePointDescriptor (const PointInT& point, std::vector <int>& local_points,
+  std::vector <float>& distances, DescriptorBuffers& buffers, PointOutT& output_point) const
+{
+  //feature size = number_of_rotations * number_of_axis_to_rotate_around * number_of_projections * number_of_central_moments
+  unsigned int feature_size = number_of_rotations_ * 3 * 3 * 5;
+
+  std::set <unsigned int>& local_triangles = buffers.local_triangles;
+  local_triangles.clear ();
+  getLocalSurface (point, local_triangles, local_points, distances);
+
+  Eigen::Matrix3f lrf_matrix;
+  computeLRF (point, local_triangles, lrf_matrix);
+
+  PointCloudIn& transformed_cloud = buffers.transformed_cloud;
+  transformCloud (point, lrf_matrix, local_points, transformed_cloud);
+
+  PointInT axis[3];
+  axis[0].x = 1.0f; axis[0].y = 0.0f; axis[0].z = 0.0f;
+  axis[1].x = 0.0f; axis[1].y = 1.0f; axis[1].z = 0.0f;
+  axis[2].x = 0.0f; axis[2].y = 0.0f; axis[2].z = 1.0f;
+  std::vector <float>& feature = buffers.feature;
+  feature.clear ();
+  feature.reserve (feature_size);
+  PointCloudIn& rotated_cloud = buffers.rotated_cloud;
+  Eigen::MatrixXf& distribution_matrix = buffers.distribution_matrix;
+  distribution_matrix.resize (number_of_bins_, number_of_bins_);
+  std::vector <float>& moments = buffers.moments;
+  for (unsigned int i_axis = 0; i_axis < 3; i_axis++)
   {
-    std::set <unsigned int> local_triangles;
-    std::vector <int> local_points;
-    getLocalSurface (input_->points[(*indices_)[i_point]], local_triangles, local_points);
-
-    Eigen::Matrix3f lrf_matrix;
-    computeLRF (input_->points[(*indices_)[i_point]], local_triangles, lrf_matrix);
-
-    PointCloudIn transformed_cloud;
-    transformCloud (input_->points[(*indices_)[i_point]], lrf_matrix, local_points, transformed_cloud);
-
-    PointInT axis[3];
-    axis[0].x = 1.0f; axis[0].y = 0.0f; axis[0].z = 0.0f;
-    axis[1].x = 0.0f; axis[1].y = 1.0f; axis[1].z = 0.0f;
-    axis[2].x = 0.0f; axis[2].y = 0.0f; axis[2].z = 1.0f;
-    std::vector <float> feature;
-    for (unsigned int i_axis = 0; i_axis < 3; i_axis++)
+    float theta = step_;
+    do
     {
-      float theta = step_;
-      do
+      //rotate local surface and get bounding box
+      Eigen::Vector3f min, max;
+      rotateCloud (axis[i_axis], theta, transformed_cloud, rotated_cloud, min, max);
+
+      //for each projection (XY, XZ and YZ) compute distribution matrix and central moments
+      for (unsigned int i_proj = 0; i_proj < 3; i_proj++)
       {
-        //rotate local surface and get bounding box
-        PointCloudIn rotated_cloud;
-        Eigen::Vector3f min, max;
-        rotateCloud (axis[i_axis], theta, transformed_cloud, rotated_cloud, min, max);
-
-        //for each projection (XY, XZ and YZ) compute distribution matrix and central moments
-        for (unsigned int i_proj = 0; i_proj < 3; i_proj++)
-        {
-          Eigen::MatrixXf distribution_matrix;
-          distribution_matrix.resize (number_of_bins_, number_of_bins_);
-          getDistributionMatrix (i_proj, min, max, rotated_cloud, distribution_matrix);
-
-          std::vector <float> moments;
-          computeCentralMoments (distribution_matrix, moments);
-
-          feature.insert (feature.end (), moments.begin (), moments.end ());
-        }
-
-        theta += step_;
-      } while (theta < 90.0f);
-    }
+        getDistributionMatrix (i_proj, min, max, rotated_cloud, distribution_matrix);
 
-    float norm = 0.0f;
-    for (unsigned int i_dim = 0; i_dim < feature_size; i_dim++)
-      norm += std::abs (feature[i_dim]);
-    if (norm < std::numeric_limits <float>::epsilon ())
-      norm = 1.0f;
-    else
-      norm = 1.0f / norm;
+        computeCentralMoments (distribution_matrix, moments);
 
-    for (unsigned int i_dim = 0; i_dim < feature_size; i_dim++)
-      output.points[i_point].histogram[i_dim] = feature[i_dim] * norm;
+        feature.insert (feature.end (), moments.begin (), moments.end ());
+      }
+
+      theta += step_;
+    } while (theta < 90.0f);
   }
+
+  float norm = 0.0f;
+  for (unsigned int i_dim = 0; i_dim < feature_size; i_dim++)
+    norm += std::abs (feature[i_dim]);
+  if (norm < std::numeric_limits <float>::epsilon ())
+    norm = 1.0f;
+  else
+    norm = 1.0f / norm;
+
+  for (unsigned int i_dim = 0; i_dim < feature_size; i_dim++)
+    output_point.histogram[i_dim] = feature[i_dim] * norm;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -224,6 +243,14 @@ template <typename PointInT, typename PointOutT> void
 pcl::ROPSEstimation <PointInT, PointOutT>::getLocalSurface (const PointInT& point, std::set <unsigned int>& local_triangles, std::vector <int>& local_points) const
 {
   std::vector <float> distances;
+  getLocalSurface (point, local_triangles, local_points, distances);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::ROPSEstimation <PointInT, PointOutT>::getLocalSurface (const PointInT& point, std::set <unsigned int>& local_triangles,
+  std::vector <int>& local_points, std::vector <float>& distances) const
+{
   tree_->radiusSearch (point, support_radius_, local_points, distances);
 
   const unsigned int number_of_indices = static_cast <unsigned int> (local_points.size ());
@@ -516,7 +543,7 @@ pcl::ROPSEstimation <PointInT, PointOutT>::computeCentralMoments (const Eigen::M
     {2.0f, 2.0f}};
 
   float entropy = 0.0f;
-  moments.resize (number_of_moments_to_compute + 1, 0.0f);
+  moments.assign (number_of_moments_to_compute + 1, 0.0f);
   for (unsigned int i = 0; i < number_of_bins_; i++)
   {
     const float i_factor = static_cast <float> (i + 1) - mean_i;
@@ -44,6 +44,10 @@
 #include <pcl/features/shot_lrf.h>
 #include <utility>
 
+#if defined __SSE2__ && !defined PCL_SHOT_NO_SSE2
+#include <emmintrin.h>
+#endif
+
 // Useful constants.
 #define PST_PI 3.1415926535897932384626433832795
 #define PST_RAD_45 0.78539816339744830961566084581988
@@ -84,6 +88,55 @@ areEquals (float val1, float val2, float zeroFloatEps = zeroFloatEps8)
   return (fabs (val1 - val2)<zeroFloatEps);
 }
 
+#if defined __SSE2__ && !defined PCL_SHOT_NO_SSE2
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Per lane select: a where mask is set, b elsewhere. */
+    inline __m128
+    sseSelect (const __m128 mask, const __m128 a, const __m128 b)
+    {
+      return (_mm_or_ps (_mm_and_ps (mask, a), _mm_andnot_ps (mask, b)));
+    }
+
+    /** \brief Four lane atan2 (y, x), accurate to a few ulps; returns 0 for x = y = 0.
+      * The arctangent of min (|x|,|y|) / max (|x|,|y|) is a minimax polynomial after
+      * reduction to [0, tan (pi/8)], then mapped back to the quadrant of (x, y).
+      */
+    inline __m128
+    sseAtan2 (const __m128 y, const __m128 x)
+    {
+      const __m128 zero = _mm_setzero_ps ();
+      const __m128 one = _mm_set1_ps (1.0f);
+      const __m128 sign = _mm_set1_ps (-0.0f);
+      const __m128 abs_x = _mm_andnot_ps (sign, x);
+      const __m128 abs_y = _mm_andnot_ps (sign, y);
+
+      __m128 den = _mm_max_ps (abs_x, abs_y);
+      den = _mm_or_ps (den, _mm_and_ps (_mm_cmpeq_ps (den, zero), one));
+      __m128 t = _mm_div_ps (_mm_min_ps (abs_x, abs_y), den);
+
+      // atan (t) = pi/4 + atan ((t - 1) / (t + 1))
+      const __m128 reduce = _mm_cmpgt_ps (t, _mm_set1_ps (0.414213562373095f));
+      t = sseSelect (reduce, _mm_div_ps (_mm_sub_ps (t, one), _mm_add_ps (t, one)), t);
+
+      const __m128 t2 = _mm_mul_ps (t, t);
+      __m128 p = _mm_set1_ps (8.05374449538e-2f);
+      p = _mm_add_ps (_mm_mul_ps (p, t2), _mm_set1_ps (-1.38776856032e-1f));
+      p = _mm_add_ps (_mm_mul_ps (p, t2), _mm_set1_ps (1.99777106478e-1f));
+      p = _mm_add_ps (_mm_mul_ps (p, t2), _mm_set1_ps (-3.33329491539e-1f));
+      __m128 a = _mm_add_ps (_mm_mul_ps (_mm_mul_ps (p, t2), t), t);
+      a = _mm_add_ps (a, _mm_and_ps (reduce, _mm_set1_ps (static_cast<float> (PST_RAD_45))));
+
+      a = sseSelect (_mm_cmpgt_ps (abs_y, abs_x), _mm_sub_ps (_mm_set1_ps (static_cast<float> (PST_RAD_90)), a), a);
+      a = sseSelect (_mm_cmplt_ps (x, zero), _mm_sub_ps (_mm_set1_ps (static_cast<float> (PST_PI)), a), a);
+      return (_mm_xor_ps (a, _mm_and_ps (_mm_cmplt_ps (y, zero), sign)));
+    }
+  }
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> float
 pcl::SHOTColorEstimation<PointInT, PointNT, PointOutT, PointRFT>::sRGB_LUT[256] = {- 1};
@@ -153,6 +206,20 @@ pcl::SHOTColorEstimation<PointInT, PointNT, PointOutT, PointRFT>::RGB2CIELAB (un
     B2 = -120.0f;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
+pcl::SHOTColorEstimation<PointInT, PointNT, PointOutT, PointRFT>::computeSurfaceLAB ()
+{
+  // Serial on purpose: this is also where the lookup tables of RGB2CIELAB get initialized
+  surface_lab_.resize (surface_->points.size ());
+  for (size_t i = 0; i < surface_->points.size (); ++i)
+  {
+    float L, a, b;
+    RGB2CIELAB (surface_->points[i].r, surface_->points[i].g, surface_->points[i].b, L, a, b);
+    surface_lab_[i] = Eigen::Vector3f (L / 100.0f, a / 120.0f, b / 120.0f);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> bool
 pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::initCompute ()
@@ -252,393 +319,385 @@ pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::normalizeHistog
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
-pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::interpolateSingleChannel (
+pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::gatherNeighbors (
     const std::vector<int> &indices,
     const std::vector<float> &sqr_dists,
     const int index,
-    std::vector<double> &binDistance,
-    const int nr_bins,
-    Eigen::VectorXf &shot)
+    std::vector<float> &delta_x,
+    std::vector<float> &delta_y,
+    std::vector<float> &delta_z,
+    std::vector<float> &distances,
+    SpatialBins &bins) const
 {
-  const Eigen::Vector4f& central_point = (*input_)[(*indices_)[index]].getVector4fMap ();
-  const PointRFT& current_frame = (*frames_)[index];
-
-  Eigen::Vector4f current_frame_x (current_frame.x_axis[0], current_frame.x_axis[1], current_frame.x_axis[2], 0);
-  Eigen::Vector4f current_frame_y (current_frame.y_axis[0], current_frame.y_axis[1], current_frame.y_axis[2], 0);
-  Eigen::Vector4f current_frame_z (current_frame.z_axis[0], current_frame.z_axis[1], current_frame.z_axis[2], 0);
-
-  for (size_t i_idx = 0; i_idx < indices.size (); ++i_idx)
+  const Eigen::Vector3f central_point = (*input_)[(*indices_)[index]].getVector3fMap ();
+
+  // Gather the neighbors in blocks of four; the padding has a zero distance and never votes
+  const size_t nr_neighbors = indices.size ();
+  const size_t nr_padded = (nr_neighbors + 3) & ~static_cast<size_t> (3);
+  delta_x.assign (nr_padded, 0.0f);
+  delta_y.assign (nr_padded, 0.0f);
+  delta_z.assign (nr_padded, 0.0f);
+  distances.assign (nr_padded, 0.0f);
+  for (size_t i_idx = 0; i_idx < nr_neighbors; ++i_idx)
   {
-    if (!pcl_isfinite(binDistance[i_idx]))
-      continue;
+    const Eigen::Vector3f delta = surface_->points[indices[i_idx]].getVector3fMap () - central_point;
+    delta_x[i_idx] = delta[0];
+    delta_y[i_idx] = delta[1];
+    delta_z[i_idx] = delta[2];
+    distances[i_idx] = sqrtf (sqr_dists[i_idx]);
+  }
 
-    Eigen::Vector4f delta = surface_->points[indices[i_idx]].getVector4fMap () - central_point;
-    delta[3] = 0;
+  bins.volume.resize (nr_padded);
+  bins.radial_volume.resize (nr_padded);
+  bins.inclination_volume.resize (nr_padded);
+  bins.azimuth_volume.resize (nr_padded);
+  bins.weight.resize (nr_padded);
+  bins.radial_weight.resize (nr_padded);
+  bins.inclination_weight.resize (nr_padded);
+  bins.azimuth_weight.resize (nr_padded);
+}
 
-    // Compute the Euclidean norm
-   double distance = sqrt (sqr_dists[i_idx]);
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
+pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::computeSpatialBins (
+    const std::vector<int> &indices,
+    const std::vector<float> &sqr_dists,
+    const int index,
+    SpatialBins &bins) const
+{
+#if defined __SSE2__ && !defined PCL_SHOT_NO_SSE2
+  std::vector<float> delta_x, delta_y, delta_z, distances;
+  gatherNeighbors (indices, sqr_dists, index, delta_x, delta_y, delta_z, distances, bins);
+  const size_t nr_padded = distances.size ();
+  const PointRFT& current_frame = (*frames_)[index];
 
-    if (areEquals (distance, 0.0))
-      continue;
+  const float radius1_4 = static_cast<float> (radius1_4_);
+  const float radius1_2 = static_cast<float> (radius1_2_);
+  const float radius3_4 = static_cast<float> (radius3_4_);
+
+  const __m128 zero = _mm_setzero_ps ();
+  const __m128 one = _mm_set1_ps (1.0f);
+  const __m128 sign = _mm_set1_ps (-0.0f);
+  const __m128 tiny = _mm_set1_ps (1E-30f);
+  const __m128 min_distance = _mm_set1_ps (1E-15f);
+  const __m128 r1_4 = _mm_set1_ps (radius1_4);
+  const __m128 r1_2 = _mm_set1_ps (radius1_2);
+  const __m128 r3_4 = _mm_set1_ps (radius3_4);
+  const __m128 rad_45 = _mm_set1_ps (static_cast<float> (PST_RAD_45));
+  const __m128 rad_90 = _mm_set1_ps (static_cast<float> (PST_RAD_90));
+  const __m128 rad_135 = _mm_set1_ps (static_cast<float> (PST_RAD_135));
+  const __m128 max_sectors = _mm_set1_ps (static_cast<float> (maxAngularSectors_));
+
+  const __m128 frame_x0 = _mm_set1_ps (current_frame.x_axis[0]);
+  const __m128 frame_x1 = _mm_set1_ps (current_frame.x_axis[1]);
+  const __m128 frame_x2 = _mm_set1_ps (current_frame.x_axis[2]);
+  const __m128 frame_y0 = _mm_set1_ps (current_frame.y_axis[0]);
+  const __m128 frame_y1 = _mm_set1_ps (current_frame.y_axis[1]);
+  const __m128 frame_y2 = _mm_set1_ps (current_frame.y_axis[2]);
+  const __m128 frame_z0 = _mm_set1_ps (current_frame.z_axis[0]);
+  const __m128 frame_z1 = _mm_set1_ps (current_frame.z_axis[1]);
+  const __m128 frame_z2 = _mm_set1_ps (current_frame.z_axis[2]);
+
+  for (size_t i_idx = 0; i_idx < nr_padded; i_idx += 4)
+  {
+    const __m128 dx = _mm_loadu_ps (&delta_x[i_idx]);
+    const __m128 dy = _mm_loadu_ps (&delta_y[i_idx]);
+    const __m128 dz = _mm_loadu_ps (&delta_z[i_idx]);
+    const __m128 distance = _mm_loadu_ps (&distances[i_idx]);
 
-    double xInFeatRef = delta.dot (current_frame_x);
-    double yInFeatRef = delta.dot (current_frame_y);
-    double zInFeatRef = delta.dot (current_frame_z);
+    __m128 x = _mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, frame_x0), _mm_mul_ps (dy, frame_x1)), _mm_mul_ps (dz, frame_x2));
+    __m128 y = _mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, frame_y0), _mm_mul_ps (dy, frame_y1)), _mm_mul_ps (dz, frame_y2));
+    __m128 z = _mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, frame_z0), _mm_mul_ps (dy, frame_z1)), _mm_mul_ps (dz, frame_z2));
 
     // To avoid numerical problems afterwards
-    if (fabs (yInFeatRef) < 1E-30)
-      yInFeatRef  = 0;
-    if (fabs (xInFeatRef) < 1E-30)
-      xInFeatRef  = 0;
-    if (fabs (zInFeatRef) < 1E-30)
-      zInFeatRef  = 0;
-
-
-    unsigned char bit4 = ((yInFeatRef > 0) || ((yInFeatRef == 0.0) && (xInFeatRef < 0))) ? 1 : 0;
-    unsigned char bit3 = static_cast<unsigned char> (((xInFeatRef > 0) || ((xInFeatRef == 0.0) && (yInFeatRef > 0))) ? !bit4 : bit4);
-
-    assert (bit3 == 0 || bit3 == 1);
+    x = _mm_andnot_ps (_mm_cmplt_ps (_mm_andnot_ps (sign, x), tiny), x);
+    y = _mm_andnot_ps (_mm_cmplt_ps (_mm_andnot_ps (sign, y), tiny), y);
+    z = _mm_andnot_ps (_mm_cmplt_ps (_mm_andnot_ps (sign, z), tiny), z);
+
+    const __m128 valid = _mm_cmpge_ps (distance, min_distance);
+    const __m128 abs_x = _mm_andnot_ps (sign, x);
+    const __m128 abs_y = _mm_andnot_ps (sign, y);
+    const __m128 x_pos = _mm_cmpgt_ps (x, zero);
+    const __m128 x_neg = _mm_cmplt_ps (x, zero);
+    const __m128 x_zero = _mm_cmpeq_ps (x, zero);
+    const __m128 y_pos = _mm_cmpgt_ps (y, zero);
+    const __m128 y_neg = _mm_cmplt_ps (y, zero);
+    const __m128 y_zero = _mm_cmpeq_ps (y, zero);
+    const __m128 outer = _mm_cmpgt_ps (distance, r1_2);
+
+    // Azimuthal sector, hemisphere and shell
+    const __m128 bit4 = _mm_or_ps (y_pos, _mm_and_ps (y_zero, x_neg));
+    const __m128 bit3 = _mm_xor_ps (_mm_or_ps (x_pos, _mm_and_ps (x_zero, y_pos)), bit4);
+    const __m128 same_sign = _mm_or_ps (_mm_or_ps (_mm_and_ps (x_pos, y_pos), _mm_and_ps (x_neg, y_neg)), x_zero);
+    const __m128 half_sector = pcl::detail::sseSelect (same_sign, _mm_cmplt_ps (abs_x, abs_y), _mm_cmpgt_ps (abs_x, abs_y));
+    __m128 desc_index = _mm_and_ps (bit4, _mm_set1_ps (16.0f));
+    desc_index = _mm_add_ps (desc_index, _mm_and_ps (bit3, _mm_set1_ps (8.0f)));
+    desc_index = _mm_add_ps (desc_index, _mm_and_ps (half_sector, _mm_set1_ps (4.0f)));
+    desc_index = _mm_add_ps (desc_index, _mm_and_ps (_mm_cmpgt_ps (z, zero), one));
+    desc_index = _mm_add_ps (desc_index, _mm_and_ps (outer, _mm_set1_ps (2.0f)));
 
-    int desc_index = (bit4<<3) + (bit3<<2);
+    //Interpolation on the distance (adjacent husks)
+    const __m128 radius_distance = _mm_div_ps (_mm_sub_ps (distance, pcl::detail::sseSelect (outer, r3_4, r1_4)), r1_2);
+    const __m128 radius_self = pcl::detail::sseSelect (outer, _mm_cmpgt_ps (distance, r3_4), _mm_cmpge_ps (distance, r1_4));
+    const __m128 radius_partner = _mm_xor_ps (outer, radius_self);
+    __m128 weight = _mm_add_ps (one, _mm_xor_ps (radius_distance, _mm_and_ps (radius_self, sign)));
+    const __m128 radial_weight = _mm_and_ps (radius_partner, _mm_xor_ps (radius_distance, _mm_and_ps (outer, sign)));
+    const __m128 radial_volume = _mm_add_ps (desc_index, _mm_and_ps (radius_partner, pcl::detail::sseSelect (outer, _mm_set1_ps (-2.0f), _mm_set1_ps (2.0f))));
 
-    desc_index = desc_index << 1;
+    //Interpolation on the inclination (adjacent vertical volumes)
+    const __m128 rho = _mm_sqrt_ps (_mm_add_ps (_mm_mul_ps (x, x), _mm_mul_ps (y, y)));
+    const __m128 inclination = pcl::detail::sseAtan2 (rho, z);
+    const __m128 lower = _mm_cmple_ps (z, zero);
+    const __m128 inclination_distance = _mm_div_ps (_mm_sub_ps (inclination, pcl::detail::sseSelect (lower, rad_135, rad_45)), rad_90);
+    const __m128 inclination_self = pcl::detail::sseSelect (lower, _mm_cmpgt_ps (inclination, rad_135), _mm_cmpge_ps (inclination, rad_45));
+    const __m128 inclination_partner = _mm_xor_ps (lower, inclination_self);
+    weight = _mm_add_ps (weight, _mm_add_ps (one, _mm_xor_ps (inclination_distance, _mm_and_ps (inclination_self, sign))));
+    const __m128 inclination_weight = _mm_and_ps (inclination_partner, _mm_xor_ps (inclination_distance, _mm_and_ps (lower, sign)));
+    const __m128 inclination_volume = _mm_add_ps (desc_index, _mm_and_ps (inclination_partner, pcl::detail::sseSelect (lower, one, _mm_set1_ps (-1.0f))));
+
+    //Interpolation on the azimuth (adjacent horizontal volumes)
+    const __m128 has_azimuth = _mm_andnot_ps (_mm_and_ps (x_zero, y_zero), _mm_cmpeq_ps (zero, zero));
+    const __m128 azimuth = pcl::detail::sseAtan2 (y, x);
+    const __m128 sel = _mm_cvtepi32_ps (_mm_srli_epi32 (_mm_cvttps_epi32 (desc_index), 2));
+    const __m128 sector_start = _mm_add_ps (_mm_set1_ps (static_cast<float> (- PST_RAD_PI_7_8)), _mm_mul_ps (sel, rad_45));
+    __m128 azimuth_distance = _mm_div_ps (_mm_sub_ps (azimuth, sector_start), rad_45);
+    azimuth_distance = _mm_max_ps (_mm_set1_ps (-0.5f), _mm_min_ps (azimuth_distance, _mm_set1_ps (0.5f)));
+    const __m128 azimuth_pos = _mm_cmpgt_ps (azimuth_distance, zero);
+    weight = _mm_add_ps (weight, _mm_and_ps (has_azimuth, _mm_add_ps (one, _mm_xor_ps (azimuth_distance, _mm_and_ps (azimuth_pos, sign)))));
+    const __m128 azimuth_weight = _mm_and_ps (has_azimuth, _mm_xor_ps (azimuth_distance, _mm_andnot_ps (azimuth_pos, sign)));
+    __m128 azimuth_volume = _mm_add_ps (desc_index, pcl::detail::sseSelect (azimuth_pos, _mm_set1_ps (4.0f), _mm_sub_ps (max_sectors, _mm_set1_ps (4.0f))));
+    azimuth_volume = _mm_sub_ps (azimuth_volume, _mm_and_ps (_mm_cmpge_ps (azimuth_volume, max_sectors), max_sectors));
+    azimuth_volume = pcl::detail::sseSelect (has_azimuth, azimuth_volume, desc_index);
+
+    const __m128 volume = pcl::detail::sseSelect (valid, desc_index, _mm_set1_ps (-1.0f));
+    _mm_storeu_si128 (reinterpret_cast<__m128i*> (&bins.volume[i_idx]), _mm_cvttps_epi32 (volume));
+    _mm_storeu_si128 (reinterpret_cast<__m128i*> (&bins.radial_volume[i_idx]), _mm_cvttps_epi32 (radial_volume));
+    _mm_storeu_si128 (reinterpret_cast<__m128i*> (&bins.inclination_volume[i_idx]), _mm_cvttps_epi32 (inclination_volume));
+    _mm_storeu_si128 (reinterpret_cast<__m128i*> (&bins.azimuth_volume[i_idx]), _mm_cvttps_epi32 (azimuth_volume));
+    _mm_storeu_ps (&bins.weight[i_idx], weight);
+    _mm_storeu_ps (&bins.radial_weight[i_idx], radial_weight);
+    _mm_storeu_ps (&bins.inclination_weight[i_idx], inclination_weight);
+    _mm_storeu_ps (&bins.azimuth_weight[i_idx], azimuth_weight);
+  }
+#else
+  computeSpatialBinsScalar (indices, sqr_dists, index, bins);
+#endif
+}
 
-    if ((xInFeatRef * yInFeatRef > 0) || (xInFeatRef == 0.0))
-      desc_index += (fabs (xInFeatRef) >= fabs (yInFeatRef)) ? 0 : 4;
-    else
-      desc_index += (fabs (xInFeatRef) > fabs (yInFeatRef)) ? 4 : 0;
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
+pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::computeSpatialBinsScalar (
+    const std::vector<int> &indices,
+    const std::vector<float> &sqr_dists,
+    const int index,
+    SpatialBins &bins) const
+{
+  std::vector<float> delta_x, delta_y, delta_z, distances;
+  gatherNeighbors (indices, sqr_dists, index, delta_x, delta_y, delta_z, distances, bins);
+  const size_t nr_padded = distances.size ();
+  const PointRFT& current_frame = (*frames_)[index];
 
-    desc_index += zInFeatRef > 0 ? 1 : 0;
+  const float radius1_4 = static_cast<float> (radius1_4_);
+  const float radius1_2 = static_cast<float> (radius1_2_);
+  const float radius3_4 = static_cast<float> (radius3_4_);
 
-    // 2 RADII
-    desc_index += (distance > radius1_2_) ? 2 : 0;
+  const Eigen::Vector3f current_frame_x (current_frame.x_axis[0], current_frame.x_axis[1], current_frame.x_axis[2]);
+  const Eigen::Vector3f current_frame_y (current_frame.y_axis[0], current_frame.y_axis[1], current_frame.y_axis[2]);
+  const Eigen::Vector3f current_frame_z (current_frame.z_axis[0], current_frame.z_axis[1], current_frame.z_axis[2]);
 
-    int step_index = static_cast<int>(floor (binDistance[i_idx] +0.5));
-    int volume_index = desc_index * (nr_bins+1);
+  for (size_t i_idx = 0; i_idx < nr_padded; ++i_idx)
+  {
+    const float distance = distances[i_idx];
+    if (distance < 1E-15f)
+    {
+      bins.volume[i_idx] = -1;
+      continue;
+    }
 
-    //Interpolation on the cosine (adjacent bins in the histogram)
-    binDistance[i_idx] -= step_index;
-    double intWeight = (1- fabs (binDistance[i_idx]));
+    const Eigen::Vector3f delta (delta_x[i_idx], delta_y[i_idx], delta_z[i_idx]);
+    float x = delta.dot (current_frame_x);
+    float y = delta.dot (current_frame_y);
+    float z = delta.dot (current_frame_z);
 
-    if (binDistance[i_idx] > 0)
-      shot[volume_index + ((step_index+1) % nr_bins)] += static_cast<float> (binDistance[i_idx]);
+    // To avoid numerical problems afterwards
+    if (fabsf (x) < 1E-30f)
+      x = 0;
+    if (fabsf (y) < 1E-30f)
+      y = 0;
+    if (fabsf (z) < 1E-30f)
+      z = 0;
+
+    // Azimuthal sector, hemisphere and shell
+    const bool bit4 = (y > 0) || ((y == 0) && (x < 0));
+    const bool bit3 = ((x > 0) || ((x == 0) && (y > 0))) != bit4;
+    int desc_index = (bit4 ? 16 : 0) + (bit3 ? 8 : 0);
+    if ((x > 0 && y > 0) || (x < 0 && y < 0) || (x == 0))
+      desc_index += (fabsf (x) >= fabsf (y)) ? 0 : 4;
     else
-      shot[volume_index + ((step_index - 1 + nr_bins) % nr_bins)] += - static_cast<float> (binDistance[i_idx]);
+      desc_index += (fabsf (x) > fabsf (y)) ? 4 : 0;
+    desc_index += z > 0 ? 1 : 0;
+    desc_index += (distance > radius1_2) ? 2 : 0;
 
-    //Interpolation on the distance (adjacent husks)
+    float weight = 0;
+    bins.radial_volume[i_idx] = bins.inclination_volume[i_idx] = bins.azimuth_volume[i_idx] = desc_index;
+    bins.radial_weight[i_idx] = bins.inclination_weight[i_idx] = bins.azimuth_weight[i_idx] = 0;
 
-    if (distance > radius1_2_)   //external sphere
+    //Interpolation on the distance (adjacent husks)
+    if (distance > radius1_2)
     {
-      double radiusDistance = (distance - radius3_4_) / radius1_2_;
-
-      if (distance > radius3_4_) //most external sector, votes only for itself
-        intWeight += 1 - radiusDistance;  //peso=1-d
-      else  //3/4 of radius, votes also for the internal sphere
+      const float radius_distance = (distance - radius3_4) / radius1_2;
+      if (distance > radius3_4)
+        weight += 1 - radius_distance;
+      else
       {
-        intWeight += 1 + radiusDistance;
-        shot[(desc_index - 2) * (nr_bins+1) + step_index] -= static_cast<float> (radiusDistance);
+        weight += 1 + radius_distance;
+        bins.radial_volume[i_idx] = desc_index - 2;
+        bins.radial_weight[i_idx] = - radius_distance;
       }
     }
-    else    //internal sphere
+    else
     {
-      double radiusDistance = (distance - radius1_4_) / radius1_2_;
-
-      if (distance < radius1_4_) //most internal sector, votes only for itself
-        intWeight += 1 + radiusDistance;  //weight=1-d
-      else  //3/4 of radius, votes also for the external sphere
+      const float radius_distance = (distance - radius1_4) / radius1_2;
+      if (distance < radius1_4)
+        weight += 1 + radius_distance;
+      else
       {
-        intWeight += 1 - radiusDistance;
-        shot[(desc_index + 2) * (nr_bins+1) + step_index] += static_cast<float> (radiusDistance);
+        weight += 1 - radius_distance;
+        bins.radial_volume[i_idx] = desc_index + 2;
+        bins.radial_weight[i_idx] = radius_distance;
       }
     }
 
     //Interpolation on the inclination (adjacent vertical volumes)
-    double inclinationCos = zInFeatRef / distance;
-    if (inclinationCos < - 1.0)
-      inclinationCos = - 1.0;
-    if (inclinationCos > 1.0)
-      inclinationCos = 1.0;
-
-    double inclination = acos (inclinationCos);
-
-    assert (inclination >= 0.0 && inclination <= PST_RAD_180);
-
-    if (inclination > PST_RAD_90 || (fabs (inclination - PST_RAD_90) < 1e-30 && zInFeatRef <= 0))
+    const float inclination = atan2f (sqrtf (x * x + y * y), z);
+    if (z <= 0)
     {
-      double inclinationDistance = (inclination - PST_RAD_135) / PST_RAD_90;
-      if (inclination > PST_RAD_135)
-        intWeight += 1 - inclinationDistance;
+      const float inclination_distance = (inclination - static_cast<float> (PST_RAD_135)) / static_cast<float> (PST_RAD_90);
+      if (inclination > static_cast<float> (PST_RAD_135))
+        weight += 1 - inclination_distance;
       else
       {
-        intWeight += 1 + inclinationDistance;
-        assert ((desc_index + 1) * (nr_bins+1) + step_index >= 0 && (desc_index + 1) * (nr_bins+1) + step_index < descLength_);
-        shot[(desc_index + 1) * (nr_bins+1) + step_index] -= static_cast<float> (inclinationDistance);
+        weight += 1 + inclination_distance;
+        bins.inclination_volume[i_idx] = desc_index + 1;
+        bins.inclination_weight[i_idx] = - inclination_distance;
       }
     }
     else
     {
-      double inclinationDistance = (inclination - PST_RAD_45) / PST_RAD_90;
-      if (inclination < PST_RAD_45)
-        intWeight += 1 + inclinationDistance;
+      const float inclination_distance = (inclination - static_cast<float> (PST_RAD_45)) / static_cast<float> (PST_RAD_90);
+      if (inclination < static_cast<float> (PST_RAD_45))
+        weight += 1 + inclination_distance;
       else
       {
-        intWeight += 1 - inclinationDistance;
-        assert ((desc_index - 1) * (nr_bins+1) + step_index >= 0 && (desc_index - 1) * (nr_bins+1) + step_index < descLength_);
-        shot[(desc_index - 1) * (nr_bins+1) + step_index] += static_cast<float> (inclinationDistance);
+        weight += 1 - inclination_distance;
+        bins.inclination_volume[i_idx] = desc_index - 1;
+        bins.inclination_weight[i_idx] = inclination_distance;
       }
     }
 
-    if (yInFeatRef != 0.0 || xInFeatRef != 0.0)
+    //Interpolation on the azimuth (adjacent horizontal volumes)
+    if (y != 0 || x != 0)
     {
-      //Interpolation on the azimuth (adjacent horizontal volumes)
-      double azimuth = atan2 (yInFeatRef, xInFeatRef);
-
-      int sel = desc_index >> 2;
-      double angularSectorSpan = PST_RAD_45;
-      double angularSectorStart = - PST_RAD_PI_7_8;
-
-      double azimuthDistance = (azimuth - (angularSectorStart + angularSectorSpan*sel)) / angularSectorSpan;
-
-      assert ((azimuthDistance < 0.5 || areEquals (azimuthDistance, 0.5)) && (azimuthDistance > - 0.5 || areEquals (azimuthDistance, - 0.5)));
-
-      azimuthDistance = (std::max)(- 0.5, std::min (azimuthDistance, 0.5));
-
-      if (azimuthDistance > 0)
+      const float azimuth = atan2f (y, x);
+      const float sector_start = static_cast<float> (- PST_RAD_PI_7_8 + PST_RAD_45 * (desc_index >> 2));
+      float azimuth_distance = (azimuth - sector_start) / static_cast<float> (PST_RAD_45);
+      azimuth_distance = (std::max) (-0.5f, (std::min) (azimuth_distance, 0.5f));
+      if (azimuth_distance > 0)
       {
-        intWeight += 1 - azimuthDistance;
-        int interp_index = (desc_index + 4) % maxAngularSectors_;
-        assert (interp_index * (nr_bins+1) + step_index >= 0 && interp_index * (nr_bins+1) + step_index < descLength_);
-        shot[interp_index * (nr_bins+1) + step_index] += static_cast<float> (azimuthDistance);
+        weight += 1 - azimuth_distance;
+        bins.azimuth_volume[i_idx] = (desc_index + 4) % maxAngularSectors_;
+        bins.azimuth_weight[i_idx] = azimuth_distance;
       }
       else
       {
-        int interp_index = (desc_index - 4 + maxAngularSectors_) % maxAngularSectors_;
-        assert (interp_index * (nr_bins+1) + step_index >= 0 && interp_index * (nr_bins+1) + step_index < descLength_);
-        intWeight += 1 + azimuthDistance;
-        shot[interp_index * (nr_bins+1) + step_index] -= static_cast<float> (azimuthDistance);
+        weight += 1 + azimuth_distance;
+        bins.azimuth_volume[i_idx] = (desc_index - 4 + maxAngularSectors_) % maxAngularSectors_;
+        bins.azimuth_weight[i_idx] = - azimuth_distance;
       }
-
     }
 
-    assert (volume_index + step_index >= 0 &&  volume_index + step_index < descLength_);
-    shot[volume_index + step_index] += static_cast<float> (intWeight);
+    bins.volume[i_idx] = desc_index;
+    bins.weight[i_idx] = weight;
   }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
-pcl::SHOTColorEstimation<PointInT, PointNT, PointOutT, PointRFT>::interpolateDoubleChannel (
-  const std::vector<int> &indices,
-  const std::vector<float> &sqr_dists,
-  const int index,
-  std::vector<double> &binDistanceShape,
-  std::vector<double> &binDistanceColor,
-  const int nr_bins_shape,
-  const int nr_bins_color,
-  Eigen::VectorXf &shot)
+pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::accumulateHistogram (
+    const SpatialBins &bins,
+    const std::vector<double> &binDistance,
+    const int nr_bins,
+    const int offset,
+    Eigen::VectorXf &shot) const
 {
-  const Eigen::Vector4f &central_point = (*input_)[(*indices_)[index]].getVector4fMap ();
-  const PointRFT& current_frame = (*frames_)[index];
-
-  int shapeToColorStride = nr_grid_sector_*(nr_bins_shape+1);
-
-  Eigen::Vector4f current_frame_x (current_frame.x_axis[0], current_frame.x_axis[1], current_frame.x_axis[2], 0);
-  Eigen::Vector4f current_frame_y (current_frame.y_axis[0], current_frame.y_axis[1], current_frame.y_axis[2], 0);
-  Eigen::Vector4f current_frame_z (current_frame.z_axis[0], current_frame.z_axis[1], current_frame.z_axis[2], 0);
+  const int volume_size = nr_bins + 1;
+  float *histogram = shot.data () + offset;
 
-  for (size_t i_idx = 0; i_idx < indices.size (); ++i_idx)
+  for (size_t i_idx = 0; i_idx < binDistance.size (); ++i_idx)
   {
-    if (!pcl_isfinite(binDistanceShape[i_idx]))
-      continue;
-
-    Eigen::Vector4f delta = surface_->points[indices[i_idx]].getVector4fMap () - central_point;
-    delta[3] = 0;
-
-    // Compute the Euclidean norm
-    double distance = sqrt (sqr_dists[i_idx]);
-
-    if (areEquals (distance, 0.0))
+    const int volume = bins.volume[i_idx];
+    if (volume < 0 || !pcl_isfinite (binDistance[i_idx]))
       continue;
 
-    double xInFeatRef = delta.dot (current_frame_x);
-    double yInFeatRef = delta.dot (current_frame_y);
-    double zInFeatRef = delta.dot (current_frame_z);
+    const int step_index = static_cast<int> (floor (binDistance[i_idx] + 0.5));
+    const float bin_distance = static_cast<float> (binDistance[i_idx] - step_index);
 
-    // To avoid numerical problems afterwards
-    if (fabs (yInFeatRef) < 1E-30)
-      yInFeatRef  = 0;
-    if (fabs (xInFeatRef) < 1E-30)
-      xInFeatRef  = 0;
-    if (fabs (zInFeatRef) < 1E-30)
-      zInFeatRef  = 0;
-
-    unsigned char bit4 = ((yInFeatRef > 0) || ((yInFeatRef == 0.0) && (xInFeatRef < 0))) ? 1 : 0;
-    unsigned char bit3 = static_cast<unsigned char> (((xInFeatRef > 0) || ((xInFeatRef == 0.0) && (yInFeatRef > 0))) ? !bit4 : bit4);
-
-    assert (bit3 == 0 || bit3 == 1);
-
-    int desc_index = (bit4<<3) + (bit3<<2);
-
-    desc_index = desc_index << 1;
-
-    if ((xInFeatRef * yInFeatRef > 0) || (xInFeatRef == 0.0))
-      desc_index += (fabs (xInFeatRef) >= fabs (yInFeatRef)) ? 0 : 4;
-    else
-      desc_index += (fabs (xInFeatRef) > fabs (yInFeatRef)) ? 4 : 0;
-
-    desc_index += zInFeatRef > 0 ? 1 : 0;
-
-    // 2 RADII
-    desc_index += (distance > radius1_2_) ? 2 : 0;
-
-    int step_index_shape = static_cast<int>(floor (binDistanceShape[i_idx] +0.5));
-    int step_index_color = static_cast<int>(floor (binDistanceColor[i_idx] +0.5));
-
-    int volume_index_shape = desc_index * (nr_bins_shape+1);
-    int volume_index_color = shapeToColorStride + desc_index * (nr_bins_color+1);
-
-    //Interpolation on the cosine (adjacent bins in the histrogram)
-    binDistanceShape[i_idx] -= step_index_shape;
-    binDistanceColor[i_idx] -= step_index_color;
-
-    double intWeightShape = (1- fabs (binDistanceShape[i_idx]));
-    double intWeightColor = (1- fabs (binDistanceColor[i_idx]));
-
-    if (binDistanceShape[i_idx] > 0)
-      shot[volume_index_shape + ((step_index_shape + 1) % nr_bins_shape)] += static_cast<float> (binDistanceShape[i_idx]);
-    else
-      shot[volume_index_shape + ((step_index_shape - 1 + nr_bins_shape) % nr_bins_shape)] -= static_cast<float> (binDistanceShape[i_idx]);
-
-    if (binDistanceColor[i_idx] > 0)
-      shot[volume_index_color + ((step_index_color+1) % nr_bins_color)] += static_cast<float> (binDistanceColor[i_idx]);
+    //Interpolation on the cosine (adjacent bins in the histogram)
+    if (bin_distance > 0)
+      histogram[volume * volume_size + ((step_index + 1) % nr_bins)] += bin_distance;
     else
-      shot[volume_index_color + ((step_index_color - 1 + nr_bins_color) % nr_bins_color)] -= static_cast<float> (binDistanceColor[i_idx]);
-
-    //Interpolation on the distance (adjacent husks)
-
-    if (distance > radius1_2_)   //external sphere
-    {
-      double radiusDistance = (distance - radius3_4_) / radius1_2_;
-
-      if (distance > radius3_4_) //most external sector, votes only for itself
-      {
-        intWeightShape += 1 - radiusDistance; //weight=1-d
-        intWeightColor += 1 - radiusDistance; //weight=1-d
-      }
-      else  //3/4 of radius, votes also for the internal sphere
-      {
-        intWeightShape += 1 + radiusDistance;
-        intWeightColor += 1 + radiusDistance;
-        shot[(desc_index - 2) * (nr_bins_shape+1) + step_index_shape] -= static_cast<float> (radiusDistance);
-        shot[shapeToColorStride + (desc_index - 2) * (nr_bins_color+1) + step_index_color] -= static_cast<float> (radiusDistance);
-      }
-    }
-    else    //internal sphere
-    {
-      double radiusDistance = (distance - radius1_4_) / radius1_2_;
-
-      if (distance < radius1_4_) //most internal sector, votes only for itself
-      {
-        intWeightShape += 1 + radiusDistance;
-        intWeightColor += 1 + radiusDistance; //weight=1-d
-      }
-      else  //3/4 of radius, votes also for the external sphere
-      {
-        intWeightShape += 1 - radiusDistance; //weight=1-d
-        intWeightColor += 1 - radiusDistance; //weight=1-d
-        shot[(desc_index + 2) * (nr_bins_shape+1) + step_index_shape] += static_cast<float> (radiusDistance);
-        shot[shapeToColorStride + (desc_index + 2) * (nr_bins_color+1) + step_index_color] += static_cast<float> (radiusDistance);
-      }
-    }
-
-    //Interpolation on the inclination (adjacent vertical volumes)
-    double inclinationCos = zInFeatRef / distance;
-    if (inclinationCos < - 1.0)
-      inclinationCos = - 1.0;
-    if (inclinationCos > 1.0)
-      inclinationCos = 1.0;
-
-    double inclination = acos (inclinationCos);
+      histogram[volume * volume_size + ((step_index - 1 + nr_bins) % nr_bins)] -= bin_distance;
 
-    assert (inclination >= 0.0 && inclination <= PST_RAD_180);
+    //Interpolation on the distance, inclination and azimuth (adjacent volumes)
+    assert (bins.radial_volume[i_idx] >= 0 && bins.radial_volume[i_idx] < nr_grid_sector_);
+    assert (bins.inclination_volume[i_idx] >= 0 && bins.inclination_volume[i_idx] < nr_grid_sector_);
+    assert (bins.azimuth_volume[i_idx] >= 0 && bins.azimuth_volume[i_idx] < nr_grid_sector_);
+    histogram[bins.radial_volume[i_idx] * volume_size + step_index] += bins.radial_weight[i_idx];
+    histogram[bins.inclination_volume[i_idx] * volume_size + step_index] += bins.inclination_weight[i_idx];
+    histogram[bins.azimuth_volume[i_idx] * volume_size + step_index] += bins.azimuth_weight[i_idx];
 
-    if (inclination > PST_RAD_90 || (fabs (inclination - PST_RAD_90) < 1e-30 && zInFeatRef <= 0))
-    {
-      double inclinationDistance = (inclination - PST_RAD_135) / PST_RAD_90;
-      if (inclination > PST_RAD_135)
-      {
-        intWeightShape += 1 - inclinationDistance;
-        intWeightColor += 1 - inclinationDistance;
-      }
-      else
-      {
-        intWeightShape += 1 + inclinationDistance;
-        intWeightColor += 1 + inclinationDistance;
-        assert ((desc_index + 1) * (nr_bins_shape+1) + step_index_shape >= 0 && (desc_index + 1) * (nr_bins_shape+1) + step_index_shape < descLength_);
-        assert (shapeToColorStride + (desc_index + 1) * (nr_bins_color+ 1) + step_index_color >= 0 && shapeToColorStride + (desc_index + 1) * (nr_bins_color+1) + step_index_color < descLength_);
-        shot[(desc_index + 1) * (nr_bins_shape+1) + step_index_shape] -= static_cast<float> (inclinationDistance);
-        shot[shapeToColorStride + (desc_index + 1) * (nr_bins_color+1) + step_index_color] -= static_cast<float> (inclinationDistance);
-      }
-    }
-    else
-    {
-      double inclinationDistance = (inclination - PST_RAD_45) / PST_RAD_90;
-      if (inclination < PST_RAD_45)
-      {
-        intWeightShape += 1 + inclinationDistance;
-        intWeightColor += 1 + inclinationDistance;
-      }
-      else
-      {
-        intWeightShape += 1 - inclinationDistance;
-        intWeightColor += 1 - inclinationDistance;
-        assert ((desc_index - 1) * (nr_bins_shape+1) + step_index_shape >= 0 && (desc_index - 1) * (nr_bins_shape+1) + step_index_shape < descLength_);
-        assert (shapeToColorStride + (desc_index - 1) * (nr_bins_color+ 1) + step_index_color >= 0 && shapeToColorStride + (desc_index - 1) * (nr_bins_color+1) + step_index_color < descLength_);
-        shot[(desc_index - 1) * (nr_bins_shape+1) + step_index_shape] += static_cast<float> (inclinationDistance);
-        shot[shapeToColorStride + (desc_index - 1) * (nr_bins_color+1) + step_index_color] += static_cast<float> (inclinationDistance);
-      }
-    }
-
-    if (yInFeatRef != 0.0 || xInFeatRef != 0.0)
-    {
-      //Interpolation on the azimuth (adjacent horizontal volumes)
-      double azimuth = atan2 (yInFeatRef, xInFeatRef);
+    histogram[volume * volume_size + step_index] += 1 - fabsf (bin_distance) + bins.weight[i_idx];
+  }
+}
 
-      int sel = desc_index >> 2;
-      double angularSectorSpan = PST_RAD_45;
-      double angularSectorStart = - PST_RAD_PI_7_8;
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
+pcl::SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::interpolateSingleChannel (
+    const std::vector<int> &indices,
+    const std::vector<float> &sqr_dists,
+    const int index,
+    std::vector<double> &binDistance,
+    const int nr_bins,
+    Eigen::VectorXf &shot)
+{
+  SpatialBins bins;
+  computeSpatialBins (indices, sqr_dists, index, bins);
+  accumulateHistogram (bins, binDistance, nr_bins, 0, shot);
+}
 
-      double azimuthDistance = (azimuth - (angularSectorStart + angularSectorSpan*sel)) / angularSectorSpan;
-      assert ((azimuthDistance < 0.5 || areEquals (azimuthDistance, 0.5)) && (azimuthDistance > - 0.5 || areEquals (azimuthDistance, - 0.5)));
-      azimuthDistance = (std::max)(- 0.5, std::min (azimuthDistance, 0.5));
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
+pcl::SHOTColorEstimation<PointInT, PointNT, PointOutT, PointRFT>::interpolateDoubleChannel (
+  const std::vector<int> &indices,
+  const std::vector<float> &sqr_dists,
+  const int index,
+  std::vector<double> &binDistanceShape,
+  std::vector<double> &binDistanceColor,
+  const int nr_bins_shape,
+  const int nr_bins_color,
+  Eigen::VectorXf &shot)
+{
+  // The spatial bins are shared by the two histograms
+  SpatialBins bins;
+  this->computeSpatialBins (indices, sqr_dists, index, bins);
 
-      if (azimuthDistance > 0)
-      {
-        intWeightShape += 1 - azimuthDistance;
-        intWeightColor += 1 - azimuthDistance;
-        int interp_index = (desc_index + 4) % maxAngularSectors_;
-        assert (interp_index * (nr_bins_shape+1) + step_index_shape >= 0 && interp_index * (nr_bins_shape+1) + step_index_shape < descLength_);
-        assert (shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color >= 0 && shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color < descLength_);
-        shot[interp_index * (nr_bins_shape+1) + step_index_shape] += static_cast<float> (azimuthDistance);
-        shot[shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color] += static_cast<float> (azimuthDistance);
-      }
-      else
-      {
-        int interp_index = (desc_index - 4 + maxAngularSectors_) % maxAngularSectors_;
-        intWeightShape += 1 + azimuthDistance;
-        intWeightColor += 1 + azimuthDistance;
-        assert (interp_index * (nr_bins_shape+1) + step_index_shape >= 0 && interp_index * (nr_bins_shape+1) + step_index_shape < descLength_);
-        assert (shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color >= 0 && shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color < descLength_);
-        shot[interp_index * (nr_bins_shape+1) + step_index_shape] -= static_cast<float> (azimuthDistance);
-        shot[shapeToColorStride + interp_index * (nr_bins_color+1) + step_index_color] -= static_cast<float> (azimuthDistance);
-      }
-    }
+  // A neighbor without a valid normal votes in neither histogram
+  for (size_t i_idx = 0; i_idx < binDistanceShape.size (); ++i_idx)
+    if (!pcl_isfinite (binDistanceShape[i_idx]))
+      binDistanceColor[i_idx] = std::numeric_limits<double>::quiet_NaN ();
 
-    assert (volume_index_shape + step_index_shape >= 0 &&  volume_index_shape + step_index_shape < descLength_);
-    assert (volume_index_color + step_index_color >= 0 &&  volume_index_color + step_index_color < descLength_);
-    shot[volume_index_shape + step_index_shape] += static_cast<float> (intWeightShape);
-    shot[volume_index_color + step_index_color] += static_cast<float> (intWeightColor);
-  }
+  this->accumulateHistogram (bins, binDistanceShape, nr_bins_shape, 0, shot);
+  this->accumulateHistogram (bins, binDistanceColor, nr_bins_color, nr_grid_sector_ * (nr_bins_shape + 1), shot);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -687,21 +746,28 @@ pcl::SHOTColorEstimation<PointInT, PointNT, PointOutT, PointRFT>::computePointSH
     aRef /= 120.0f;
     bRef /= 120.0f;    //normalized LAB components (0<L<1, -1<a<1, -1<b<1)
 
+    // Use the colors converted once per cloud in computeFeature, if available
+    const bool use_surface_lab = (surface_lab_.size () == surface_->points.size ());
+
     for (size_t i_idx = 0; i_idx < indices.size (); ++i_idx)
     {
-      //unsigned char red = surface_->points[indices[i_idx]].rgba >> 16 & 0xFF;
-      //unsigned char green = surface_->points[indices[i_idx]].rgba >> 8 & 0xFF;
-      //unsigned char blue = surface_->points[indices[i_idx]].rgba & 0xFF;
-      unsigned char red = surface_->points[indices[i_idx]].r;
-      unsigned char green = surface_->points[indices[i_idx]].g;
-      unsigned char blue = surface_->points[indices[i_idx]].b;
-
       float L, a, b;
 
-      RGB2CIELAB (red, green, blue, L, a, b);
-      L /= 100.0f;
-      a /= 120.0f;
-      b /= 120.0f;   //normalized LAB components (0<L<1, -1<a<1, -1<b<1)
+      if (use_surface_lab)
+      {
+        const Eigen::Vector3f &lab = surface_lab_[indices[i_idx]];
+        L = lab[0];
+        a = lab[1];
+        b = lab[2];
+      }
+      else
+      {
+        RGB2CIELAB (surface_->points[indices[i_idx]].r, surface_->points[indices[i_idx]].g,
+                    surface_->points[indices[i_idx]].b, L, a, b);
+        L /= 100.0f;
+        a /= 120.0f;
+        b /= 120.0f;   //normalized LAB components (0<L<1, -1<a<1, -1<b<1)
+      }
 
       double colorDistance = (fabs (LRef - L) + ((fabs (aRef - a) + fabs (bRef - b)) / 2)) /3;
 
@@ -846,6 +912,9 @@ pcl::SHOTColorEstimation<PointInT, PointNT, PointOutT, PointRFT>::computeFeature
 
   shot_.setZero (descLength_);
 
+  if (b_describe_color_)
+    computeSurfaceLAB ();
+
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
   std::vector<int> nn_indices (k_);
@@ -893,6 +962,8 @@ pcl::SHOTColorEstimation<PointInT, PointNT, PointOutT, PointRFT>::computeFeature
       output.points[idx].rf[d + 6] = frames_->points[idx].z_axis[d];
     }
   }
+
+  surface_lab_.clear ();
 }
 
 #define PCL_INSTANTIATE_SHOTEstimationBase(T,NT,OutT,RFT) template class PCL_EXPORTS pcl::SHOTEstimationBase<T,NT,OutT,RFT>;
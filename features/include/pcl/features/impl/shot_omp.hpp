@@ -208,6 +208,9 @@ pcl::SHOTColorEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::computeFeat
 
   int data_size = static_cast<int> (indices_->size ());
 
+  if (b_describe_color_)
+    this->computeSurfaceLAB ();
+
   output.is_dense = true;
   // Iterating over the entire index vector
 #ifdef _OPENMP
@@ -261,6 +264,8 @@ pcl::SHOTColorEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::computeFeat
       output.points[idx].rf[d + 6] = frames_->points[idx].z_axis[d];
     }
   }
+
+  this->surface_lab_.clear ();
 }
 
 #define PCL_INSTANTIATE_SHOTEstimationOMP(T,NT,OutT,RFT) template class PCL_EXPORTS pcl::SHOTEstimationOMP<T,NT,OutT,RFT>;
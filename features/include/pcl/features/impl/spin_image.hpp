@@ -67,6 +67,20 @@ pcl::SpinImageEstimation<PointInT, PointNT, PointOutT>::SpinImageEstimation (
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT> Eigen::ArrayXXd 
 pcl::SpinImageEstimation<PointInT, PointNT, PointOutT>::computeSiForPoint (int index) const
+{
+  std::vector<int> nn_indices;
+  std::vector<float> nn_sqr_dists;
+  Eigen::ArrayXXd m_averAngles;
+  Eigen::ArrayXXd m_matrix;
+  computeSiForPoint (index, nn_indices, nn_sqr_dists, m_averAngles, m_matrix);
+  return m_matrix;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::SpinImageEstimation<PointInT, PointNT, PointOutT>::computeSiForPoint (
+    int index, std::vector<int> &nn_indices, std::vector<float> &nn_sqr_dists,
+    Eigen::ArrayXXd &m_averAngles, Eigen::ArrayXXd &m_matrix) const
 {
   assert (image_width_ > 0);
   assert (support_angle_cos_ <= 1.0 && support_angle_cos_ >= 0.0); // may be permit negative cosine?
@@ -85,8 +99,8 @@ pcl::SpinImageEstimation<PointInT, PointNT, PointOutT>::computeSiForPoint (int i
       rotation_axes_cloud_->points[index].getNormalVector3fMap () :
       origin_normal;  
 
-  Eigen::ArrayXXd m_matrix (Eigen::ArrayXXd::Zero (image_width_+1, 2*image_width_+1));
-  Eigen::ArrayXXd m_averAngles (Eigen::ArrayXXd::Zero (image_width_+1, 2*image_width_+1));
+  m_matrix.setZero (image_width_+1, 2*image_width_+1);
+  m_averAngles.setZero (image_width_+1, 2*image_width_+1);
 
   // OK, we are interested in the points of the cylinder of height 2*r and
   // base radius r, where r = m_dBinSize * in_iImageWidth
@@ -99,8 +113,6 @@ pcl::SpinImageEstimation<PointInT, PointNT, PointOutT>::computeSiForPoint (int i
   else
     bin_size = search_radius_ / image_width_ / sqrt(2.0);
 
-  std::vector<int> nn_indices;
-  std::vector<float> nn_sqr_dists;
   const int neighb_cnt = this->searchForNeighbors (index, search_radius_, nn_indices, nn_sqr_dists);
   if (neighb_cnt < static_cast<int> (min_pts_neighb_))
   {
@@ -229,8 +241,6 @@ pcl::SpinImageEstimation<PointInT, PointNT, PointOutT>::computeSiForPoint (int i
     // normalization
     m_matrix /= m_matrix.sum();
   }
-
-  return m_matrix;
 }
 
 
@@ -0,0 +1,72 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#ifndef PCL_FEATURES_IMPL_SPIN_IMAGE_OMP_H_
+#define PCL_FEATURES_IMPL_SPIN_IMAGE_OMP_H_
+
+#include <pcl/features/spin_image_omp.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::SpinImageEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  this->computeFeatureParallel (output, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> bool
+pcl::SpinImageEstimationOMP<PointInT, PointNT, PointOutT>::computePointFeature (
+    size_t index, ThreadContext &context, PointOutT &output_point) const
+{
+  Scratch &scratch = static_cast<Scratch&> (*context.scratch);
+  computeSiForPoint ((*indices_)[index], context.nn_indices, context.nn_dists, scratch.aver_angles, scratch.image);
+  const Eigen::ArrayXXd &res = scratch.image;
+
+  // Copy into the resultant point
+  for (int iRow = 0; iRow < res.rows (); iRow++)
+    for (int iCol = 0; iCol < res.cols (); iCol++)
+      output_point.histogram[iRow * res.cols () + iCol] = static_cast<float> (res (iRow, iCol));
+  return (true);
+}
+
+#define PCL_INSTANTIATE_SpinImageEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::SpinImageEstimationOMP<T,NT,OutT>;
+
+#endif    // PCL_FEATURES_IMPL_SPIN_IMAGE_OMP_H_
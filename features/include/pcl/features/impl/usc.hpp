@@ -141,7 +141,21 @@ pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::initCompute ()
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT, typename PointRFT> void
-pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computePointDescriptor (size_t index, /*float rf[9],*/ std::vector<float> &desc)
+pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computePointDescriptor (size_t index, /*float rf[9],*/ std::vector<float> &desc) const
+{
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dists;
+  std::vector<int> density_indices;
+  std::vector<float> density_dists;
+  computePointDescriptor (index, desc, nn_indices, nn_dists, density_indices, density_dists);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename PointRFT> void
+pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computePointDescriptor (
+    size_t index, std::vector<float> &desc,
+    std::vector<int> &nn_indices, std::vector<float> &nn_dists,
+    std::vector<int> &density_indices, std::vector<float> &density_dists) const
 {
   pcl::Vector3fMapConst origin = input_->points[(*indices_)[index]].getVector3fMap ();
 
@@ -154,8 +168,6 @@ pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computePointDescriptor (
                                 frames_->points[index].z_axis[2]);
 
   // Find every point within specified search_radius_
-  std::vector<int> nn_indices;
-  std::vector<float> nn_dists;
   const size_t neighb_cnt = searchForNeighbors ((*indices_)[index], search_radius_, nn_indices, nn_dists);
   // For each point within radius
   for (size_t ne = 0; ne < neighb_cnt; ne++)
@@ -222,9 +234,7 @@ pcl::UniqueShapeContext<PointInT, PointOutT, PointRFT>::computePointDescriptor (
     }
 
     /// Local point density = number of points in a sphere of radius "point_density_radius_" around the current neighbour
-    std::vector<int> neighbour_indices;
-    std::vector<float> neighbour_didtances;
-    float point_density = static_cast<float> (searchForNeighbors (*surface_, nn_indices[ne], point_density_radius_, neighbour_indices, neighbour_didtances));
+    float point_density = static_cast<float> (searchForNeighbors (*surface_, nn_indices[ne], point_density_radius_, density_indices, density_dists));
     /// point_density is always bigger than 0 because FindPointsWithinRadius returns at least the point itself
     float w = (1.0f / point_density) * volume_lut_[(l*elevation_bins_*radius_bins_) +
                                                    (k*radius_bins_) +
@@ -0,0 +1,94 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#ifndef PCL_FEATURES_IMPL_USC_OMP_HPP_
+#define PCL_FEATURES_IMPL_USC_OMP_HPP_
+
+#include <pcl/features/usc_omp.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename PointRFT> void
+pcl::UniqueShapeContextOMP<PointInT, PointOutT, PointRFT>::computeFeature (PointCloudOut &output)
+{
+  assert (descriptor_length_ == 1960);
+
+  this->computeFeatureParallel (output, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename PointRFT> bool
+pcl::UniqueShapeContextOMP<PointInT, PointOutT, PointRFT>::computePointFeature (
+    size_t index, ThreadContext &context, PointOutT &output_point) const
+{
+  // If the point is not finite, set the descriptor to NaN
+  const PointRFT& current_frame = (*frames_)[index];
+  if (!isFinite ((*input_)[(*indices_)[index]]) ||
+      !pcl_isfinite (current_frame.x_axis[0]) ||
+      !pcl_isfinite (current_frame.y_axis[0]) ||
+      !pcl_isfinite (current_frame.z_axis[0])  )
+  {
+    for (size_t i = 0; i < descriptor_length_; ++i)
+      output_point.descriptor[i] = std::numeric_limits<float>::quiet_NaN ();
+
+    memset (output_point.rf, 0, sizeof (output_point.rf[0]) * 9);
+    return (false);
+  }
+
+  for (int d = 0; d < 3; ++d)
+  {
+    output_point.rf[0 + d] = current_frame.x_axis[d];
+    output_point.rf[3 + d] = current_frame.y_axis[d];
+    output_point.rf[6 + d] = current_frame.z_axis[d];
+  }
+
+  Scratch &scratch = static_cast<Scratch&> (*context.scratch);
+  std::vector<float> &descriptor = scratch.descriptor;
+  descriptor.assign (descriptor_length_, 0.0f);
+  computePointDescriptor (index, descriptor, context.nn_indices, context.nn_dists,
+                          scratch.density_indices, scratch.density_dists);
+  for (size_t j = 0; j < descriptor_length_; ++j)
+    output_point.descriptor[j] = descriptor[j];
+  return (true);
+}
+
+#define PCL_INSTANTIATE_UniqueShapeContextOMP(T,OutT,RFT) template class PCL_EXPORTS pcl::UniqueShapeContextOMP<T,OutT,RFT>;
+
+#endif
@@ -101,15 +101,27 @@ namespace pcl
   };
 
   /** \brief Determines an integral image representation for a given organized data array
+    *
+    * The images are built in two passes: running sums along every row, then
+    * running sums down every column. Both passes are split over
+    * setNumberOfThreads () threads and give the same result for any thread count.
+    *
+    * The accumulation type defaults to IntegralImageTypeTraits<DataType>::IntegralType
+    * (double for float data). Passing float halves the memory traffic, but the
+    * prefix sums keep only 24 bits of mantissa: the absolute error of a
+    * rectangle sum grows with the magnitude of the prefix sums at its corners,
+    * i.e. with |value| * x * y. Use it only for data that is small and roughly
+    * zero mean, such as image derivatives.
     * \author Suat Gedikli
     */
-  template <class DataType, unsigned Dimension>
+  template <class DataType, unsigned Dimension,
+            typename IntegralType = typename IntegralImageTypeTraits<DataType>::IntegralType>
   class IntegralImage2D
   {
     public:
       static const unsigned second_order_size = (Dimension * (Dimension + 1)) >> 1;
-      typedef Eigen::Matrix<typename IntegralImageTypeTraits<DataType>::IntegralType, Dimension, 1> ElementType;
-      typedef Eigen::Matrix<typename IntegralImageTypeTraits<DataType>::IntegralType, second_order_size, 1> SecondOrderType;
+      typedef Eigen::Matrix<IntegralType, Dimension, 1> ElementType;
+      typedef Eigen::Matrix<IntegralType, second_order_size, 1> SecondOrderType;
 
       /** \brief Constructor for an Integral Image
         * \param[in] compute_second_order_integral_images set to true if we want to compute a second order image
@@ -120,7 +132,8 @@ namespace pcl
         finite_values_integral_image_ (),
         width_ (1), 
         height_ (1), 
-        compute_second_order_integral_images_ (compute_second_order_integral_images)
+        compute_second_order_integral_images_ (compute_second_order_integral_images),
+        threads_ (1)
       {
       }
 
@@ -128,6 +141,12 @@ namespace pcl
       virtual
       ~IntegralImage2D () { }
 
+      /** \brief Set the number of threads used to build the integral images.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
       /** \brief sets the computation for second order integral images on or off.
         * \param compute_second_order_integral_images
         */
@@ -221,18 +240,21 @@ namespace pcl
 
       /** \brief Indicates whether second order integral images are available **/
       bool compute_second_order_integral_images_;
+
+      /** \brief The number of threads used to build the integral images. */
+      unsigned int threads_;
    };
 
    /**
      * \brief partial template specialization for integral images with just one channel.
      */
-  template <class DataType>
-  class IntegralImage2D <DataType, 1>
+  template <class DataType, typename IntegralType>
+  class IntegralImage2D <DataType, 1, IntegralType>
   {
     public:
       static const unsigned second_order_size = 1;
-      typedef typename IntegralImageTypeTraits<DataType>::IntegralType ElementType;
-      typedef typename IntegralImageTypeTraits<DataType>::IntegralType SecondOrderType;
+      typedef IntegralType ElementType;
+      typedef IntegralType SecondOrderType;
 
       /** \brief Constructor for an Integral Image
         * \param[in] compute_second_order_integral_images set to true if we want to compute a second order image
@@ -242,7 +264,8 @@ namespace pcl
         second_order_integral_image_ (),
         finite_values_integral_image_ (),
         width_ (1), height_ (1), 
-        compute_second_order_integral_images_ (compute_second_order_integral_images)
+        compute_second_order_integral_images_ (compute_second_order_integral_images),
+        threads_ (1)
       {
       }
 
@@ -250,6 +273,12 @@ namespace pcl
       virtual
       ~IntegralImage2D () { }
 
+      /** \brief Set the number of threads used to build the integral images.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
       /** \brief Set the input data to compute the integral image for
         * \param[in] data the input data
         * \param[in] width the width of the data
@@ -337,6 +366,9 @@ namespace pcl
 
       /** \brief Indicates whether second order integral images are available **/
       bool compute_second_order_integral_images_;
+
+      /** \brief The number of threads used to build the integral images. */
+      unsigned int threads_;
    };
  }
 
@@ -117,6 +117,10 @@ namespace pcl
         , integral_image_DY_ (false)
         , integral_image_depth_ (false)
         , integral_image_XYZ_ (true)
+        , integral_image_DX_single_ (false)
+        , integral_image_DY_single_ (false)
+        , single_precision_gradients_ (false)
+        , threads_ (1)
         , diff_x_ (NULL)
         , diff_y_ (NULL)
         , depth_data_ (NULL)
@@ -175,6 +179,32 @@ namespace pcl
       void
       computePointNormalMirror (const int pos_x, const int pos_y, const unsigned point_index, PointOutT &normal);
 
+      /** \brief Set the number of threads used to build the integral images and to estimate the normals.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The result does not depend on the number of threads. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
+      /** \brief Set whether the AVERAGE_3D_GRADIENT integral images accumulate in single instead of double precision.
+        *
+        * This halves the memory traffic of the gradient images. The gradients are differences of neighboring points,
+        * so their prefix sums stay small enough for float: on a 640x480 frame the normal components stay within
+        * 5e-3 of the double precision result. The other methods integrate absolute coordinates (or their squares)
+        * and always use double precision integral images.
+        * \param[in] single_precision true to accumulate the gradient images in float
+        */
+      void
+      setSinglePrecisionGradients (bool single_precision)
+      {
+        if (single_precision != single_precision_gradients_)
+          init_average_3d_gradient_ = false;
+        single_precision_gradients_ = single_precision;
+      }
+
       /** \brief The depth change threshold for computing object borders
         * \param[in] max_depth_change_factor the depth change threshold for computing object borders based on
         * depth changes
@@ -344,6 +374,74 @@ namespace pcl
 
     private:
 
+      /** \brief Computes the normal at the specified position using a given rectangle size.
+        * \param[in] pos_x x position (pixel)
+        * \param[in] pos_y y position (pixel)
+        * \param[in] point_index the position index of the point
+        * \param[in] rect_width the width of the search rectangle
+        * \param[in] rect_height the height of the search rectangle
+        * \param[out] normal the output estimated normal
+        * \note The integral images for the current method must have been initialized.
+        */
+      void
+      computePointNormal (const int pos_x, const int pos_y, const unsigned point_index,
+                          const int rect_width, const int rect_height, PointOutT &normal) const;
+
+      /** \brief Computes the normal at the specified position using a given rectangle size, with mirroring for
+        * border handling.
+        * \param[in] pos_x x position (pixel)
+        * \param[in] pos_y y position (pixel)
+        * \param[in] point_index the position index of the point
+        * \param[in] rect_width the width of the search rectangle
+        * \param[in] rect_height the height of the search rectangle
+        * \param[out] normal the output estimated normal
+        * \note The integral images for the current method must have been initialized.
+        */
+      void
+      computePointNormalMirror (const int pos_x, const int pos_y, const unsigned point_index,
+                                const int rect_width, const int rect_height, PointOutT &normal) const;
+
+      /** \brief Computes the normal of a single pixel, with the rectangle size given by the distance map and the
+        * smoothing settings.
+        * \param[in] pos_x x position (pixel)
+        * \param[in] pos_y y position (pixel)
+        * \param[in] point_index the position index of the point
+        * \param[in] distance_map distance map
+        * \param[out] normal the output estimated normal
+        */
+      void
+      computeSmoothedPointNormal (const int pos_x, const int pos_y, const unsigned point_index,
+                                  const float* distance_map, PointOutT &normal) const;
+
+      /** \brief Sums the horizontal and vertical 3D gradients within a rectangle.
+        * \param[in] integral_image_dx integral image of the horizontal gradients
+        * \param[in] integral_image_dy integral image of the vertical gradients
+        * \param[in] start_x x position of the start of the rectangle
+        * \param[in] start_y y position of the start of the rectangle
+        * \param[in] rect_width the width of the rectangle
+        * \param[in] rect_height the height of the rectangle
+        * \param[in] mirror whether parts of the rectangle outside the image are mirrored back into it
+        * \param[out] gradient_x the sum of the horizontal gradients
+        * \param[out] gradient_y the sum of the vertical gradients
+        * \return false if the rectangle does not contain any finite gradient
+        */
+      template <typename IntegralImageT> bool
+      sumGradients (const IntegralImageT &integral_image_dx, const IntegralImageT &integral_image_dy,
+                    const int start_x, const int start_y, const int rect_width, const int rect_height,
+                    const bool mirror, Eigen::Vector3d &gradient_x, Eigen::Vector3d &gradient_y) const;
+
+      /** \brief Check whether the depth step between two neighboring pixels exceeds the depth change threshold.
+        * \param[in] depth the depth of the pixel
+        * \param[in] neighbor_depth the depth of its right or lower neighbor
+        */
+      inline bool
+      isDepthChange (const float depth, const float neighbor_depth) const
+      {
+        const float depth_dependent_depth_change = max_depth_change_factor_ * (fabsf (depth) + 1.0f) * 2.0f;
+        return (fabsf (depth - neighbor_depth) > depth_dependent_depth_change ||
+                !pcl_isfinite (depth) || !pcl_isfinite (neighbor_depth));
+      }
+
       /** \brief Flip (in place) the estimated normal of a point towards a given viewpoint
         * \param point a given point
         * \param vp_x the X coordinate of the viewpoint
@@ -357,7 +455,7 @@ namespace pcl
       inline void
       flipNormalTowardsViewpoint (const PointInT &point, 
                                   float vp_x, float vp_y, float vp_z,
-                                  float &nx, float &ny, float &nz)
+                                  float &nx, float &ny, float &nz) const
       {
         // See if we need to flip any plane normals
         vp_x -= point.x;
@@ -407,6 +505,16 @@ namespace pcl
       IntegralImage2D<float, 1> integral_image_depth_;
       /** integral image xyz */
       IntegralImage2D<float, 3> integral_image_XYZ_;
+      /** single precision integral image in x-direction */
+      IntegralImage2D<float, 3, float> integral_image_DX_single_;
+      /** single precision integral image in y-direction */
+      IntegralImage2D<float, 3, float> integral_image_DY_single_;
+
+      /** \brief Accumulate the AVERAGE_3D_GRADIENT integral images in single precision (true/false). */
+      bool single_precision_gradients_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
 
       /** derivatives in x-direction */
       float *diff_x_;
@@ -467,6 +575,10 @@ namespace pcl
       void
       initSimple3DGradientMethod ();
 
+      /** \brief Initializes the integral images of the current normal estimation method, unless they are up to date. */
+      void
+      initIntegralImages ();
+
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   };
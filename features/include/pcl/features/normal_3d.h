@@ -43,6 +43,7 @@
 
 #include <pcl/features/feature.h>
 #include <pcl/common/centroid.h>
+#include <pcl/common/eigen.h>
 
 namespace pcl
 {
@@ -219,6 +220,7 @@ namespace pcl
       , covariance_matrix_ ()
       , xyz_centroid_ ()
       , use_sensor_origin_ (true)
+      , batch_size_ (0)
       {
         feature_name_ = "NormalEstimation";
       };
@@ -346,6 +348,18 @@ namespace pcl
         }
       }
       
+      /** \brief Set the number of neighborhoods whose covariance matrices and eigenvectors are solved together.
+        * With a batch size greater than 0 the neighborhoods of that many consecutive points are gathered first and
+        * processed with computeMeanAndCovarianceMatrixBatch and eigen33Batch, which vectorize across neighborhoods.
+        * \param[in] batch_size number of neighborhoods per batch (0 disables batching, default)
+        */
+      inline void
+      setBatchSize (unsigned int batch_size) { batch_size_ = batch_size; }
+
+      /** \brief Get the number of neighborhoods whose covariance matrices and eigenvectors are solved together. */
+      inline unsigned int
+      getBatchSize () const { return (batch_size_); }
+
     protected:
       /** \brief Estimate normals for all points given in <setInputCloud (), setIndices ()> using the surface in
         * setSearchSurface () and the spatial locator in setSearchMethod ()
@@ -355,6 +369,15 @@ namespace pcl
       void
       computeFeature (PointCloudOut &output);
 
+      /** \brief Estimate normals for the points indices_[begin] to indices_[end - 1] as one batch.
+        * \param[in] begin first position in indices_ to process
+        * \param[in] end one past the last position in indices_ to process
+        * \param[out] output the resultant point cloud, only the entries begin to end - 1 are written
+        * \return true if all normals of the batch are finite
+        */
+      bool
+      computeFeatureBatch (int begin, int end, PointCloudOut &output) const;
+
       /** \brief Values describing the viewpoint ("pinhole" camera model assumed). For per point viewpoints, inherit
         * from NormalEstimation and provide your own computeFeature (). By default, the viewpoint is set to 0,0,0. */
       float vpx_, vpy_, vpz_;
@@ -368,6 +391,9 @@ namespace pcl
       /** whether the sensor origin of the input cloud or a user given viewpoint should be used.*/
       bool use_sensor_origin_;
 
+      /** \brief Number of neighborhoods solved together, 0 if batching is disabled. */
+      unsigned int batch_size_;
+
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   };
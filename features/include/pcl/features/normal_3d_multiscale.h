@@ -0,0 +1,146 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#ifndef PCL_NORMAL_3D_MULTISCALE_H_
+#define PCL_NORMAL_3D_MULTISCALE_H_
+
+#include <pcl/features/normal_3d.h>
+
+namespace pcl
+{
+  /** \brief MultiscaleNormalEstimation estimates surface normals and curvatures at several radii at once.
+    *
+    * For every query point a single radius search is run at the largest scale. The neighbors are sorted by
+    * distance once and the first and second order moments of their coordinates are accumulated as prefix sums,
+    * so the covariance matrix of every smaller radius is read off the sums when its distance threshold is
+    * crossed. One output cloud is produced per scale, in the order given to \ref setScales. The results
+    * approximately match running \ref NormalEstimation once per radius with setRadiusSearch (): the moments are
+    * accumulated in double precision around the query point, while NormalEstimation computes the covariance in
+    * single precision. The normal components can differ by up to 1e-2 and the curvatures by up to 1e-3, the
+    * largest differences being found on neighborhoods of only a few points.
+    *
+    * \code
+    * pcl::MultiscaleNormalEstimation<pcl::PointXYZ, pcl::Normal> ne;
+    * ne.setInputCloud (cloud);
+    * std::vector<float> scales;
+    * scales.push_back (0.01f); scales.push_back (0.05f);
+    * ne.setScales (scales);
+    * std::vector<pcl::PointCloud<pcl::Normal>::Ptr> normals;
+    * ne.compute (normals);     // normals[0] at 1cm, normals[1] at 5cm
+    * \endcode
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointOutT>
+  class MultiscaleNormalEstimation: public NormalEstimation<PointInT, PointOutT>
+  {
+    public:
+      typedef boost::shared_ptr<MultiscaleNormalEstimation<PointInT, PointOutT> > Ptr;
+      typedef boost::shared_ptr<const MultiscaleNormalEstimation<PointInT, PointOutT> > ConstPtr;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::getClassName;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::input_;
+      using Feature<PointInT, PointOutT>::surface_;
+      using Feature<PointInT, PointOutT>::k_;
+      using Feature<PointInT, PointOutT>::search_radius_;
+      using Feature<PointInT, PointOutT>::search_parameter_;
+      using Feature<PointInT, PointOutT>::compute;
+      using NormalEstimation<PointInT, PointOutT>::vpx_;
+      using NormalEstimation<PointInT, PointOutT>::vpy_;
+      using NormalEstimation<PointInT, PointOutT>::vpz_;
+
+      typedef typename Feature<PointInT, PointOutT>::PointCloudOut PointCloudOut;
+      typedef typename PointCloudOut::Ptr PointCloudOutPtr;
+
+      /** \brief Empty constructor. */
+      MultiscaleNormalEstimation () : scales_ ()
+      {
+        feature_name_ = "MultiscaleNormalEstimation";
+      }
+
+      /** \brief Set the radii at which the normals are estimated.
+        * \param[in] scales the search radii, in any order
+        */
+      inline void
+      setScales (const std::vector<float> &scales) { scales_ = scales; }
+
+      /** \brief Get the radii at which the normals are estimated. */
+      inline const std::vector<float>&
+      getScales () const { return (scales_); }
+
+      /** \brief Estimate the normals at all scales given by \ref setScales, for all points given in
+        * <setInputCloud (), setIndices ()> using the surface in setSearchSurface () and the spatial locator in
+        * setSearchMethod (). The search radius and K set on the estimator are ignored.
+        * \param[out] outputs one resultant normal cloud per scale, in the order of the scales
+        */
+      void
+      compute (std::vector<PointCloudOutPtr> &outputs);
+
+    protected:
+      /** \brief Estimate the normals of a single point at all scales. The is_dense flag of an output is cleared
+        * if its normal is not finite.
+        * \param[in] index the position of the query point in indices_
+        * \param[in] order the scale indices sorted by increasing radius
+        * \param[in,out] nn_indices neighbor index buffer
+        * \param[in,out] nn_dists neighbor squared distance buffer
+        * \param[in,out] neighbors buffer for the neighbors sorted by squared distance
+        * \param[out] outputs the resultant normal clouds, only the entries at \a index are written
+        */
+      void
+      computePointNormals (size_t index, const std::vector<size_t> &order,
+                           std::vector<int> &nn_indices, std::vector<float> &nn_dists,
+                           std::vector<std::pair<float, int> > &neighbors,
+                           std::vector<PointCloudOutPtr> &outputs) const;
+
+      /** \brief The radii at which the normals are estimated. */
+      std::vector<float> scales_;
+
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/normal_3d_multiscale.hpp>
+#endif
+
+#endif  //#ifndef PCL_NORMAL_3D_MULTISCALE_H_
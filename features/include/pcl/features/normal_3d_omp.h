@@ -67,6 +67,7 @@ namespace pcl
       using NormalEstimation<PointInT, PointOutT>::search_parameter_;
       using NormalEstimation<PointInT, PointOutT>::surface_;
       using NormalEstimation<PointInT, PointOutT>::getViewPoint;
+      using NormalEstimation<PointInT, PointOutT>::batch_size_;
 
       typedef typename NormalEstimation<PointInT, PointOutT>::PointCloudOut PointCloudOut;
 
@@ -0,0 +1,310 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_PFH_OMP_H_
+#define PCL_PFH_OMP_H_
+
+#include <pcl/features/pfh.h>
+#include <pcl/common/atomic.h>
+
+namespace pcl
+{
+  /** \brief Fixed size, open addressing cache of PFH pair features, shared by all the threads of PFHEstimationOMP.
+    *
+    * Entries are keyed on the ordered index pair (p, q). When all slots of a probe window are taken, the first one
+    * is overwritten. Every slot carries a sequence word that is odd while the slot is written: a writer claims the
+    * slot with a compare-and-swap from an even value and releases it with the next even value, and a reader only
+    * accepts an entry if it read the same even sequence before and after copying it. A slot that is busy or changed
+    * during a read is a miss, and a writer that loses the race drops its entry, so no thread ever waits. The cached
+    * values are the ones computePairFeatures () returns, so the result does not depend on the number of threads.
+    *
+    * \ingroup features
+    */
+  class PFHPairFeatureCache
+  {
+    public:
+      /** \brief Empty constructor. */
+      PFHPairFeatureCache () : table_ (), mask_ (0) {}
+
+      /** \brief Allocate the table and remove all entries. Not thread-safe.
+        * \param[in] capacity the number of entries, rounded down to a power of two (at least \a probe_length_)
+        */
+      inline void
+      resize (size_t capacity)
+      {
+        size_t size = probe_length_;
+        while (size * 2 <= capacity)
+          size *= 2;
+        table_.assign (size, Entry ());
+        mask_ = size - 1;
+      }
+
+      /** \brief Remove all entries and release the table memory. Not thread-safe. */
+      inline void
+      clear ()
+      {
+        std::vector<Entry> ().swap (table_);
+        mask_ = 0;
+      }
+
+      /** \brief Get the number of entries the table can hold. */
+      inline size_t
+      capacity () const { return (table_.size ()); }
+
+      /** \brief Look up the pair features of the ordered pair (p, q). Can be called concurrently with insert ().
+        * \param[in] p the index of the first point (source)
+        * \param[in] q the index of the second point (target)
+        * \param[out] tuple the cached pair features
+        * \return true if a complete entry was found
+        */
+      inline bool
+      find (int p, int q, Eigen::Vector4f &tuple)
+      {
+        if (table_.empty ())
+          return (false);
+
+        const size_t home = hash (p, q);
+        Entry entry;
+        for (size_t i = 0; i < probe_length_; ++i)
+        {
+          if (read (table_[(home + i) & mask_], entry) && entry.p == p && entry.q == q)
+          {
+            tuple = Eigen::Vector4f (entry.tuple[0], entry.tuple[1], entry.tuple[2], entry.tuple[3]);
+            return (true);
+          }
+        }
+        return (false);
+      }
+
+      /** \brief Store the pair features of the ordered pair (p, q). Can be called concurrently with find () and
+        * insert (); the entry is dropped if another thread is writing the chosen slot.
+        * \param[in] p the index of the first point (source)
+        * \param[in] q the index of the second point (target)
+        * \param[in] tuple the pair features to store
+        */
+      inline void
+      insert (int p, int q, const Eigen::Vector4f &tuple)
+      {
+        if (table_.empty ())
+          return;
+
+        const size_t home = hash (p, q);
+        size_t slot = home & mask_;
+        Entry entry;
+        for (size_t i = 0; i < probe_length_; ++i)
+        {
+          if (read (table_[(home + i) & mask_], entry) && (entry.p < 0 || (entry.p == p && entry.q == q)))
+          {
+            slot = (home + i) & mask_;
+            break;
+          }
+        }
+
+        Entry &target = table_[slot];
+        int sequence;
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+        sequence = target.sequence;
+        if ((sequence & 1) != 0 || !pcl::detail::compareAndSwap (&target.sequence, sequence, sequence + 1))
+          return;
+
+        target.p = p;
+        target.q = q;
+        for (int d = 0; d < 4; ++d)
+          target.tuple[d] = tuple[d];
+#ifdef _OPENMP
+#pragma omp flush
+#pragma omp atomic write
+#endif
+        target.sequence = sequence + 2;
+      }
+
+    private:
+      /** \brief A cache slot, empty if \a p is -1. \a sequence is odd while the slot is written. */
+      struct Entry
+      {
+        Entry () : sequence (0), p (-1), q (-1)
+        {
+          tuple[0] = tuple[1] = tuple[2] = tuple[3] = 0.0f;
+        }
+        int sequence;
+        int p, q;
+        float tuple[4];
+      };
+
+      /** \brief Copy a slot into \a copy.
+        * \return false if the slot was being written, in which case \a copy may be torn
+        */
+      static inline bool
+      read (const Entry &slot, Entry &copy)
+      {
+        int before, after;
+#ifdef _OPENMP
+#pragma omp atomic read
+#endif
+        before = slot.sequence;
+        if ((before & 1) != 0)
+          return (false);
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+        copy.p = slot.p;
+        copy.q = slot.q;
+        for (int d = 0; d < 4; ++d)
+          copy.tuple[d] = slot.tuple[d];
+#ifdef _OPENMP
+#pragma omp flush
+#pragma omp atomic read
+#endif
+        after = slot.sequence;
+        return (before == after);
+      }
+
+      /** \brief Home slot of the ordered pair (p, q) (64 bit finalizer of MurmurHash3). */
+      inline size_t
+      hash (int p, int q) const
+      {
+        uint64_t key = (static_cast<uint64_t> (static_cast<uint32_t> (p)) << 32) | static_cast<uint32_t> (q);
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return (static_cast<size_t> (key) & mask_);
+      }
+
+      /** \brief Number of consecutive slots searched for a key. */
+      static const size_t probe_length_ = 4;
+
+      /** \brief The slots. */
+      std::vector<Entry> table_;
+
+      /** \brief Table size - 1. */
+      size_t mask_;
+  };
+
+  /** \brief PFHEstimationOMP estimates the Point Feature Histogram (PFH) descriptor for a given point cloud dataset
+    * containing points and normals, in parallel, using the OpenMP standard.
+    *
+    * When the internal cache is enabled (see \ref setUseInternalCache), all threads share one
+    * \ref PFHPairFeatureCache, which they read and write without locks, so a pair computed by one thread is reused
+    * by the others. Its size is derived from the expected number of neighbor pairs and bounded by
+    * \ref setMaximumCacheSize; unlike PFHEstimation it never evicts entries in FIFO order.
+    *
+    * \note If you use this code in any academic work, please cite:
+    *
+    *   - R.B. Rusu, N. Blodow, Z.C. Marton, M. Beetz.
+    *     Aligning Point Cloud Views using Persistent Feature Histograms.
+    *     In Proceedings of the 21st IEEE/RSJ International Conference on Intelligent Robots and Systems (IROS),
+    *     Nice, France, September 22-26 2008.
+    *
+    * \author Radu B. Rusu
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT = pcl::PFHSignature125>
+  class PFHEstimationOMP : public PFHEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      typedef boost::shared_ptr<PFHEstimationOMP<PointInT, PointNT, PointOutT> > Ptr;
+      typedef boost::shared_ptr<const PFHEstimationOMP<PointInT, PointNT, PointOutT> > ConstPtr;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::getClassName;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::k_;
+      using Feature<PointInT, PointOutT>::search_parameter_;
+      using Feature<PointInT, PointOutT>::input_;
+      using Feature<PointInT, PointOutT>::surface_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using PFHEstimation<PointInT, PointNT, PointOutT>::nr_subdiv_;
+      using PFHEstimation<PointInT, PointNT, PointOutT>::d_pi_;
+      using PFHEstimation<PointInT, PointNT, PointOutT>::max_cache_size_;
+      using PFHEstimation<PointInT, PointNT, PointOutT>::use_cache_;
+
+      typedef typename Feature<PointInT, PointOutT>::PointCloudOut PointCloudOut;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      PFHEstimationOMP (unsigned int nr_threads = 0) : threads_ (nr_threads)
+      {
+        feature_name_ = "PFHEstimationOMP";
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+    protected:
+      /** \brief Estimate the PFH signature of a neighborhood without touching any shared scratch data except the
+        * thread-safe \a cache, so that it can be called from several threads at once.
+        * \param[in] cloud the dataset containing the XYZ Cartesian coordinates of the two points
+        * \param[in] normals the dataset containing the surface normals at each point in \a cloud
+        * \param[in] indices the k-neighborhood point indices in the dataset
+        * \param[in] nr_split the number of subdivisions for each angular feature interval
+        * \param[in,out] cache the pair feature cache shared by the threads, used if the internal cache is enabled
+        * \param[out] pfh_histogram the resultant (combinatorial) PFH histogram representing the feature at the query point
+        */
+      void
+      computeSharedPFHSignature (const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
+                                 const std::vector<int> &indices, int nr_split, PFHPairFeatureCache &cache,
+                                 Eigen::VectorXf &pfh_histogram);
+
+    private:
+      /** \brief Estimate the Point Feature Histograms (PFH) descriptors at a set of points given by
+        * <setInputCloud (), setIndices ()> using the surface in setSearchSurface () and the spatial locator in
+        * setSearchMethod ()
+        * \param[out] output the resultant point cloud model dataset that contains the PFH feature estimates
+        */
+      void
+      computeFeature (PointCloudOut &output);
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/pfh_omp.hpp>
+#endif
+
+#endif  //#ifndef PCL_PFH_OMP_H_
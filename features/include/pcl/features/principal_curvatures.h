@@ -43,6 +43,8 @@
 
 #include <pcl/features/eigen.h>
 #include <pcl/features/feature.h>
+#include <pcl/common/centroid.h>
+#include <pcl/common/eigen.h>
 
 namespace pcl
 {
@@ -77,12 +79,8 @@ namespace pcl
 
       /** \brief Empty constructor. */
       PrincipalCurvaturesEstimation () : 
-        projected_normals_ (), 
-        xyz_centroid_ (Eigen::Vector3f::Zero ()), 
-        demean_ (Eigen::Vector3f::Zero ()),
-        covariance_matrix_ (Eigen::Matrix3f::Zero ()),
-        eigenvector_ (Eigen::Vector3f::Zero ()),
-        eigenvalues_ (Eigen::Vector3f::Zero ())
+        batch_size_ (0),
+        projected_normals_ ()
       {
         feature_name_ = "PrincipalCurvaturesEstimation";
       };
@@ -104,6 +102,18 @@ namespace pcl
                                        int p_idx, const std::vector<int> &indices,
                                        float &pcx, float &pcy, float &pcz, float &pc1, float &pc2);
 
+      /** \brief Set the number of neighborhoods whose normal covariance matrices and eigenvectors are solved together.
+        * With a batch size greater than 0 the neighborhoods of that many consecutive points are processed with
+        * computeNormalMeanAndCovarianceMatrixBatch and eigen33Batch. Neighbors with non-finite normals are skipped.
+        * \param[in] batch_size number of neighborhoods per batch (0 disables batching, default)
+        */
+      inline void
+      setBatchSize (unsigned int batch_size) { batch_size_ = batch_size; }
+
+      /** \brief Get the number of neighborhoods whose normal covariance matrices and eigenvectors are solved together. */
+      inline unsigned int
+      getBatchSize () const { return (batch_size_); }
+
     protected:
 
       /** \brief Estimate the principal curvature (eigenvector of the max eigenvalue), along with both the max (pc1)
@@ -114,23 +124,39 @@ namespace pcl
       void
       computeFeature (PointCloudOut &output);
 
-    private:
-      /** \brief A pointer to the input dataset that contains the point normals of the XYZ dataset. */
-      std::vector<Eigen::Vector3f> projected_normals_;
-
-      /** \brief SSE aligned placeholder for the XYZ centroid of a surface patch. */
-      Eigen::Vector3f xyz_centroid_;
+      /** \brief Estimate the principal curvatures for the points indices_[begin] to indices_[end - 1] as one batch.
+        * \param[in] begin first position in indices_ to process
+        * \param[in] end one past the last position in indices_ to process
+        * \param[out] output the resultant point cloud, only the entries begin to end - 1 are written
+        * \return true if all estimates of the batch are finite
+        */
+      bool
+      computeFeatureBatch (int begin, int end, PointCloudOut &output) const;
 
-      /** \brief Temporary point placeholder. */
-      Eigen::Vector3f demean_;
+      /** \brief Perform Principal Components Analysis (PCA) on the point normals of a surface patch without
+        * touching any member, so that it can be called from several threads at once.
+        * \param[in] normals the point cloud normals
+        * \param[in] p_idx the query point at which the least-squares plane was estimated
+        * \param[in] indices the point cloud indices that need to be used
+        * \param[out] projected_normals scratch space for the normals projected into the tangent plane
+        * \param[out] pcx the principal curvature X direction
+        * \param[out] pcy the principal curvature Y direction
+        * \param[out] pcz the principal curvature Z direction
+        * \param[out] pc1 the max eigenvalue of curvature
+        * \param[out] pc2 the min eigenvalue of curvature
+        */
+      void
+      computePointPrincipalCurvatures (const pcl::PointCloud<PointNT> &normals,
+                                       int p_idx, const std::vector<int> &indices,
+                                       std::vector<Eigen::Vector3f> &projected_normals,
+                                       float &pcx, float &pcy, float &pcz, float &pc1, float &pc2) const;
 
-      /** \brief Placeholder for the 3x3 covariance matrix at each surface patch. */
-      EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix_;
+      /** \brief Number of neighborhoods solved together, 0 if batching is disabled. */
+      unsigned int batch_size_;
 
-      /** \brief SSE aligned eigenvectors placeholder for a covariance matrix. */
-      Eigen::Vector3f eigenvector_;
-      /** \brief eigenvalues placeholder for a covariance matrix. */
-      Eigen::Vector3f eigenvalues_;
+    private:
+      /** \brief Placeholder for the normals of a surface patch projected into the tangent plane. */
+      std::vector<Eigen::Vector3f> projected_normals_;
   };
 }
 
@@ -0,0 +1,126 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#ifndef PCL_PRINCIPAL_CURVATURES_OMP_H_
+#define PCL_PRINCIPAL_CURVATURES_OMP_H_
+
+#include <pcl/features/principal_curvatures.h>
+
+namespace pcl
+{
+  /** \brief PrincipalCurvaturesEstimationOMP estimates the directions (eigenvectors) and magnitudes (eigenvalues)
+    * of principal surface curvatures for a given point cloud dataset containing points and normals, in parallel,
+    * using the OpenMP standard.
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT = pcl::PrincipalCurvatures>
+  class PrincipalCurvaturesEstimationOMP : public PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      typedef boost::shared_ptr<PrincipalCurvaturesEstimationOMP<PointInT, PointNT, PointOutT> > Ptr;
+      typedef boost::shared_ptr<const PrincipalCurvaturesEstimationOMP<PointInT, PointNT, PointOutT> > ConstPtr;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::search_parameter_;
+      using Feature<PointInT, PointOutT>::input_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using PrincipalCurvaturesEstimation<PointInT, PointNT, PointOutT>::computePointPrincipalCurvatures;
+
+      typedef typename Feature<PointInT, PointOutT>::PointCloudOut PointCloudOut;
+      typedef typename Feature<PointInT, PointOutT>::ThreadContext ThreadContext;
+      typedef typename Feature<PointInT, PointOutT>::ThreadScratchPtr ThreadScratchPtr;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      PrincipalCurvaturesEstimationOMP (unsigned int nr_threads = 0) : threads_ (nr_threads)
+      {
+        feature_name_ = "PrincipalCurvaturesEstimationOMP";
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+    protected:
+      /** \brief Projected normal buffer of one thread, the neighbors of the point are searched into the
+        * buffers of the \ref ThreadContext.
+        */
+      struct Scratch : public Feature<PointInT, PointOutT>::ThreadScratch
+      {
+        /** \brief The neighbor normals projected onto the tangent plane of the current point. */
+        std::vector<Eigen::Vector3f> projected_normals;
+      };
+
+      /** \brief Estimate the principal curvatures of a single point.
+        * \param[in] index the position of the query point in indices_
+        * \param[in,out] context the scratch state of the calling thread
+        * \param[out] output_point the resultant principal curvatures
+        */
+      virtual bool
+      computePointFeature (size_t index, ThreadContext &context, PointOutT &output_point) const;
+
+      /** \brief Create the projected normal buffer of one thread. */
+      virtual ThreadScratchPtr
+      createThreadScratch () const { return (ThreadScratchPtr (new Scratch)); }
+
+    private:
+      /** \brief Estimate the principal curvature (eigenvector of the max eigenvalue), along with both the max (pc1)
+        * and min (pc2) eigenvalues for all points given in <setInputCloud (), setIndices ()> using the surface in
+        * setSearchSurface () and the spatial locator in setSearchMethod (), in parallel
+        * \param[out] output the resultant point cloud model dataset that contains the principal curvature estimates
+        */
+      void
+      computeFeature (PointCloudOut &output);
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/principal_curvatures_omp.hpp>
+#endif
+
+#endif  //#ifndef PCL_PRINCIPAL_CURVATURES_OMP_H_
@@ -115,7 +115,33 @@ namespace pcl
       void
       getTriangles (std::vector <pcl::Vertices>& triangles) const;
 
-    private:
+    protected:
+
+      /** \brief Buffers used while computing the descriptor of one point, so that they can be reused across
+        * the points.
+        */
+      struct DescriptorBuffers
+      {
+        /** \brief Indices of the triangles of the local surface. */
+        std::set <unsigned int> local_triangles;
+
+        /** \brief Local surface in the LRF of the point. */
+        PointCloudIn transformed_cloud;
+
+        /** \brief Local surface rotated around one of the LRF axes. */
+        PointCloudIn rotated_cloud;
+
+        /** \brief Distribution matrix of one projection. */
+        Eigen::MatrixXf distribution_matrix;
+
+        /** \brief Central moments of one distribution matrix. */
+        std::vector <float> moments;
+
+        /** \brief The descriptor before normalization. */
+        std::vector <float> feature;
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+      };
 
       /** \brief Abstract feature estimation method.
         * \param[out] output the resultant features
@@ -123,6 +149,26 @@ namespace pcl
       virtual void
       computeFeature (PointCloudOut& output);
 
+      /** \brief Computes the RoPS descriptor of a single point. Only reads the members, so it can be called
+        * concurrently once buildListOfPointsTriangles () has been run.
+        * \param[in] point point for which the descriptor is computed
+        * \param[out] output_point the resultant descriptor
+        */
+      void
+      computePointDescriptor (const PointInT& point, PointOutT& output_point) const;
+
+      /** \brief Computes the RoPS descriptor of a single point into caller owned buffers. Only reads the members,
+        * so it can be called concurrently once buildListOfPointsTriangles () has been run.
+        * \param[in] point point for which the descriptor is computed
+        * \param[out] local_points buffer for the indices of the points of the local surface
+        * \param[out] distances buffer for the squared distances of the points of the local surface
+        * \param[out] buffers the other buffers used by the computation
+        * \param[out] output_point the resultant descriptor
+        */
+      void
+      computePointDescriptor (const PointInT& point, std::vector <int>& local_points, std::vector <float>& distances,
+                              DescriptorBuffers& buffers, PointOutT& output_point) const;
+
       /** \brief This method simply builds the list of triangles for every point.
         * The list of triangles for each point consists of indices of triangles it belongs to.
         * The only purpose of this method is to improve perfomance of the algorithm.
@@ -138,6 +184,17 @@ namespace pcl
       void
       getLocalSurface (const PointInT& point, std::set <unsigned int>& local_triangles, std::vector <int>& local_points) const;
 
+      /** \brief This method crops all the triangles within the given radius of the given point, searching into
+        * a caller owned distance buffer.
+        * \param[in] point point for which the local surface is computed
+        * \param[out] local_triangles strores the indices of the triangles that belong to the local surface
+        * \param[out] local_points stores the indices of the points that belong to the local surface
+        * \param[out] distances stores the squared distances of the points that belong to the local surface
+        */
+      void
+      getLocalSurface (const PointInT& point, std::set <unsigned int>& local_triangles, std::vector <int>& local_points,
+                       std::vector <float>& distances) const;
+
       /** \brief This method computes LRF (Local Reference Frame) matrix for the given point.
         * \param[in] point point for which the LRF is computed
         * \param[in] local_triangles list of triangles that represents the local surface of the point
@@ -198,7 +255,7 @@ namespace pcl
       void
       computeCentralMoments (const Eigen::MatrixXf& matrix, std::vector <float>& moments) const;
 
-    private:
+    protected:
 
       /** \brief Stores the number of partition bins that is used for distribution matrix calculation. */
       unsigned int number_of_bins_;
@@ -0,0 +1,123 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#ifndef PCL_ROPS_ESTIMATION_OMP_H_
+#define PCL_ROPS_ESTIMATION_OMP_H_
+
+#include <pcl/features/rops_estimation.h>
+
+namespace pcl
+{
+  /** \brief ROPSEstimationOMP extracts the RoPS features described in \ref ROPSEstimation, in parallel,
+    * using the OpenMP standard.
+    */
+  template <typename PointInT, typename PointOutT>
+  class ROPSEstimationOMP : public ROPSEstimation <PointInT, PointOutT>
+  {
+    public:
+
+      using Feature <PointInT, PointOutT>::input_;
+      using Feature <PointInT, PointOutT>::indices_;
+      using ROPSEstimation <PointInT, PointOutT>::triangles_;
+      using ROPSEstimation <PointInT, PointOutT>::buildListOfPointsTriangles;
+      using ROPSEstimation <PointInT, PointOutT>::computePointDescriptor;
+
+      typedef typename pcl::Feature <PointInT, PointOutT>::PointCloudOut PointCloudOut;
+      typedef typename pcl::Feature <PointInT, PointOutT>::ThreadContext ThreadContext;
+      typedef typename pcl::Feature <PointInT, PointOutT>::ThreadScratchPtr ThreadScratchPtr;
+      typedef typename pcl::ROPSEstimation <PointInT, PointOutT>::DescriptorBuffers DescriptorBuffers;
+
+    public:
+
+      /** \brief Simple constructor.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      ROPSEstimationOMP (unsigned int nr_threads = 0) : threads_ (nr_threads) {}
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+    protected:
+
+      /** \brief Descriptor buffers of one thread, the local surface is searched into the neighbor buffers of
+        * the \ref ThreadContext.
+        */
+      struct Scratch : public pcl::Feature <PointInT, PointOutT>::ThreadScratch
+      {
+        /** \brief The buffers of the descriptor computation. */
+        DescriptorBuffers buffers;
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+      };
+
+      /** \brief Computes the descriptor of a single point.
+        * \param[in] index the position of the query point in indices_
+        * \param[in,out] context the scratch state of the calling thread
+        * \param[out] output_point the resultant descriptor
+        */
+      virtual bool
+      computePointFeature (size_t index, ThreadContext &context, PointOutT &output_point) const;
+
+      /** \brief Create the descriptor buffers of one thread. */
+      virtual ThreadScratchPtr
+      createThreadScratch () const { return (ThreadScratchPtr (new Scratch)); }
+
+    private:
+
+      /** \brief Builds the list of triangles of every point, then computes the features in parallel.
+        * \param[out] output the resultant features
+        */
+      virtual void
+      computeFeature (PointCloudOut& output);
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/rops_estimation_omp.hpp>
+#endif
+
+#endif  //#ifndef PCL_ROPS_ESTIMATION_OMP_H_
@@ -166,6 +166,87 @@ namespace pcl
       createBinDistanceShape (int index, const std::vector<int> &indices,
                               std::vector<double> &bin_distance_shape);
 
+      /** \brief Spatial binning of a neighborhood, shared by the shape and the color histograms: for each
+        * neighbor, the volume (grid sector) it falls in, the adjacent volumes it is interpolated with along
+        * the radial, inclination and azimuth directions, and the corresponding weights. Neighbors that do
+        * not vote have a volume of -1; a missing interpolation partner has the neighbor's own volume and a
+        * zero weight.
+        */
+      struct SpatialBins
+      {
+        std::vector<int> volume;
+        std::vector<int> radial_volume;
+        std::vector<int> inclination_volume;
+        std::vector<int> azimuth_volume;
+        std::vector<float> weight;
+        std::vector<float> radial_weight;
+        std::vector<float> inclination_weight;
+        std::vector<float> azimuth_weight;
+      };
+
+      /** \brief Compute the spatial bins of a neighborhood. Four neighbors are processed at a time when SSE2
+        * is available, unless PCL is built with PCL_SHOT_NO_SSE2 defined; otherwise this is
+        * computeSpatialBinsScalar. The SSE2 arctangent differs from atan2f by a few ulps, so the weights of
+        * the two paths agree to about 1e-6 while the volumes are the same.
+        * \param[in] indices the neighborhood point indices
+        * \param[in] sqr_dists the neighborhood point distances
+        * \param[in] index the index of the point in indices_
+        * \param[out] bins the resultant spatial bins
+        */
+      void
+      computeSpatialBins (const std::vector<int> &indices,
+                          const std::vector<float> &sqr_dists,
+                          const int index,
+                          SpatialBins &bins) const;
+
+      /** \brief Compute the spatial bins of a neighborhood one neighbor at a time. Always compiled, so that
+        * the SSE2 path of computeSpatialBins can be checked against it.
+        * \param[in] indices the neighborhood point indices
+        * \param[in] sqr_dists the neighborhood point distances
+        * \param[in] index the index of the point in indices_
+        * \param[out] bins the resultant spatial bins
+        */
+      void
+      computeSpatialBinsScalar (const std::vector<int> &indices,
+                                const std::vector<float> &sqr_dists,
+                                const int index,
+                                SpatialBins &bins) const;
+
+      /** \brief Compute the offsets and distances of the neighbors from the point, padded with
+        * zero distance entries to a multiple of four, and size the spatial bins accordingly.
+        * \param[in] indices the neighborhood point indices
+        * \param[in] sqr_dists the neighborhood point distances
+        * \param[in] index the index of the point in indices_
+        * \param[out] delta_x the x offsets of the neighbors
+        * \param[out] delta_y the y offsets of the neighbors
+        * \param[out] delta_z the z offsets of the neighbors
+        * \param[out] distances the distances of the neighbors
+        * \param[out] bins the spatial bins, resized to the padded neighborhood size
+        */
+      void
+      gatherNeighbors (const std::vector<int> &indices,
+                       const std::vector<float> &sqr_dists,
+                       const int index,
+                       std::vector<float> &delta_x,
+                       std::vector<float> &delta_y,
+                       std::vector<float> &delta_z,
+                       std::vector<float> &distances,
+                       SpatialBins &bins) const;
+
+      /** \brief Add the votes of a neighborhood to one (shape or color) histogram of the descriptor.
+        * \param[in] bins the spatial bins of the neighborhood
+        * \param[in] binDistance the histogram bin activated by each neighbor; NaN entries are skipped
+        * \param[in] nr_bins the number of bins in the histogram
+        * \param[in] offset the position of the histogram in the descriptor
+        * \param[out] shot the resultant SHOT histogram
+        */
+      void
+      accumulateHistogram (const SpatialBins &bins,
+                           const std::vector<double> &binDistance,
+                           const int nr_bins,
+                           const int offset,
+                           Eigen::VectorXf &shot) const;
+
       /** \brief The number of bins in each shape histogram. */
       int nr_shape_bins_;
 
@@ -322,6 +403,7 @@ namespace pcl
       using FeatureWithLocalReferenceFrames<PointInT, PointRFT>::frames_;
 
       typedef typename Feature<PointInT, PointOutT>::PointCloudIn PointCloudIn;
+      typedef typename SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT>::SpatialBins SpatialBins;
 
       /** \brief Empty constructor.
         * \param[in] describe_shape
@@ -332,7 +414,8 @@ namespace pcl
         : SHOTEstimationBase<PointInT, PointNT, PointOutT, PointRFT> (10),
           b_describe_shape_ (describe_shape),
           b_describe_color_ (describe_color),
-          nr_color_bins_ (30)
+          nr_color_bins_ (30),
+          surface_lab_ ()
       {
         feature_name_ = "SHOTColorEstimation";
       };
@@ -380,6 +463,12 @@ namespace pcl
                                 const int nr_bins_color,
                                 Eigen::VectorXf &shot);
 
+      /** \brief Convert the colors of the search surface to normalized CIELab, once per cloud instead of
+        * once per neighbor of every point.
+        */
+      void
+      computeSurfaceLAB ();
+
       /** \brief Compute shape descriptor. */
       bool b_describe_shape_;
 
@@ -389,6 +478,9 @@ namespace pcl
       /** \brief The number of bins in each color histogram. */
       int nr_color_bins_;
 
+      /** \brief Normalized CIELab color (0<L<1, -1<a<1, -1<b<1) of each point of the search surface. */
+      std::vector<Eigen::Vector3f> surface_lab_;
+
     public:
       /** \brief Converts RGB triplets to CIELab space.
         * \param[in] R the red channel
@@ -262,6 +262,19 @@ namespace pcl
       Eigen::ArrayXXd 
       computeSiForPoint (int index) const;
 
+      /** \brief Computes a spin-image for the point of the scan into caller owned buffers, which are resized
+        * only when the image width changes. Does not modify the estimator and can be called from several
+        * threads.
+        * \param[in] index the index of the reference point in the input cloud
+        * \param[out] nn_indices buffer for the indices of the support points
+        * \param[out] nn_sqr_dists buffer for the squared distances of the support points
+        * \param[out] aver_angles buffer for the accumulated angles between normals
+        * \param[out] image the estimated spin-image (or its variant)
+        */
+      void
+      computeSiForPoint (int index, std::vector<int> &nn_indices, std::vector<float> &nn_sqr_dists,
+                         Eigen::ArrayXXd &aver_angles, Eigen::ArrayXXd &image) const;
+
     private:
       PointCloudNConstPtr input_normals_;
       PointCloudNConstPtr rotation_axes_cloud_;
@@ -0,0 +1,137 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2009, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#ifndef PCL_SPIN_IMAGE_OMP_H_
+#define PCL_SPIN_IMAGE_OMP_H_
+
+#include <pcl/features/spin_image.h>
+
+namespace pcl
+{
+  /** \brief SpinImageEstimationOMP estimates the Spin Image descriptor for a given point cloud dataset containing
+    * points and normals, in parallel, using the OpenMP standard.
+    *
+    * The points are distributed over the threads by \ref Feature::computeFeatureParallel. If the support of a
+    * point is too small, the first pcl::PCLException raised by any thread is rethrown once all threads finished.
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT>
+  class SpinImageEstimationOMP : public SpinImageEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      typedef boost::shared_ptr<SpinImageEstimationOMP<PointInT, PointNT, PointOutT> > Ptr;
+      typedef boost::shared_ptr<const SpinImageEstimationOMP<PointInT, PointNT, PointOutT> > ConstPtr;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::indices_;
+      using SpinImageEstimation<PointInT, PointNT, PointOutT>::computeSiForPoint;
+
+      typedef typename Feature<PointInT, PointOutT>::PointCloudOut PointCloudOut;
+      typedef typename Feature<PointInT, PointOutT>::ThreadContext ThreadContext;
+      typedef typename Feature<PointInT, PointOutT>::ThreadScratchPtr ThreadScratchPtr;
+
+      /** \brief Constructs empty spin image estimator.
+        * \param[in] image_width spin-image resolution, number of bins along one dimension
+        * \param[in] support_angle_cos minimal allowed cosine of the angle between
+        *   the normals of input point and search surface point for the point
+        *   to be retained in the support
+        * \param[in] min_pts_neighb min number of points in the support to correctly estimate
+        *   spin-image. If at some point the support contains less points, exception is thrown
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      SpinImageEstimationOMP (unsigned int image_width = 8,
+                              double support_angle_cos = 0.0,
+                              unsigned int min_pts_neighb = 0,
+                              unsigned int nr_threads = 0) :
+        SpinImageEstimation<PointInT, PointNT, PointOutT> (image_width, support_angle_cos, min_pts_neighb),
+        threads_ (nr_threads)
+      {
+        feature_name_ = "SpinImageEstimationOMP";
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
+    protected:
+      /** \brief Spin image buffers of one thread, the support is searched into the neighbor buffers of the
+        * \ref ThreadContext.
+        */
+      struct Scratch : public Feature<PointInT, PointOutT>::ThreadScratch
+      {
+        /** \brief Accumulated angles between the normals. */
+        Eigen::ArrayXXd aver_angles;
+
+        /** \brief The spin image of the current point. */
+        Eigen::ArrayXXd image;
+      };
+
+      /** \brief Estimate the spin image of a single point.
+        * \param[in] index the position of the query point in indices_
+        * \param[in,out] context the scratch state of the calling thread
+        * \param[out] output_point the resultant spin image
+        */
+      virtual bool
+      computePointFeature (size_t index, ThreadContext &context, PointOutT &output_point) const;
+
+      /** \brief Create the spin image buffers of one thread. */
+      virtual ThreadScratchPtr
+      createThreadScratch () const { return (ThreadScratchPtr (new Scratch)); }
+
+    private:
+      /** \brief Estimate the Spin Image descriptors in parallel.
+        * \param[out] output the resultant point cloud that contains the Spin Image feature estimates
+        */
+      virtual void
+      computeFeature (PointCloudOut &output);
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/spin_image_omp.hpp>
+#endif
+
+#endif  //#ifndef PCL_SPIN_IMAGE_OMP_H_
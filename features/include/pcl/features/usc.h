@@ -143,7 +143,21 @@ namespace pcl
         * \param[out] desc descriptor to compute
         */
       void
-      computePointDescriptor (size_t index, std::vector<float> &desc);
+      computePointDescriptor (size_t index, std::vector<float> &desc) const;
+
+      /** Compute 3D shape context feature descriptor, searching into caller owned buffers so that it can be
+        * called from several threads without allocating per point
+        * \param[in] index point index in input_
+        * \param[out] desc descriptor to compute, accumulated into, so it must be zero on input
+        * \param[out] nn_indices buffer for the indices of the neighbors of the point
+        * \param[out] nn_dists buffer for the squared distances of the neighbors of the point
+        * \param[out] density_indices buffer for the indices of the neighbors used for the local point density
+        * \param[out] density_dists buffer for the squared distances of the neighbors used for the local point density
+        */
+      void
+      computePointDescriptor (size_t index, std::vector<float> &desc,
+                              std::vector<int> &nn_indices, std::vector<float> &nn_dists,
+                              std::vector<int> &density_indices, std::vector<float> &density_dists) const;
 
       /** \brief Initialize computation by allocating all the intervals and the volume lookup table. */
       virtual bool
@@ -38,6 +38,7 @@
 
 #include <pcl/features/pfh_tools.h>
 #include <pcl/features/impl/pfh.hpp>
+#include <pcl/features/impl/pfh_omp.hpp>
 #include <pcl/features/impl/pfhrgb.hpp>
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -169,11 +170,13 @@ pcl::computeRGBPairFeatures (const Eigen::Vector4f &p1, const Eigen::Vector4f &n
 // Instantiations of specific point types
 #ifdef PCL_ONLY_CORE_POINT_TYPES
   PCL_INSTANTIATE_PRODUCT(PFHEstimation, ((pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGB)(pcl::PointXYZRGBA))((pcl::Normal))((pcl::PFHSignature125)))
+  PCL_INSTANTIATE_PRODUCT(PFHEstimationOMP, ((pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGB)(pcl::PointXYZRGBA))((pcl::Normal))((pcl::PFHSignature125)))
   PCL_INSTANTIATE_PRODUCT(PFHRGBEstimation, ((pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
                           ((pcl::Normal)(pcl::PointXYZRGBNormal))
                           ((pcl::PFHRGBSignature250)))
 #else
   PCL_INSTANTIATE_PRODUCT(PFHEstimation, (PCL_XYZ_POINT_TYPES)(PCL_NORMAL_POINT_TYPES)((pcl::PFHSignature125)))
+  PCL_INSTANTIATE_PRODUCT(PFHEstimationOMP, (PCL_XYZ_POINT_TYPES)(PCL_NORMAL_POINT_TYPES)((pcl::PFHSignature125)))
   PCL_INSTANTIATE_PRODUCT(PFHRGBEstimation, ((pcl::PointXYZRGB)(pcl::PointXYZRGBA)(pcl::PointXYZRGBNormal))
                           (PCL_NORMAL_POINT_TYPES)
                           ((pcl::PFHRGBSignature250)))
@@ -39,6 +39,7 @@
 
 #include <pcl/features/rops_estimation.h>
 #include <pcl/features/impl/rops_estimation.hpp>
+#include <pcl/features/impl/rops_estimation_omp.hpp>
 
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/point_types.h>
@@ -46,7 +47,9 @@
 // Instantiations of specific point types
 #ifdef PCL_ONLY_CORE_POINT_TYPES
   PCL_INSTANTIATE_PRODUCT(ROPSEstimation, ((pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointNormal))((pcl::Histogram<135>)))
+  PCL_INSTANTIATE_PRODUCT(ROPSEstimationOMP, ((pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointNormal))((pcl::Histogram<135>)))
 #else
   PCL_INSTANTIATE_PRODUCT(ROPSEstimation, (PCL_XYZ_POINT_TYPES)((pcl::Histogram<135>)))
+  PCL_INSTANTIATE_PRODUCT(ROPSEstimationOMP, (PCL_XYZ_POINT_TYPES)((pcl::Histogram<135>)))
 #endif
 #endif    // PCL_NO_PRECOMPILE
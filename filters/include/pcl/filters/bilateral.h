@@ -72,7 +72,9 @@ namespace pcl
         */
       BilateralFilter () : sigma_s_ (0), 
                            sigma_r_ (std::numeric_limits<double>::max ()),
-                           tree_ ()
+                           tree_ (),
+                           use_lattice_ (false),
+                           threads_ (1)
       {
       }
 
@@ -123,8 +125,40 @@ namespace pcl
       setSearchMethod (const KdTreePtr &tree)
       { tree_ = tree; }
 
+      /** \brief Set whether the filter response is approximated on a permutohedral lattice.
+        * \details The lattice (see pcl::Permutohedral) splats the intensities of all the points in the joint
+        * (x, y, z, intensity) space scaled by the two standard deviations, blurs them and interpolates the
+        * result back. Its cost grows linearly with the number of points and does not depend on the window
+        * size, but the result only approximates the Gaussian kernels and is not truncated to the window.
+        * No search method is used in that case. The lattice is implemented in pcl_ml, which is why pcl_filters
+        * depends on the ml module.
+        * \param[in] use_lattice true to use the permutohedral lattice, false to compute the exact response (default)
+        */
+      inline void
+      setUsePermutohedralLattice (bool use_lattice)
+      { use_lattice_ = use_lattice; }
+
+      /** \brief Get whether the filter response is approximated on a permutohedral lattice. */
+      inline bool
+      getUsePermutohedralLattice () const
+      { return (use_lattice_); }
+
+      /** \brief Set the number of threads used for the exact filter response.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The result does not depend on the number of threads. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      { threads_ = nr_threads; }
+
     private:
 
+      /** \brief Approximate the filter response of all the points on a permutohedral lattice.
+        * \param[out] output the resultant point cloud, already containing a copy of the input
+        */
+      void
+      applyLatticeFilter (PointCloud &output);
+
       /** \brief The bilateral filter Gaussian distance kernel.
         * \param[in] x the spatial distance (distance or intensity)
         * \param[in] sigma standard deviation
@@ -140,6 +174,12 @@ namespace pcl
 
       /** \brief A pointer to the spatial search object. */
       KdTreePtr tree_;
+
+      /** \brief Whether the response is approximated on a permutohedral lattice. */
+      bool use_lattice_;
+
+      /** \brief The number of threads the exact response is computed with. */
+      unsigned int threads_;
   };
 }
 
@@ -439,6 +439,8 @@ namespace pcl
       Eigen::Vector4f tf_comp_vect_;
   };
   
+  template<typename PointT> class ConditionalRemoval;
+
   //////////////////////////////////////////////////////////////////////////////////////////
   /** \brief Base condition class. */
   template<typename PointT>
@@ -501,6 +503,8 @@ namespace pcl
 
       /** \brief The collection of all conditions that need to be verified. */
       std::vector<Ptr> conditions_;
+
+      friend class ConditionalRemoval<PointT>;
   };
 
   //////////////////////////////////////////////////////////////////////////////////////////
@@ -617,7 +621,7 @@ namespace pcl
         */
       ConditionalRemoval (int extract_removed_indices = false) :
         Filter<PointT>::Filter (extract_removed_indices), capable_ (false), keep_organized_ (false), condition_ (),
-        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ())
+        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ()), program_ (), threads_ (1)
       {
         filter_name_ = "ConditionalRemoval";
       }
@@ -631,7 +635,7 @@ namespace pcl
       "please use the setCondition (ConditionBasePtr condition) function instead.")
       ConditionalRemoval (ConditionBasePtr condition, bool extract_removed_indices = false) :
         Filter<PointT>::Filter (extract_removed_indices), capable_ (false), keep_organized_ (false), condition_ (),
-        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ())
+        user_filter_value_ (std::numeric_limits<float>::quiet_NaN ()), program_ (), threads_ (1)
       {
         filter_name_ = "ConditionalRemoval";
         setCondition (condition);
@@ -677,13 +681,77 @@ namespace pcl
       void
       setCondition (ConditionBasePtr condition);
 
+      /** \brief Set the number of threads used to evaluate the condition.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note All comparisons of the condition must be safe to evaluate concurrently when more than
+        * one thread is used. The output does not depend on the number of threads. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
     protected:
+      typedef typename ConditionBase::ComparisonBase ComparisonBase;
+
+      /** \brief The final results of the compiled program. */
+      enum { PROGRAM_TRUE = -1, PROGRAM_FALSE = -2 };
+
+      /** \brief One step of a condition compiled by compileCondition (). The comparison, or the
+        * condition when it is not a plain ConditionAnd or ConditionOr, is evaluated and the program
+        * continues at on_true or on_false. Negative targets end the program, see evaluateProgram ().
+        */
+      struct Instruction
+      {
+        const ComparisonBase *comparison;
+        const ConditionBase *condition;
+        int on_true;
+        int on_false;
+      };
+
       /** \brief Filter a Point Cloud.
         * \param output the resultant point cloud message
         */
       void
       applyFilter (PointCloud &output);
 
+      /** \brief Flatten the condition tree into program_, so that a point is evaluated with a single loop
+        * instead of a recursion through the nested conditions. The comparisons are evaluated in the same
+        * order and with the same short-circuiting as ConditionBase::evaluate ().
+        * \return the index of the first instruction, or the final result if no instruction is needed
+        */
+      int
+      compileCondition ();
+
+      /** \brief Append the instructions for one comparison or condition of the tree to program_.
+        * \param[in] comparison the comparison to compile, or NULL if condition is to be compiled
+        * \param[in] condition the condition to compile, if comparison is NULL
+        * \param[in] on_true the instruction to continue at if the item evaluates to true
+        * \param[in] on_false the instruction to continue at if the item evaluates to false
+        * \return the index of the first instruction of the item
+        */
+      int
+      compileItem (const ComparisonBase *comparison, const ConditionBase *condition, int on_true, int on_false);
+
+      /** \brief Run the compiled condition on a point.
+        * \param[in] entry the first instruction, as returned by compileCondition ()
+        * \param[in] point the point to evaluate
+        */
+      inline bool
+      evaluateProgram (int entry, const PointT &point) const
+      {
+        int next = entry;
+        while (next >= 0)
+        {
+          const Instruction &instruction = program_[next];
+          bool result = instruction.comparison ? instruction.comparison->evaluate (point) : instruction.condition->evaluate (point);
+          next = result ? instruction.on_true : instruction.on_false;
+        }
+        return (next == PROGRAM_TRUE);
+      }
+
+
       /** \brief True if capable. */
       bool capable_;
 
@@ -699,6 +767,12 @@ namespace pcl
         * the correct field type. 
         */
       float user_filter_value_;
+
+      /** \brief The compiled condition, rebuilt on every call to applyFilter (). */
+      std::vector<Instruction> program_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
   };
 }
 
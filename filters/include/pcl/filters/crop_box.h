@@ -42,11 +42,72 @@
 
 #include <pcl/point_types.h>
 #include <pcl/filters/filter_indices.h>
+#include <pcl/filters/conditional_removal.h>
 #include <pcl/common/transforms.h>
 #include <pcl/common/eigen.h>
 
 namespace pcl
 {
+  /** \brief The per-point test of CropBox as a condition: a point meets it when it is finite and inside the box
+    * (outside of it, if negative). CropBox evaluates it for every point, FilterPipeline evaluates it together with
+    * other conditions in a single sweep.
+    * \ingroup filters
+    */
+  template<typename PointT>
+  class CropBoxCondition : public ConditionBase<PointT>
+  {
+    public:
+      typedef boost::shared_ptr<CropBoxCondition<PointT> > Ptr;
+      typedef boost::shared_ptr<const CropBoxCondition<PointT> > ConstPtr;
+
+      /** \brief Constructor, see the setters of CropBox for the meaning of the parameters.
+        * \param[in] min_pt the minimum point of the box
+        * \param[in] max_pt the maximum point of the box
+        * \param[in] rotation the rotation of the box
+        * \param[in] translation the translation of the box
+        * \param[in] transform the transformation applied to the points
+        * \param[in] negative true to let the points outside of the box pass instead
+        */
+      CropBoxCondition (const Eigen::Vector4f &min_pt, const Eigen::Vector4f &max_pt,
+                        const Eigen::Vector3f &rotation, const Eigen::Vector3f &translation,
+                        const Eigen::Affine3f &transform, bool negative);
+
+      /** \brief Determine if a point meets this condition.
+        * \return whether the point meets this condition.
+        */
+      virtual bool
+      evaluate (const PointT &point) const;
+
+      /** \brief Test whether a point is inside the box, without checking that it is finite.
+        * \param[in] point the point to test
+        */
+      bool
+      isInside (const PointT &point) const;
+
+    protected:
+      /** \brief The minimum point of the box. */
+      Eigen::Vector3f min_pt_;
+      /** \brief The maximum point of the box. */
+      Eigen::Vector3f max_pt_;
+      /** \brief The 3D translation for the box. */
+      Eigen::Vector3f translation_;
+      /** \brief The affine transform applied to the points. */
+      Eigen::Affine3f transform_;
+      /** \brief The inverse of the rotation of the box. */
+      Eigen::Affine3f inverse_transform_;
+      /** \brief True if transform_ is not the identity. */
+      bool apply_transform_;
+      /** \brief True if translation_ is not zero. */
+      bool apply_translation_;
+      /** \brief True if inverse_transform_ is not the identity. */
+      bool apply_inverse_transform_;
+      /** \brief True if the points outside of the box pass. */
+      bool negative_;
+
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
   /** \brief CropBox is a filter that allows the user to filter all the data
     * inside of a given box.
     *
@@ -76,7 +137,8 @@ namespace pcl
         max_pt_ (Eigen::Vector4f (1, 1, 1, 1)),
         rotation_ (Eigen::Vector3f::Zero ()),
         translation_ (Eigen::Vector3f::Zero ()),
-        transform_ (Eigen::Affine3f::Identity ())
+        transform_ (Eigen::Affine3f::Identity ()),
+        threads_ (1)
       {
         filter_name_ = "CropBox";
       }
@@ -165,6 +227,24 @@ namespace pcl
         return (transform_);
       }
 
+      /** \brief Get the test this filter applies to every point, with its current settings. */
+      inline typename CropBoxCondition<PointT>::Ptr
+      getCondition () const
+      {
+        return (typename CropBoxCondition<PointT>::Ptr (new CropBoxCondition<PointT> (
+            min_pt_, max_pt_, rotation_, translation_, transform_, negative_)));
+      }
+
+      /** \brief Set the number of threads used to test the points against the box.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The output does not depend on the number of threads. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
     protected:
       using PCLBase<PointT>::input_;
       using PCLBase<PointT>::indices_;
@@ -198,6 +278,8 @@ namespace pcl
       Eigen::Vector3f translation_;
       /** \brief The affine transform applied to the cloud. */
       Eigen::Affine3f transform_;
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
   };
 
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
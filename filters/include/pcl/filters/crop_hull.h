@@ -70,7 +70,8 @@ namespace pcl
         hull_polygons_(),
         hull_cloud_(),
         dim_(3),
-        crop_outside_(true)
+        crop_outside_(true),
+        threads_(1)
       {
         filter_name_ = "CropHull";
       }
@@ -131,6 +132,16 @@ namespace pcl
         crop_outside_ = crop_outside;
       }
 
+      /** \brief Set the number of threads used to test the points against the hull.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The output does not depend on the number of threads. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
     protected:
       /** \brief Filter the input points using the 2D or 3D polygon hull.
         * \param[out] output The set of points that passed the filter
@@ -145,6 +156,57 @@ namespace pcl
       applyFilter (std::vector<int> &indices);
 
     private:  
+      /** \brief A uniform grid over the hull polygons, projected on the plane spanned by two axes. Every
+        * cell stores the polygons whose projected bounding box overlaps it, so that a point is only tested
+        * against the polygons that can contain it (2D) or be crossed by a ray along the grid normal (3D).
+        */
+      struct PolygonGrid
+      {
+        /** \brief The projection axes. */
+        Eigen::Vector3f axis_u, axis_v;
+        /** \brief The extent of the grid in projected coordinates. */
+        float min_u, max_u, min_v, max_v;
+        /** \brief The inverse of the cell size along each axis. */
+        float inverse_cell_u, inverse_cell_v;
+        /** \brief The number of cells along each axis. */
+        int cells_u, cells_v;
+        /** \brief The polygons of cell i are cell_polygons[cell_offsets[i]] .. cell_polygons[cell_offsets[i + 1] - 1]. */
+        std::vector<int> cell_offsets, cell_polygons;
+      };
+
+      /** \brief Build a PolygonGrid over hull_polygons_.
+        * \param[in] axis_u the first projection axis
+        * \param[in] axis_v the second projection axis
+        * \param[out] grid the resulting grid
+        */
+      void
+      buildPolygonGrid (const Eigen::Vector3f &axis_u, const Eigen::Vector3f &axis_v, PolygonGrid &grid) const;
+
+      /** \brief Collect the polygons of all grid cells that overlap a rectangle in projected coordinates.
+        * Every polygon is reported once, in increasing order.
+        * \param[in] grid the polygon grid
+        * \param[in] min_u the lower bound of the rectangle along the first axis
+        * \param[in] max_u the upper bound of the rectangle along the first axis
+        * \param[in] min_v the lower bound of the rectangle along the second axis
+        * \param[in] max_v the upper bound of the rectangle along the second axis
+        * \param[out] candidates the indices of the candidate polygons
+        */
+      static void
+      getCandidatePolygons (const PolygonGrid &grid, float min_u, float max_u, float min_v, float max_v,
+                            std::vector<int> &candidates);
+
+      /** \brief Decide for every input index whether it passes the 2D polygon filter.
+        * \param[out] keep the result for each entry of indices_
+        */
+      template<unsigned PlaneDim1, unsigned PlaneDim2> void
+      classify2D (std::vector<unsigned char> &keep);
+
+      /** \brief Decide for every input index whether it passes the 3D hull filter.
+        * \param[out] keep the result for each entry of indices_
+        */
+      void
+      classify3D (std::vector<unsigned char> &keep);
+
       /** \brief Return the size of the hull point cloud in line with coordinate axes.
         * This is used to choose the 2D projection to use when cropping to a 2d
         * polygon.
@@ -232,6 +294,9 @@ namespace pcl
        * false, those inside will be removed.
        */
       bool crop_outside_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
   };
 
 } // namespace pcl
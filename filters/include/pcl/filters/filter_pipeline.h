@@ -0,0 +1,284 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef PCL_FILTERS_FILTER_PIPELINE_H_
+#define PCL_FILTERS_FILTER_PIPELINE_H_
+
+#include <pcl/filters/filter_indices.h>
+#include <pcl/filters/conditional_removal.h>
+#include <pcl/filters/passthrough.h>
+#include <pcl/filters/crop_box.h>
+#include <pcl/search/search.h>
+
+namespace pcl
+{
+  /** \brief FilterPipeline runs a chain of filters on a point cloud without materializing a point cloud
+    * after every stage.
+    *
+    * The stages are executed in the order in which they are added:
+    *  - conditions (\a addCondition): evaluated on the current points;
+    *  - point filters (\a addPointFilter): FilterIndices whose decision for a point only depends on the point
+    *    itself (PassThrough, CropBox, CropHull, ...). PassThrough and CropBox are evaluated through their
+    *    per-point test (PassThroughCondition, CropBoxCondition), like conditions. The other point filters are
+    *    run on the current points, given as indices into the current cloud, and no intermediate cloud is
+    *    created;
+    *  - neighborhood filters (\a addNeighborhoodFilter): FilterIndices which look at the neighbors of a point
+    *    (StatisticalOutlierRemoval, RadiusOutlierRemoval, ...). The current points are compacted into a cloud
+    *    first, so that only surviving points are considered as neighbors. The search method given through
+    *    \a setSearchMethod is built once for that cloud and can be shared by all neighborhood filters that
+    *    were given the same search method with index reuse enabled (see
+    *    StatisticalOutlierRemoval::setSearchMethod);
+    *  - reductions (\a addReduction): filters that create new points (VoxelGrid, ...). They are applied on the
+    *    current points and their output becomes the current cloud.
+    *
+    * Consecutive conditions, PassThrough and CropBox stages are fused: they are evaluated together in a single
+    * (multi-threaded) sweep over the current points, and reported as one stage. No other stage is fused.
+    *
+    * The result is identical to applying the filters one after the other. The time spent in every stage,
+    * together with the number of points entering and leaving it, is available through \a getStageReports
+    * after each call to filter ().
+    * \ingroup filters
+    */
+  template<typename PointT>
+  class FilterPipeline : public Filter<PointT>
+  {
+    using Filter<PointT>::filter_name_;
+    using Filter<PointT>::getClassName;
+    using Filter<PointT>::indices_;
+    using Filter<PointT>::input_;
+
+    typedef typename Filter<PointT>::PointCloud PointCloud;
+    typedef typename PointCloud::Ptr PointCloudPtr;
+    typedef typename PointCloud::ConstPtr PointCloudConstPtr;
+
+    public:
+
+      typedef boost::shared_ptr< FilterPipeline<PointT> > Ptr;
+      typedef boost::shared_ptr< const FilterPipeline<PointT> > ConstPtr;
+
+      typedef typename pcl::ConditionBase<PointT>::Ptr ConditionBasePtr;
+      typedef typename pcl::FilterIndices<PointT>::Ptr FilterIndicesPtr;
+      typedef typename pcl::Filter<PointT>::Ptr FilterPtr;
+      typedef typename pcl::search::Search<PointT>::Ptr SearcherPtr;
+
+      /** \brief Timing and size information of one executed stage. */
+      struct StageReport
+      {
+        /** \brief The name of the stage, fused conditions are reported as one stage with their names joined. */
+        std::string name;
+        /** \brief The time spent in the stage, in milliseconds. */
+        double time;
+        /** \brief The number of points entering the stage. */
+        size_t points_in;
+        /** \brief The number of points leaving the stage. */
+        size_t points_out;
+      };
+
+      /** \brief Empty constructor. */
+      FilterPipeline () :
+        stages_ (),
+        reports_ (),
+        searcher_ (),
+        threads_ (1)
+      {
+        filter_name_ = "FilterPipeline";
+      }
+
+      /** \brief Add a condition, points for which it evaluates to false are removed.
+        * \param[in] name the name of the stage used in the reports
+        * \param[in] condition the condition
+        * \note The condition is evaluated concurrently when more than one thread is used.
+        */
+      inline void
+      addCondition (const std::string &name, const ConditionBasePtr &condition)
+      {
+        Stage stage (name, CONDITION);
+        stage.condition = condition;
+        stages_.push_back (stage);
+      }
+
+      /** \brief Add a filter that keeps or removes each point independently of the other points.
+        * \param[in] name the name of the stage used in the reports
+        * \param[in] filter the filter, its input cloud and indices are set by the pipeline
+        */
+      inline void
+      addPointFilter (const std::string &name, const FilterIndicesPtr &filter)
+      {
+        Stage stage (name, POINT_FILTER);
+        stage.point_filter = filter;
+        stages_.push_back (stage);
+      }
+
+      /** \brief Add a filter that looks at the neighborhood of each point.
+        * \param[in] name the name of the stage used in the reports
+        * \param[in] filter the filter, its input cloud is set by the pipeline
+        */
+      inline void
+      addNeighborhoodFilter (const std::string &name, const FilterIndicesPtr &filter)
+      {
+        Stage stage (name, NEIGHBORHOOD_FILTER);
+        stage.point_filter = filter;
+        stages_.push_back (stage);
+      }
+
+      /** \brief Add a filter that replaces the current points by new ones (e.g. a VoxelGrid).
+        * \param[in] name the name of the stage used in the reports
+        * \param[in] filter the filter, its input cloud and indices are set by the pipeline
+        */
+      inline void
+      addReduction (const std::string &name, const FilterPtr &filter)
+      {
+        Stage stage (name, REDUCTION);
+        stage.reduction = filter;
+        stages_.push_back (stage);
+      }
+
+      /** \brief Remove all stages. */
+      inline void
+      clear ()
+      {
+        stages_.clear ();
+        reports_.clear ();
+      }
+
+      /** \brief Provide the search method that is shared by the neighborhood filters. The pipeline sets its
+        * input cloud to the compacted points before a neighborhood filter is run, so the filters configured
+        * with the same search method and index reuse enabled do not build their own. The compacted points
+        * are owned by the pipeline, so the shared index cannot go stale.
+        * \param[in] searcher the search method, or an empty pointer to let every filter use its own
+        */
+      inline void
+      setSearchMethod (const SearcherPtr &searcher)
+      {
+        searcher_ = searcher;
+      }
+
+      /** \brief Get the search method shared by the neighborhood filters. */
+      inline SearcherPtr
+      getSearchMethod () const
+      {
+        return (searcher_);
+      }
+
+      /** \brief Set the number of threads used to evaluate the conditions and the fused point filters.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The filters added to the pipeline use their own settings. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
+      /** \brief Get the reports of the stages executed during the last call to filter (). */
+      inline const std::vector<StageReport>&
+      getStageReports () const
+      {
+        return (reports_);
+      }
+
+    protected:
+
+      /** \brief The kind of a stage. */
+      enum StageType
+      {
+        CONDITION,
+        POINT_FILTER,
+        NEIGHBORHOOD_FILTER,
+        REDUCTION
+      };
+
+      /** \brief A stage of the pipeline, only the member matching its type is set. */
+      struct Stage
+      {
+        Stage (const std::string &stage_name, StageType stage_type) :
+          name (stage_name), type (stage_type), condition (), point_filter (), reduction ()
+        {
+        }
+
+        std::string name;
+        StageType type;
+        ConditionBasePtr condition;
+        FilterIndicesPtr point_filter;
+        FilterPtr reduction;
+      };
+
+      /** \brief The stages, in order of execution. */
+      std::vector<Stage> stages_;
+
+      /** \brief The reports of the last execution. */
+      std::vector<StageReport> reports_;
+
+      /** \brief The search method shared by the neighborhood filters. */
+      SearcherPtr searcher_;
+
+      /** \brief The number of threads the fused stages are evaluated with. */
+      unsigned int threads_;
+
+      /** \brief Run the pipeline.
+        * \param[out] output the resultant point cloud
+        */
+      void
+      applyFilter (PointCloud &output);
+
+      /** \brief Get the per-point test of a stage: the condition of a condition stage, or the condition of a
+        * PassThrough or CropBox point filter with its current settings. Empty for the other stages.
+        * \param[in] stage the stage
+        */
+      ConditionBasePtr
+      getStageCondition (const Stage &stage) const;
+
+      /** \brief Evaluate the conditions of the stages [first, last) in a single sweep and keep the points
+        * passing all of them.
+        * \param[in] cloud the current cloud
+        * \param[in,out] indices the current points of \a cloud
+        * \param[in] conditions the per-point tests of all stages
+        * \param[in] first the first fused stage
+        * \param[in] last one past the last fused stage
+        */
+      void
+      applyConditions (const PointCloud &cloud, std::vector<int> &indices,
+                       const std::vector<ConditionBasePtr> &conditions, size_t first, size_t last);
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/filters/impl/filter_pipeline.hpp>
+#endif
+
+#endif  // PCL_FILTERS_FILTER_PIPELINE_H_
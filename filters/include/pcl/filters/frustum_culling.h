@@ -43,6 +43,7 @@
 #include <pcl/filters/filter_indices.h>
 #include <pcl/common/transforms.h>
 #include <pcl/common/eigen.h>
+#include <pcl/filters/boost.h>
 
 namespace pcl
 {
@@ -70,6 +71,9 @@ namespace pcl
    * fc.filter (target);
    * \endcode
    *
+   * The same cloud can be culled against several cameras sharing the field of view and the
+   * near/far planes in a single pass over the points with \ref computeVisibility.
+   *
    *
    * \author Aravindhan K Krishnan
    * \ingroup filters
@@ -86,6 +90,7 @@ namespace pcl
       typedef boost::shared_ptr< FrustumCulling<PointT> > Ptr;
       typedef boost::shared_ptr< const FrustumCulling<PointT> > ConstPtr;
 
+      typedef std::vector<Eigen::Matrix4f, Eigen::aligned_allocator<Eigen::Matrix4f> > CameraPoses;
 
       using Filter<PointT>::getClassName;
 
@@ -96,6 +101,8 @@ namespace pcl
         , vfov_ (60.0f)
         , np_dist_ (0.1f)
         , fp_dist_ (5.0f)
+        , use_block_culling_ (true)
+        , threads_ (1)
       {
         filter_name_ = "FrustumCulling";
       }
@@ -195,9 +202,51 @@ namespace pcl
         return (fp_dist_);
       }
 
+      /** \brief Set whether runs of consecutive points are first tested as a whole against the frustum.
+        * \param[in] use_block_culling true to reject or accept a block of points through its bounding box
+        * \note Only blocks lying clearly inside or outside of the frustum are decided from their bounding
+        * box, the result is the same as testing every point. This pays off for clouds stored in scan or
+        * grid order, where consecutive points are close to each other. The default is true.
+        */
+      inline void
+      setUseBlockCulling (bool use_block_culling)
+      {
+        use_block_culling_ = use_block_culling;
+      }
+
+      /** \brief Get whether runs of consecutive points are first tested as a whole against the frustum. */
+      inline bool
+      getUseBlockCulling () const
+      {
+        return (use_block_culling_);
+      }
+
+      /** \brief Set the number of threads used to test the points against the frustum.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The result does not depend on the number of threads. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
+      /** \brief Test the input points against the frusta of several cameras in a single pass.
+        * All the cameras share the field of view and the near and far plane distances of this filter,
+        * the camera pose set through \ref setCameraPose is not used.
+        * \param[in] camera_poses the poses of the cameras w.r.t the origin
+        * \param[out] visibility one mask per camera, bit i is set if the point (*indices_)[i] lies inside
+        * the frustum of that camera (the negative flag is not applied)
+        */
+      void
+      computeVisibility (const CameraPoses &camera_poses,
+                         std::vector<boost::dynamic_bitset<> > &visibility);
+
     protected:
       using PCLBase<PointT>::input_;
       using PCLBase<PointT>::indices_;
+      using PCLBase<PointT>::initCompute;
+      using PCLBase<PointT>::deinitCompute;
       using Filter<PointT>::filter_name_;
       using FilterIndices<PointT>::negative_;
       using FilterIndices<PointT>::keep_organized_;
@@ -217,6 +266,36 @@ namespace pcl
       void
       applyFilter (std::vector<int> &indices);
 
+      /** \brief The six bounding planes of a frustum, stored column-wise as (a, b, c, d) with
+        * a * x + b * y + c * z + d <= 0 for the points inside.
+        */
+      typedef Eigen::Matrix<float, 4, 6> FrustumPlanes;
+      typedef std::vector<FrustumPlanes, Eigen::aligned_allocator<FrustumPlanes> > FrustumPlanesVector;
+      typedef boost::dynamic_bitset<>::block_type Block;
+
+      /** \brief Compute the bounding planes of the frustum of a camera.
+        * \param[in] camera_pose the camera pose
+        * \param[out] planes the left, right, top, bottom, far and near planes
+        */
+      void
+      computePlanes (const Eigen::Matrix4f &camera_pose, FrustumPlanes &planes) const;
+
+      /** \brief Test the input points against a set of frusta, one bit per point and frustum.
+        * \param[in] planes the bounding planes of every frustum
+        * \param[out] blocks the masks of every frustum, packed into blocks of bits
+        */
+      void
+      computeBlocks (const FrustumPlanesVector &planes, std::vector<std::vector<Block> > &blocks) const;
+
+      /** \brief Test a run of at most one block worth of consecutive indices against a frustum.
+        * \param[in] planes the bounding planes of the frustum
+        * \param[in] begin the position of the first point in indices_
+        * \param[in] count the number of points to test
+        * \return the mask of the points inside the frustum
+        */
+      Block
+      testPoints (const FrustumPlanes &planes, size_t begin, size_t count) const;
+
     private:
 
       /** \brief The camera pose */
@@ -229,6 +308,10 @@ namespace pcl
       float np_dist_;
       /** \brief Far plane distance */
       float fp_dist_;
+      /** \brief Whether blocks of consecutive points are first tested through their bounding box */
+      bool use_block_culling_;
+      /** \brief The number of threads the scheduler should use */
+      unsigned int threads_;
 
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -41,6 +41,7 @@
 #define PCL_FILTERS_BILATERAL_IMPL_H_
 
 #include <pcl/filters/bilateral.h>
+#include <pcl/ml/permutohedral.h>
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> double
@@ -78,6 +79,14 @@ pcl::BilateralFilter<PointT>::applyFilter (PointCloud &output)
     PCL_ERROR ("[pcl::BilateralFilter::applyFilter] Need a sigma_s value given before continuing.\n");
     return;
   }
+
+  if (use_lattice_)
+  {
+    output = *input_;
+    applyLatticeFilter (output);
+    return;
+  }
+
   // In case a search method has not been given, initialize it using some defaults
   if (!tree_)
   {
@@ -90,20 +99,77 @@ pcl::BilateralFilter<PointT>::applyFilter (PointCloud &output)
   }
   tree_->setInputCloud (input_);
 
-  std::vector<int> k_indices;
-  std::vector<float> k_distances;
-
   // Copy the input data into the output
   output = *input_;
 
-  // For all the indices given (equal to the entire cloud if none given)
-  for (size_t i = 0; i < indices_->size (); ++i)
+  // For all the indices given (equal to the entire cloud if none given). The averages are computed from
+  // the input intensities only, so the points are independent of each other.
+  const int nr_indices = static_cast<int> (indices_->size ());
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
   {
-    // Perform a radius search to find the nearest neighbors
-    tree_->radiusSearch ((*indices_)[i], sigma_s_ * 2, k_indices, k_distances);
+    std::vector<int> k_indices;
+    std::vector<float> k_distances;
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 256)
+#endif
+    for (int i = 0; i < nr_indices; ++i)
+    {
+      // Perform a radius search to find the nearest neighbors
+      tree_->radiusSearch ((*indices_)[i], sigma_s_ * 2, k_indices, k_distances);
 
-    // Overwrite the intensity value with the computed average
-    output.points[(*indices_)[i]].intensity = static_cast<float> (computePointWeight ((*indices_)[i], k_indices, k_distances));
+      // Overwrite the intensity value with the computed average
+      output.points[(*indices_)[i]].intensity = static_cast<float> (computePointWeight ((*indices_)[i], k_indices, k_distances));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::BilateralFilter<PointT>::applyLatticeFilter (PointCloud &output)
+{
+  // Only the finite points take part, the features are scaled so that the lattice blur corresponds
+  // to the two Gaussian kernels
+  std::vector<int> lattice_points;
+  lattice_points.reserve (input_->points.size ());
+  for (size_t i = 0; i < input_->points.size (); ++i)
+    if (pcl::isFinite (input_->points[i]) && pcl_isfinite (input_->points[i].intensity))
+      lattice_points.push_back (static_cast<int> (i));
+  if (lattice_points.empty ())
+    return;
+
+  const int nr_points = static_cast<int> (lattice_points.size ());
+  const float inv_sigma_s = static_cast<float> (1.0 / sigma_s_);
+  const float inv_sigma_r = static_cast<float> (1.0 / sigma_r_);
+  std::vector<float> features (4 * nr_points);
+  // The homogeneous coordinate gives the sum of the weights
+  std::vector<float> values (2 * nr_points);
+  for (int i = 0; i < nr_points; ++i)
+  {
+    const PointT &point = input_->points[lattice_points[i]];
+    features[4 * i + 0] = point.x * inv_sigma_s;
+    features[4 * i + 1] = point.y * inv_sigma_s;
+    features[4 * i + 2] = point.z * inv_sigma_s;
+    features[4 * i + 3] = point.intensity * inv_sigma_r;
+    values[2 * i + 0] = point.intensity;
+    values[2 * i + 1] = 1.0f;
+  }
+
+  pcl::Permutohedral lattice;
+  lattice.init (features, 4, nr_points);
+  std::vector<float> filtered (2 * nr_points);
+  lattice.compute (filtered, values, 2);
+
+  // Map the cloud indices to the lattice points and write the response of the requested points only
+  std::vector<int> lattice_index (input_->points.size (), -1);
+  for (int i = 0; i < nr_points; ++i)
+    lattice_index[lattice_points[i]] = i;
+  for (size_t i = 0; i < indices_->size (); ++i)
+  {
+    const int idx = lattice_index[(*indices_)[i]];
+    if (idx != -1 && filtered[2 * idx + 1] > 0.0f)
+      output.points[(*indices_)[i]].intensity = filtered[2 * idx] / filtered[2 * idx + 1];
   }
 }
  
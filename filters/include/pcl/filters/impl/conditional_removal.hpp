@@ -41,6 +41,7 @@
 #include <pcl/common/io.h>
 #include <pcl/common/copy_point.h>
 #include <pcl/filters/conditional_removal.h>
+#include <typeinfo>
 
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
@@ -301,55 +302,43 @@ pcl::PackedHSIComparison<PointT>::PackedHSIComparison (
 template <typename PointT> bool
 pcl::PackedHSIComparison<PointT>::evaluate (const PointT &point) const
 {
-  // Since this is a const function, we can't make these data members because we change them here
-  static uint32_t rgb_val_ = 0;
-  static uint8_t r_ = 0;
-  static uint8_t g_ = 0;
-  static uint8_t b_ = 0;
-  static int8_t h_ = 0;
-  static uint8_t s_ = 0;
-  static uint8_t i_ = 0;
-
   // We know that rgb data is 32 bit aligned (verified in the ctor) so...
   const uint8_t* pt_data = reinterpret_cast<const uint8_t*> (&point);
   const uint32_t* rgb_data = reinterpret_cast<const uint32_t*> (pt_data + rgb_offset_);
-  uint32_t new_rgb_val = *rgb_data;
-
-  if (rgb_val_ != new_rgb_val) 
-  { // avoid having to redo this calc, if possible
-    rgb_val_ = new_rgb_val;
-    // extract r,g,b
-    r_ = static_cast <uint8_t> (rgb_val_ >> 16); 
-    g_ = static_cast <uint8_t> (rgb_val_ >> 8);
-    b_ = static_cast <uint8_t> (rgb_val_);
-
-    // definitions taken from http://en.wikipedia.org/wiki/HSL_and_HSI
-    float hx = (2.0f * r_ - g_ - b_) / 4.0f;  // hue x component -127 to 127
-    float hy = static_cast<float> (g_ - b_) * 111.0f / 255.0f; // hue y component -111 to 111
-    h_ = static_cast<int8_t> (atan2(hy, hx) * 128.0f / M_PI);
-
-    int32_t i = (r_+g_+b_)/3; // 0 to 255
-    i_ = static_cast<uint8_t> (i);
+  uint32_t rgb_val = *rgb_data;
 
-    int32_t m;  // min(r,g,b)
-    m = (r_ < g_) ? r_ : g_;
-    m = (m < b_) ? m : b_;
-
-    s_ = static_cast<uint8_t> ((i == 0) ? 0 : 255 - (m * 255) / i); // saturation 0 to 255
-  }
+  // The components are computed for every point rather than cached between calls, so that the
+  // comparison can be evaluated from several threads at once
+  // extract r,g,b
+  uint8_t r = static_cast <uint8_t> (rgb_val >> 16); 
+  uint8_t g = static_cast <uint8_t> (rgb_val >> 8);
+  uint8_t b = static_cast <uint8_t> (rgb_val);
 
   float my_val = 0;
 
   switch (component_id_) 
   {
     case H:
-      my_val = static_cast <float> (h_);
+    {
+      // definitions taken from http://en.wikipedia.org/wiki/HSL_and_HSI
+      float hx = (2.0f * r - g - b) / 4.0f;  // hue x component -127 to 127
+      float hy = static_cast<float> (g - b) * 111.0f / 255.0f; // hue y component -111 to 111
+      my_val = static_cast <float> (static_cast<int8_t> (atan2(hy, hx) * 128.0f / M_PI));
       break;
+    }
     case S:
-      my_val = static_cast <float> (s_);
+    {
+      int32_t i = (r+g+b)/3; // 0 to 255
+
+      int32_t m;  // min(r,g,b)
+      m = (r < g) ? r : g;
+      m = (m < b) ? m : b;
+
+      my_val = static_cast <float> (static_cast<uint8_t> ((i == 0) ? 0 : 255 - (m * 255) / i)); // saturation 0 to 255
       break;
+    }
     case I:
-      my_val = static_cast <float> (i_);
+      my_val = static_cast <float> (static_cast<uint8_t> ((r+g+b)/3));
       break;
     default:
       assert (false);
@@ -666,6 +655,53 @@ pcl::ConditionalRemoval<PointT>::setCondition (ConditionBasePtr condition)
   capable_ = condition_->isCapable ();
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::ConditionalRemoval<PointT>::compileCondition ()
+{
+  program_.clear ();
+  return (compileItem (NULL, condition_.get (), PROGRAM_TRUE, PROGRAM_FALSE));
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::ConditionalRemoval<PointT>::compileItem (const ComparisonBase *comparison, const ConditionBase *condition,
+                                              int on_true, int on_false)
+{
+  // plain ConditionAnd and ConditionOr nodes are resolved into jumps, the items are compiled back to
+  // front so that the entry of the following item is known
+  bool is_and = condition && typeid (*condition) == typeid (pcl::ConditionAnd<PointT>);
+  bool is_or = condition && typeid (*condition) == typeid (pcl::ConditionOr<PointT>);
+  if (comparison || (!is_and && !is_or))
+  {
+    Instruction instruction;
+    instruction.comparison = comparison;
+    instruction.condition = condition;
+    instruction.on_true = on_true;
+    instruction.on_false = on_false;
+    program_.push_back (instruction);
+    return (static_cast<int> (program_.size ()) - 1);
+  }
+
+  const std::vector<typename ComparisonBase::ConstPtr> &comparisons = condition->comparisons_;
+  const std::vector<ConditionBasePtr> &conditions = condition->conditions_;
+
+  // an empty condition is always true
+  if (comparisons.empty () && conditions.empty ())
+    return (on_true);
+
+  // ConditionAnd: every item continues with the next one when true and stops when false,
+  // ConditionOr: every item stops when true and continues with the next one when false
+  int next = is_and ? on_true : on_false;
+  for (size_t i = conditions.size (); i-- > 0; )
+    next = is_and ? compileItem (NULL, conditions[i].get (), next, on_false)
+                  : compileItem (NULL, conditions[i].get (), on_true, next);
+  for (size_t i = comparisons.size (); i-- > 0; )
+    next = is_and ? compileItem (comparisons[i].get (), NULL, next, on_false)
+                  : compileItem (comparisons[i].get (), NULL, on_true, next);
+  return (next);
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
@@ -707,33 +743,37 @@ pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
   int nr_p = 0;
   int nr_removed_p = 0;
 
+  // The condition is evaluated in parallel into a per point flag, the output is then assembled serially
+  const int entry = compileCondition ();
+  const std::vector<int> &indices = *Filter<PointT>::indices_;
+
   if (!keep_organized_)
   {
-    for (size_t cp = 0; cp < Filter<PointT>::indices_->size (); ++cp)
+    const int nr_indices = static_cast<int> (indices.size ());
+    std::vector<unsigned char> passed (nr_indices, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (static)
+#endif
+    for (int cp = 0; cp < nr_indices; ++cp)
     {
-      // Check if the point is invalid
-      if (!pcl_isfinite (input_->points[(*Filter < PointT > ::indices_)[cp]].x)
-          || !pcl_isfinite (input_->points[(*Filter < PointT > ::indices_)[cp]].y)
-          || !pcl_isfinite (input_->points[(*Filter < PointT > ::indices_)[cp]].z))
-      {
-        if (extract_removed_indices_)
-        {
-          (*removed_indices_)[nr_removed_p] = (*Filter<PointT>::indices_)[cp];
-          nr_removed_p++;
-        }
-        continue;
-      }
+      const PointT &point = input_->points[indices[cp]];
+      // Invalid points are always removed
+      if (pcl_isfinite (point.x) && pcl_isfinite (point.y) && pcl_isfinite (point.z))
+        passed[cp] = evaluateProgram (entry, point);
+    }
 
-      if (condition_->evaluate (input_->points[(*Filter < PointT > ::indices_)[cp]]))
+    for (int cp = 0; cp < nr_indices; ++cp)
+    {
+      if (passed[cp])
       {
-        copyPoint (input_->points[(*Filter < PointT > ::indices_)[cp]], output.points[nr_p]);
+        copyPoint (input_->points[indices[cp]], output.points[nr_p]);
         nr_p++;
       }
       else
       {
         if (extract_removed_indices_)
         {
-          (*removed_indices_)[nr_removed_p] = (*Filter<PointT>::indices_)[cp];
+          (*removed_indices_)[nr_removed_p] = indices[cp];
           nr_removed_p++;
         }
       }
@@ -744,25 +784,36 @@ pcl::ConditionalRemoval<PointT>::applyFilter (PointCloud &output)
   }
   else
   {
-    std::vector<int> indices = *Filter<PointT>::indices_;
-    std::sort (indices.begin (), indices.end ());   //TODO: is this necessary or can we assume the indices to be sorted?
+    const int nr_points = static_cast<int> (input_->points.size ());
+    std::vector<unsigned char> passed (nr_points, 0);
+    for (size_t i = 0; i < indices.size (); ++i)
+      passed[indices[i]] = 1;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (static)
+#endif
+    for (int cp = 0; cp < nr_points; ++cp)
+      if (passed[cp])
+        passed[cp] = evaluateProgram (entry, input_->points[cp]);
+
+    std::vector<int> sorted_indices = indices;
+    std::sort (sorted_indices.begin (), sorted_indices.end ());   //TODO: is this necessary or can we assume the indices to be sorted?
     bool removed_p = false;
     size_t ci = 0;
     for (size_t cp = 0; cp < input_->points.size (); ++cp)
     {
-      if (cp == static_cast<size_t> (indices[ci]))
+      if (cp == static_cast<size_t> (sorted_indices[ci]))
       {
-        if (ci < indices.size () - 1)
+        if (ci < sorted_indices.size () - 1)
         {
           ci++;
-          if (cp == static_cast<size_t> (indices[ci]))   //check whether the next index will have the same value. TODO: necessary?
+          if (cp == static_cast<size_t> (sorted_indices[ci]))   //check whether the next index will have the same value. TODO: necessary?
             continue;
         }
 
         // copy all the fields
         copyPoint (input_->points[cp], output.points[cp]);
 
-        if (!condition_->evaluate (input_->points[cp]))
+        if (!passed[cp])
         {
           output.points[cp].getVector4fMap ().setConstant (user_filter_value_);
           removed_p = true;
@@ -43,6 +43,63 @@
 #include <pcl/filters/crop_box.h>
 #include <pcl/common/io.h>
 
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT>
+pcl::CropBoxCondition<PointT>::CropBoxCondition (const Eigen::Vector4f &min_pt, const Eigen::Vector4f &max_pt,
+                                                 const Eigen::Vector3f &rotation,
+                                                 const Eigen::Vector3f &translation,
+                                                 const Eigen::Affine3f &transform, bool negative) :
+  min_pt_ (min_pt.head<3> ()),
+  max_pt_ (max_pt.head<3> ()),
+  translation_ (translation),
+  transform_ (transform),
+  inverse_transform_ (Eigen::Affine3f::Identity ()),
+  negative_ (negative)
+{
+  if (rotation != Eigen::Vector3f::Zero ())
+  {
+    Eigen::Affine3f box_transform;
+    pcl::getTransformation (0, 0, 0,
+                            rotation (0), rotation (1), rotation (2),
+                            box_transform);
+    inverse_transform_ = box_transform.inverse ();
+  }
+
+  // the identity tests are hoisted out of the point tests
+  apply_transform_ = !(transform_.matrix ().isIdentity ());
+  apply_translation_ = (translation_ != Eigen::Vector3f::Zero ());
+  apply_inverse_transform_ = !(inverse_transform_.matrix ().isIdentity ());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT> bool
+pcl::CropBoxCondition<PointT>::isInside (const PointT &point) const
+{
+  // Get local point
+  Eigen::Vector3f local_pt = point.getVector3fMap ();
+
+  // Transform point to world space
+  if (apply_transform_)
+    local_pt = transform_ * local_pt;
+
+  if (apply_translation_)
+    local_pt -= translation_;
+
+  // Transform point to local space of crop box
+  if (apply_inverse_transform_)
+    local_pt = inverse_transform_ * local_pt;
+
+  return (!(local_pt.array () < min_pt_.array ()).any () && !(local_pt.array () > max_pt_.array ()).any ());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename PointT> bool
+pcl::CropBoxCondition<PointT>::evaluate (const PointT &point) const
+{
+  // the point passes when it is inside the box, or outside of it when negative_ is set
+  return (isFinite (point) && (isInside (point) != negative_));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 template<typename PointT> void
 pcl::CropBox<PointT>::applyFilter (PointCloud &output)
@@ -78,64 +135,40 @@ pcl::CropBox<PointT>::applyFilter (std::vector<int> &indices)
   int indices_count = 0;
   int removed_indices_count = 0;
 
-  Eigen::Affine3f transform = Eigen::Affine3f::Identity ();
-  Eigen::Affine3f inverse_transform = Eigen::Affine3f::Identity ();
-
-  if (rotation_ != Eigen::Vector3f::Zero ())
-  {
-    pcl::getTransformation (0, 0, 0,
-                            rotation_ (0), rotation_ (1), rotation_ (2),
-                            transform);
-    inverse_transform = transform.inverse ();
-  }
-
-  for (size_t index = 0; index < indices_->size (); ++index)
+  // the points are classified in parallel and compacted in their input order:
+  // 0 = skipped (invalid), 1 = inside the box, 2 = outside the box
+  const CropBoxCondition<PointT> condition (min_pt_, max_pt_, rotation_, translation_, transform_, negative_);
+  const int nr_indices = static_cast<int> (indices_->size ());
+  std::vector<unsigned char> classification (nr_indices, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (static)
+#endif
+  for (int index = 0; index < nr_indices; ++index)
   {
     if (!input_->is_dense)
       // Check if the point is invalid
-      if (!isFinite (input_->points[index]))
+      if (!isFinite (input_->points[(*indices_)[index]]))
         continue;
 
-    // Get local point
-    PointT local_pt = input_->points[(*indices_)[index]];
-
-    // Transform point to world space
-    if (!(transform_.matrix ().isIdentity ()))
-      local_pt = pcl::transformPoint<PointT> (local_pt, transform_);
-
-    if (translation_ != Eigen::Vector3f::Zero ())
-    {
-      local_pt.x -= translation_ (0);
-      local_pt.y -= translation_ (1);
-      local_pt.z -= translation_ (2);
-    }
-
-    // Transform point to local space of crop box
-    if (!(inverse_transform.matrix ().isIdentity ()))
-      local_pt = pcl::transformPoint<PointT> (local_pt, inverse_transform);
-
-    // If outside the cropbox
-    if ( (local_pt.x < min_pt_[0] || local_pt.y < min_pt_[1] || local_pt.z < min_pt_[2]) ||
-         (local_pt.x > max_pt_[0] || local_pt.y > max_pt_[1] || local_pt.z > max_pt_[2]))
-    {
-      if (negative_)
-        indices[indices_count++] = (*indices_)[index];
-      else if (extract_removed_indices_)
-        (*removed_indices_)[removed_indices_count++] = static_cast<int> (index);
-    }
-    // If inside the cropbox
-    else
-    {
-      if (negative_ && extract_removed_indices_)
-        (*removed_indices_)[removed_indices_count++] = static_cast<int> (index);
-      else if (!negative_) 
-        indices[indices_count++] = (*indices_)[index];
-    }
+    classification[index] = condition.isInside (input_->points[(*indices_)[index]]) ? 1 : 2;
+  }
+
+  for (int index = 0; index < nr_indices; ++index)
+  {
+    if (classification[index] == 0)
+      continue;
+
+    // the point is kept when it is inside the box, or outside of it when negative_ is set
+    if ((classification[index] == 2) == negative_)
+      indices[indices_count++] = (*indices_)[index];
+    else if (extract_removed_indices_)
+      (*removed_indices_)[removed_indices_count++] = (*indices_)[index];
   }
   indices.resize (indices_count);
   removed_indices_->resize (removed_indices_count);
 }
 
+#define PCL_INSTANTIATE_CropBoxCondition(T) template class PCL_EXPORTS pcl::CropBoxCondition<T>;
 #define PCL_INSTANTIATE_CropBox(T) template class PCL_EXPORTS pcl::CropBox<T>;
 
 #endif    // PCL_FILTERS_IMPL_CROP_BOX_H_
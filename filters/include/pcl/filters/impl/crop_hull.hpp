@@ -39,6 +39,8 @@
 #define PCL_FILTERS_IMPL_CROP_HULL_H_
 
 #include <pcl/filters/crop_hull.h>
+#include <algorithm>
+#include <cmath>
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT> void
@@ -121,115 +123,263 @@ pcl::CropHull<PointT>::getHullCloudRange ()
 template<typename PointT> template<unsigned PlaneDim1, unsigned PlaneDim2> void 
 pcl::CropHull<PointT>::applyFilter2D (PointCloud &output)
 {
+  std::vector<unsigned char> keep;
+  classify2D<PlaneDim1,PlaneDim2> (keep);
   for (size_t index = 0; index < indices_->size (); index++)
-  {
-    // iterate over polygons faster than points because we expect this data
-    // to be, in general, more cache-local - the point cloud might be huge
-    size_t poly;
-    for (poly = 0; poly < hull_polygons_.size (); poly++)
-    {
-      if (isPointIn2DPolyWithVertIndices<PlaneDim1,PlaneDim2> (
-              input_->points[(*indices_)[index]], hull_polygons_[poly], *hull_cloud_
-         ))
-      {
-        if (crop_outside_)
-          output.push_back (input_->points[(*indices_)[index]]);
-        // once a point has tested +ve for being inside one polygon, we can
-        // stop checking the others:
-        break;
-      }
-    }
-    // If we're removing points *inside* the hull, only remove points that
-    // haven't been found inside any polygons
-    if (poly == hull_polygons_.size () && !crop_outside_)
+    if (keep[index])
       output.push_back (input_->points[(*indices_)[index]]);
-  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT> template<unsigned PlaneDim1, unsigned PlaneDim2> void 
 pcl::CropHull<PointT>::applyFilter2D (std::vector<int> &indices)
 {
-  // see comments in (PointCloud& output) overload
+  std::vector<unsigned char> keep;
+  classify2D<PlaneDim1,PlaneDim2> (keep);
   for (size_t index = 0; index < indices_->size (); index++)
-  {
-    size_t poly;
-    for (poly = 0; poly < hull_polygons_.size (); poly++)
-    {
-      if (isPointIn2DPolyWithVertIndices<PlaneDim1,PlaneDim2> (
-              input_->points[(*indices_)[index]], hull_polygons_[poly], *hull_cloud_
-         ))
-      {
-        if (crop_outside_)      
-          indices.push_back ((*indices_)[index]);
-        break;
-      }
-    }
-    if (poly == hull_polygons_.size () && !crop_outside_)
+    if (keep[index])
       indices.push_back ((*indices_)[index]);
-  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT> void 
 pcl::CropHull<PointT>::applyFilter3D (PointCloud &output)
 {
-  // This algorithm could definitely be sped up using kdtree/octree
-  // information, if that is available!
+  std::vector<unsigned char> keep;
+  classify3D (keep);
+  for (size_t index = 0; index < indices_->size (); index++)
+    if (keep[index])
+      output.push_back (input_->points[(*indices_)[index]]);
+}
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void 
+pcl::CropHull<PointT>::applyFilter3D (std::vector<int> &indices)
+{
+  std::vector<unsigned char> keep;
+  classify3D (keep);
   for (size_t index = 0; index < indices_->size (); index++)
+    if (keep[index])
+      indices.push_back ((*indices_)[index]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> template<unsigned PlaneDim1, unsigned PlaneDim2> void 
+pcl::CropHull<PointT>::classify2D (std::vector<unsigned char> &keep)
+{
+  // a point can only be inside a polygon if it lies within the polygon's bounding box, so only the
+  // polygons of the grid cell the point falls into need to be tested; the order in which the polygons
+  // are tested does not matter since a point is kept as soon as it is inside any of them
+  PolygonGrid grid;
+  buildPolygonGrid (Eigen::Vector3f::Unit (PlaneDim1), Eigen::Vector3f::Unit (PlaneDim2), grid);
+
+  const int nr_indices = static_cast<int> (indices_->size ());
+  keep.assign (nr_indices, 0);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
   {
-    // test ray-crossings for three random rays, and take vote of crossings
-    // counts to determine if each point is inside the hull: the vote avoids
-    // tricky edge and corner cases when rays might fluke through the edge
-    // between two polygons
-    // 'random' rays are arbitrary - basically anything that is less likely to
-    // hit the edge between polygons than coordinate-axis aligned rays would
-    // be.
-    size_t crossings[3] = {0,0,0};
-    Eigen::Vector3f rays[3] = 
+    std::vector<int> candidates;
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 1024)
+#endif
+    for (int index = 0; index < nr_indices; index++)
     {
-      Eigen::Vector3f (0.264882f,  0.688399f, 0.675237f),
-      Eigen::Vector3f (0.0145419f, 0.732901f, 0.68018f),
-      Eigen::Vector3f (0.856514f,  0.508771f, 0.0868081f)
-    };
+      const PointT &point = input_->points[(*indices_)[index]];
+      const float u = point.getVector3fMap ()[PlaneDim1];
+      const float v = point.getVector3fMap ()[PlaneDim2];
+      candidates.clear ();
+      getCandidatePolygons (grid, u, u, v, v, candidates);
 
-    for (size_t poly = 0; poly < hull_polygons_.size (); poly++)
-      for (size_t ray = 0; ray < 3; ray++)
-        crossings[ray] += rayTriangleIntersect
-          (input_->points[(*indices_)[index]], rays[ray], hull_polygons_[poly], *hull_cloud_);
+      bool inside = false;
+      for (size_t poly = 0; poly < candidates.size () && !inside; poly++)
+        inside = isPointIn2DPolyWithVertIndices<PlaneDim1,PlaneDim2> (point, hull_polygons_[candidates[poly]], *hull_cloud_);
 
-    if (crop_outside_ && (crossings[0]&1) + (crossings[1]&1) + (crossings[2]&1) > 1)
-      output.push_back (input_->points[(*indices_)[index]]);
-    else if (!crop_outside_)
-      output.push_back (input_->points[(*indices_)[index]]);
+      // If we're removing points *inside* the hull, only keep points that
+      // haven't been found inside any polygons
+      keep[index] = (inside == crop_outside_);
+    }
   }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT> void 
-pcl::CropHull<PointT>::applyFilter3D (std::vector<int> &indices)
+pcl::CropHull<PointT>::classify3D (std::vector<unsigned char> &keep)
 {
-  // see comments in applyFilter3D (PointCloud& output)
-  for (size_t index = 0; index < indices_->size (); index++)
+  // test ray-crossings for three random rays, and take vote of crossings
+  // counts to determine if each point is inside the hull: the vote avoids
+  // tricky edge and corner cases when rays might fluke through the edge
+  // between two polygons
+  // 'random' rays are arbitrary - basically anything that is less likely to
+  // hit the edge between polygons than coordinate-axis aligned rays would
+  // be.
+  const Eigen::Vector3f rays[3] = 
   {
-    size_t crossings[3] = {0,0,0};
-    Eigen::Vector3f rays[3] = 
+    Eigen::Vector3f (0.264882f,  0.688399f, 0.675237f),
+    Eigen::Vector3f (0.0145419f, 0.732901f, 0.68018f),
+    Eigen::Vector3f (0.856514f,  0.508771f, 0.0868081f)
+  };
+
+  // A ray can only cross the polygons whose projection along the ray contains the point, so every ray
+  // gets a grid in the plane orthogonal to it. The looked up rectangle is grown by a small tolerance
+  // relative to the magnitude of the point, which covers the rounding of rayTriangleIntersect for rays
+  // that graze a polygon edge.
+  PolygonGrid grids[3];
+  float hull_scale = 0.0f;
+  for (size_t ray = 0; ray < 3; ray++)
+  {
+    const Eigen::Vector3f axis_u = rays[ray].unitOrthogonal ();
+    buildPolygonGrid (axis_u, rays[ray].cross (axis_u).normalized (), grids[ray]);
+    hull_scale = std::max (hull_scale, std::max (grids[ray].max_u - grids[ray].min_u, grids[ray].max_v - grids[ray].min_v));
+  }
+
+  const int nr_indices = static_cast<int> (indices_->size ());
+  keep.assign (nr_indices, 0);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
+  {
+    std::vector<int> candidates;
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 1024)
+#endif
+    for (int index = 0; index < nr_indices; index++)
     {
-      Eigen::Vector3f(0.264882f,  0.688399f, 0.675237f),
-      Eigen::Vector3f(0.0145419f, 0.732901f, 0.68018f),
-      Eigen::Vector3f(0.856514f,  0.508771f, 0.0868081f)
-    };
+      const PointT &point = input_->points[(*indices_)[index]];
+      const Eigen::Vector3f p = point.getVector3fMap ();
+      const bool finite = pcl_isfinite (p[0]) && pcl_isfinite (p[1]) && pcl_isfinite (p[2]);
+      const float tolerance = finite ? 1e-4f * (p.cwiseAbs ().maxCoeff () + hull_scale) : 0.0f;
 
-    for (size_t poly = 0; poly < hull_polygons_.size (); poly++)
+      size_t crossings[3] = {0,0,0};
       for (size_t ray = 0; ray < 3; ray++)
-        crossings[ray] += rayTriangleIntersect
-          (input_->points[(*indices_)[index]], rays[ray], hull_polygons_[poly], *hull_cloud_);
+      {
+        if (finite)
+        {
+          const float u = p.dot (grids[ray].axis_u);
+          const float v = p.dot (grids[ray].axis_v);
+          candidates.clear ();
+          getCandidatePolygons (grids[ray], u - tolerance, u + tolerance, v - tolerance, v + tolerance, candidates);
+          for (size_t poly = 0; poly < candidates.size (); poly++)
+            crossings[ray] += rayTriangleIntersect (point, rays[ray], hull_polygons_[candidates[poly]], *hull_cloud_);
+        }
+        else
+        {
+          // the intersection test does not reject non-finite points, so they are tested against every polygon
+          for (size_t poly = 0; poly < hull_polygons_.size (); poly++)
+            crossings[ray] += rayTriangleIntersect (point, rays[ray], hull_polygons_[poly], *hull_cloud_);
+        }
+      }
 
-    if (crop_outside_ && (crossings[0]&1) + (crossings[1]&1) + (crossings[2]&1) > 1)
-      indices.push_back ((*indices_)[index]);
-    else if (!crop_outside_)
-      indices.push_back ((*indices_)[index]);
+      if (crop_outside_ && (crossings[0]&1) + (crossings[1]&1) + (crossings[2]&1) > 1)
+        keep[index] = 1;
+      else if (!crop_outside_)
+        keep[index] = 1;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::CropHull<PointT>::buildPolygonGrid (const Eigen::Vector3f &axis_u, const Eigen::Vector3f &axis_v,
+                                         PolygonGrid &grid) const
+{
+  grid.axis_u = axis_u;
+  grid.axis_v = axis_v;
+  grid.min_u = grid.min_v = std::numeric_limits<float>::max ();
+  grid.max_u = grid.max_v = -std::numeric_limits<float>::max ();
+
+  // projected bounding box of every polygon, empty polygons never contain a point
+  const int nr_polygons = static_cast<int> (hull_polygons_.size ());
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > boxes (nr_polygons);
+  for (int poly = 0; poly < nr_polygons; poly++)
+  {
+    Eigen::Vector4f &box = boxes[poly];
+    box << std::numeric_limits<float>::max (), -std::numeric_limits<float>::max (),
+           std::numeric_limits<float>::max (), -std::numeric_limits<float>::max ();
+    const std::vector<uint32_t> &vertices = hull_polygons_[poly].vertices;
+    for (size_t i = 0; i < vertices.size (); i++)
+    {
+      const Eigen::Vector3f vertex = hull_cloud_->points[vertices[i]].getVector3fMap ();
+      const float u = vertex.dot (axis_u);
+      const float v = vertex.dot (axis_v);
+      box[0] = std::min (box[0], u);
+      box[1] = std::max (box[1], u);
+      box[2] = std::min (box[2], v);
+      box[3] = std::max (box[3], v);
+    }
+    if (vertices.empty ())
+      continue;
+    grid.min_u = std::min (grid.min_u, box[0]);
+    grid.max_u = std::max (grid.max_u, box[1]);
+    grid.min_v = std::min (grid.min_v, box[2]);
+    grid.max_v = std::max (grid.max_v, box[3]);
+  }
+
+  // about one cell per polygon
+  const int cells = std::max (1, std::min (1024, static_cast<int> (std::sqrt (static_cast<float> (nr_polygons)))));
+  grid.cells_u = grid.cells_v = cells;
+  grid.inverse_cell_u = grid.max_u > grid.min_u ? static_cast<float> (cells) / (grid.max_u - grid.min_u) : 0.0f;
+  grid.inverse_cell_v = grid.max_v > grid.min_v ? static_cast<float> (cells) / (grid.max_v - grid.min_v) : 0.0f;
+
+  // counting sort of the polygons into the cells they overlap: the first pass counts, the second pass
+  // fills every cell from its end, which leaves cell_offsets at the start of each cell
+  grid.cell_offsets.assign (cells * cells + 1, 0);
+  for (int pass = 0; pass < 2; pass++)
+  {
+    if (pass == 1)
+    {
+      for (size_t cell = 1; cell < grid.cell_offsets.size (); cell++)
+        grid.cell_offsets[cell] += grid.cell_offsets[cell - 1];
+      grid.cell_polygons.resize (grid.cell_offsets.back ());
+    }
+    for (int poly = nr_polygons - 1; poly >= 0; poly--)
+    {
+      if (hull_polygons_[poly].vertices.empty ())
+        continue;
+      const Eigen::Vector4f &box = boxes[poly];
+      const int u_first = std::min (cells - 1, static_cast<int> ((box[0] - grid.min_u) * grid.inverse_cell_u));
+      const int u_last = std::min (cells - 1, static_cast<int> ((box[1] - grid.min_u) * grid.inverse_cell_u));
+      const int v_first = std::min (cells - 1, static_cast<int> ((box[2] - grid.min_v) * grid.inverse_cell_v));
+      const int v_last = std::min (cells - 1, static_cast<int> ((box[3] - grid.min_v) * grid.inverse_cell_v));
+      for (int cell_v = v_first; cell_v <= v_last; cell_v++)
+        for (int cell_u = u_first; cell_u <= u_last; cell_u++)
+        {
+          const int cell = cell_v * cells + cell_u;
+          if (pass == 0)
+            grid.cell_offsets[cell]++;
+          else
+            grid.cell_polygons[--grid.cell_offsets[cell]] = poly;
+        }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> void
+pcl::CropHull<PointT>::getCandidatePolygons (const PolygonGrid &grid, float min_u, float max_u, float min_v, float max_v,
+                                             std::vector<int> &candidates)
+{
+  // this also rejects non-finite coordinates
+  if (!(max_u >= grid.min_u && min_u <= grid.max_u && max_v >= grid.min_v && min_v <= grid.max_v))
+    return;
+
+  const int u_first = std::min (grid.cells_u - 1, static_cast<int> ((std::max (min_u, grid.min_u) - grid.min_u) * grid.inverse_cell_u));
+  const int u_last = std::min (grid.cells_u - 1, static_cast<int> ((std::min (max_u, grid.max_u) - grid.min_u) * grid.inverse_cell_u));
+  const int v_first = std::min (grid.cells_v - 1, static_cast<int> ((std::max (min_v, grid.min_v) - grid.min_v) * grid.inverse_cell_v));
+  const int v_last = std::min (grid.cells_v - 1, static_cast<int> ((std::min (max_v, grid.max_v) - grid.min_v) * grid.inverse_cell_v));
+  for (int cell_v = v_first; cell_v <= v_last; cell_v++)
+    for (int cell_u = u_first; cell_u <= u_last; cell_u++)
+    {
+      const int cell = cell_v * grid.cells_u + cell_u;
+      candidates.insert (candidates.end (), grid.cell_polygons.begin () + grid.cell_offsets[cell],
+                         grid.cell_polygons.begin () + grid.cell_offsets[cell + 1]);
+    }
+
+  // a polygon that overlaps several of the looked up cells must only be counted once
+  if (u_first != u_last || v_first != v_last)
+  {
+    std::sort (candidates.begin (), candidates.end ());
+    candidates.erase (std::unique (candidates.begin (), candidates.end ()), candidates.end ());
   }
 }
 
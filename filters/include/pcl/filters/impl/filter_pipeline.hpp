@@ -0,0 +1,206 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef PCL_FILTERS_IMPL_FILTER_PIPELINE_H_
+#define PCL_FILTERS_IMPL_FILTER_PIPELINE_H_
+
+#include <pcl/filters/filter_pipeline.h>
+#include <pcl/common/io.h>
+#include <pcl/common/time.h>
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::applyFilter (PointCloud &output)
+{
+  reports_.clear ();
+
+  // The current points are indices into the current cloud. A new cloud is only created when a stage
+  // needs one, i.e. before a neighborhood filter and as the output of a reduction.
+  PointCloudConstPtr cloud = input_;
+  IndicesPtr indices (new std::vector<int> (*indices_));
+  // True when the current points are all the points of the current cloud, in order
+  bool is_compact = false;
+
+  // The per-point tests of the stages that have one: the conditions, and the point filters that expose
+  // their test (PassThrough, CropBox). They are taken with the current settings of the filters.
+  std::vector<ConditionBasePtr> conditions (stages_.size ());
+  for (size_t i = 0; i < stages_.size (); ++i)
+    conditions[i] = getStageCondition (stages_[i]);
+
+  size_t stage_idx = 0;
+  while (stage_idx < stages_.size ())
+  {
+    const Stage &stage = stages_[stage_idx];
+    StageReport report;
+    report.name = stage.name;
+    report.points_in = indices->size ();
+    const double start_time = pcl::getTime ();
+
+    size_t next_stage_idx = stage_idx + 1;
+    switch (stage.type)
+    {
+      case CONDITION:
+      case POINT_FILTER:
+      {
+        // Consecutive per-point tests are evaluated together
+        if (conditions[stage_idx])
+        {
+          while (next_stage_idx < stages_.size () && conditions[next_stage_idx])
+            report.name += " + " + stages_[next_stage_idx++].name;
+          applyConditions (*cloud, *indices, conditions, stage_idx, next_stage_idx);
+          break;
+        }
+        // Other point filters are run on the current points
+        IndicesPtr kept (new std::vector<int>);
+        stage.point_filter->setInputCloud (cloud);
+        stage.point_filter->setIndices (indices);
+        stage.point_filter->filter (*kept);
+        indices = kept;
+        break;
+      }
+      case NEIGHBORHOOD_FILTER:
+      {
+        // The neighbors have to be searched among the remaining points only
+        if (!is_compact)
+        {
+          PointCloudPtr compacted (new PointCloud);
+          pcl::copyPointCloud (*cloud, *indices, *compacted);
+          cloud = compacted;
+          indices.reset (new std::vector<int> (cloud->points.size ()));
+          for (size_t i = 0; i < indices->size (); ++i)
+            (*indices)[i] = static_cast<int> (i);
+          is_compact = true;
+        }
+        // The shared search method is only rebuilt when the points have changed
+        if (searcher_ && (searcher_->getInputCloud () != cloud || searcher_->getIndices ()))
+          searcher_->setInputCloud (cloud);
+
+        IndicesPtr kept (new std::vector<int>);
+        stage.point_filter->setInputCloud (cloud);
+        stage.point_filter->setIndices (indices);
+        stage.point_filter->filter (*kept);
+        indices = kept;
+        break;
+      }
+      case REDUCTION:
+      {
+        PointCloudPtr reduced (new PointCloud);
+        stage.reduction->setInputCloud (cloud);
+        stage.reduction->setIndices (indices);
+        stage.reduction->filter (*reduced);
+        cloud = reduced;
+        indices.reset (new std::vector<int> (cloud->points.size ()));
+        for (size_t i = 0; i < indices->size (); ++i)
+          (*indices)[i] = static_cast<int> (i);
+        is_compact = true;
+        break;
+      }
+    }
+    // The filters keep the order of their input indices, so keeping all points keeps the cloud compact
+    is_compact = is_compact && (indices->size () == cloud->points.size ());
+
+    report.time = (pcl::getTime () - start_time) * 1000.0;
+    report.points_out = indices->size ();
+    reports_.push_back (report);
+    stage_idx = next_stage_idx;
+  }
+
+  if (is_compact)
+  {
+    output = *cloud;
+    return;
+  }
+  pcl::copyPointCloud (*cloud, *indices, output);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> typename pcl::FilterPipeline<PointT>::ConditionBasePtr
+pcl::FilterPipeline<PointT>::getStageCondition (const Stage &stage) const
+{
+  if (stage.type == CONDITION)
+    return (stage.condition);
+  if (stage.type != POINT_FILTER)
+    return (ConditionBasePtr ());
+
+  ConditionBasePtr condition;
+  typename PassThrough<PointT>::Ptr pass = boost::dynamic_pointer_cast<PassThrough<PointT> > (stage.point_filter);
+  typename CropBox<PointT>::Ptr box = boost::dynamic_pointer_cast<CropBox<PointT> > (stage.point_filter);
+  if (pass)
+    condition = pass->getCondition ();
+  else if (box)
+    condition = box->getCondition ();
+
+  // A PassThrough on a field the point type does not have is run as a filter, which reports the error
+  if (condition && !condition->isCapable ())
+    condition.reset ();
+  return (condition);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FilterPipeline<PointT>::applyConditions (const PointCloud &cloud, std::vector<int> &indices,
+                                              const std::vector<ConditionBasePtr> &conditions,
+                                              size_t first, size_t last)
+{
+  const int nr_indices = static_cast<int> (indices.size ());
+  std::vector<unsigned char> passed (nr_indices, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (static)
+#endif
+  for (int i = 0; i < nr_indices; ++i)
+  {
+    const PointT &point = cloud.points[indices[i]];
+    // Invalid points are always removed, as done by ConditionalRemoval
+    if (!pcl_isfinite (point.x) || !pcl_isfinite (point.y) || !pcl_isfinite (point.z))
+      continue;
+    bool point_passed = true;
+    for (size_t stage_idx = first; stage_idx < last && point_passed; ++stage_idx)
+      point_passed = conditions[stage_idx]->evaluate (point);
+    passed[i] = point_passed;
+  }
+
+  int nr_passed = 0;
+  for (int i = 0; i < nr_indices; ++i)
+    if (passed[i])
+      indices[nr_passed++] = indices[i];
+  indices.resize (nr_passed);
+}
+
+#define PCL_INSTANTIATE_FilterPipeline(T) template class PCL_EXPORTS pcl::FilterPipeline<T>;
+
+#endif  // PCL_FILTERS_IMPL_FILTER_PIPELINE_H_
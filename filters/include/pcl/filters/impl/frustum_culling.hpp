@@ -40,6 +40,8 @@
 
 #include <pcl/filters/frustum_culling.h>
 #include <pcl/common/io.h>
+#include <pcl/sse.h>
+#include <cfloat>
 #include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -74,6 +76,67 @@ pcl::FrustumCulling<PointT>::applyFilter (PointCloud& output)
 ///////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::FrustumCulling<PointT>::applyFilter (std::vector<int> &indices)
+{
+  FrustumPlanesVector planes (1);
+  computePlanes (camera_pose_, planes[0]);
+
+  std::vector<std::vector<Block> > blocks;
+  computeBlocks (planes, blocks);
+  const size_t bits = boost::dynamic_bitset<>::bits_per_block;
+
+  if (extract_removed_indices_)
+  {
+    removed_indices_->resize (indices_->size ());
+  }
+  indices.resize (indices_->size ());
+  size_t indices_ctr = 0;
+  size_t removed_ctr = 0;
+  for (size_t i = 0; i < indices_->size (); i++) 
+  {
+    int idx = (*indices_)[i];
+    bool is_in_fov = ((blocks[0][i / bits] >> (i % bits)) & 1) != 0;
+    if (is_in_fov ^ negative_)
+    {
+      indices[indices_ctr++] = idx;
+    }
+    else if (extract_removed_indices_)
+    {
+      (*removed_indices_)[removed_ctr++] = idx;
+    }
+  }
+  indices.resize (indices_ctr);
+  removed_indices_->resize (removed_ctr);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FrustumCulling<PointT>::computeVisibility (const CameraPoses &camera_poses,
+                                                std::vector<boost::dynamic_bitset<> > &visibility)
+{
+  visibility.clear ();
+  if (!initCompute ())
+    return;
+
+  FrustumPlanesVector planes (camera_poses.size ());
+  for (size_t c = 0; c < camera_poses.size (); ++c)
+    computePlanes (camera_poses[c], planes[c]);
+
+  std::vector<std::vector<Block> > blocks;
+  computeBlocks (planes, blocks);
+
+  visibility.resize (camera_poses.size ());
+  for (size_t c = 0; c < camera_poses.size (); ++c)
+  {
+    visibility[c] = boost::dynamic_bitset<> (blocks[c].begin (), blocks[c].end ());
+    visibility[c].resize (indices_->size ());
+  }
+
+  deinitCompute ();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FrustumCulling<PointT>::computePlanes (const Eigen::Matrix4f &camera_pose, FrustumPlanes &planes) const
 {
   Eigen::Vector4f pl_n; // near plane 
   Eigen::Vector4f pl_f; // far plane
@@ -82,10 +145,10 @@ pcl::FrustumCulling<PointT>::applyFilter (std::vector<int> &indices)
   Eigen::Vector4f pl_r; // right plane
   Eigen::Vector4f pl_l; // left plane
 
-  Eigen::Vector3f view = camera_pose_.block (0, 0, 3, 1);    // view vector for the camera  - first column of the rotation matrix
-  Eigen::Vector3f up = camera_pose_.block (0, 1, 3, 1);      // up vector for the camera    - second column of the rotation matix
-  Eigen::Vector3f right = camera_pose_.block (0, 2, 3, 1);   // right vector for the camera - third column of the rotation matrix
-  Eigen::Vector3f T = camera_pose_.block (0, 3, 3, 1);       // The (X, Y, Z) position of the camera w.r.t origin
+  Eigen::Vector3f view = camera_pose.block (0, 0, 3, 1);    // view vector for the camera  - first column of the rotation matrix
+  Eigen::Vector3f up = camera_pose.block (0, 1, 3, 1);      // up vector for the camera    - second column of the rotation matix
+  Eigen::Vector3f right = camera_pose.block (0, 2, 3, 1);   // right vector for the camera - third column of the rotation matrix
+  Eigen::Vector3f T = camera_pose.block (0, 3, 3, 1);       // The (X, Y, Z) position of the camera w.r.t origin
 
 
   float vfov_rad = float (vfov_ * M_PI / 180); // degrees to radians
@@ -109,11 +172,11 @@ pcl::FrustumCulling<PointT>::applyFilter (std::vector<int> &indices)
   Eigen::Vector3f np_bl (np_c - (up * np_h / 2) - (right * np_w / 2));   // Bottom left corner of the near plane
   Eigen::Vector3f np_br (np_c - (up * np_h / 2) + (right * np_w / 2));   // Bottom right corner of the near plane
 
-  pl_f.block (0, 0, 3, 1).matrix () = (fp_bl - fp_br).cross (fp_tr - fp_br);   // Far plane equation - cross product of the 
-  pl_f (3) = -fp_c.dot (pl_f.block (0, 0, 3, 1));                    // perpendicular edges of the far plane
+  pl_f.head<3> () = (fp_bl - fp_br).cross (fp_tr - fp_br);   // Far plane equation - cross product of the 
+  pl_f (3) = -fp_c.dot (pl_f.head<3> ());                    // perpendicular edges of the far plane
 
-  pl_n.block (0, 0, 3, 1).matrix () = (np_tr - np_br).cross (np_bl - np_br);   // Near plane equation - cross product of the 
-  pl_n (3) = -np_c.dot (pl_n.block (0, 0, 3, 1));                    // perpendicular edges of the far plane
+  pl_n.head<3> () = (np_tr - np_br).cross (np_bl - np_br);   // Near plane equation - cross product of the 
+  pl_n (3) = -np_c.dot (pl_n.head<3> ());                    // perpendicular edges of the far plane
 
   Eigen::Vector3f a (fp_bl - T);    // Vector connecting the camera and far plane bottom left
   Eigen::Vector3f b (fp_br - T);    // Vector connecting the camera and far plane bottom right
@@ -133,47 +196,147 @@ pcl::FrustumCulling<PointT>::applyFilter (std::vector<int> &indices)
   //                   T
   //
 
-  pl_r.block (0, 0, 3, 1).matrix () = b.cross (c);
-  pl_l.block (0, 0, 3, 1).matrix () = d.cross (a);
-  pl_t.block (0, 0, 3, 1).matrix () = c.cross (d);
-  pl_b.block (0, 0, 3, 1).matrix () = a.cross (b);
+  pl_r.head<3> () = b.cross (c);
+  pl_l.head<3> () = d.cross (a);
+  pl_t.head<3> () = c.cross (d);
+  pl_b.head<3> () = a.cross (b);
 
-  pl_r (3) = -T.dot (pl_r.block (0, 0, 3, 1));
-  pl_l (3) = -T.dot (pl_l.block (0, 0, 3, 1));
-  pl_t (3) = -T.dot (pl_t.block (0, 0, 3, 1));
-  pl_b (3) = -T.dot (pl_b.block (0, 0, 3, 1));
+  pl_r (3) = -T.dot (pl_r.head<3> ());
+  pl_l (3) = -T.dot (pl_l.head<3> ());
+  pl_t (3) = -T.dot (pl_t.head<3> ());
+  pl_b (3) = -T.dot (pl_b.head<3> ());
 
-  if (extract_removed_indices_)
-  {
-    removed_indices_->resize (indices_->size ());
-  }
-  indices.resize (indices_->size ());
-  size_t indices_ctr = 0;
-  size_t removed_ctr = 0;
-  for (size_t i = 0; i < indices_->size (); i++) 
+  planes.col (0) = pl_l;
+  planes.col (1) = pl_r;
+  planes.col (2) = pl_t;
+  planes.col (3) = pl_b;
+  planes.col (4) = pl_f;
+  planes.col (5) = pl_n;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::FrustumCulling<PointT>::computeBlocks (const FrustumPlanesVector &planes,
+                                            std::vector<std::vector<Block> > &blocks) const
+{
+  const size_t bits = boost::dynamic_bitset<>::bits_per_block;
+  const size_t nr_points = indices_->size ();
+  const int nr_blocks = static_cast<int> ((nr_points + bits - 1) / bits);
+  blocks.assign (planes.size (), std::vector<Block> (nr_blocks, 0));
+
+  // Every block of points is read once and tested against all the frusta while it is in cache.
+#ifdef _OPENMP
+#pragma omp parallel for schedule (dynamic, 64) num_threads(threads_)
+#endif
+  for (int b = 0; b < nr_blocks; ++b)
   {
-    int idx = indices_->at (i);
-    Eigen::Vector4f pt (input_->points[idx].x,
-                        input_->points[idx].y,
-                        input_->points[idx].z,
-                        1.0f);
-    bool is_in_fov = (pt.dot (pl_l) <= 0) && 
-                     (pt.dot (pl_r) <= 0) &&
-                     (pt.dot (pl_t) <= 0) && 
-                     (pt.dot (pl_b) <= 0) && 
-                     (pt.dot (pl_f) <= 0) &&
-                     (pt.dot (pl_n) <= 0);
-    if (is_in_fov ^ negative_)
+    const size_t begin = static_cast<size_t> (b) * bits;
+    const size_t count = std::min (bits, nr_points - begin);
+    const Block full = (count == bits) ? ~Block (0) : ((Block (1) << count) - 1);
+
+    // Bounding box of the finite points of the block. Points with a NaN coordinate are never inside
+    // a frustum, the block can still be rejected as a whole but not accepted. Infinite coordinates
+    // disable the box for the block.
+    bool has_box = use_block_culling_;
+    bool has_nan = false;
+    Eigen::Array3f min_pt (FLT_MAX, FLT_MAX, FLT_MAX);
+    Eigen::Array3f max_pt (-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (size_t i = begin; has_box && i < begin + count; ++i)
     {
-      indices[indices_ctr++] = idx;
+      const PointT &pt = input_->points[(*indices_)[i]];
+      if (!isFinite (pt))
+      {
+        if (pcl_isnan (pt.x) || pcl_isnan (pt.y) || pcl_isnan (pt.z))
+          has_nan = true;
+        else
+          has_box = false;
+        continue;
+      }
+      min_pt = min_pt.min (pt.getArray3fMap ());
+      max_pt = max_pt.max (pt.getArray3fMap ());
     }
-    else if (extract_removed_indices_)
+    const Eigen::Array3f extent = min_pt.abs ().max (max_pt.abs ());
+
+    for (size_t f = 0; f < planes.size (); ++f)
     {
-      (*removed_indices_)[removed_ctr++] = idx;
+      if (has_box)
+      {
+        // The smallest and largest values of a plane over the box are reached at the corners picked
+        // by the signs of its normal. The box is only decided with a margin well above the rounding
+        // error of the point tests, so that the result is the same as testing every point.
+        bool outside = false;
+        bool inside = true;
+        for (int k = 0; k < 6 && !outside; ++k)
+        {
+          const Eigen::Array3f normal = planes[f].col (k).template head<3> ().array ();
+          float lo = planes[f] (3, k);
+          float hi = planes[f] (3, k);
+          for (int j = 0; j < 3; ++j)
+          {
+            lo += normal[j] * (normal[j] >= 0 ? min_pt[j] : max_pt[j]);
+            hi += normal[j] * (normal[j] >= 0 ? max_pt[j] : min_pt[j]);
+          }
+          const float margin = 1e-5f * ((normal.abs () * extent).sum () + fabsf (planes[f] (3, k)));
+          if (lo > margin)
+            outside = true;
+          else if (hi >= -margin)
+            inside = false;
+        }
+        if (outside)
+          continue;
+        if (inside && !has_nan)
+        {
+          blocks[f][b] = full;
+          continue;
+        }
+      }
+      blocks[f][b] = testPoints (planes[f], begin, count);
     }
   }
-  indices.resize (indices_ctr);
-  removed_indices_->resize (removed_ctr);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename PointT> typename pcl::FrustumCulling<PointT>::Block
+pcl::FrustumCulling<PointT>::testPoints (const FrustumPlanes &planes, size_t begin, size_t count) const
+{
+  // The plane distances are summed as (a * x + c * z) + (b * y + d) in both paths, which is also
+  // the order of the vectorized Eigen dot product this replaces.
+  const int *idx = &(*indices_)[begin];
+  Block mask = 0;
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128 zero = _mm_setzero_ps ();
+  for (; i + 4 <= count; i += 4)
+  {
+    const PointT &p0 = input_->points[idx[i]];
+    const PointT &p1 = input_->points[idx[i + 1]];
+    const PointT &p2 = input_->points[idx[i + 2]];
+    const PointT &p3 = input_->points[idx[i + 3]];
+    const __m128 x = sse_set (p3.x, p2.x, p1.x, p0.x);
+    const __m128 y = sse_set (p3.y, p2.y, p1.y, p0.y);
+    const __m128 z = sse_set (p3.z, p2.z, p1.z, p0.z);
+
+    __m128 inside = _mm_castsi128_ps (_mm_set1_epi32 (-1));
+    for (int k = 0; k < 6; ++k)
+    {
+      const __m128 dist = sse_add (sse_add (sse_mul (x, planes (0, k)), sse_mul (z, planes (2, k))),
+                                   sse_add (sse_mul (y, planes (1, k)), sse_set (planes (3, k))));
+      // Comparisons with NaN are false, so non-finite points are never inside
+      inside = sse_and (inside, sse_cmple (dist, zero));
+    }
+    mask |= static_cast<Block> (_mm_movemask_ps (inside)) << i;
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    const PointT &pt = input_->points[idx[i]];
+    bool is_in_fov = true;
+    for (int k = 0; k < 6 && is_in_fov; ++k)
+      is_in_fov = ((pt.x * planes (0, k) + pt.z * planes (2, k)) + (pt.y * planes (1, k) + planes (3, k))) <= 0;
+    if (is_in_fov)
+      mask |= Block (1) << i;
+  }
+  return (mask);
 }
 
 #define PCL_INSTANTIATE_FrustumCulling(T) template class PCL_EXPORTS pcl::FrustumCulling<T>;
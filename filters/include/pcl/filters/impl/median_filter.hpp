@@ -42,7 +42,9 @@
 
 #include <pcl/filters/median_filter.h>
 #include <pcl/common/io.h>
+#include <algorithm>
 
+//////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::MedianFilter<PointT>::applyFilter (PointCloud &output)
 {
@@ -55,38 +57,136 @@ pcl::MedianFilter<PointT>::applyFilter (PointCloud &output)
   // Copy everything from the input cloud to the output cloud (takes care of all the fields)
   copyPointCloud (*input_, output);
 
-  int height = static_cast<int> (output.height);
-  int width = static_cast<int> (output.width);
-  for (int y = 0; y < height; ++y)
+  // The medians are computed from the input depths only, so the rows are independent of each other.
+  // Selecting the median costs about the window area per point, the sliding histogram about its side
+  // length plus a scan of the histogram, which pays off for the larger windows.
+  const int height = static_cast<int> (output.height);
+  const bool use_histogram = (window_size_ / 2) >= 3;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
+  {
+    std::vector<float> values;
+    std::vector<std::pair<float, int> > depths;
+    std::vector<int> ranks;
+    std::vector<unsigned char> histogram;
+    std::vector<int> coarse_histogram;
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 1)
+#endif
+    for (int y = 0; y < height; ++y)
+    {
+      if (use_histogram)
+        filterRowHistogram (y, output, depths, ranks, histogram, coarse_histogram);
+      else
+        filterRowSelection (y, output, values);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::MedianFilter<PointT>::filterRowSelection (int y, PointCloud &output, std::vector<float> &values) const
+{
+  const int height = static_cast<int> (input_->height);
+  const int width = static_cast<int> (input_->width);
+  for (int x = 0; x < width; ++x)
+    if (pcl::isFinite ((*input_)(x, y)))
+    {
+      values.clear ();
+      // Fill in the vector of values with the depths around the interest point
+      for (int y_dev = -window_size_/2; y_dev <= window_size_/2; ++y_dev)
+        for (int x_dev = -window_size_/2; x_dev <= window_size_/2; ++x_dev)
+        {
+          if (x + x_dev >= 0 && x + x_dev < width &&
+              y + y_dev >= 0 && y + y_dev < height &&
+              pcl::isFinite ((*input_)(x+x_dev, y+y_dev)))
+            values.push_back ((*input_)(x+x_dev, y+y_dev).z);
+        }
+
+      // The output depth will be the median of all the depths in the window
+      std::nth_element (values.begin (), values.begin () + values.size () / 2, values.end ());
+      setDepth (x, y, values[values.size () / 2], output);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::MedianFilter<PointT>::filterRowHistogram (int y, PointCloud &output,
+                                               std::vector<std::pair<float, int> > &depths,
+                                               std::vector<int> &ranks,
+                                               std::vector<unsigned char> &histogram,
+                                               std::vector<int> &coarse_histogram) const
+{
+  const int height = static_cast<int> (input_->height);
+  const int width = static_cast<int> (input_->width);
+  const int radius = window_size_ / 2;
+  const int first_row = std::max (0, y - radius);
+  const int nr_rows = std::min (height - 1, y + radius) - first_row + 1;
+  // Number of ranks per block of the coarse histogram
+  const int block_bits = 6;
+
+  // Sort the finite depths of the band of rows covered by the windows, equal depths are ordered by
+  // position so that every position gets its own rank
+  depths.clear ();
+  ranks.assign (nr_rows * width, -1);
+  for (int row = 0; row < nr_rows; ++row)
     for (int x = 0; x < width; ++x)
-      if (pcl::isFinite ((*input_)(x, y)))
+      if (pcl::isFinite ((*input_)(x, first_row + row)))
+        depths.push_back (std::make_pair ((*input_)(x, first_row + row).z, row * width + x));
+  if (depths.empty ())
+    return;
+  std::sort (depths.begin (), depths.end ());
+  for (size_t rank = 0; rank < depths.size (); ++rank)
+    ranks[depths[rank].second] = static_cast<int> (rank);
+
+  histogram.assign (depths.size (), 0);
+  coarse_histogram.assign ((depths.size () >> block_bits) + 1, 0);
+  int nr_values = 0;
+
+  for (int x = 0; x < width; ++x)
+  {
+    // Slide the window: add the columns entering it and remove the one leaving it
+    const int first_added = (x == 0) ? 0 : x + radius;
+    const int last_added = std::min (width - 1, x + radius);
+    for (int column = first_added; column <= last_added; ++column)
+      for (int row = 0; row < nr_rows; ++row)
       {
-        std::vector<float> vals;
-        vals.reserve (window_size_ * window_size_);
-        // Fill in the vector of values with the depths around the interest point
-        for (int y_dev = -window_size_/2; y_dev <= window_size_/2; ++y_dev)
-          for (int x_dev = -window_size_/2; x_dev <= window_size_/2; ++x_dev)
-          {
-            if (x + x_dev >= 0 && x + x_dev < width &&
-                y + y_dev >= 0 && y + y_dev < height &&
-                pcl::isFinite ((*input_)(x+x_dev, y+y_dev)))
-              vals.push_back ((*input_)(x+x_dev, y+y_dev).z);
-          }
-
-        if (vals.size () == 0)
-          continue;
-
-        // The output depth will be the median of all the depths in the window
-        partial_sort (vals.begin (), vals.begin () + vals.size () / 2 + 1, vals.end ());
-        float new_depth = vals[vals.size () / 2];
-        // Do not allow points to move more than the set max_allowed_movement_
-        if (fabs (new_depth - (*input_)(x, y).z) < max_allowed_movement_)
-          output (x, y).z = new_depth;
-        else
-          output (x, y).z = (*input_)(x, y).z +
-                            max_allowed_movement_ * (new_depth - (*input_)(x, y).z) / fabsf (new_depth - (*input_)(x, y).z);
+        const int rank = ranks[row * width + column];
+        if (rank != -1)
+        {
+          histogram[rank] = 1;
+          ++coarse_histogram[rank >> block_bits];
+          ++nr_values;
+        }
       }
-}
+    const int removed = x - radius - 1;
+    if (removed >= 0)
+      for (int row = 0; row < nr_rows; ++row)
+      {
+        const int rank = ranks[row * width + removed];
+        if (rank != -1)
+        {
+          histogram[rank] = 0;
+          --coarse_histogram[rank >> block_bits];
+          --nr_values;
+        }
+      }
+
+    if (ranks[(y - first_row) * width + x] == -1)
+      continue;
 
+    // The median is the element at position nr_values / 2 in the sorted window
+    int remaining = nr_values / 2;
+    int block = 0;
+    while (remaining >= coarse_histogram[block])
+      remaining -= coarse_histogram[block++];
+    int rank = block << block_bits;
+    for (;; ++rank)
+      if (histogram[rank] && remaining-- == 0)
+        break;
+    setDepth (x, y, depths[rank].first, output);
+  }
+}
 
 #endif /* PCL_FILTERS_IMPL_MEDIAN_FILTER_HPP_ */
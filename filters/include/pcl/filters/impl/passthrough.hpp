@@ -43,6 +43,52 @@
 #include <pcl/filters/passthrough.h>
 #include <pcl/common/io.h>
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT>
+pcl::PassThroughCondition<PointT>::PassThroughCondition (const std::string &field_name,
+                                                         float limit_min, float limit_max, bool negative) :
+  field_offset_ (-1),
+  limit_min_ (limit_min),
+  limit_max_ (limit_max),
+  negative_ (negative)
+{
+  if (field_name.empty ())
+    return;
+
+  std::vector<pcl::PCLPointField> fields;
+  const int field_idx = pcl::getFieldIndex<PointT> (field_name, fields);
+  if (field_idx == -1)
+    capable_ = false;
+  else
+    field_offset_ = static_cast<int> (fields[field_idx].offset);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::PassThroughCondition<PointT>::evaluate (const PointT &point) const
+{
+  // Non-finite entries never pass
+  if (!pcl_isfinite (point.x) || !pcl_isfinite (point.y) || !pcl_isfinite (point.z))
+    return (false);
+
+  // Only filter for non-finite entries if no field name has been specified
+  if (field_offset_ == -1)
+    return (true);
+
+  // Get the field's value
+  const uint8_t* pt_data = reinterpret_cast<const uint8_t*> (&point);
+  float field_value = 0;
+  memcpy (&field_value, pt_data + field_offset_, sizeof (float));
+
+  // Remove NAN/INF/-INF values. We expect passthrough to output clean valid data.
+  if (!pcl_isfinite (field_value))
+    return (false);
+
+  // Points inside of the field limits pass, unless negative was set
+  const bool inside = field_value >= limit_min_ && field_value <= limit_max_;
+  return (inside != negative_);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::PassThrough<PointT>::applyFilter (PointCloud &output)
@@ -78,82 +124,31 @@ pcl::PassThrough<PointT>::applyFilterIndices (std::vector<int> &indices)
   removed_indices_->resize (indices_->size ());
   int oii = 0, rii = 0;  // oii = output indices iterator, rii = removed indices iterator
 
-  // Has a field name been specified?
-  if (filter_field_name_.empty ())
+  // Attempt to get the field name's index
+  const PassThroughCondition<PointT> condition (filter_field_name_, filter_limit_min_, filter_limit_max_, negative_);
+  if (!condition.isCapable ())
   {
-    // Only filter for non-finite entries then
-    for (int iii = 0; iii < static_cast<int> (indices_->size ()); ++iii)  // iii = input indices iterator
-    {
-      // Non-finite entries are always passed to removed indices
-      if (!pcl_isfinite (input_->points[(*indices_)[iii]].x) ||
-          !pcl_isfinite (input_->points[(*indices_)[iii]].y) ||
-          !pcl_isfinite (input_->points[(*indices_)[iii]].z))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = (*indices_)[iii];
-        continue;
-      }
-      indices[oii++] = (*indices_)[iii];
-    }
+    PCL_WARN ("[pcl::%s::applyFilter] Unable to find field name in point type.\n", getClassName ().c_str ());
+    indices.clear ();
+    removed_indices_->clear ();
+    return;
   }
-  else
+
+  // The points are classified in parallel, then compacted in their input order
+  const int nr_indices = static_cast<int> (indices_->size ());
+  std::vector<unsigned char> inlier (nr_indices, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (static)
+#endif
+  for (int iii = 0; iii < nr_indices; ++iii)  // iii = input indices iterator
+    inlier[iii] = condition.evaluate (input_->points[(*indices_)[iii]]);
+
+  for (int iii = 0; iii < nr_indices; ++iii)
   {
-    // Attempt to get the field name's index
-    std::vector<pcl::PCLPointField> fields;
-    int distance_idx = pcl::getFieldIndex (*input_, filter_field_name_, fields);
-    if (distance_idx == -1)
-    {
-      PCL_WARN ("[pcl::%s::applyFilter] Unable to find field name in point type.\n", getClassName ().c_str ());
-      indices.clear ();
-      removed_indices_->clear ();
-      return;
-    }
-
-    // Filter for non-finite entries and the specified field limits
-    for (int iii = 0; iii < static_cast<int> (indices_->size ()); ++iii)  // iii = input indices iterator
-    {
-      // Non-finite entries are always passed to removed indices
-      if (!pcl_isfinite (input_->points[(*indices_)[iii]].x) ||
-          !pcl_isfinite (input_->points[(*indices_)[iii]].y) ||
-          !pcl_isfinite (input_->points[(*indices_)[iii]].z))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = (*indices_)[iii];
-        continue;
-      }
-
-      // Get the field's value
-      const uint8_t* pt_data = reinterpret_cast<const uint8_t*> (&input_->points[(*indices_)[iii]]);
-      float field_value = 0;
-      memcpy (&field_value, pt_data + fields[distance_idx].offset, sizeof (float));
-
-      // Remove NAN/INF/-INF values. We expect passthrough to output clean valid data.
-      if (!pcl_isfinite (field_value))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = (*indices_)[iii];
-        continue;
-      }
-
-      // Outside of the field limits are passed to removed indices
-      if (!negative_ && (field_value < filter_limit_min_ || field_value > filter_limit_max_))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = (*indices_)[iii];
-        continue;
-      }
-
-      // Inside of the field limits are passed to removed indices if negative was set
-      if (negative_ && field_value >= filter_limit_min_ && field_value <= filter_limit_max_)
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = (*indices_)[iii];
-        continue;
-      }
-
-      // Otherwise it was a normal point for output (inlier)
+    if (inlier[iii])
       indices[oii++] = (*indices_)[iii];
-    }
+    else if (extract_removed_indices_)
+      (*removed_indices_)[rii++] = (*indices_)[iii];
   }
 
   // Resize the output arrays
@@ -161,6 +156,7 @@ pcl::PassThrough<PointT>::applyFilterIndices (std::vector<int> &indices)
   removed_indices_->resize (rii);
 }
 
+#define PCL_INSTANTIATE_PassThroughCondition(T) template class PCL_EXPORTS pcl::PassThroughCondition<T>;
 #define PCL_INSTANTIATE_PassThrough(T) template class PCL_EXPORTS pcl::PassThrough<T>;
 
 #endif  // PCL_FILTERS_IMPL_PASSTHROUGH_HPP_
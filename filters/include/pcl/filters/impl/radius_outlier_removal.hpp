@@ -80,99 +80,84 @@ pcl::RadiusOutlierRemoval<PointT>::applyFilterIndices (std::vector<int> &indices
     return;
   }
 
-  // Initialize the search class
-  if (!searcher_)
+  // Initialize the search class, a user given search method that is already set up on the input is
+  // used as is if reusing its index was requested
+  SearcherPtr searcher = searcher_;
+  if (!searcher)
   {
     if (input_->isOrganized ())
-      searcher_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
+      searcher.reset (new pcl::search::OrganizedNeighbor<PointT> ());
     else
-      searcher_.reset (new pcl::search::KdTree<PointT> (false));
+      searcher.reset (new pcl::search::KdTree<PointT> (false));
   }
-  searcher_->setInputCloud (input_);
+  if (searcher != searcher_ || !reuse_search_index_ || searcher->getInputCloud () != input_ || searcher->getIndices ())
+    searcher->setInputCloud (input_);
 
-  // The arrays to be used
-  std::vector<int> nn_indices (indices_->size ());
-  std::vector<float> nn_dists (indices_->size ());
-  indices.resize (indices_->size ());
-  removed_indices_->resize (indices_->size ());
-  int oii = 0, rii = 0;  // oii = output indices iterator, rii = removed indices iterator
+  // Classification of every point, filled in parallel and compacted afterwards to keep the order of the indices
+  std::vector<unsigned char> inlier (indices_->size (), 0);
 
   // If the data is dense => use nearest-k search
-  if (input_->is_dense)
-  {
-    // Note: k includes the query point, so is always at least 1
-    int mean_k = min_pts_radius_ + 1;
-    double nn_dists_max = search_radius_ * search_radius_;
+  // NaN or Inf values could exist => use radius search
+  const bool dense = input_->is_dense;
 
-    for (std::vector<int>::const_iterator it = indices_->begin (); it != indices_->end (); ++it)
-    {
-      // Perform the nearest-k search
-      int k = searcher_->nearestKSearch (*it, mean_k, nn_indices, nn_dists);
+  // Note: k includes the query point, so is always at least 1
+  const int mean_k = min_pts_radius_ + 1;
+  const double nn_dists_max = search_radius_ * search_radius_;
 
-      // Check the number of neighbors
-      // Note: nn_dists is sorted, so check the last item
-      bool chk_neighbors = true;
-      if (k == mean_k)
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
+  {
+    // Search results, reused for all points of this thread
+    std::vector<int> nn_indices;
+    std::vector<float> nn_dists;
+    nn_indices.reserve (mean_k);
+    nn_dists.reserve (mean_k);
+
+#ifdef _OPENMP
+#pragma omp for schedule (static)
+#endif
+    for (int iii = 0; iii < static_cast<int> (indices_->size ()); ++iii)  // iii = input indices iterator
+    {
+      bool enough_neighbors;
+      if (dense)
       {
-        if (negative_)
-        {
-          chk_neighbors = false;
-          if (nn_dists_max < nn_dists[k-1])
-          {
-            chk_neighbors = true;
-          }
-        }
-        else
-        {
-          chk_neighbors = true;
-          if (nn_dists_max < nn_dists[k-1])
-          {
-            chk_neighbors = false;
-          }
-        }
+        // Perform the nearest-k search
+        int k = searcher->nearestKSearch ((*indices_)[iii], mean_k, nn_indices, nn_dists);
+
+        // Check the number of neighbors
+        // Note: nn_dists is sorted, so check the last item
+        enough_neighbors = (k == mean_k && nn_dists[k-1] <= nn_dists_max);
       }
       else
       {
-        if (negative_)
-          chk_neighbors = true;
-        else
-          chk_neighbors = false;
+        // Perform the radius search, returning at most mean_k neighbors. This only bounds the size of the
+        // result: pcl::search::OrganizedNeighbor stops as soon as mean_k neighbors were found, but
+        // pcl::search::KdTree still visits every neighbor inside the radius
+        int k = searcher->radiusSearch ((*indices_)[iii], search_radius_, nn_indices, nn_dists, static_cast<unsigned int> (mean_k));
+        enough_neighbors = (k > min_pts_radius_);
       }
 
       // Points having too few neighbors are outliers and are passed to removed indices
       // Unless negative was set, then it's the opposite condition
-      if (!chk_neighbors)
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = *it;
-        continue;
-      }
-
-      // Otherwise it was a normal point for output (inlier)
-      indices[oii++] = *it;
+      inlier[iii] = (enough_neighbors != negative_);
     }
   }
-  // NaN or Inf values could exist => use radius search
-  else
+
+  indices.resize (indices_->size ());
+  removed_indices_->resize (indices_->size ());
+  int oii = 0, rii = 0;  // oii = output indices iterator, rii = removed indices iterator
+  for (size_t iii = 0; iii < indices_->size (); ++iii)
   {
-    for (std::vector<int>::const_iterator it = indices_->begin (); it != indices_->end (); ++it)
+    if (!inlier[iii])
     {
-      // Perform the radius search
-      // Note: k includes the query point, so is always at least 1
-      int k = searcher_->radiusSearch (*it, search_radius_, nn_indices, nn_dists);
-
-      // Points having too few neighbors are outliers and are passed to removed indices
-      // Unless negative was set, then it's the opposite condition
-      if ((!negative_ && k <= min_pts_radius_) || (negative_ && k > min_pts_radius_))
-      {
-        if (extract_removed_indices_)
-          (*removed_indices_)[rii++] = *it;
-        continue;
-      }
-
-      // Otherwise it was a normal point for output (inlier)
-      indices[oii++] = *it;
+      if (extract_removed_indices_)
+        (*removed_indices_)[rii++] = (*indices_)[iii];
+      continue;
     }
+
+    // Otherwise it was a normal point for output (inlier)
+    indices[oii++] = (*indices_)[iii];
   }
 
   // Resize the output arrays
@@ -72,19 +72,20 @@ pcl::StatisticalOutlierRemoval<PointT>::applyFilter (PointCloud &output)
 template <typename PointT> void
 pcl::StatisticalOutlierRemoval<PointT>::applyFilterIndices (std::vector<int> &indices)
 {
-  // Initialize the search class
-  if (!searcher_)
+  // Initialize the search class, a user given search method that is already set up on the input is
+  // used as is if reusing its index was requested
+  SearcherPtr searcher = searcher_;
+  if (!searcher)
   {
     if (input_->isOrganized ())
-      searcher_.reset (new pcl::search::OrganizedNeighbor<PointT> ());
+      searcher.reset (new pcl::search::OrganizedNeighbor<PointT> ());
     else
-      searcher_.reset (new pcl::search::KdTree<PointT> (false));
+      searcher.reset (new pcl::search::KdTree<PointT> (false));
   }
-  searcher_->setInputCloud (input_);
+  if (searcher != searcher_ || !reuse_search_index_ || searcher->getInputCloud () != input_ || searcher->getIndices ())
+    searcher->setInputCloud (input_);
 
   // The arrays to be used
-  std::vector<int> nn_indices (mean_k_);
-  std::vector<float> nn_dists (mean_k_);
   std::vector<float> distances (indices_->size ());
   indices.resize (indices_->size ());
   removed_indices_->resize (indices_->size ());
@@ -92,39 +93,54 @@ pcl::StatisticalOutlierRemoval<PointT>::applyFilterIndices (std::vector<int> &in
 
   // First pass: Compute the mean distances for all points with respect to their k nearest neighbors
   int valid_distances = 0;
-  for (int iii = 0; iii < static_cast<int> (indices_->size ()); ++iii)  // iii = input indices iterator
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_) reduction (+: valid_distances)
+#endif
   {
-    if (!pcl_isfinite (input_->points[(*indices_)[iii]].x) ||
-        !pcl_isfinite (input_->points[(*indices_)[iii]].y) ||
-        !pcl_isfinite (input_->points[(*indices_)[iii]].z))
-    {
-      distances[iii] = 0.0;
-      continue;
-    }
-
-    // Perform the nearest k search
-    if (searcher_->nearestKSearch ((*indices_)[iii], mean_k_ + 1, nn_indices, nn_dists) == 0)
+    // Search results, reused for all points of this thread
+    std::vector<int> nn_indices (mean_k_);
+    std::vector<float> nn_dists (mean_k_);
+
+#ifdef _OPENMP
+#pragma omp for schedule (static)
+#endif
+    for (int iii = 0; iii < static_cast<int> (indices_->size ()); ++iii)  // iii = input indices iterator
     {
-      distances[iii] = 0.0;
-      PCL_WARN ("[pcl::%s::applyFilter] Searching for the closest %d neighbors failed.\n", getClassName ().c_str (), mean_k_);
-      continue;
+      if (!pcl_isfinite (input_->points[(*indices_)[iii]].x) ||
+          !pcl_isfinite (input_->points[(*indices_)[iii]].y) ||
+          !pcl_isfinite (input_->points[(*indices_)[iii]].z))
+      {
+        distances[iii] = 0.0;
+        continue;
+      }
+
+      // Perform the nearest k search
+      if (searcher->nearestKSearch ((*indices_)[iii], mean_k_ + 1, nn_indices, nn_dists) == 0)
+      {
+        distances[iii] = 0.0;
+        PCL_WARN ("[pcl::%s::applyFilter] Searching for the closest %d neighbors failed.\n", getClassName ().c_str (), mean_k_);
+        continue;
+      }
+
+      // Calculate the mean distance to its neighbors
+      double dist_sum = 0.0;
+      for (int k = 1; k < mean_k_ + 1; ++k)  // k = 0 is the query point
+        dist_sum += sqrt (nn_dists[k]);
+      distances[iii] = static_cast<float> (dist_sum / mean_k_);
+      valid_distances++;
     }
-
-    // Calculate the mean distance to its neighbors
-    double dist_sum = 0.0;
-    for (int k = 1; k < mean_k_ + 1; ++k)  // k = 0 is the query point
-      dist_sum += sqrt (nn_dists[k]);
-    distances[iii] = static_cast<float> (dist_sum / mean_k_);
-    valid_distances++;
   }
 
-  // Estimate the mean and the standard deviation of the distance vector
+  // Accumulate the sums in input order, so that the threshold does not depend on the number of threads;
+  // points without a valid distance were set to 0 and do not contribute
   double sum = 0, sq_sum = 0;
   for (size_t i = 0; i < distances.size (); ++i)
   {
     sum += distances[i];
     sq_sum += distances[i] * distances[i];
   }
+
+  // Estimate the mean and the standard deviation of the distance vector
   double mean = sum / static_cast<double>(valid_distances);
   double variance = (sq_sum - sum * sum / static_cast<double>(valid_distances)) / (static_cast<double>(valid_distances) - 1);
   double stddev = sqrt (variance);
@@ -138,39 +138,72 @@ pcl::VoxelGridOcclusionEstimation<PointT>::occlusionEstimationAll (std::vector<E
     return -1;
   }
 
-  // reserve space for the ray vector
-  int reserve_size = div_b_[0] * div_b_[1] * div_b_[2];
-  occluded_voxels.reserve (reserve_size);
-
-  // iterate over the entire voxel grid
-  for (int kk = min_b_.z (); kk <= max_b_.z (); ++kk)
-    for (int jj = min_b_.y (); jj <= max_b_.y (); ++jj)
-      for (int ii = min_b_.x (); ii <= max_b_.x (); ++ii)
-      {
-        Eigen::Vector3i ijk (ii, jj, kk);
-        // process all free voxels
-        int index = this->getCentroidIndexAt (ijk);
-        if (index == -1)
-        {
-          // estimate direction to target voxel
-          Eigen::Vector4f p = getCentroidCoordinate (ijk);
-          Eigen::Vector4f direction = p - sensor_origin_;
-          direction.normalize ();
-          
-          // estimate entry point into the voxel grid
-          float tmin = rayBoxIntersection (sensor_origin_, direction);
-
-          // ray traversal
-          int state = rayTraversal (ijk, sensor_origin_, direction, tmin);
-          
-          // if voxel is occluded
-          if (state == 1)
-            occluded_voxels.push_back (ijk);
-        }
-      }
+  estimateGridOcclusion (false, occluded_voxels);
   return 0;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::VoxelGridOcclusionEstimation<PointT>::occlusionEstimationOccupied (std::vector<Eigen::Vector3i>& occluded_voxels)
+{
+  if (!initialized_)
+  {
+    PCL_ERROR ("Voxel grid not initialized; call initializeVoxelGrid () first! \n");
+    return -1;
+  }
+
+  estimateGridOcclusion (true, occluded_voxels);
+  return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::VoxelGridOcclusionEstimation<PointT>::estimateGridOcclusion (bool occupied,
+                                                                  std::vector<Eigen::Vector3i>& occluded_voxels)
+{
+  // The rays are independent, every one of them writes the state of its target voxel. A row of
+  // voxels along x is handled by one thread at a time: its rays are coherent and visit mostly the
+  // same part of the leaf layout.
+  const int nr_rows = div_b_[1] * div_b_[2];
+  std::vector<unsigned char> occluded (static_cast<size_t> (nr_rows) * div_b_[0], 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (dynamic, 1)
+#endif
+  for (int row = 0; row < nr_rows; ++row)
+  {
+    const int jj = min_b_[1] + row % div_b_[1];
+    const int kk = min_b_[2] + row / div_b_[1];
+    for (int ii = min_b_[0]; ii <= max_b_[0]; ++ii)
+    {
+      Eigen::Vector3i ijk (ii, jj, kk);
+      if ((this->getCentroidIndexAt (ijk) != -1) != occupied)
+        continue;
+
+      // estimate direction to target voxel
+      Eigen::Vector4f p = getCentroidCoordinate (ijk);
+      Eigen::Vector4f direction = p - sensor_origin_;
+      direction.normalize ();
+
+      // estimate entry point into the voxel grid
+      float tmin = rayBoxIntersection (sensor_origin_, direction);
+
+      // ray traversal
+      if (rayTraversal (ijk, sensor_origin_, direction, tmin) == 1)
+        occluded[static_cast<size_t> (row) * div_b_[0] + (ii - min_b_[0])] = 1;
+    }
+  }
+
+  // collect the occluded voxels in grid order
+  size_t nr_occluded = 0;
+  for (size_t i = 0; i < occluded.size (); ++i)
+    nr_occluded += occluded[i];
+  occluded_voxels.reserve (occluded_voxels.size () + nr_occluded);
+  for (int row = 0; row < nr_rows; ++row)
+    for (int ii = 0; ii < div_b_[0]; ++ii)
+      if (occluded[static_cast<size_t> (row) * div_b_[0] + ii])
+        occluded_voxels.push_back (Eigen::Vector3i (min_b_[0] + ii, min_b_[1] + row % div_b_[1], min_b_[2] + row / div_b_[1]));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> float
 pcl::VoxelGridOcclusionEstimation<PointT>::rayBoxIntersection (const Eigen::Vector4f& origin, 
@@ -296,8 +329,12 @@ pcl::VoxelGridOcclusionEstimation<PointT>::rayTraversal (const Eigen::Vector3i&
   float t_delta_y = leaf_size_[1] / static_cast<float> (fabs (direction[1]));
   float t_delta_z = leaf_size_[2] / static_cast<float> (fabs (direction[2]));
 
-  // index of the point in the point cloud
-  int index;
+  // index of the current voxel in the leaf layout, updated along with ijk
+  const int step_index_x = step_x * divb_mul_[0];
+  const int step_index_y = step_y * divb_mul_[1];
+  const int step_index_z = step_z * divb_mul_[2];
+  int layout_index = ((Eigen::Vector4i () << ijk, 0).finished () - min_b_).dot (divb_mul_);
+  const int layout_size = static_cast<int> (leaf_layout_.size ());
 
   while ( (ijk[0] < max_b_[0]+1) && (ijk[0] >= min_b_[0]) && 
           (ijk[1] < max_b_[1]+1) && (ijk[1] >= min_b_[1]) && 
@@ -308,8 +345,7 @@ pcl::VoxelGridOcclusionEstimation<PointT>::rayTraversal (const Eigen::Vector3i&
       return 0;
 
     // check if voxel is occupied, if yes return 1 for occluded
-    index = this->getCentroidIndexAt (ijk);
-    if (index != -1)
+    if (layout_index < layout_size && leaf_layout_[layout_index] != -1)
       return 1;
 
     // estimate next voxel
@@ -317,16 +353,19 @@ pcl::VoxelGridOcclusionEstimation<PointT>::rayTraversal (const Eigen::Vector3i&
     {
       t_max_x += t_delta_x;
       ijk[0] += step_x;
+      layout_index += step_index_x;
     }
     else if(t_max_y <= t_max_z && t_max_y <= t_max_x)
     {
       t_max_y += t_delta_y;
       ijk[1] += step_y;
+      layout_index += step_index_y;
     }
     else
     {
       t_max_z += t_delta_z;
       ijk[2] += step_z;
+      layout_index += step_index_z;
     }
   }
   return 0;
@@ -340,8 +379,8 @@ pcl::VoxelGridOcclusionEstimation<PointT>::rayTraversal (std::vector <Eigen::Vec
                                                          const Eigen::Vector4f& direction,
                                                          const float t_min)
 {
-  // reserve space for the ray vector
-  int reserve_size = div_b_.maxCoeff () * div_b_.maxCoeff ();
+  // reserve space for the ray vector, a ray enters at most one new voxel per step along each axis
+  int reserve_size = div_b_[0] + div_b_[1] + div_b_[2];
   out_ray.reserve (reserve_size);
 
   // coordinate of the boundary of the voxel grid
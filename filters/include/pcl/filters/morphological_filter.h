@@ -72,6 +72,21 @@ namespace pcl
   applyMorphologicalOperator (const typename pcl::PointCloud<PointT>::ConstPtr &cloud_in,
                               float resolution, const int morphological_operator,
                               pcl::PointCloud<PointT> &cloud_out);
+
+  /** \brief Apply morphological operator to a 2D grid of elevations, e.g. the minimum z of the points in each cell
+    * The square window spans 2 * half_size + 1 cells. Erosion and dilation use the van Herk / Gil-Werman
+    * algorithm on rows and columns, so their cost per cell does not depend on the window size.
+    * \param[in] grid_in the input grid, empty cells are NaN and are ignored
+    * \param[in] half_size the number of cells of the window on each side of a cell
+    * \param[in] morphological_operator the morphological operator to apply (open, close, dilate, erode)
+    * \param[out] grid_out the resultant grid, cells without any non-empty cell in their window are NaN
+    * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+    * \ingroup filters
+    */
+  PCL_EXPORTS void
+  applyMorphologicalOperator (const Eigen::MatrixXf &grid_in, int half_size,
+                              const int morphological_operator, Eigen::MatrixXf &grid_out,
+                              unsigned int nr_threads = 1);
 }
 
 #ifdef PCL_NO_PRECOMPILE
@@ -41,9 +41,52 @@
 #define PCL_FILTERS_PASSTHROUGH_H_
 
 #include <pcl/filters/filter_indices.h>
+#include <pcl/filters/conditional_removal.h>
 
 namespace pcl
 {
+  /** \brief The per-point test of PassThrough as a condition: a point meets it when it is finite and the value of
+    * the tested field is finite and inside the limits (outside of them, if negative). PassThrough evaluates it for
+    * every point, FilterPipeline evaluates it together with other conditions in a single sweep.
+    * \ingroup filters
+    */
+  template <typename PointT>
+  class PassThroughCondition : public ConditionBase<PointT>
+  {
+    using ConditionBase<PointT>::capable_;
+
+    public:
+      typedef boost::shared_ptr<PassThroughCondition<PointT> > Ptr;
+      typedef boost::shared_ptr<const PassThroughCondition<PointT> > ConstPtr;
+
+      /** \brief Constructor. The condition is not capable if the point type has no field \a field_name.
+        * \param[in] field_name the name of the tested field, an empty name only tests the point for being finite
+        * \param[in] limit_min the minimum allowed field value
+        * \param[in] limit_max the maximum allowed field value
+        * \param[in] negative true to let the points outside of the limits pass instead
+        */
+      PassThroughCondition (const std::string &field_name, float limit_min, float limit_max, bool negative);
+
+      /** \brief Determine if a point meets this condition.
+        * \return whether the point meets this condition.
+        */
+      virtual bool
+      evaluate (const PointT &point) const;
+
+    protected:
+      /** \brief The offset of the tested field in the point, or -1 if no field is tested. */
+      int field_offset_;
+
+      /** \brief The minimum allowed field value. */
+      float limit_min_;
+
+      /** \brief The maximum allowed field value. */
+      float limit_max_;
+
+      /** \brief True if the points outside of the limits pass. */
+      bool negative_;
+  };
+
   /** \brief @b PassThrough passes points in a cloud based on constraints for one particular field of the point type.
     * \details Iterates through the entire input once, automatically filtering non-finite points and the points outside
     * the interval specified by setFilterLimits(), which applies only to the field specified by setFilterFieldName().
@@ -98,7 +141,8 @@ namespace pcl
         FilterIndices<PointT>::FilterIndices (extract_removed_indices),
         filter_field_name_ (""),
         filter_limit_min_ (FLT_MIN),
-        filter_limit_max_ (FLT_MAX)
+        filter_limit_max_ (FLT_MAX),
+        threads_ (1)
       {
         filter_name_ = "PassThrough";
       }
@@ -176,6 +220,24 @@ namespace pcl
         return (negative_);
       }
 
+      /** \brief Get the test this filter applies to every point, with its current settings. */
+      inline typename PassThroughCondition<PointT>::Ptr
+      getCondition () const
+      {
+        return (typename PassThroughCondition<PointT>::Ptr (new PassThroughCondition<PointT> (
+            filter_field_name_, filter_limit_min_, filter_limit_max_, negative_)));
+      }
+
+      /** \brief Set the number of threads used to test the points against the field limits.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The output does not depend on the number of threads. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
     protected:
       using PCLBase<PointT>::input_;
       using PCLBase<PointT>::indices_;
@@ -217,6 +279,9 @@ namespace pcl
 
       /** \brief The maximum allowed field value (default = FLT_MIN). */
       float filter_limit_max_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
   };
 
   ////////////////////////////////////////////////////////////////////////////////////////////
@@ -98,8 +98,10 @@ namespace pcl
       StatisticalOutlierRemoval (bool extract_removed_indices = false) :
         FilterIndices<PointT>::FilterIndices (extract_removed_indices),
         searcher_ (),
+        reuse_search_index_ (false),
         mean_k_ (1),
-        std_mul_ (0.0)
+        std_mul_ (0.0),
+        threads_ (1)
       {
         filter_name_ = "StatisticalOutlierRemoval";
       }
@@ -143,6 +145,36 @@ namespace pcl
         return (std_mul_);
       }
 
+      /** \brief Provide the search method used for the neighbor searches.
+        * \details By default the input cloud of the search method is set, and its index rebuilt, on every
+        * call to filter (). With \a reuse_index, a search method whose input cloud already is the input cloud
+        * of this filter (the same pointer, without indices) is used as is, which lets several filters share
+        * one spatial index.
+        * \warning With \a reuse_index, the index is not rebuilt when the points of the input cloud are changed
+        * in place through the same pointer: the searches then run on the stale index and return wrong
+        * neighbors. Call setInputCloud () on the search method after editing the cloud.
+        * \param[in] searcher the search method, or an empty pointer to use a KdTree (or an OrganizedNeighbor
+        * for organized clouds) that is built on every call
+        * \param[in] reuse_index true to use the search method as is when it is already set up on the input
+        * cloud (default = false)
+        */
+      inline void
+      setSearchMethod (const typename pcl::search::Search<PointT>::Ptr &searcher, bool reuse_index = false)
+      {
+        searcher_ = searcher;
+        reuse_search_index_ = reuse_index;
+      }
+
+      /** \brief Set the number of threads used for the neighbor searches.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The classification does not depend on the number of threads. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
     protected:
       using PCLBase<PointT>::input_;
       using PCLBase<PointT>::indices_;
@@ -179,12 +211,18 @@ namespace pcl
       /** \brief A pointer to the spatial search object. */
       SearcherPtr searcher_;
 
+      /** \brief True if the spatial search object is used as is when it is set up on the input cloud. */
+      bool reuse_search_index_;
+
       /** \brief The number of points to use for mean distance estimation. */
       int mean_k_;
 
       /** \brief Standard deviations threshold (i.e., points outside of 
         * \f$ \mu \pm \sigma \cdot std\_mul \f$ will be marked as outliers). */
       double std_mul_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
   };
 
   /** \brief @b StatisticalOutlierRemoval uses point neighborhood statistics to filter outlier data. For more
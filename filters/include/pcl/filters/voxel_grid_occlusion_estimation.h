@@ -61,6 +61,8 @@ namespace pcl
       using VoxelGrid<PointT>::div_b_;
       using VoxelGrid<PointT>::leaf_size_;
       using VoxelGrid<PointT>::inverse_leaf_size_;
+      using VoxelGrid<PointT>::divb_mul_;
+      using VoxelGrid<PointT>::leaf_layout_;
 
       typedef typename Filter<PointT>::PointCloud PointCloud;
       typedef typename PointCloud::Ptr PointCloudPtr;
@@ -71,6 +73,7 @@ namespace pcl
       VoxelGridOcclusionEstimation ()
       {
         initialized_ = false;
+        threads_ = 1;
         this->setSaveLeafLayout (true);
       }
 
@@ -120,6 +123,26 @@ namespace pcl
       int
       occlusionEstimationAll (std::vector<Eigen::Vector3i>& occluded_voxels);
 
+      /** \brief Returns the voxel coordinates (i, j, k) of all occupied
+        * voxels which are hidden from the sensor by another occupied voxel,
+        * i.e. a ray is cast from the sensor origin towards every filled voxel.
+        * \param[out] occluded_voxels the coordinates (i, j, k) of all occluded occupied voxels
+        * \return 0 on success, -1 if the voxel grid is not initialized
+        */
+      int
+      occlusionEstimationOccupied (std::vector<Eigen::Vector3i>& occluded_voxels);
+
+      /** \brief Set the number of threads used to cast the rays in \a occlusionEstimationAll
+        * and \a occlusionEstimationOccupied.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        * \note The result does not depend on the number of threads. The default is 1.
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
       /** \brief Returns the voxel grid filtered point cloud
         * \return The voxel grid filtered point cloud
         */
@@ -208,6 +231,14 @@ namespace pcl
                     const Eigen::Vector4f& direction,
                     const float t_min);
 
+      /** \brief Cast a ray from the sensor origin towards every free (or every
+        * occupied) voxel of the grid and collect the occluded ones, in grid order.
+        * \param[in] occupied true to cast the rays towards the occupied voxels, false for the free ones
+        * \param[out] occluded_voxels the coordinates (i, j, k) of the occluded voxels
+        */
+      void
+      estimateGridOcclusion (bool occupied, std::vector<Eigen::Vector3i>& occluded_voxels);
+
       /** \brief Returns a rounded value. 
         * \param[in] d
         * \return rounded value
@@ -243,6 +274,9 @@ namespace pcl
 
       // voxel grid filtered cloud
       PointCloud filtered_cloud_;
+
+      // number of threads used to cast the rays
+      unsigned int threads_;
   };
 }
 
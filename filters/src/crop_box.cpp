@@ -212,6 +212,7 @@ pcl::CropBox<pcl::PCLPointCloud2>::applyFilter (std::vector<int> &indices)
 #include <pcl/impl/instantiate.hpp>
 #include <pcl/point_types.h>
 
+PCL_INSTANTIATE(CropBoxCondition, PCL_XYZ_POINT_TYPES)
 PCL_INSTANTIATE(CropBox, PCL_XYZ_POINT_TYPES)
 
 #endif    // PCL_NO_PRECOMPILE
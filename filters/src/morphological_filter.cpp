@@ -41,6 +41,137 @@
 
 #include <pcl/filters/impl/morphological_filter.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+  /** \brief Running minimum or maximum over a centered window of one row or column (van Herk / Gil-Werman).
+    * Empty cells and the cells beyond the borders hold the identity of the operation.
+    */
+  void
+  slidingMinMax (const float *in, std::ptrdiff_t in_stride, int size, int half_size, bool take_min,
+                 float *out, std::ptrdiff_t out_stride,
+                 std::vector<float> &padded, std::vector<float> &prefix, std::vector<float> &suffix)
+  {
+    const float identity = take_min ? std::numeric_limits<float>::infinity () : -std::numeric_limits<float>::infinity ();
+    const int window = 2 * half_size + 1;
+    const int padded_size = size + 2 * half_size;
+    padded.assign (padded_size, identity);
+    for (int i = 0; i < size; ++i)
+    {
+      const float value = in[i * in_stride];
+      if (!pcl_isnan (value))
+        padded[half_size + i] = value;
+    }
+
+    // Minimum (maximum) from the start of each block of window cells, and up to the end of it
+    prefix.resize (padded_size);
+    suffix.resize (padded_size);
+    for (int j = 0; j < padded_size; ++j)
+    {
+      if (j % window == 0)
+        prefix[j] = padded[j];
+      else
+        prefix[j] = take_min ? std::min (prefix[j - 1], padded[j]) : std::max (prefix[j - 1], padded[j]);
+    }
+    for (int j = padded_size - 1; j >= 0; --j)
+    {
+      if (j == padded_size - 1 || (j + 1) % window == 0)
+        suffix[j] = padded[j];
+      else
+        suffix[j] = take_min ? std::min (suffix[j + 1], padded[j]) : std::max (suffix[j + 1], padded[j]);
+    }
+
+    // The window of cell i covers padded[i] to padded[i + 2 * half_size], which spans at most two blocks
+    for (int i = 0; i < size; ++i)
+      out[i * out_stride] = take_min ? std::min (suffix[i], prefix[i + 2 * half_size])
+                                     : std::max (suffix[i], prefix[i + 2 * half_size]);
+  }
+
+  /** \brief Erosion (take_min) or dilation of a grid, separable over rows and then columns */
+  void
+  erodeOrDilateGrid (const Eigen::MatrixXf &grid_in, int half_size, bool take_min, Eigen::MatrixXf &grid_out,
+                     unsigned int nr_threads)
+  {
+    const int rows = static_cast<int> (grid_in.rows ());
+    const int cols = static_cast<int> (grid_in.cols ());
+    Eigen::MatrixXf row_pass (rows, cols);
+    grid_out.resize (rows, cols);
+    // A window larger than the grid is the same as one covering all of it
+    const int row_half_size = std::min (half_size, cols);
+    const int col_half_size = std::min (half_size, rows);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+    {
+      std::vector<float> padded, prefix, suffix;
+      // Along each row: the cells are rows apart in the column major storage
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (int r = 0; r < rows; ++r)
+        slidingMinMax (grid_in.data () + r, rows, cols, row_half_size, take_min,
+                       row_pass.data () + r, rows, padded, prefix, suffix);
+
+      // Along each column, on the result of the rows
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (int c = 0; c < cols; ++c)
+      {
+        float *column = grid_out.data () + static_cast<std::ptrdiff_t> (c) * rows;
+        slidingMinMax (row_pass.data () + static_cast<std::ptrdiff_t> (c) * rows, 1, rows, col_half_size, take_min,
+                       column, 1, padded, prefix, suffix);
+        // Cells whose window only holds empty cells are empty
+        for (int r = 0; r < rows; ++r)
+          if (!pcl_isfinite (column[r]) && !pcl_isnan (column[r]))
+            column[r] = std::numeric_limits<float>::quiet_NaN ();
+      }
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::applyMorphologicalOperator (const Eigen::MatrixXf &grid_in, int half_size,
+                                 const int morphological_operator, Eigen::MatrixXf &grid_out,
+                                 unsigned int nr_threads)
+{
+#ifdef _OPENMP
+  if (nr_threads == 0)
+    nr_threads = omp_get_num_procs ();
+#endif
+  if (half_size < 0)
+    half_size = 0;
+
+  switch (morphological_operator)
+  {
+    case MORPH_DILATE:
+    case MORPH_ERODE:
+    {
+      erodeOrDilateGrid (grid_in, half_size, morphological_operator == MORPH_ERODE, grid_out, nr_threads);
+      break;
+    }
+    case MORPH_OPEN:
+    case MORPH_CLOSE:
+    {
+      Eigen::MatrixXf grid_temp;
+      erodeOrDilateGrid (grid_in, half_size, morphological_operator == MORPH_OPEN, grid_temp, nr_threads);
+      erodeOrDilateGrid (grid_temp, half_size, morphological_operator == MORPH_CLOSE, grid_out, nr_threads);
+      break;
+    }
+    default:
+    {
+      PCL_ERROR ("Morphological operator is not supported!\n");
+      grid_out = grid_in;
+      break;
+    }
+  }
+}
+
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/impl/instantiate.hpp>
 #include <pcl/point_types.h>
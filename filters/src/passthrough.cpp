@@ -284,6 +284,7 @@ pcl::PassThrough<pcl::PCLPointCloud2>::applyFilter (PCLPointCloud2 &output)
 #include <pcl/point_types.h>
 
 // Instantiations of specific point types
+PCL_INSTANTIATE(PassThroughCondition, PCL_XYZ_POINT_TYPES)
 PCL_INSTANTIATE(PassThrough, PCL_XYZ_POINT_TYPES)
 
 #endif    // PCL_NO_PRECOMPILE
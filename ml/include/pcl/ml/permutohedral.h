@@ -44,6 +44,7 @@
 
 #include <vector>
 #include <map>
+#include <pcl/pcl_macros.h>
 #include <pcl/common/eigen.h>
 #include <boost/intrusive/hashtable.hpp>
 
@@ -67,7 +68,7 @@ namespace pcl
     *   pages = {2010}
     * }
     */
-  class Permutohedral
+  class PCL_EXPORTS Permutohedral
   {
     protected:
       struct Neighbors
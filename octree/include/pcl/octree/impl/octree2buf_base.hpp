@@ -39,6 +39,10 @@
 #ifndef PCL_OCTREE_2BUF_BASE_HPP
 #define PCL_OCTREE_2BUF_BASE_HPP
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace pcl
 {
   namespace octree
@@ -54,7 +58,10 @@ namespace pcl
       buffer_selector_ (0),
       tree_dirty_flag_ (false),
       octree_depth_ (0),
-      dynamic_depth_enabled_(false)
+      dynamic_depth_enabled_(false),
+      node_pool_enabled_ (false),
+      branch_pool_ (),
+      leaf_pool_ ()
     {
     }
 
@@ -301,6 +308,153 @@ namespace pcl
     }
 
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename LeafContainerT, typename BranchContainerT> void
+    Octree2BufBase<LeafContainerT, BranchContainerT>::enableNodePool (bool enable_arg)
+    {
+      node_pool_enabled_ = enable_arg;
+
+      if (!node_pool_enabled_)
+      {
+        branch_pool_.deletePool ();
+        leaf_pool_.deletePool ();
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename LeafContainerT, typename BranchContainerT> void
+    Octree2BufBase<LeafContainerT, BranchContainerT>::serializeChangedLeafs (std::vector<LeafContainerT*>& new_leafs_arg,
+                                                                             std::vector<LeafContainerT*>& removed_leafs_arg,
+                                                                             std::vector<OctreeKey>* new_keys_arg,
+                                                                             std::vector<OctreeKey>* removed_keys_arg,
+                                                                             unsigned int threads_arg)
+    {
+      new_leafs_arg.clear ();
+      removed_leafs_arg.clear ();
+      if (new_keys_arg)
+        new_keys_arg->clear ();
+      if (removed_keys_arg)
+        removed_keys_arg->clear ();
+
+#ifdef _OPENMP
+      if (threads_arg == 0)
+        threads_arg = static_cast<unsigned int> (omp_get_num_procs ());
+#endif
+      if (threads_arg == 0)
+        threads_arg = 1;
+
+      // split the top levels of the octree until there is enough work to balance across threads
+      std::vector<ChangedSubtreeTask> tasks (1);
+      tasks[0].node = root_node_;
+      tasks[0].buffer = -1;
+
+      const size_t min_task_count = 8 * threads_arg;
+      bool expanded = true;
+
+      while (threads_arg > 1 && tasks.size () < min_task_count && expanded)
+      {
+        std::vector<ChangedSubtreeTask> next_tasks;
+        next_tasks.reserve (8 * tasks.size ());
+        expanded = false;
+
+        for (size_t i = 0; i < tasks.size (); ++i)
+        {
+          const ChangedSubtreeTask& task = tasks[i];
+
+          if (task.node->getNodeType () != BRANCH_NODE)
+          {
+            next_tasks.push_back (task);
+            continue;
+          }
+
+          const BranchNode* branch = static_cast<const BranchNode*> (task.node);
+          expanded = true;
+
+          for (unsigned char child_idx = 0; child_idx < 8; ++child_idx)
+          {
+            ChangedSubtreeTask child_task;
+            child_task.key = task.key;
+            child_task.key.pushBranch (child_idx);
+
+            if (task.buffer < 0)
+            {
+              const OctreeNode* curr_child = branch->getChildPtr (buffer_selector_, child_idx);
+              const OctreeNode* prev_child = branch->getChildPtr (!buffer_selector_, child_idx);
+
+              if (curr_child && (curr_child == prev_child))
+              {
+                // unchanged leafs need no further processing
+                if (curr_child->getNodeType () == BRANCH_NODE)
+                {
+                  child_task.node = curr_child;
+                  child_task.buffer = -1;
+                  next_tasks.push_back (child_task);
+                }
+                continue;
+              }
+
+              if (curr_child)
+              {
+                child_task.node = curr_child;
+                child_task.buffer = buffer_selector_;
+                next_tasks.push_back (child_task);
+              }
+              if (prev_child)
+              {
+                child_task.node = prev_child;
+                child_task.buffer = !buffer_selector_;
+                next_tasks.push_back (child_task);
+              }
+            }
+            else if (branch->hasChild (static_cast<unsigned char> (task.buffer), child_idx))
+            {
+              child_task.node = branch->getChildPtr (static_cast<unsigned char> (task.buffer), child_idx);
+              child_task.buffer = task.buffer;
+              next_tasks.push_back (child_task);
+            }
+          }
+        }
+
+        tasks.swap (next_tasks);
+      }
+
+      // compare the subtrees independently
+      const int task_count = static_cast<int> (tasks.size ());
+      std::vector<std::vector<LeafContainerT*> > task_new_leafs (task_count);
+      std::vector<std::vector<LeafContainerT*> > task_removed_leafs (task_count);
+      std::vector<std::vector<OctreeKey> > task_new_keys (new_keys_arg ? task_count : 0);
+      std::vector<std::vector<OctreeKey> > task_removed_keys (removed_keys_arg ? task_count : 0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(threads_arg)
+#endif
+      for (int i = 0; i < task_count; ++i)
+      {
+        OctreeKey key = tasks[i].key;
+        std::vector<OctreeKey>* new_keys = new_keys_arg ? &task_new_keys[i] : 0;
+        std::vector<OctreeKey>* removed_keys = removed_keys_arg ? &task_removed_keys[i] : 0;
+
+        if (tasks[i].buffer < 0)
+          serializeChangedLeafsRecursive (static_cast<const BranchNode*> (tasks[i].node), key,
+                                          task_new_leafs[i], task_removed_leafs[i], new_keys, removed_keys);
+        else if (tasks[i].buffer == buffer_selector_)
+          serializeBufferLeafsRecursive (tasks[i].node, buffer_selector_, key, task_new_leafs[i], new_keys);
+        else
+          serializeBufferLeafsRecursive (tasks[i].node, !buffer_selector_, key, task_removed_leafs[i], removed_keys);
+      }
+
+      // concatenate the results in task order
+      for (int i = 0; i < task_count; ++i)
+      {
+        new_leafs_arg.insert (new_leafs_arg.end (), task_new_leafs[i].begin (), task_new_leafs[i].end ());
+        removed_leafs_arg.insert (removed_leafs_arg.end (), task_removed_leafs[i].begin (), task_removed_leafs[i].end ());
+        if (new_keys_arg)
+          new_keys_arg->insert (new_keys_arg->end (), task_new_keys[i].begin (), task_new_keys[i].end ());
+        if (removed_keys_arg)
+          removed_keys_arg->insert (removed_keys_arg->end (), task_removed_keys[i].begin (), task_removed_keys[i].end ());
+      }
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename LeafContainerT, typename BranchContainerT> void
     Octree2BufBase<LeafContainerT, BranchContainerT>::serializeNewLeafs (std::vector<LeafContainerT*>& leaf_container_vector_arg)
@@ -405,6 +559,9 @@ namespace pcl
             {
               child_leaf = static_cast<LeafNode*> (child_node);
               branch_arg->setChildPtr(buffer_selector_, child_idx, child_node);
+
+              // drop the data of the previous frame
+              child_leaf->reset ();
             } else {
               // depth has changed.. child in preceeding buffer is a leaf node.
               deleteBranchChild (*branch_arg, !buffer_selector_, child_idx);
@@ -837,6 +994,82 @@ namespace pcl
         }  
       }
     }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename LeafContainerT, typename BranchContainerT> void
+    Octree2BufBase<LeafContainerT, BranchContainerT>::serializeChangedLeafsRecursive (const BranchNode* branch_arg,
+                                                                                      OctreeKey& key_arg,
+                                                                                      std::vector<LeafContainerT*>& new_leafs_arg,
+                                                                                      std::vector<LeafContainerT*>& removed_leafs_arg,
+                                                                                      std::vector<OctreeKey>* new_keys_arg,
+                                                                                      std::vector<OctreeKey>* removed_keys_arg) const
+    {
+      // child iterator
+      unsigned char child_idx;
+
+      // iterate over all children
+      for (child_idx = 0; child_idx < 8; child_idx++)
+      {
+        const OctreeNode* curr_child = branch_arg->getChildPtr (buffer_selector_, child_idx);
+        const OctreeNode* prev_child = branch_arg->getChildPtr (!buffer_selector_, child_idx);
+
+        if (!curr_child && !prev_child)
+          continue;
+
+        // add current branch voxel to key
+        key_arg.pushBranch (child_idx);
+
+        if (curr_child == prev_child)
+        {
+          // node is shared by both buffers - only its subtree can contain changes
+          if (curr_child->getNodeType () == BRANCH_NODE)
+            serializeChangedLeafsRecursive (static_cast<const BranchNode*> (curr_child), key_arg,
+                                            new_leafs_arg, removed_leafs_arg, new_keys_arg, removed_keys_arg);
+        }
+        else
+        {
+          if (curr_child)
+            serializeBufferLeafsRecursive (curr_child, buffer_selector_, key_arg, new_leafs_arg, new_keys_arg);
+          if (prev_child)
+            serializeBufferLeafsRecursive (prev_child, !buffer_selector_, key_arg, removed_leafs_arg, removed_keys_arg);
+        }
+
+        // pop current branch voxel from key
+        key_arg.popBranch ();
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename LeafContainerT, typename BranchContainerT> void
+    Octree2BufBase<LeafContainerT, BranchContainerT>::serializeBufferLeafsRecursive (const OctreeNode* node_arg,
+                                                                                     unsigned char buffer_selector_arg,
+                                                                                     OctreeKey& key_arg,
+                                                                                     std::vector<LeafContainerT*>& leafs_arg,
+                                                                                     std::vector<OctreeKey>* keys_arg) const
+    {
+      if (node_arg->getNodeType () == LEAF_NODE)
+      {
+        // leafs are only read by the caller, the container pointer is handed out like in serializeLeafs
+        LeafNode* leaf = const_cast<LeafNode*> (static_cast<const LeafNode*> (node_arg));
+        leafs_arg.push_back (leaf->getContainerPtr ());
+        if (keys_arg)
+          keys_arg->push_back (key_arg);
+        return;
+      }
+
+      const BranchNode* branch = static_cast<const BranchNode*> (node_arg);
+
+      for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+      {
+        if (!branch->hasChild (buffer_selector_arg, child_idx))
+          continue;
+
+        key_arg.pushBranch (child_idx);
+        serializeBufferLeafsRecursive (branch->getChildPtr (buffer_selector_arg, child_idx), buffer_selector_arg,
+                                       key_arg, leafs_arg, keys_arg);
+        key_arg.popBranch ();
+      }
+    }
   }
 }
 
@@ -45,6 +45,7 @@ template<typename PointT, typename LeafContainerT, typename BranchContainerT>
 pcl::octree::OctreePointCloudAdjacency<PointT, LeafContainerT, BranchContainerT>::OctreePointCloudAdjacency (const double resolution_arg) 
 : OctreePointCloud<PointT, LeafContainerT, BranchContainerT
 , OctreeBase<LeafContainerT, BranchContainerT> > (resolution_arg)
+, threads_ (1)
 {
 
 }
@@ -57,47 +58,111 @@ pcl::octree::OctreePointCloudAdjacency<PointT, LeafContainerT, BranchContainerT>
   float minX = std::numeric_limits<float>::max (), minY = std::numeric_limits<float>::max (), minZ = std::numeric_limits<float>::max ();
   float maxX = -std::numeric_limits<float>::max(), maxY = -std::numeric_limits<float>::max(), maxZ = -std::numeric_limits<float>::max();
   
-  for (size_t i = 0; i < input_->size (); ++i)
+  const int nr_points = static_cast<int> (input_->size ());
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
   {
-    PointT temp (input_->points[i]);
-    if (transform_func_) //Search for point with 
-      transform_func_ (temp);
-    if (!pcl::isFinite (temp)) //Check to make sure transform didn't make point not finite
-      continue;
-    if (temp.x < minX)
-      minX = temp.x;
-    if (temp.y < minY)
-      minY = temp.y;
-    if (temp.z < minZ)
-      minZ = temp.z;
-    if (temp.x > maxX)
-      maxX = temp.x;
-    if (temp.y > maxY)
-      maxY = temp.y;
-    if (temp.z > maxZ)
-      maxZ = temp.z;
+    float thread_minX = minX, thread_minY = minY, thread_minZ = minZ;
+    float thread_maxX = maxX, thread_maxY = maxY, thread_maxZ = maxZ;
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < nr_points; ++i)
+    {
+      PointT temp (input_->points[i]);
+      if (transform_func_) //Search for point with 
+        transform_func_ (temp);
+      if (!pcl::isFinite (temp)) //Check to make sure transform didn't make point not finite
+        continue;
+      if (temp.x < thread_minX)
+        thread_minX = temp.x;
+      if (temp.y < thread_minY)
+        thread_minY = temp.y;
+      if (temp.z < thread_minZ)
+        thread_minZ = temp.z;
+      if (temp.x > thread_maxX)
+        thread_maxX = temp.x;
+      if (temp.y > thread_maxY)
+        thread_maxY = temp.y;
+      if (temp.z > thread_maxZ)
+        thread_maxZ = temp.z;
+    }
+#ifdef _OPENMP
+#pragma omp critical (octree_adjacency_bounding_box)
+#endif
+    {
+      minX = std::min (minX, thread_minX);
+      minY = std::min (minY, thread_minY);
+      minZ = std::min (minZ, thread_minZ);
+      maxX = std::max (maxX, thread_maxX);
+      maxY = std::max (maxY, thread_maxY);
+      maxZ = std::max (maxZ, thread_maxZ);
+    }
   }
   this->defineBoundingBox (minX, minY, minZ, maxX, maxY, maxZ);
 
-  OctreePointCloud<PointT, LeafContainerT, BranchContainerT>::addPointsFromInputCloud ();
+  // Gather the finite points in the order the base class would add them, and generate their keys concurrently
+  std::vector<int> point_indices;
+  if (this->indices_)
+  {
+    point_indices.reserve (this->indices_->size ());
+    for (std::vector<int>::const_iterator current = this->indices_->begin (); current != this->indices_->end (); ++current)
+    {
+      assert ((*current >= 0) && (*current < nr_points));
+      if (pcl::isFinite (input_->points[*current]))
+        point_indices.push_back (*current);
+    }
+  }
+  else
+  {
+    point_indices.reserve (input_->size ());
+    for (int i = 0; i < nr_points; ++i)
+      if (pcl::isFinite (input_->points[i]))
+        point_indices.push_back (i);
+  }
+
+  const int nr_finite = static_cast<int> (point_indices.size ());
+  std::vector<OctreeKey> point_keys (nr_finite);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads_)
+#endif
+  for (int i = 0; i < nr_finite; ++i)
+    this->genOctreeKeyforPoint (input_->points[point_indices[i]], point_keys[i]);
+
+  // Changing the tree is serial, the points are added to their leaves in cloud order
+  for (int i = 0; i < nr_finite; ++i)
+  {
+    LeafContainerT* container = this->createLeaf (point_keys[i]);
+    container->addPoint (input_->points[point_indices[i]]);
+  }
   
-  LeafContainerT *leaf_container;
+  std::vector<OctreeKey> leaf_keys;
+  leaf_keys.reserve (this->getLeafCount ());
   typename OctreeAdjacencyT::LeafNodeIterator leaf_itr;
-  leaf_vector_.reserve (this->getLeafCount ());
+  const size_t first_leaf = leaf_vector_.size ();
+  leaf_vector_.reserve (first_leaf + this->getLeafCount ());
   for ( leaf_itr = this->leaf_begin () ; leaf_itr != this->leaf_end (); ++leaf_itr)
   {
-    OctreeKey leaf_key = leaf_itr.getCurrentOctreeKey ();
-    leaf_container = &(leaf_itr.getLeafContainer ());
-    
+    leaf_keys.push_back (leaf_itr.getCurrentOctreeKey ());
+    leaf_vector_.push_back (&(leaf_itr.getLeafContainer ()));
+  }
+  //Make sure our leaf vector is correctly sized
+  assert (leaf_vector_.size () == this->getLeafCount ());
+
+  // Every leaf only writes its own data and neighbor list, the tree itself is read only from here on
+  const int nr_leaves = static_cast<int> (leaf_keys.size ());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256) num_threads(threads_)
+#endif
+  for (int i = 0; i < nr_leaves; ++i)
+  {
     //Run the leaf's compute function
+    LeafContainerT *leaf_container = leaf_vector_[first_leaf + i];
     leaf_container->computeData ();
 
-    computeNeighbors (leaf_key, leaf_container);
-    
-    leaf_vector_.push_back (leaf_container);
+    computeNeighbors (leaf_keys[i], leaf_container);
   }
-  //Make sure our leaf vector is correctly sized
-  assert (leaf_vector_.size () == this->getLeafCount ());
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -44,6 +44,7 @@
 
 #include <pcl/common/common.h>
 #include <assert.h>
+#include <algorithm>
 
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -190,6 +191,238 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::r
   return (radiusSearch (search_point, radius, k_indices, k_sqr_distances, max_nn));
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::approxNearestKSearch (
+    const PointT &p_q, int k, float eps, unsigned int max_leaf_visits,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  assert (isFinite (p_q) && "Invalid (NaN, Inf) point coordinates given to approxNearestKSearch!");
+
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+
+  if (k < 1)
+    return 0;
+
+  const size_t K = static_cast<size_t> (k);
+
+  // a voxel can only contribute if its distance, inflated by the error bound, beats the current k-th candidate
+  const float eps_factor = (1.0f + eps) * (1.0f + eps);
+
+  // priority queue of voxels to visit (closest first) and bounded max-heap of point candidates
+  std::vector<approxSearchEntry> node_queue;
+  node_queue.reserve (8 * this->octree_depth_ + 1);
+  std::vector<prioPointQueueEntry> point_candidates;
+  point_candidates.reserve (K);
+  std::vector<int> decoded_point_vector;
+
+  OctreeKey key;
+  key.x = key.y = key.z = 0;
+  node_queue.push_back (approxSearchEntry (this->root_node_, key, 0, 0.0f));
+
+  unsigned int leaf_visits = 0;
+
+  while (!node_queue.empty ())
+  {
+    std::pop_heap (node_queue.begin (), node_queue.end ());
+    const approxSearchEntry entry = node_queue.back ();
+    node_queue.pop_back ();
+
+    // all remaining voxels are at least as far away as this one
+    if ((point_candidates.size () == K)
+        && (entry.min_sqr_distance * eps_factor >= point_candidates.front ().point_distance_))
+      break;
+
+    if (entry.depth < this->octree_depth_)
+    {
+      const BranchNode* branch = static_cast<const BranchNode*> (entry.node);
+
+      for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+      {
+        if (!this->branchHasChild (*branch, child_idx))
+          continue;
+
+        OctreeKey new_key;
+        new_key.x = (entry.key.x << 1) + (!!(child_idx & (1 << 2)));
+        new_key.y = (entry.key.y << 1) + (!!(child_idx & (1 << 1)));
+        new_key.z = (entry.key.z << 1) + (!!(child_idx & (1 << 0)));
+
+        const float min_sqr_dist = voxelSquaredDist (p_q, new_key, entry.depth + 1);
+
+        if ((point_candidates.size () == K)
+            && (min_sqr_dist * eps_factor >= point_candidates.front ().point_distance_))
+          continue;
+
+        node_queue.push_back (approxSearchEntry (this->getBranchChildPtr (*branch, child_idx), new_key,
+                                                 entry.depth + 1, min_sqr_dist));
+        std::push_heap (node_queue.begin (), node_queue.end ());
+      }
+    }
+    else
+    {
+      // we reached leaf node level
+      const LeafNode* leaf = static_cast<const LeafNode*> (entry.node);
+
+      decoded_point_vector.clear ();
+      (*leaf)->getPointIndices (decoded_point_vector);
+
+      for (size_t i = 0; i < decoded_point_vector.size (); i++)
+      {
+        const float squared_dist = pointSquaredDist (this->getPointByIndex (decoded_point_vector[i]), p_q);
+
+        if (point_candidates.size () < K)
+        {
+          prioPointQueueEntry point_entry;
+          point_entry.point_idx_ = decoded_point_vector[i];
+          point_entry.point_distance_ = squared_dist;
+          point_candidates.push_back (point_entry);
+          std::push_heap (point_candidates.begin (), point_candidates.end ());
+        }
+        else if (squared_dist < point_candidates.front ().point_distance_)
+        {
+          // replace the farthest candidate
+          std::pop_heap (point_candidates.begin (), point_candidates.end ());
+          point_candidates.back ().point_idx_ = decoded_point_vector[i];
+          point_candidates.back ().point_distance_ = squared_dist;
+          std::push_heap (point_candidates.begin (), point_candidates.end ());
+        }
+      }
+
+      if ((max_leaf_visits != 0) && (++leaf_visits >= max_leaf_visits))
+        break;
+    }
+  }
+
+  std::sort_heap (point_candidates.begin (), point_candidates.end ());
+
+  k_indices.resize (point_candidates.size ());
+  k_sqr_distances.resize (point_candidates.size ());
+
+  for (size_t i = 0; i < point_candidates.size (); ++i)
+  {
+    k_indices[i] = point_candidates[i].point_idx_;
+    k_sqr_distances[i] = point_candidates[i].point_distance_;
+  }
+
+  return (static_cast<int> (k_indices.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::approxNearestKSearch (
+    int index, int k, float eps, unsigned int max_leaf_visits,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+{
+  const PointT search_point = this->getPointByIndex (index);
+  return (approxNearestKSearch (search_point, k, eps, max_leaf_visits, k_indices, k_sqr_distances));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::approxRadiusSearch (
+    const PointT &p_q, const double radius, float eps, unsigned int max_leaf_visits,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+{
+  assert (isFinite (p_q) && "Invalid (NaN, Inf) point coordinates given to approxRadiusSearch!");
+
+  k_indices.clear ();
+  k_sqr_distances.clear ();
+
+  const double radius_sqr = radius * radius;
+
+  // voxels farther away than the shrunken radius are not descended
+  const double pruning_radius = radius / (1.0 + eps);
+  const double pruning_sqr = pruning_radius * pruning_radius;
+
+  // depth-first traversal: at most 7 siblings are pending per level plus the one being expanded
+  std::vector<approxSearchEntry> node_stack;
+  node_stack.reserve (7 * this->octree_depth_ + 1);
+  std::vector<int> decoded_point_vector;
+
+  OctreeKey key;
+  key.x = key.y = key.z = 0;
+  node_stack.push_back (approxSearchEntry (this->root_node_, key, 0, 0.0f));
+
+  unsigned int leaf_visits = 0;
+
+  while (!node_stack.empty ())
+  {
+    const approxSearchEntry entry = node_stack.back ();
+    node_stack.pop_back ();
+
+    if (entry.depth < this->octree_depth_)
+    {
+      const BranchNode* branch = static_cast<const BranchNode*> (entry.node);
+
+      approxSearchEntry children[8];
+      unsigned int child_count = 0;
+
+      for (unsigned char child_idx = 0; child_idx < 8; child_idx++)
+      {
+        if (!this->branchHasChild (*branch, child_idx))
+          continue;
+
+        OctreeKey new_key;
+        new_key.x = (entry.key.x << 1) + (!!(child_idx & (1 << 2)));
+        new_key.y = (entry.key.y << 1) + (!!(child_idx & (1 << 1)));
+        new_key.z = (entry.key.z << 1) + (!!(child_idx & (1 << 0)));
+
+        const float min_sqr_dist = voxelSquaredDist (p_q, new_key, entry.depth + 1);
+
+        if (min_sqr_dist > pruning_sqr)
+          continue;
+
+        children[child_count++] = approxSearchEntry (this->getBranchChildPtr (*branch, child_idx), new_key,
+                                                     entry.depth + 1, min_sqr_dist);
+      }
+
+      // push farthest first so that the closest child is explored next
+      std::sort (children, children + child_count);
+      for (unsigned int i = 0; i < child_count; ++i)
+        node_stack.push_back (children[i]);
+    }
+    else
+    {
+      // we reached leaf node level
+      const LeafNode* leaf = static_cast<const LeafNode*> (entry.node);
+
+      decoded_point_vector.clear ();
+      (*leaf)->getPointIndices (decoded_point_vector);
+
+      for (size_t i = 0; i < decoded_point_vector.size (); i++)
+      {
+        const float squared_dist = pointSquaredDist (this->getPointByIndex (decoded_point_vector[i]), p_q);
+
+        if (squared_dist > radius_sqr)
+          continue;
+
+        k_indices.push_back (decoded_point_vector[i]);
+        k_sqr_distances.push_back (squared_dist);
+
+        if (max_nn != 0 && k_indices.size () == static_cast<unsigned int> (max_nn))
+          return (static_cast<int> (k_indices.size ()));
+      }
+
+      if ((max_leaf_visits != 0) && (++leaf_visits >= max_leaf_visits))
+        break;
+    }
+  }
+
+  return (static_cast<int> (k_indices.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::approxRadiusSearch (
+    int index, const double radius, float eps, unsigned int max_leaf_visits,
+    std::vector<int> &k_indices, std::vector<float> &k_sqr_distances, unsigned int max_nn) const
+{
+  const PointT search_point = this->getPointByIndex (index);
+
+  return (approxRadiusSearch (search_point, radius, eps, max_leaf_visits, k_indices, k_sqr_distances, max_nn));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> int
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::boxSearch (const Eigen::Vector3f &min_pt,
@@ -506,6 +739,21 @@ pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::p
   return (point_a.getVector3fMap () - point_b.getVector3fMap ()).squaredNorm ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT, typename LeafContainerT, typename BranchContainerT> float
+pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::voxelSquaredDist (const PointT & point,
+                                                                               const OctreeKey & key,
+                                                                               unsigned int tree_depth) const
+{
+  Eigen::Vector3f min_pt, max_pt;
+  this->genVoxelBoundsFromOctreeKey (key, tree_depth, min_pt, max_pt);
+
+  // distance to the closest point of the axis aligned voxel box
+  const Eigen::Vector3f q = point.getVector3fMap ();
+  const Eigen::Vector3f delta = (min_pt - q).cwiseMax (q - max_pt).cwiseMax (Eigen::Vector3f::Zero ());
+  return (delta.squaredNorm ());
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template<typename PointT, typename LeafContainerT, typename BranchContainerT> void
 pcl::octree::OctreePointCloudSearch<PointT, LeafContainerT, BranchContainerT>::boxSearchRecursive (const Eigen::Vector3f &min_pt,
@@ -45,6 +45,7 @@
 #include "octree_container.h"
 #include "octree_key.h"
 #include "octree_iterator.h"
+#include "octree_node_pool.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -284,7 +285,10 @@ namespace pcl
             buffer_selector_ (source.buffer_selector_),
             tree_dirty_flag_ (source.tree_dirty_flag_),
             octree_depth_ (source.octree_depth_),
-            dynamic_depth_enabled_(source.dynamic_depth_enabled_)
+            dynamic_depth_enabled_(source.dynamic_depth_enabled_),
+            node_pool_enabled_ (source.node_pool_enabled_),
+            branch_pool_ (),
+            leaf_pool_ ()
         {
         }
 
@@ -301,6 +305,7 @@ namespace pcl
           tree_dirty_flag_ = source.tree_dirty_flag_;
           octree_depth_ = source.octree_depth_;
           dynamic_depth_enabled_ = source.dynamic_depth_enabled_;
+          node_pool_enabled_ = source.node_pool_enabled_;
           return (*this);
         }
 
@@ -400,6 +405,22 @@ namespace pcl
         void
         switchBuffers ();
 
+        /** \brief Enable or disable recycling of octree nodes. When enabled, nodes released from the previous
+         *  buffer are kept in a node pool and reused for the next frames instead of being deleted and allocated again.
+         *  \param enable_arg: enable (true) or disable (false) the node pool. Disabling frees all pooled nodes.
+         * */
+        void
+        enableNodePool (bool enable_arg);
+
+        /** \brief Check if octree nodes are recycled through a node pool.
+         *  \return "true" if the node pool is enabled
+         * */
+        inline bool
+        getNodePoolEnabled () const
+        {
+          return (node_pool_enabled_);
+        }
+
         /** \brief Serialize octree into a binary output vector describing its branch node structure.
          *  \param binary_tree_out_arg: reference to output vector for writing binary tree structure.
          *  \param do_XOR_encoding_arg: select if binary tree structure should be generated based on current octree (false) of based on a XOR comparison between current and previous octree
@@ -430,6 +451,23 @@ namespace pcl
         void
         serializeNewLeafs (std::vector<LeafContainerT*>& leaf_container_vector_arg);
 
+        /** \brief Outputs the leaf nodes that were added to or removed from the octree since the previous buffer.
+         *  \note In contrast to serializeNewLeafs, the octree is not modified, so containers of removed leafs stay
+         *  valid until the next call of switchBuffers. The top of the octree is split into independent subtrees that
+         *  are compared in parallel.
+         *  \param new_leafs_arg: vector of pointers to LeafContainerT objects that do not exist in the previous buffer
+         *  \param removed_leafs_arg: vector of pointers to LeafContainerT objects that only exist in the previous buffer
+         *  \param new_keys_arg: if given, octree keys of the new leaf nodes are written to this vector
+         *  \param removed_keys_arg: if given, octree keys of the removed leaf nodes are written to this vector
+         *  \param threads_arg: number of threads to use (0: automatic)
+         * */
+        void
+        serializeChangedLeafs (std::vector<LeafContainerT*>& new_leafs_arg,
+                               std::vector<LeafContainerT*>& removed_leafs_arg,
+                               std::vector<OctreeKey>* new_keys_arg = 0,
+                               std::vector<OctreeKey>* removed_keys_arg = 0,
+                               unsigned int threads_arg = 0);
+
         /** \brief Deserialize a binary octree description vector and create a corresponding octree structure. Leaf nodes are initialized with getDataTByKey(..).
          *  \param binary_tree_in_arg: reference to input vector for reading binary tree structure.
          *  \param do_XOR_decoding_arg: select if binary tree structure is based on current octree (false) of based on a XOR comparison between current and previous octree
@@ -649,15 +687,21 @@ namespace pcl
                 // free child branch recursively
                 deleteBranch (*static_cast<BranchNode*> (branchChild));
 
-                // delete unused branch
-                delete (branchChild);
+                // delete unused branch or push it to branch pool
+                if (node_pool_enabled_)
+                  branch_pool_.pushNode (static_cast<BranchNode*> (branchChild));
+                else
+                  delete (branchChild);
                 break;
               }
 
               case LEAF_NODE:
               {
-                // push unused leaf to branch pool
-                delete (branchChild);
+                // delete unused leaf or push it to leaf pool
+                if (node_pool_enabled_)
+                  leaf_pool_.pushNode (static_cast<LeafNode*> (branchChild));
+                else
+                  delete (branchChild);
                 break;
               }
               default:
@@ -714,7 +758,7 @@ namespace pcl
         inline  BranchNode* createBranchChild (BranchNode& branch_arg,
             unsigned char child_idx_arg)
         {
-          BranchNode* new_branch_child = new BranchNode();
+          BranchNode* new_branch_child = node_pool_enabled_ ? branch_pool_.popNode () : new BranchNode ();
 
           branch_arg.setChildPtr (buffer_selector_, child_idx_arg,
               static_cast<OctreeNode*> (new_branch_child));
@@ -730,7 +774,7 @@ namespace pcl
         inline LeafNode*
         createLeafChild (BranchNode& branch_arg, unsigned char child_idx_arg)
         {
-          LeafNode* new_leaf_child = new LeafNode();
+          LeafNode* new_leaf_child = node_pool_enabled_ ? leaf_pool_.popNode () : new LeafNode ();
 
           branch_arg.setChildPtr(buffer_selector_, child_idx_arg, new_leaf_child);
 
@@ -851,6 +895,48 @@ namespace pcl
         void
         treeCleanUpRecursive (BranchNode* branch_arg);
 
+        /** \brief Subtree processed by serializeChangedLeafs. It either compares both buffers below a branch
+         *  shared by both buffers (buffer < 0), or collects all leafs of a node that only exists in one buffer.
+         * */
+        struct ChangedSubtreeTask
+        {
+          ChangedSubtreeTask () : node (0), key (), buffer (-1) {}
+
+          const OctreeNode* node;
+          OctreeKey key;
+          int buffer;
+        };
+
+        /** \brief Recursively compare the current and previous buffer below a branch that exists in both buffers.
+         *  \param branch_arg: current branch node
+         *  \param key_arg: reference to an octree key
+         *  \param new_leafs_arg: leaf containers that do not exist in the previous buffer are appended here
+         *  \param removed_leafs_arg: leaf containers that only exist in the previous buffer are appended here
+         *  \param new_keys_arg: if given, keys of the new leaf nodes are appended here
+         *  \param removed_keys_arg: if given, keys of the removed leaf nodes are appended here
+         * */
+        void
+        serializeChangedLeafsRecursive (const BranchNode* branch_arg,
+                                        OctreeKey& key_arg,
+                                        std::vector<LeafContainerT*>& new_leafs_arg,
+                                        std::vector<LeafContainerT*>& removed_leafs_arg,
+                                        std::vector<OctreeKey>* new_keys_arg,
+                                        std::vector<OctreeKey>* removed_keys_arg) const;
+
+        /** \brief Recursively collect all leaf nodes below a node of a specific buffer.
+         *  \param node_arg: current octree node
+         *  \param buffer_selector_arg: buffer selector
+         *  \param key_arg: reference to an octree key
+         *  \param leafs_arg: leaf containers are appended here
+         *  \param keys_arg: if given, keys of the leaf nodes are appended here
+         * */
+        void
+        serializeBufferLeafsRecursive (const OctreeNode* node_arg,
+                                       unsigned char buffer_selector_arg,
+                                       OctreeKey& key_arg,
+                                       std::vector<LeafContainerT*>& leafs_arg,
+                                       std::vector<OctreeKey>* keys_arg) const;
+
         /** \brief Helper function to calculate the binary logarithm
          * \param n_arg: some value
          * \return binary logarithm (log2) of argument n_arg
@@ -916,6 +1002,15 @@ namespace pcl
          *  \note Note that this parameter is ignored in octree2buf! */
         bool dynamic_depth_enabled_;
 
+        /** \brief Recycle released octree nodes through the node pools. */
+        bool node_pool_enabled_;
+
+        /** \brief Pool of released branch nodes. */
+        OctreeNodePool<BranchNode> branch_pool_;
+
+        /** \brief Pool of released leaf nodes. */
+        OctreeNodePool<LeafNode> leaf_pool_;
+
     };
   }
 }
@@ -134,6 +134,13 @@ namespace pcl
           return LEAF_NODE;
         }
 
+        /** \brief Reset leaf node container. */
+        void
+        reset ()
+        {
+          container_ = ContainerT ();
+        }
+
         /** \brief Get const pointer to container */
         const ContainerT*
         operator->() const
@@ -148,6 +148,8 @@ namespace pcl
 
         /** \brief Adds points from cloud to the octree.
           *
+          * The bounding box, the point keys and the data and neighbors of the leaves are computed with
+          * setNumberOfThreads() threads, only the insertion of the points into the tree is serial.
           * \note This overrides addPointsFromInputCloud() from the OctreePointCloud class. */
         void
         addPointsFromInputCloud ();
@@ -182,6 +184,15 @@ namespace pcl
           transform_func_ = transform_func;
         }
 
+        /** \brief Set the number of threads used to build the adjacency information of the voxels.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          * \note The transform function, if any, is then called concurrently and must be thread safe. */
+        inline void
+        setNumberOfThreads (unsigned int nr_threads = 0)
+        {
+          threads_ = nr_threads;
+        }
+
         /** \brief Tests whether input point is occluded from specified camera point by other voxels.
           *
           * \param[in] point_arg Point to test for
@@ -241,6 +252,9 @@ namespace pcl
 
         boost::function<void (PointT &p)> transform_func_;
 
+        /** \brief The number of threads the scheduler should use. The default is 1. */
+        unsigned int threads_;
+
     };
 
   }
@@ -67,12 +67,16 @@ namespace pcl
 
       public:
 
+        typedef typename OctreePointCloud<PointT, LeafContainerT, BranchContainerT,
+            Octree2BufBase<LeafContainerT, BranchContainerT> >::AlignedPointTVector AlignedPointTVector;
+
         /** \brief Constructor.
          *  \param resolution_arg:  octree resolution at lowest octree level
          * */
         OctreePointCloudChangeDetector (const double resolution_arg) :
             OctreePointCloud<PointT, LeafContainerT, BranchContainerT,
-                Octree2BufBase<LeafContainerT, BranchContainerT> > (resolution_arg)
+                Octree2BufBase<LeafContainerT, BranchContainerT> > (resolution_arg),
+            threads_ (0)
         {
         }
 
@@ -104,6 +108,78 @@ namespace pcl
 
           return (indicesVector_arg.size ());
         }
+
+        /** \brief Set the number of threads used to compare the octree buffers.
+         * \param nr_threads: the number of hardware threads to use (0 sets the value back to automatic)
+         */
+        inline void
+        setNumberOfThreads (unsigned int nr_threads = 0)
+        {
+          threads_ = nr_threads;
+        }
+
+        /** \brief Get indices from all leaf nodes that were added or removed since the previous buffer.
+         * \note Indices of removed voxels refer to the point cloud of the previous buffer. Unlike
+         * getPointIndicesFromNewVoxels, the octree is not modified, so both methods can be called for the same frame.
+         * \param newIndicesVector_arg: indices of points within new leaf nodes are written to this vector
+         * \param removedIndicesVector_arg: indices of points within removed leaf nodes are written to this vector
+         * \param minPointsPerLeaf_arg: minimum amount of points required within leaf node to become serialized.
+         * \return number of point indices in new and removed leaf nodes
+         */
+        std::size_t getPointIndicesFromChangedVoxels (std::vector<int> &newIndicesVector_arg,
+            std::vector<int> &removedIndicesVector_arg,
+            const int minPointsPerLeaf_arg = 0)
+        {
+          std::vector<LeafContainerT*> new_leafs;
+          std::vector<LeafContainerT*> removed_leafs;
+          this->serializeChangedLeafs (new_leafs, removed_leafs, 0, 0, threads_);
+
+          newIndicesVector_arg.clear ();
+          removedIndicesVector_arg.clear ();
+
+          for (size_t i = 0; i < new_leafs.size (); ++i)
+          {
+            if (static_cast<int> (new_leafs[i]->getSize ()) >= minPointsPerLeaf_arg)
+              new_leafs[i]->getPointIndices (newIndicesVector_arg);
+          }
+
+          for (size_t i = 0; i < removed_leafs.size (); ++i)
+          {
+            if (static_cast<int> (removed_leafs[i]->getSize ()) >= minPointsPerLeaf_arg)
+              removed_leafs[i]->getPointIndices (removedIndicesVector_arg);
+          }
+
+          return (newIndicesVector_arg.size () + removedIndicesVector_arg.size ());
+        }
+
+        /** \brief Get the centers of all voxels that were added or removed since the previous buffer.
+         * \param newVoxelCenters_arg: centers of new voxels are written to this vector
+         * \param removedVoxelCenters_arg: centers of removed voxels are written to this vector
+         * \return number of new and removed voxels
+         */
+        std::size_t getChangedVoxelCenters (AlignedPointTVector &newVoxelCenters_arg,
+            AlignedPointTVector &removedVoxelCenters_arg)
+        {
+          std::vector<LeafContainerT*> new_leafs;
+          std::vector<LeafContainerT*> removed_leafs;
+          std::vector<OctreeKey> new_keys;
+          std::vector<OctreeKey> removed_keys;
+          this->serializeChangedLeafs (new_leafs, removed_leafs, &new_keys, &removed_keys, threads_);
+
+          newVoxelCenters_arg.resize (new_keys.size ());
+          for (size_t i = 0; i < new_keys.size (); ++i)
+            this->genLeafNodeCenterFromOctreeKey (new_keys[i], newVoxelCenters_arg[i]);
+
+          removedVoxelCenters_arg.resize (removed_keys.size ());
+          for (size_t i = 0; i < removed_keys.size (); ++i)
+            this->genLeafNodeCenterFromOctreeKey (removed_keys[i], removedVoxelCenters_arg[i]);
+
+          return (newVoxelCenters_arg.size () + removedVoxelCenters_arg.size ());
+        }
+
+      protected:
+        /** \brief Number of threads used to compare the octree buffers (0: automatic). */
+        unsigned int threads_;
     };
   }
 }
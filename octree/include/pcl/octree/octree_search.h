@@ -177,6 +177,37 @@ namespace pcl
         void
         approxNearestSearch (int query_index, int &result_index, float &sqr_distance);
 
+        /** \brief Search for approximate k-nearest neighbors at the query point with a bounded error.
+          * The octree is traversed best-first using an explicit priority queue instead of recursion. Voxels
+          * whose minimum distance to the query, scaled by (1 + \a eps), is not smaller than the current k-th
+          * candidate distance are pruned, so that every returned distance is at most (1 + \a eps) times the
+          * distance of the true neighbor of the same rank.
+          * \param[in] p_q the given query point
+          * \param[in] k the number of neighbors to search for
+          * \param[in] eps relative error bound (0: exact search)
+          * \param[in] max_leaf_visits stop the search after this many leaf voxels were visited (0: disable)
+          * \param[out] k_indices the resultant indices of the neighboring points, sorted by distance
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        int
+        approxNearestKSearch (const PointT &p_q, int k, float eps, unsigned int max_leaf_visits,
+                              std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
+
+        /** \brief Search for approximate k-nearest neighbors at the query point with a bounded error.
+          * \param[in] index index representing the query point in the dataset given by \a setInputCloud.
+          *        If indices were given in setInputCloud, index will be the position in the indices vector.
+          * \param[in] k the number of neighbors to search for
+          * \param[in] eps relative error bound (0: exact search)
+          * \param[in] max_leaf_visits stop the search after this many leaf voxels were visited (0: disable)
+          * \param[out] k_indices the resultant indices of the neighboring points, sorted by distance
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        int
+        approxNearestKSearch (int index, int k, float eps, unsigned int max_leaf_visits,
+                              std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const;
+
         /** \brief Search for all neighbors of query point that are within a given radius.
           * \param[in] cloud the point cloud data
           * \param[in] index the index in \a cloud representing the query point
@@ -218,6 +249,40 @@ namespace pcl
         radiusSearch (int index, const double radius, std::vector<int> &k_indices,
                       std::vector<float> &k_sqr_distances, unsigned int max_nn = 0) const;
 
+        /** \brief Search for neighbors of the query point within a given radius with a bounded error.
+          * The octree is traversed iteratively using an explicit stack. Only voxels closer than
+          * \a radius / (1 + \a eps) to the query point are descended, hence all points within that reduced
+          * radius are guaranteed to be found while no point farther than \a radius is ever returned.
+          * \param[in] p_q the given query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[in] eps relative error bound (0: exact search)
+          * \param[in] max_leaf_visits stop the search after this many leaf voxels were visited (0: disable)
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value
+          * \return number of neighbors found in radius
+          */
+        int
+        approxRadiusSearch (const PointT &p_q, const double radius, float eps, unsigned int max_leaf_visits,
+                            std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+                            unsigned int max_nn = 0) const;
+
+        /** \brief Search for neighbors of the query point within a given radius with a bounded error.
+          * \param[in] index index representing the query point in the dataset given by \a setInputCloud.
+          *        If indices were given in setInputCloud, index will be the position in the indices vector
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[in] eps relative error bound (0: exact search)
+          * \param[in] max_leaf_visits stop the search after this many leaf voxels were visited (0: disable)
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value
+          * \return number of neighbors found in radius
+          */
+        int
+        approxRadiusSearch (int index, const double radius, float eps, unsigned int max_leaf_visits,
+                            std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+                            unsigned int max_nn = 0) const;
+
         /** \brief Get a PointT vector of centers of all voxels that intersected by a ray (origin, direction).
           * \param[in] origin ray origin
           * \param[in] direction ray direction vector
@@ -337,6 +402,53 @@ namespace pcl
           float point_distance_;
         };
 
+        //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        /** \brief @b Traversal entry for the iterative approximate search routines
+          * \note Holds an octree node together with its key, depth and minimum squared distance to the query.
+          */
+        class approxSearchEntry
+        {
+        public:
+          /** \brief Empty constructor  */
+          approxSearchEntry () :
+              node (), key (), depth (0), min_sqr_distance (0)
+          {
+          }
+
+          /** \brief Constructor for initializing a traversal entry.
+           * \param[in] _node pointer to octree node
+           * \param[in] _key octree key addressing voxel in octree structure
+           * \param[in] _depth depth of the voxel in the octree
+           * \param[in] _min_sqr_distance minimum squared distance of query point to voxel
+           */
+          approxSearchEntry (const OctreeNode* _node, const OctreeKey& _key, unsigned int _depth,
+                             float _min_sqr_distance) :
+              node (_node), key (_key), depth (_depth), min_sqr_distance (_min_sqr_distance)
+          {
+          }
+
+          /** \brief Operator< for comparing entries; the closest voxel has the highest priority.
+           * \param[in] rhs the entry to compare this against
+           */
+          bool
+          operator < (const approxSearchEntry& rhs) const
+          {
+            return (this->min_sqr_distance > rhs.min_sqr_distance);
+          }
+
+          /** \brief Pointer to octree node. */
+          const OctreeNode* node;
+
+          /** \brief Octree key. */
+          OctreeKey key;
+
+          /** \brief Depth of the voxel in the octree. */
+          unsigned int depth;
+
+          /** \brief Minimum squared distance of the voxel to the query point. */
+          float min_sqr_distance;
+        };
+
         /** \brief Helper function to calculate the squared distance between two points
           * \param[in] point_a point A
           * \param[in] point_b point B
@@ -345,6 +457,15 @@ namespace pcl
         float
         pointSquaredDist (const PointT& point_a, const PointT& point_b) const;
 
+        /** \brief Helper function to calculate the minimum squared distance between a point and an octree voxel
+          * \param[in] point query point
+          * \param[in] key octree key addressing the voxel
+          * \param[in] tree_depth depth of the voxel in the octree
+          * \return squared distance between the point and the closest point of the voxel (0 if inside)
+          */
+        float
+        voxelSquaredDist (const PointT& point, const OctreeKey& key, unsigned int tree_depth) const;
+
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
         // Recursive search routine methods
         //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -54,5 +54,7 @@
 #include <boost/random/bernoulli_distribution.hpp>
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
 
 #endif //PCL_OUTOFCORE_BOOST_H_
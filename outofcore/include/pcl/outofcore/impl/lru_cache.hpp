@@ -4,6 +4,7 @@
 
 #include <cassert>
 #include <list>
+#include <map>
 
 template<typename T>
 class LRUCacheItem
@@ -85,10 +86,16 @@ public:
     size_t item_size = value.sizeOf ();
     int evict_count = 0;
 
+    // Items larger than the whole cache are never stored
+    if (item_size >= capacity_)
+    {
+      return false;
+    }
+
     // Get LRU key iterator
     KeyIndexIterator key_it = key_index_.begin ();
 
-    while (size + item_size >= capacity_)
+    while (size + item_size >= capacity_ && key_it != key_index_.end ())
     {
       const CacheIterator cache_it = cache_.find (*key_it);
 
@@ -121,6 +128,21 @@ public:
     return true;
   }
 
+  // Remove a key from the cache if it is present
+  bool
+  erase (const KeyT& key)
+  {
+    const CacheIterator it = cache_.find (key);
+    if (it == cache_.end ())
+      return false;
+
+    size_ -= it->second.first.sizeOf ();
+    key_index_.erase (it->second.second);
+    cache_.erase (it);
+
+    return true;
+  }
+
   void
   setCapacity (size_t capacity)
   {
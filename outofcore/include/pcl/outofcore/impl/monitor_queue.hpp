@@ -5,6 +5,10 @@
 
 #include <queue>
 
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition.hpp>
+
 template<typename DataT>
 class MonitorQueue : boost::noncopyable
 {
@@ -22,7 +26,7 @@ public:
   {
     boost::mutex::scoped_lock lock (monitor_mutex_);
 
-    if (queue_.empty ())
+    while (queue_.empty ())
     {
       item_available_.wait (lock);
     }
@@ -55,6 +55,7 @@
 #include <sstream>
 #include <string>
 #include <exception>
+#include <typeinfo>
 
 namespace pcl
 {
@@ -80,6 +81,12 @@ namespace pcl
       , metadata_ (new OutofcoreOctreeBaseMetadata ())
       , sample_percent_ (0.125)
       , lod_filter_ptr_ (new pcl::RandomSample<pcl::PCLPointCloud2> ())
+      , threads_ (1)
+      , metadata_mutex_ ()
+      , progress_ ()
+      , progress_timer_ ()
+      , progress_running_ (false)
+      , progress_mutex_ ()
     {
       //validate the root filename
       if (!this->checkExtension (root_name))
@@ -108,6 +115,12 @@ namespace pcl
       , metadata_ (new OutofcoreOctreeBaseMetadata ())
       , sample_percent_ (0.125)
       , lod_filter_ptr_ (new pcl::RandomSample<pcl::PCLPointCloud2> ())
+      , threads_ (1)
+      , metadata_mutex_ ()
+      , progress_ ()
+      , progress_timer_ ()
+      , progress_running_ (false)
+      , progress_mutex_ ()
     {
       //Enlarge the bounding box to a cube so our voxels will be cubes
       Eigen::Vector3d tmp_min = min;
@@ -130,6 +143,12 @@ namespace pcl
       , metadata_ (new OutofcoreOctreeBaseMetadata ())
       , sample_percent_ (0.125)
       , lod_filter_ptr_ (new pcl::RandomSample<pcl::PCLPointCloud2> ())
+      , threads_ (1)
+      , metadata_mutex_ ()
+      , progress_ ()
+      , progress_timer_ ()
+      , progress_running_ (false)
+      , progress_mutex_ ()
     {
       //Create a new outofcore tree
       this->init (max_depth, min, max, root_node_name, coord_sys);
@@ -244,7 +263,9 @@ namespace pcl
     {
       // Lock the tree while writing
       boost::unique_lock < boost::shared_mutex > lock (read_write_mutex_);
+      startProgress ();
       boost::uint64_t pt_added = root_node_->addDataToLeaf_and_genLOD (point_cloud->points, false);
+      stopProgress ();
       return (pt_added);
     }
 
@@ -255,7 +276,9 @@ namespace pcl
     {
       // Lock the tree while writing
       boost::unique_lock < boost::shared_mutex > lock (read_write_mutex_);
+      startProgress ();
       boost::uint64_t pt_added = root_node_->addPointCloud_and_genLOD (input_cloud);
+      stopProgress ();
       
       PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBase::%s] Points added %lu, points in input cloud, %lu\n",__FUNCTION__, pt_added, input_cloud->width*input_cloud->height );
  
@@ -271,7 +294,9 @@ namespace pcl
     {
       // Lock the tree while writing
       boost::unique_lock < boost::shared_mutex > lock (read_write_mutex_);
+      startProgress ();
       boost::uint64_t pt_added = root_node_->addDataToLeaf_and_genLOD (src, false);
+      stopProgress ();
       return (pt_added);
     }
 
@@ -429,6 +454,16 @@ namespace pcl
 
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::queryBBIntersects (const Eigen::Vector3d& min, const Eigen::Vector3d& max, const boost::uint32_t query_depth, std::vector<ConstPointSpan>& spans) const
+    {
+      boost::shared_lock < boost::shared_mutex > lock (read_write_mutex_);
+      spans.clear ();
+      root_node_->queryBBIntersects (min, max, query_depth, spans);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBase<ContainerT, PointT>::writeVPythonVisual (const boost::filesystem::path filename)
     {
@@ -566,13 +601,154 @@ namespace pcl
       }
 
       boost::unique_lock < boost::shared_mutex > lock (read_write_mutex_);
+      startProgress ();
 
       const int number_of_nodes = 1;
 
       std::vector<BranchNode*> current_branch (number_of_nodes, static_cast<BranchNode*>(0));
       current_branch[0] = root_node_;
       assert (current_branch.back () != 0);
-      this->buildLODRecursive (current_branch);
+
+      //RandomSample draws from the global rand () state, which concurrent tasks cannot share;
+      //any other filter may not be thread-safe either, so only a plain RandomSample is replaced
+      const bool sample_in_parallel = (typeid (*lod_filter_ptr_) == typeid (pcl::RandomSample<pcl::PCLPointCloud2>));
+      if (threads_ < 2 || !sample_in_parallel || root_node_->getNodeType () == pcl::octree::LEAF_NODE)
+      {
+        this->buildLODRecursive (current_branch);
+        stopProgress ();
+        return;
+      }
+
+      //the subtrees below the root share no files except the root payload, so each one is sampled
+      //bottom-up by its own task, with a generator seeded from the filter seed and the octant; the
+      //samples of the root are buffered per octant and appended in octant order once all tasks are done
+      root_node_->clearData ();
+      if (root_node_->hasUnloadedChildren ())
+        root_node_->loadChildren (false);
+
+      std::vector<std::vector<BranchNode*> > branches;
+      std::vector<boost::uint32_t> seeds;
+      for (size_t i = 0; i < 8; i++)
+      {
+        BranchNode* child = root_node_->getChildPtr (i);
+        if (child == 0)
+          continue;
+
+        branches.push_back (current_branch);
+        branches.back ().push_back (child);
+        seeds.push_back (static_cast<boost::uint32_t> (lod_filter_ptr_->getSeed () + i));
+      }
+
+      std::vector<std::vector<pcl::PCLPointCloud2::Ptr> > root_samples (branches.size ());
+      std::vector<boost::function<boost::uint64_t ()> > tasks;
+      for (size_t i = 0; i < branches.size (); i++)
+        tasks.push_back (boost::bind (&OutofcoreOctreeBase::buildLODSubtree, this, boost::cref (branches[i]), seeds[i], &root_samples[i]));
+
+      runTasks (tasks, threads_);
+
+      for (size_t i = 0; i < root_samples.size (); i++)
+      {
+        for (size_t j = 0; j < root_samples[i].size (); j++)
+        {
+          root_node_->payload_->insertRange (root_samples[i][j]);
+          this->incrementPointsInLOD (root_node_->getDepth (), root_samples[i][j]->width*root_samples[i][j]->height);
+        }
+      }
+      stopProgress ();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::setNumberOfThreads (unsigned int nr_threads)
+    {
+      if (nr_threads == 0)
+        nr_threads = boost::thread::hardware_concurrency ();
+
+      threads_ = std::max (nr_threads, 1u);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> OutofcoreProgress
+    OutofcoreOctreeBase<ContainerT, PointT>::getProgress () const
+    {
+      boost::mutex::scoped_lock lock (progress_mutex_);
+      OutofcoreProgress progress = progress_;
+      if (progress_running_)
+        progress.elapsed_seconds = progress_timer_.getTimeSeconds ();
+      return (progress);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::startProgress ()
+    {
+      boost::mutex::scoped_lock lock (progress_mutex_);
+      progress_ = OutofcoreProgress ();
+      progress_timer_.reset ();
+      progress_running_ = true;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::stopProgress ()
+    {
+      boost::mutex::scoped_lock lock (progress_mutex_);
+      progress_.elapsed_seconds = progress_timer_.getTimeSeconds ();
+      progress_running_ = false;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> boost::uint64_t
+    OutofcoreOctreeBase<ContainerT, PointT>::runTasks (const std::vector<boost::function<boost::uint64_t ()> >& tasks, const unsigned int nr_threads)
+    {
+      boost::uint64_t total = 0;
+
+      if (nr_threads < 2 || tasks.size () < 2)
+      {
+        for (size_t i = 0; i < tasks.size (); i++)
+          total += tasks[i] ();
+        return (total);
+      }
+
+      //each worker pulls the next task from a shared counter until all are done
+      boost::mutex task_mutex;
+      size_t next_task = 0;
+      std::vector<boost::uint64_t> results (tasks.size (), 0);
+
+      struct Worker
+      {
+        static void
+        run (const std::vector<boost::function<boost::uint64_t ()> >* tasks, std::vector<boost::uint64_t>* results, boost::mutex* task_mutex, size_t* next_task)
+        {
+          while (true)
+          {
+            size_t task;
+            {
+              boost::mutex::scoped_lock lock (*task_mutex);
+              if (*next_task >= tasks->size ())
+                return;
+              task = (*next_task)++;
+            }
+            (*results)[task] = (*tasks)[task] ();
+          }
+        }
+      };
+
+      boost::thread_group workers;
+      const size_t nr_workers = std::min (static_cast<size_t> (nr_threads), tasks.size ());
+      for (size_t i = 0; i < nr_workers; i++)
+        workers.create_thread (boost::bind (&Worker::run, &tasks, &results, &task_mutex, &next_task));
+      workers.join_all ();
+
+      for (size_t i = 0; i < results.size (); i++)
+        total += results[i];
+
+      return (total);
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -590,12 +766,60 @@ namespace pcl
 
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBase<ContainerT, PointT>::buildLODRecursive (const std::vector<BranchNode*>& current_branch)
+    {
+      buildLODRecursive (current_branch, NULL, NULL);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> boost::uint64_t
+    OutofcoreOctreeBase<ContainerT, PointT>::buildLODSubtree (const std::vector<BranchNode*>& current_branch, const boost::uint32_t seed,
+                                                               std::vector<pcl::PCLPointCloud2::Ptr>* root_samples)
+    {
+      boost::mt19937 rng (seed);
+      return (buildLODRecursive (current_branch, &rng, root_samples));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBase<ContainerT, PointT>::sampleIndices (const boost::uint64_t nr_points, const boost::uint64_t sample_size, boost::mt19937& rng, std::vector<int>& indices)
+    {
+      indices.clear ();
+      if (sample_size >= nr_points)
+      {
+        indices.resize (nr_points);
+        for (size_t i = 0; i < indices.size (); i++)
+          indices[i] = static_cast<int> (i);
+        return;
+      }
+
+      //selection sampling: each index is kept with probability (indices still needed) / (indices left)
+      indices.reserve (sample_size);
+      boost::uint64_t needed = sample_size;
+      for (boost::uint64_t i = 0; i < nr_points && needed > 0; i++)
+      {
+        boost::uniform_int<boost::uint64_t> dist (0, nr_points - i - 1);
+        if (dist (rng) < needed)
+        {
+          indices.push_back (static_cast<int> (i));
+          needed--;
+        }
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename ContainerT, typename PointT> boost::uint64_t
+    OutofcoreOctreeBase<ContainerT, PointT>::buildLODRecursive (const std::vector<BranchNode*>& current_branch, boost::mt19937* rng,
+                                                                 std::vector<pcl::PCLPointCloud2::Ptr>* root_samples)
     {
       PCL_DEBUG ("%s Building LOD at depth %d",__PRETTY_FUNCTION__, current_branch.size ());
       
+      boost::uint64_t points_written = 0;
       if (!current_branch.back ())
       {
-        return;
+        return (points_written);
       }
       
       if (current_branch.back ()->getNodeType () == pcl::octree::LEAF_NODE)
@@ -624,22 +848,27 @@ namespace pcl
           //   2. Extract those indices with the extract indices class (in order to also get the complement)
           //------------------------------------------------------------
 
-          lod_filter_ptr_->setInputCloud (leaf_input_cloud);
-
           //set sample size to 1/8 of total points (12.5%)
           uint64_t sample_size = static_cast<uint64_t> (static_cast<double> (leaf_input_cloud->width*leaf_input_cloud->height) * current_depth_sample_percent);
 
           if (sample_size == 0)
             sample_size = 1;
           
-          lod_filter_ptr_->setSample (static_cast<unsigned int>(sample_size));
-      
           //create our destination
           pcl::PCLPointCloud2::Ptr downsampled_cloud (new pcl::PCLPointCloud2 ());
 
           //create destination for indices
           pcl::IndicesPtr downsampled_cloud_indices (new std::vector< int > ());
-          lod_filter_ptr_->filter (*downsampled_cloud_indices);
+          if (rng)
+          {
+            sampleIndices (leaf_input_cloud->width*leaf_input_cloud->height, sample_size, *rng, *downsampled_cloud_indices);
+          }
+          else
+          {
+            lod_filter_ptr_->setInputCloud (leaf_input_cloud);
+            lod_filter_ptr_->setSample (static_cast<unsigned int>(sample_size));
+            lod_filter_ptr_->filter (*downsampled_cloud_indices);
+          }
 
           //extract the "random subset", size by setSampleSize
           pcl::ExtractIndices<pcl::PCLPointCloud2> extractor;
@@ -650,8 +879,18 @@ namespace pcl
           //write to the target
           if (downsampled_cloud->width*downsampled_cloud->height > 0)
           {
-            target_parent->payload_->insertRange (downsampled_cloud);
-            this->incrementPointsInLOD (target_parent->getDepth (), downsampled_cloud->width*downsampled_cloud->height);
+            //the root payload is the only one shared by concurrently built subtrees, so its samples are
+            //handed back to the caller, which appends them in a fixed order
+            if (root_samples && target_parent == root_node_)
+            {
+              root_samples->push_back (downsampled_cloud);
+            }
+            else
+            {
+              target_parent->payload_->insertRange (downsampled_cloud);
+              this->incrementPointsInLOD (target_parent->getDepth (), downsampled_cloud->width*downsampled_cloud->height);
+            }
+            points_written += downsampled_cloud->width*downsampled_cloud->height;
           }
         }
       }
@@ -672,17 +911,20 @@ namespace pcl
           next_branch.push_back (current_branch.back ()->getChildPtr (i));
           //skip that child if it doesn't exist
           if (next_branch.back () != 0)
-            buildLODRecursive (next_branch);
+            points_written += buildLODRecursive (next_branch, rng, root_samples);
           
           next_branch.pop_back ();
         }
       }
+      return (points_written);
     }
     ////////////////////////////////////////////////////////////////////////////////
 
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBase<ContainerT, PointT>::incrementPointsInLOD (boost::uint64_t depth, boost::uint64_t new_point_count)
     {
+      boost::mutex::scoped_lock lock (metadata_mutex_);
+
       if (std::numeric_limits<uint64_t>::max () - metadata_->getLODPoints (depth) < new_point_count)
       {
         PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeBase::incrementPointsInLOD] Overflow error. Too many points in depth %d of outofcore octree with root at %s\n", depth, metadata_->getMetadataFilename().c_str());
@@ -690,6 +932,10 @@ namespace pcl
       }
         
       metadata_->setLODPoints (depth, new_point_count, true /*true->increment*/);
+
+      boost::mutex::scoped_lock progress_lock (progress_mutex_);
+      progress_.nodes_written++;
+      progress_.points_written += new_point_count;
     }
 
     ////////////////////////////////////////////////////////////////////////////////
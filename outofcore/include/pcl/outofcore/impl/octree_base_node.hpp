@@ -746,19 +746,32 @@ namespace pcl
       //   1. Get indices from a random sample
       //   2. Extract those indices with the extract indices class (in order to also get the complement)
       //------------------------------------------------------------
-      pcl::RandomSample<pcl::PCLPointCloud2> random_sampler;
-      random_sampler.setInputCloud (input_cloud);
-
       //set sample size to 1/8 of total points (12.5%)
       uint64_t sample_size = input_cloud->width*input_cloud->height / 8;
-      random_sampler.setSample (static_cast<unsigned int> (sample_size));
       
       //create our destination
       pcl::PCLPointCloud2::Ptr downsampled_cloud ( new pcl::PCLPointCloud2 () );
 
       //create destination for indices
       pcl::IndicesPtr downsampled_cloud_indices ( new std::vector< int > () );
-      random_sampler.filter (*downsampled_cloud_indices);
+      if (root_node_->m_tree_->getNumberOfThreads () > 1)
+      {
+        //the top-level subtrees are filled concurrently, and RandomSample draws from the global rand () state
+        boost::uint32_t seed;
+        {
+          boost::mutex::scoped_lock lock (rng_mutex_);
+          seed = static_cast<boost::uint32_t> (rand_gen_ ());
+        }
+        boost::mt19937 rng (seed);
+        OutofcoreOctreeBase<ContainerT, PointT>::sampleIndices (input_cloud->width*input_cloud->height, sample_size, rng, *downsampled_cloud_indices);
+      }
+      else
+      {
+        pcl::RandomSample<pcl::PCLPointCloud2> random_sampler;
+        random_sampler.setInputCloud (input_cloud);
+        random_sampler.setSample (static_cast<unsigned int> (sample_size));
+        random_sampler.filter (*downsampled_cloud_indices);
+      }
 
       //extract the "random subset", size by setSampleSize
       pcl::ExtractIndices<pcl::PCLPointCloud2> extractor;
@@ -789,6 +802,31 @@ namespace pcl
 
       this->sortOctantIndices (remaining_points, indices, node_metadata_->getVoxelCenter ());
 
+      //below the root, the top-level subtrees share no files and are filled by concurrent writers
+      const unsigned int nr_threads = (this->parent_ == NULL) ? root_node_->m_tree_->getNumberOfThreads () : 1;
+      if (nr_threads > 1)
+      {
+        std::vector<pcl::PCLPointCloud2::Ptr> child_clouds;
+        std::vector<boost::function<boost::uint64_t ()> > tasks;
+        for (size_t i = 0; i < 8; i++)
+        {
+          if (indices[i].empty ())
+            continue;
+
+          //children are created up front, since creating them modifies this node
+          if (!children_[i])
+            createChild (i);
+
+          child_clouds.push_back (pcl::PCLPointCloud2::Ptr (new pcl::PCLPointCloud2 ()));
+          pcl::copyPointCloud (*remaining_points, indices[i], *child_clouds.back ());
+          tasks.push_back (boost::bind (&OutofcoreOctreeBaseNode::addPointCloud_and_genLOD, children_[i], child_clouds.back ()));
+        }
+
+        points_added += OutofcoreOctreeBase<ContainerT, PointT>::runTasks (tasks, nr_threads);
+        assert (points_added == input_cloud->width*input_cloud->height);
+        return (points_added);
+      }
+
       //pass each set of points to the appropriate child octant
       for(size_t i=0; i<8; i++)
       {
@@ -855,6 +893,27 @@ namespace pcl
       subdividePoints(p, c, skip_bb_check);
 
       boost::uint64_t points_added = 0;
+
+      // Below the root, the top-level subtrees share no files and are filled by concurrent writers
+      const unsigned int nr_threads = (this->parent_ == NULL) ? root_node_->m_tree_->getNumberOfThreads () : 1;
+      if (nr_threads > 1)
+      {
+        std::vector<boost::function<boost::uint64_t ()> > tasks;
+        for (size_t i = 0; i < 8; i++)
+        {
+          if (c[i].empty ())
+            continue;
+
+          // Children are created up front, since creating them modifies this node
+          if (!children_[i])
+            createChild (i);
+
+          tasks.push_back (boost::bind (&OutofcoreOctreeBaseNode::addDataToLeaf_and_genLOD, children_[i], boost::cref (c[i]), true));
+        }
+
+        return (OutofcoreOctreeBase<ContainerT, PointT>::runTasks (tasks, nr_threads));
+      }
+
       for(size_t i = 0; i < 8; i++)
       {
         // If child doesn't have points
@@ -1389,6 +1448,31 @@ namespace pcl
     }
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::queryBBIntersects (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, const boost::uint32_t query_depth, std::vector<ConstPointSpan>& spans)
+    {
+      if (intersectsWithBoundingBox (min_bb, max_bb))
+      {
+        if (this->depth_ < query_depth)
+        {
+          if (this->hasUnloadedChildren ())
+            this->loadChildren (false);
+
+          for (size_t i = 0; i < 8; i++)
+          {
+            if (children_[i])
+              children_[i]->queryBBIntersects (min_bb, max_bb, query_depth, spans);
+          }
+          return;
+        }
+
+        ConstPointSpan span = payload_->getMappedPoints ();
+        if (!span.empty ())
+          spans.push_back (span);
+      }
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBaseNode<ContainerT, PointT>::queryBBIncludes (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, size_t query_depth, const pcl::PCLPointCloud2::Ptr& dst_blob)
     {
@@ -1513,6 +1597,21 @@ namespace pcl
       PCL_DEBUG ("[pcl::outofcore::OutofcoreOctreeBaseNode::%s] Points added by function call: %ul\n", __FUNCTION__, dst_blob->width*dst_blob->height - startingSize );
     }
 
+    template<typename ContainerT, typename PointT> void
+    OutofcoreOctreeBaseNode<ContainerT, PointT>::prefetchChildren (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, const boost::uint64_t query_depth)
+    {
+      //only the children at the query depth have their payload read by a bounding box query
+      if (this->depth_ + 1 != query_depth)
+        return;
+
+      for (size_t i = 0; i < 8; i++)
+      {
+        if (children_[i] && children_[i]->intersectsWithBoundingBox (min_bb, max_bb))
+          children_[i]->payload_->prefetch ();
+      }
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename ContainerT, typename PointT> void
     OutofcoreOctreeBaseNode<ContainerT, PointT>::queryBBIncludes (const Eigen::Vector3d& min_bb, const Eigen::Vector3d& max_bb, size_t query_depth, AlignedPointTVector& v)
     {
@@ -1535,6 +1634,9 @@ namespace pcl
             if(hasUnloadedChildren ())
               loadChildren (false);
 
+            //queue the payloads that will be read below so disk access overlaps the traversal
+            prefetchChildren (min_bb, max_bb, query_depth);
+
             //recursively store any points that fall into the queried bounding box into v and return
             for (size_t i = 0; i < 8; i++)
             {
@@ -1671,6 +1773,8 @@ namespace pcl
           //if we do have children
           if (num_children_ > 0)
           {
+            prefetchChildren (min_bb, max_bb, query_depth);
+
             //recursively add their valid points within the queried bounding box to the list v
             for (size_t i = 0; i < 8; i++)
             {
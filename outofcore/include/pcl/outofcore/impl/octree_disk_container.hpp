@@ -42,6 +42,9 @@
 
 // C++
 #include <sstream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
 #include <cassert>
 #include <ctime>
 
@@ -76,6 +79,21 @@ namespace pcl
     template<typename PointT>
     boost::uuids::random_generator OutofcoreOctreeDiskContainer<PointT>::uuid_gen_ (&rand_gen_);
 
+    template<typename PointT> typename OutofcoreOctreeDiskContainer<PointT>::NodeCache
+    OutofcoreOctreeDiskContainer<PointT>::node_cache_ (static_cast<size_t> (256) << 20);
+
+    template<typename PointT>
+    boost::mutex OutofcoreOctreeDiskContainer<PointT>::node_cache_mutex_;
+
+    template<typename PointT>
+    size_t OutofcoreOctreeDiskContainer<PointT>::node_cache_timestamp_ = 0;
+
+    template<typename PointT>
+    std::map<std::string, typename OutofcoreOctreeDiskContainer<PointT>::PendingRead> OutofcoreOctreeDiskContainer<PointT>::pending_reads_;
+
+    template<typename PointT>
+    const std::string OutofcoreOctreeDiskContainer<PointT>::FLAT_EXTENSION_ (".flat");
+
     template<typename PointT>
     const uint64_t OutofcoreOctreeDiskContainer<PointT>::READ_BLOCK_SIZE_ = static_cast<uint64_t> (2e12);
     template<typename PointT>
@@ -96,6 +114,237 @@ namespace pcl
     }
     ////////////////////////////////////////////////////////////////////////////////
 
+    template<typename PointT> typename OutofcoreOctreeDiskContainer<PointT>::AlignedPointTVectorConstPtr
+    OutofcoreOctreeDiskContainer<PointT>::readCached (const std::string &path)
+    {
+      uint64_t generation = 0;
+      {
+        boost::mutex::scoped_lock lock (node_cache_mutex_);
+        if (node_cache_.hasKey (path))
+          return (node_cache_.get (path).item);
+
+        // Register the read, so that invalidations during the decode are counted
+        PendingRead &pending = pending_reads_[path];
+        ++pending.readers;
+        generation = pending.generation;
+      }
+
+      // Decode the whole node file once; the lock is not held during disk access
+      boost::shared_ptr<AlignedPointTVector> points (new AlignedPointTVector ());
+      bool valid = true;
+      if (boost::filesystem::exists (path))
+      {
+        pcl::PointCloud<PointT> cloud;
+        pcl::PCDReader reader;
+        if (reader.read (path, cloud) != 0)
+        {
+          PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Could not read %s\n", __FUNCTION__, path.c_str ());
+          valid = false;
+        }
+        else
+          points->swap (cloud.points);
+      }
+
+      // Only cache the points if the file was not modified while it was decoded
+      boost::mutex::scoped_lock lock (node_cache_mutex_);
+      typename std::map<std::string, PendingRead>::iterator it = pending_reads_.find (path);
+      assert (it != pending_reads_.end ());
+      const uint64_t current = it->second.generation;
+      if (--it->second.readers == 0)
+        pending_reads_.erase (it);
+
+      if (valid && current == generation && !node_cache_.hasKey (path))
+        node_cache_.insert (path, OutofcoreNodeCacheItem<PointT> (points, ++node_cache_timestamp_));
+
+      return (points);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::invalidateCache (const std::string &path)
+    {
+      {
+        boost::mutex::scoped_lock lock (node_cache_mutex_);
+        node_cache_.erase (path);
+        typename std::map<std::string, PendingRead>::iterator it = pending_reads_.find (path);
+        if (it != pending_reads_.end ())
+          ++it->second.generation;
+      }
+
+      // Views handed out earlier keep their mapping of the old flat file
+      boost::system::error_code ec;
+      boost::filesystem::remove (path + FLAT_EXTENSION_, ec);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> bool
+    OutofcoreOctreeDiskContainer<PointT>::isFlatFileCurrent (const std::string &path, const OutofcoreFlatNodeHeader &header)
+    {
+      OutofcoreFileStamp stamp;
+      if (!getFileStamp (path, stamp) || !(stamp == header.source))
+        return (false);
+
+      if (!header.racy)
+        return (true);
+
+      boost::uint64_t hash;
+      if (!hashFile (path, hash) || hash != header.source_hash)
+        return (false);
+
+      const boost::int64_t now = static_cast<boost::int64_t> (std::time (NULL)) * 1000000000;
+      return (std::max (stamp.mtime, stamp.ctime) > now - OutofcoreFlatNodeHeader::RACY_INTERVAL);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> bool
+    OutofcoreOctreeDiskContainer<PointT>::writeFlatFile (const std::string &path, const std::string &flat_path)
+    {
+      OutofcoreFlatNodeHeader header;
+      memcpy (header.magic, "PCLFLAT3", sizeof (header.magic));
+      header.point_size = static_cast<boost::uint32_t> (sizeof (PointT));
+      header.padding = 0;
+
+      // The stamp and hash are taken before reading, so that a change during the read is caught by the next check
+      if (!getFileStamp (path, header.source))
+        return (false);
+      header.stamp_time = static_cast<boost::int64_t> (std::time (NULL)) * 1000000000;
+      header.racy = (std::max (header.source.mtime, header.source.ctime) > header.stamp_time - OutofcoreFlatNodeHeader::RACY_INTERVAL) ? 1 : 0;
+      if (!hashFile (path, header.source_hash))
+        return (false);
+
+      AlignedPointTVectorConstPtr points = readCached (path);
+      header.num_points = points->size ();
+
+      // Write to a unique temporary name first so that concurrent readers never map a partial file
+      std::string uuid;
+      getRandomUUIDString (uuid);
+      const std::string tmp_path = flat_path + "." + uuid;
+      {
+        std::ofstream file (tmp_path.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file)
+          return (false);
+
+        file.write (reinterpret_cast<const char*> (&header), sizeof (header));
+        if (!points->empty ())
+          file.write (reinterpret_cast<const char*> (&(*points)[0]), static_cast<std::streamsize> (points->size () * sizeof (PointT)));
+        if (!file)
+        {
+          file.close ();
+          boost::filesystem::remove (tmp_path);
+          return (false);
+        }
+      }
+
+      boost::system::error_code ec;
+      boost::filesystem::rename (tmp_path, flat_path, ec);
+      if (ec)
+      {
+        boost::filesystem::remove (tmp_path, ec);
+        return (false);
+      }
+      return (true);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> typename OutofcoreOctreeDiskContainer<PointT>::ConstPointSpan
+    OutofcoreOctreeDiskContainer<PointT>::getMappedPoints () const
+    {
+      if (filelen_ == 0 || !boost::filesystem::exists (*disk_storage_filename_))
+        return (ConstPointSpan ());
+
+      const std::string flat_path = *disk_storage_filename_ + FLAT_EXTENSION_;
+
+      // Map the flat copy, (re)generating it if it is missing or does not match the node file
+      OutofcoreMappedFile::Ptr file (new OutofcoreMappedFile ());
+      for (int attempt = 0; attempt < 2; attempt++)
+      {
+        if (file->open (flat_path) && file->size () >= sizeof (OutofcoreFlatNodeHeader))
+        {
+          OutofcoreFlatNodeHeader header;
+          memcpy (&header, file->data (), sizeof (header));
+          if (memcmp (header.magic, "PCLFLAT3", sizeof (header.magic)) == 0 &&
+              header.point_size == sizeof (PointT) &&
+              header.num_points == filelen_ &&
+              file->size () >= sizeof (header) + header.num_points * sizeof (PointT) &&
+              isFlatFileCurrent (*disk_storage_filename_, header))
+          {
+            const PointT *points = reinterpret_cast<const PointT*> (file->data () + sizeof (header));
+            return (ConstPointSpan (points, static_cast<size_t> (header.num_points), file));
+          }
+        }
+        file->close ();
+
+        // The node file may have been modified outside of this container, so the cached points are dropped too
+        if (attempt == 0)
+        {
+          invalidateCache (*disk_storage_filename_);
+          if (!writeFlatFile (*disk_storage_filename_, flat_path))
+            break;
+        }
+      }
+
+      PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Could not map the points of %s\n", __FUNCTION__, disk_storage_filename_->c_str ());
+      return (ConstPointSpan ());
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> typename OutofcoreOctreeDiskContainer<PointT>::PrefetchWorker&
+    OutofcoreOctreeDiskContainer<PointT>::getPrefetchWorker ()
+    {
+      static PrefetchWorker worker;
+      return (worker);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::stopPrefetching ()
+    {
+      getPrefetchWorker ().stop ();
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::prefetch () const
+    {
+      {
+        boost::mutex::scoped_lock lock (node_cache_mutex_);
+        if (node_cache_.capacity_ == 0 || node_cache_.hasKey (*disk_storage_filename_))
+          return;
+      }
+
+      if (!boost::filesystem::exists (*disk_storage_filename_))
+        return;
+
+      getPrefetchWorker ().push (*disk_storage_filename_);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::setCacheCapacity (const size_t bytes)
+    {
+      boost::mutex::scoped_lock lock (node_cache_mutex_);
+      node_cache_.setCapacity (bytes);
+      while (node_cache_.size_ > bytes && node_cache_.evict ())
+        ;
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> size_t
+    OutofcoreOctreeDiskContainer<PointT>::getCacheCapacity ()
+    {
+      boost::mutex::scoped_lock lock (node_cache_mutex_);
+      return (node_cache_.capacity_);
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
+    template<typename PointT> void
+    OutofcoreOctreeDiskContainer<PointT>::clearCache ()
+    {
+      boost::mutex::scoped_lock lock (node_cache_mutex_);
+      node_cache_.evict (static_cast<int> (node_cache_.key_index_.size ()));
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+
     template<typename PointT>
     OutofcoreOctreeDiskContainer<PointT>::OutofcoreOctreeDiskContainer () 
       : disk_storage_filename_ ()
@@ -186,6 +435,7 @@ namespace pcl
         int res = writer.writeBinaryCompressed (*disk_storage_filename_, *cloud);
         (void)res;
         assert (res == 0);
+        invalidateCache (*disk_storage_filename_);
         if (force_cache_dealloc)
         {
           writebuff_.resize (0);
@@ -249,16 +499,21 @@ namespace pcl
         PCL_THROW_EXCEPTION (PCLException, "[pcl::outofcore::OutofcoreOctreeDiskContainer] Outofcore Octree Exception: Read indices exceed range");
       }
 
-      pcl::PCDReader reader;
-      typename pcl::PointCloud<PointT>::Ptr cloud (new pcl::PointCloud<PointT> ());
-      
-      int res = reader.read (*disk_storage_filename_, *cloud);
-      (void)res;
-      assert (res == 0);
-      
-      for (size_t i=0; i < cloud->points.size (); i++)
-        dst.push_back (cloud->points[i]);
-      
+      // Copy the part of the range stored on disk in one block out of the cached node data
+      if (start < filelen_)
+      {
+        AlignedPointTVectorConstPtr points = readCached (*disk_storage_filename_);
+        const uint64_t filestop = std::min (start + count, static_cast<uint64_t> (points->size ()));
+        if (start < filestop)
+          dst.insert (dst.end (), points->begin () + start, points->begin () + filestop);
+      }
+
+      // Append the part of the range still waiting in the write buffer
+      if ((start + count) > filelen_)
+      {
+        const uint64_t buffstart = (start > filelen_) ? (start - filelen_) : 0;
+        dst.insert (dst.end (), writebuff_.begin () + buffstart, writebuff_.begin () + (start + count - filelen_));
+      }
     }
     ////////////////////////////////////////////////////////////////////////////////
 
@@ -329,27 +584,18 @@ namespace pcl
             }
           }
         }
-        std::sort (offsets.begin (), offsets.end ());
 
-        FILE* f = fopen (disk_storage_filename_->c_str (), "rb");
-        assert (f != NULL);
-        PointT p;
-        char* loc = reinterpret_cast<char*> (&p);
-        
-        uint64_t filesamp = offsets.size ();
-        for (uint64_t i = 0; i < filesamp; i++)
+        // Gather the samples from the cached node data instead of seeking once per point
+        AlignedPointTVectorConstPtr points = readCached (*disk_storage_filename_);
+        if (points->size () < filestart + filecount)
+          PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Only %lu of %lu points could be read from %s; skipping the missing ones\n", __FUNCTION__, points->size (), filelen_, disk_storage_filename_->c_str ());
+
+        dst.reserve (dst.size () + offsets.size ());
+        for (size_t i = 0; i < offsets.size (); i++)
         {
-          int seekret = _fseeki64 (f, offsets[i] * static_cast<uint64_t> (sizeof(PointT)), SEEK_SET);
-          (void)seekret;
-          assert (seekret == 0);
-          size_t readlen = fread (loc, sizeof(PointT), 1, f);
-          (void)readlen;
-          assert (readlen == 1);
-
-          dst.push_back (p);
+          if (offsets[i] < points->size ())
+            dst.push_back ((*points)[offsets[i]]);
         }
-
-        fclose (f);
       }
     }
     ////////////////////////////////////////////////////////////////////////////////
@@ -428,26 +674,18 @@ namespace pcl
             offsets[i] = _filestart;
           }
         }
-        std::sort (offsets.begin (), offsets.end ());
 
-        FILE* f = fopen (disk_storage_filename_->c_str (), "rb");
-        assert (f != NULL);
-        PointT p;
-        char* loc = reinterpret_cast<char*> (&p);
+        // Gather the samples from the cached node data instead of seeking once per point
+        AlignedPointTVectorConstPtr points = readCached (*disk_storage_filename_);
+        if (points->size () < filestart + filecount)
+          PCL_ERROR ("[pcl::outofcore::OutofcoreOctreeDiskContainer::%s] Only %lu of %lu points could be read from %s; skipping the missing ones\n", __FUNCTION__, points->size (), filelen_, disk_storage_filename_->c_str ());
+
+        dst.reserve (dst.size () + filesamp);
         for (uint64_t i = 0; i < filesamp; i++)
         {
-          int seekret = _fseeki64 (f, offsets[i] * static_cast<uint64_t> (sizeof(PointT)), SEEK_SET);
-          (void)seekret;
-          assert (seekret == 0);
-          size_t readlen = fread (loc, sizeof(PointT), 1, f);
-          (void)readlen;
-          assert (readlen == 1);
-
-          dst.push_back (p);
+          if (offsets[i] < points->size ())
+            dst.push_back ((*points)[offsets[i]]);
         }
-        int res = fclose (f);
-        (void)res;
-        assert (res == 0);
       }
     }
     ////////////////////////////////////////////////////////////////////////////////
@@ -504,6 +742,11 @@ namespace pcl
       int res = writer.writeBinaryCompressed (*disk_storage_filename_, *tmp_cloud);
       (void)res;
       assert (res == 0);
+
+      // The write buffer was persisted together with the new points
+      filelen_ = tmp_cloud->points.size ();
+      writebuff_.clear ();
+      invalidateCache (*disk_storage_filename_);
     }
   
     ////////////////////////////////////////////////////////////////////////////////
@@ -535,7 +778,7 @@ namespace pcl
         assert (previous_num_pts == res_pts);
         
         writer.writeBinaryCompressed (*disk_storage_filename_, *tmp_cloud);
-            
+        filelen_ = res_pts;
       }
       else //otherwise create the point cloud which will be saved to the pcd file for the first time
       {
@@ -543,8 +786,10 @@ namespace pcl
         int res = writer.writeBinaryCompressed (*disk_storage_filename_, *input_cloud);
         (void)res;
         assert (res == 0);
+        filelen_ = input_cloud->width*input_cloud->height;
       }            
 
+      invalidateCache (*disk_storage_filename_);
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -666,6 +911,11 @@ namespace pcl
       int res = writer.writeBinaryCompressed (*disk_storage_filename_, *tmp_cloud);
       (void)res;
       assert (res == 0);
+
+      // The write buffer was persisted together with the new points
+      filelen_ = tmp_cloud->points.size ();
+      writebuff_.clear ();
+      invalidateCache (*disk_storage_filename_);
     }
     ////////////////////////////////////////////////////////////////////////////////
 
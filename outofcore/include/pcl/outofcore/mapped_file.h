@@ -0,0 +1,246 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  $Id$
+ */
+
+#ifndef PCL_OUTOFCORE_MAPPED_FILE_H_
+#define PCL_OUTOFCORE_MAPPED_FILE_H_
+
+#include <pcl/pcl_macros.h>
+#include <pcl/outofcore/boost.h>
+
+#include <string>
+
+namespace pcl
+{
+  namespace outofcore
+  {
+    /** \brief Identity of one version of a file, used to detect that the file was modified.
+     *
+     *  Timestamps are kept with the full resolution of the file system. Two versions
+     *  written within one tick of the file system clock, with the same size and in
+     *  place, can still have the same stamp; see \ref OutofcoreFlatNodeHeader for how
+     *  such racy stamps are handled.
+     *
+     *  \ingroup outofcore
+     */
+    struct OutofcoreFileStamp
+    {
+      /** \brief Size of the file in bytes */
+      boost::uint64_t size;
+      /** \brief Inode number (file index on Windows), which changes when the file is replaced */
+      boost::uint64_t inode;
+      /** \brief Modification time in nanoseconds since the epoch */
+      boost::int64_t mtime;
+      /** \brief Status change time (change time on Windows) in nanoseconds since the epoch, which
+       *  is also updated when the modification time is set explicitly
+       */
+      boost::int64_t ctime;
+    };
+
+    /** \brief Returns true if \b a and \b b describe the same version of a file */
+    inline bool
+    operator== (const OutofcoreFileStamp &a, const OutofcoreFileStamp &b)
+    {
+      return (a.size == b.size && a.inode == b.inode && a.mtime == b.mtime && a.ctime == b.ctime);
+    }
+
+    /** \brief Reads the stamp of the file \b path.
+     *  \return true on success
+     *
+     *  \ingroup outofcore
+     */
+    PCL_EXPORTS bool
+    getFileStamp (const std::string &path, OutofcoreFileStamp &stamp);
+
+    /** \brief Computes a 64 bit FNV-1a hash of the contents of the file \b path.
+     *  \return true on success
+     *
+     *  \ingroup outofcore
+     */
+    PCL_EXPORTS bool
+    hashFile (const std::string &path, boost::uint64_t &hash);
+
+    /** \brief Header of the flat node files produced by \ref OutofcoreOctreeDiskContainer::getMappedPoints.
+     *
+     *  A flat node file consists of this 80 byte header followed by \c num_points
+     *  points stored as raw \c PointT structures with a stride of \c point_size
+     *  bytes, so that it can be mapped into memory and used in place. The file
+     *  layout depends on the machine and the point type; it is a cache derived
+     *  from the PCD file of the node and is regenerated whenever that file changes,
+     *  which is detected through the stamp of the PCD file (see \ref OutofcoreFileStamp).
+     *
+     *  If the PCD file changed less than \c RACY_INTERVAL nanoseconds before its stamp
+     *  was taken, a later change could leave the stamp as it is. Such a flat file is
+     *  marked racy and only used after the hash of the PCD file is checked against
+     *  \c source_hash.
+     *
+     *  \ingroup outofcore
+     */
+    struct OutofcoreFlatNodeHeader
+    {
+      /** \brief Always "PCLFLAT3" */
+      char magic[8];
+      /** \brief sizeof (PointT) of the stored points */
+      boost::uint32_t point_size;
+      /** \brief Nonzero if the stamp of the PCD file was taken within \c RACY_INTERVAL of its last change */
+      boost::uint32_t racy;
+      /** \brief Number of stored points */
+      boost::uint64_t num_points;
+      /** \brief Stamp of the PCD file the points were read from */
+      OutofcoreFileStamp source;
+      /** \brief Hash of the contents of the PCD file the points were read from (see \ref hashFile) */
+      boost::uint64_t source_hash;
+      /** \brief Time the stamp was taken, in nanoseconds since the epoch */
+      boost::int64_t stamp_time;
+      /** \brief Padding so that the points start 16 byte aligned */
+      boost::uint64_t padding;
+
+      /** \brief Changes closer than this to the time of the stamp make it racy (2 s, in nanoseconds) */
+      static const boost::int64_t RACY_INTERVAL = static_cast<boost::int64_t> (2000000000);
+    };
+
+    /** \brief Read-only memory mapping of a whole file. The mapping is released
+     *  when the object is destroyed.
+     *
+     *  \ingroup outofcore
+     */
+    class PCL_EXPORTS OutofcoreMappedFile : boost::noncopyable
+    {
+      public:
+        typedef boost::shared_ptr<OutofcoreMappedFile> Ptr;
+        typedef boost::shared_ptr<const OutofcoreMappedFile> ConstPtr;
+
+        OutofcoreMappedFile ();
+
+        ~OutofcoreMappedFile ();
+
+        /** \brief Map the file \b path into memory, releasing any previous mapping. The size of the mapping
+         *  is read from the opened file, so it matches the file even if \b path was replaced meanwhile. The file
+         *  must not be truncated while it is mapped; flat node files are only ever replaced by renaming.
+         *  \return true on success
+         */
+        bool
+        open (const std::string &path);
+
+        /** \brief Release the mapping */
+        void
+        close ();
+
+        /** \brief Returns the first byte of the mapping, or NULL if nothing is mapped */
+        inline const char*
+        data () const
+        {
+          return (map_);
+        }
+
+        /** \brief Returns the number of mapped bytes */
+        inline size_t
+        size () const
+        {
+          return (size_);
+        }
+
+      private:
+        char *map_;
+        size_t size_;
+#ifdef _WIN32
+        void *file_mapping_;
+#endif
+    };
+
+    /** \brief Read-only view of points stored contiguously in a memory mapped node file.
+     *  The view keeps the mapping alive, so it stays valid after the node that produced it
+     *  is modified or destroyed.
+     *
+     *  \ingroup outofcore
+     */
+    template<typename PointT>
+    class OutofcoreConstPointSpan
+    {
+      public:
+        typedef const PointT* const_iterator;
+
+        OutofcoreConstPointSpan ()
+          : points_ (NULL)
+          , size_ (0)
+          , file_ ()
+        {}
+
+        OutofcoreConstPointSpan (const PointT *points, const size_t size, const OutofcoreMappedFile::ConstPtr &file)
+          : points_ (points)
+          , size_ (size)
+          , file_ (file)
+        {}
+
+        inline const_iterator
+        begin () const
+        {
+          return (points_);
+        }
+
+        inline const_iterator
+        end () const
+        {
+          return (points_ + size_);
+        }
+
+        inline const PointT&
+        operator[] (const size_t idx) const
+        {
+          return (points_[idx]);
+        }
+
+        inline size_t
+        size () const
+        {
+          return (size_);
+        }
+
+        inline bool
+        empty () const
+        {
+          return (size_ == 0);
+        }
+
+      private:
+        const PointT *points_;
+        size_t size_;
+        OutofcoreMappedFile::ConstPtr file_;
+    };
+  }
+}
+
+#endif //PCL_OUTOFCORE_MAPPED_FILE_H_
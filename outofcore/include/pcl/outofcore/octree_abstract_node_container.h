@@ -91,6 +91,12 @@ namespace pcl
         virtual PointT
         operator[] (uint64_t idx) const=0;
 
+        /** \brief Hint that the points of this container will be read soon. Containers
+         * backed by slow storage may start loading them asynchronously; the default does nothing.
+         */
+        virtual void
+        prefetch () const {}
+
       protected:
         OutofcoreAbstractNodeContainer (const OutofcoreAbstractNodeContainer& rval);
 
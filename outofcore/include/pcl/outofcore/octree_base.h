@@ -63,6 +63,7 @@
 #include <pcl/filters/random_sample.h>
 
 #include <pcl/PCLPointCloud2.h>
+#include <pcl/common/time.h>
 
 namespace pcl
 {
@@ -76,6 +77,30 @@ namespace pcl
       std::string node_container_extension_;
       double sample_percent;
     };
+
+    /** \brief Progress and throughput counters of an outofcore octree ingestion or LOD build */
+    struct OutofcoreProgress
+    {
+      OutofcoreProgress ()
+        : nodes_written (0)
+        , points_written (0)
+        , elapsed_seconds (0.0)
+      {}
+
+      /** \brief Number of writes to node payloads, LOD samples included */
+      boost::uint64_t nodes_written;
+      /** \brief Number of points written to node payloads, LOD samples included */
+      boost::uint64_t points_written;
+      /** \brief Wall time spent since the operation started */
+      double elapsed_seconds;
+
+      /** \brief Returns the number of points written per second */
+      double
+      getThroughput () const
+      {
+        return (elapsed_seconds > 0.0 ? static_cast<double> (points_written) / elapsed_seconds : 0.0);
+      }
+    };
     
     /** \class OutofcoreOctreeBase 
      *  \brief This code defines the octree used for point storage at Urban Robotics. 
@@ -187,6 +212,8 @@ namespace pcl
 
         typedef std::vector<PointT, Eigen::aligned_allocator<PointT> > AlignedPointTVector;
 
+        typedef OutofcoreConstPointSpan<PointT> ConstPointSpan;
+
         // Constructors
         // -----------------------------------------------------------------------
 
@@ -321,6 +348,21 @@ namespace pcl
         void
         queryBBIntersects (const Eigen::Vector3d &min, const Eigen::Vector3d &max, const boost::uint32_t query_depth, std::list<std::string> &bin_name) const;
 
+        /** \brief Get read-only views of the points of all nodes at \c query_depth which intersect the bounding box,
+         * without copying them. Each view maps a flat copy of the node file into memory, so repeated queries are
+         * served from the OS page cache. Nodes which only partially overlap the bounding box are returned whole;
+         * use \ref queryBBIncludes to get only the points inside the box.
+         *
+         * Only available for trees using \ref OutofcoreOctreeDiskContainer.
+         *
+         * \param[in] min The minimum corner of the bounding box
+         * \param[in] max The maximum corner of the bounding box
+         * \param[in] query_depth The depth from which point data will be taken
+         * \param[out] spans One view per non-empty node; the views stay valid after the tree is modified
+         */
+        void
+        queryBBIntersects (const Eigen::Vector3d &min, const Eigen::Vector3d &max, const boost::uint32_t query_depth, std::vector<ConstPointSpan> &spans) const;
+
         /** \brief Get Points in BB, only points inside BB. The query
          * processes the data at each node, filtering points that fall
          * out of the query bounds, and returns a single, concatenated
@@ -474,10 +516,34 @@ namespace pcl
         // -----------------------------------------------------------------------
 
         /** \brief Generate multi-resolution LODs for the tree, which are a uniform random sampling all child leafs below the node.
+         *  With more than one thread (see \ref setNumberOfThreads) and a pcl::RandomSample LOD filter, the subtrees below
+         *  the root are sampled in parallel, each with a generator seeded from the filter seed and its octant. The samples
+         *  of the root are appended in octant order after all subtrees are done, so that the result does not depend on the
+         *  number of threads. Other LOD filters are run serially.
          */
         void
         buildLOD ();
 
+        /** \brief Set the number of threads used by \ref addPointCloud_and_genLOD, \ref addDataToLeaf_and_genLOD
+         *  and \ref buildLOD. The work is partitioned by top-level octant, so at most eight threads are busy at a time.
+         *  \param[in] nr_threads the number of threads to use; 0 selects the number of hardware threads (default: 1)
+         */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
+        /** \brief Returns the number of threads used for ingestion and LOD generation */
+        unsigned int
+        getNumberOfThreads () const
+        {
+          return (threads_);
+        }
+
+        /** \brief Returns the progress of the ingestion or LOD build currently running, or of the last one that finished.
+         *  May be called from another thread while points are being added.
+         */
+        OutofcoreProgress
+        getProgress () const;
+
         /** \brief Prints size of BBox to stdout
          */ 
         void
@@ -597,6 +663,46 @@ namespace pcl
         void
         buildLODRecursive (const std::vector<BranchNode*>& current_branch);
 
+        /** \brief recursive portion of lod builder. If \b rng is not NULL the points are sampled with it instead
+         *  of the LOD filter, so that subtrees can be processed concurrently.
+         *  \param[in] current_branch the branch from the root to the current node
+         *  \param[in] rng the generator sampling the branch, or NULL to use the LOD filter
+         *  \param[out] root_samples if not NULL, receives the samples of the root instead of the root payload
+         *  \return the number of points written to the LODs of the branch
+         */
+        boost::uint64_t
+        buildLODRecursive (const std::vector<BranchNode*>& current_branch, boost::mt19937* rng,
+                           std::vector<pcl::PCLPointCloud2::Ptr>* root_samples);
+
+        /** \brief Builds the LOD of one subtree below the root with its own generator; task body of the parallel \ref buildLOD
+         *  \param[in] current_branch the branch from the root to the subtree
+         *  \param[in] seed the seed of the generator sampling the subtree
+         *  \param[out] root_samples receives the samples of the root, in the order they were drawn
+         *  \return the number of points written to the LODs of the subtree
+         */
+        boost::uint64_t
+        buildLODSubtree (const std::vector<BranchNode*>& current_branch, const boost::uint32_t seed,
+                         std::vector<pcl::PCLPointCloud2::Ptr>* root_samples);
+
+        /** \brief Draws \b sample_size distinct indices out of [0, \b nr_points) in increasing order.
+         *  Unlike RandomSample, which uses the global rand () state, this can be called from concurrent
+         *  tasks that each own their generator.
+         */
+        static void
+        sampleIndices (const boost::uint64_t nr_points, const boost::uint64_t sample_size, boost::mt19937& rng, std::vector<int>& indices);
+
+        /** \brief Runs \b tasks on up to \b nr_threads threads and returns the sum of their results */
+        static boost::uint64_t
+        runTasks (const std::vector<boost::function<boost::uint64_t ()> >& tasks, const unsigned int nr_threads);
+
+        /** \brief Resets the progress counters at the start of an ingestion or LOD build */
+        void
+        startProgress ();
+
+        /** \brief Stops the clock of the progress counters at the end of an ingestion or LOD build */
+        void
+        stopProgress ();
+
         /** \brief Increment current depths (LOD for branch nodes) point count; called by addDataAtMaxDepth in OutofcoreOctreeBaseNode
          */
         inline void
@@ -657,6 +763,17 @@ namespace pcl
         double sample_percent_;
 
         pcl::RandomSample<pcl::PCLPointCloud2>::Ptr lod_filter_ptr_;
+
+        /** \brief Number of threads used for ingestion and LOD generation */
+        unsigned int threads_;
+
+        /** \brief Serializes updates of the LOD point counts in the metadata */
+        boost::mutex metadata_mutex_;
+
+        OutofcoreProgress progress_;
+        mutable pcl::StopWatch progress_timer_;
+        bool progress_running_;
+        mutable boost::mutex progress_mutex_;
         
     };
   }
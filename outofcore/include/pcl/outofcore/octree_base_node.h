@@ -108,6 +108,7 @@ namespace pcl
         typedef OutofcoreOctreeBaseNode<OutofcoreOctreeDiskContainer < PointT > , PointT > octree_disk_node;
 
         typedef std::vector<PointT, Eigen::aligned_allocator<PointT> > AlignedPointTVector;
+        typedef OutofcoreConstPointSpan<PointT> ConstPointSpan;
 
         typedef pcl::octree::node_type_t node_type_t;
 
@@ -201,6 +202,13 @@ namespace pcl
         virtual void
         queryBBIntersects (const Eigen::Vector3d &min_bb, const Eigen::Vector3d &max_bb, const boost::uint32_t query_depth, std::list<std::string> &file_names);
 
+        /** \brief Recursively collects read-only views of the points of every node with which the queried bounding
+         *  box intersects (at query_depth only). The points are memory mapped, not copied; requires a container
+         *  providing \c getMappedPoints, such as \ref OutofcoreOctreeDiskContainer.
+         */
+        void
+        queryBBIntersects (const Eigen::Vector3d &min_bb, const Eigen::Vector3d &max_bb, const boost::uint32_t query_depth, std::vector<ConstPointSpan> &spans);
+
         /** \brief Write the voxel size to stdout at \c query_depth 
          * \param[in] query_depth The depth at which to print the size of the voxel/bounding boxes
          */
@@ -409,6 +417,15 @@ namespace pcl
         inline bool
         intersectsWithBoundingBox (const Eigen::Vector3d &min_bb, const Eigen::Vector3d &max_bb) const;
 
+        /** \brief Asks the payload containers of the children whose points a bounding box query
+         *  at \c query_depth will read next to start loading them asynchronously
+         *  \param[in] min_bb The minimum corner of the queried bounding box
+         *  \param[in] max_bb The maximum corner of the queried bounding box
+         *  \param[in] query_depth The depth of the query
+         */
+        void
+        prefetchChildren (const Eigen::Vector3d &min_bb, const Eigen::Vector3d &max_bb, const boost::uint64_t query_depth);
+
         /** \brief Tests whether the input bounding box falls inclusively within this node's bounding box
          *  \param[in] min_bb The minimum corner of the input bounding box
          *  \param[in] max_bb The maximum corner of the input bounding box
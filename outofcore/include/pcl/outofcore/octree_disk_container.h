@@ -43,9 +43,13 @@
 // C++
 #include <vector>
 #include <string>
+#include <map>
 
 #include <pcl/outofcore/boost.h>
 #include <pcl/outofcore/octree_abstract_node_container.h>
+#include <pcl/outofcore/mapped_file.h>
+#include <pcl/outofcore/impl/lru_cache.hpp>
+#include <pcl/outofcore/impl/monitor_queue.hpp>
 #include <pcl/io/pcd_io.h>
 #include <pcl/PCLPointCloud2.h>
 
@@ -60,6 +64,28 @@ namespace pcl
 {
   namespace outofcore
   {
+    /** \brief Entry of the node cache shared by all \ref OutofcoreOctreeDiskContainer of a point type.
+     *  Holds the decoded points of one node file; its size is accounted in bytes.
+     */
+    template<typename PointT>
+    class OutofcoreNodeCacheItem : public LRUCacheItem<boost::shared_ptr<const std::vector<PointT, Eigen::aligned_allocator<PointT> > > >
+    {
+      public:
+        typedef std::vector<PointT, Eigen::aligned_allocator<PointT> > AlignedPointTVector;
+
+        OutofcoreNodeCacheItem (const boost::shared_ptr<const AlignedPointTVector> &points, size_t timestamp)
+        {
+          this->item = points;
+          this->timestamp = timestamp;
+        }
+
+        virtual size_t
+        sizeOf () const
+        {
+          return (this->item->size () * sizeof (PointT));
+        }
+    };
+
   /** \class OutofcoreOctreeDiskContainer
    *  \note Code was adapted from the Urban Robotics out of core octree implementation. 
    *  Contact Jacob Schloss <jacob.schloss@urbanrobotics.net> with any questions. 
@@ -75,6 +101,8 @@ namespace pcl
   
       public:
         typedef typename OutofcoreAbstractNodeContainer<PointT>::AlignedPointTVector AlignedPointTVector;
+        typedef boost::shared_ptr<const AlignedPointTVector> AlignedPointTVectorConstPtr;
+        typedef OutofcoreConstPointSpan<PointT> ConstPointSpan;
         
         /** \brief Empty constructor creates disk container and sets filename from random uuid string*/
         OutofcoreOctreeDiskContainer ();
@@ -171,6 +199,48 @@ namespace pcl
         readRangeSubSample_bernoulli (const uint64_t start, const uint64_t count, 
                                       const double percent, AlignedPointTVector& dst);
 
+        /** \brief Returns a read-only view of the points stored on disk, without copying them.
+         *
+         * The points are served from a flat, fixed-stride copy of the node file (see
+         * \ref OutofcoreFlatNodeHeader) that is mapped into memory, so the OS page cache
+         * does the caching. The flat file is written next to the PCD file the first time
+         * it is needed and rewritten after the node changes. Points still waiting in
+         * the write buffer are not part of the view.
+         *
+         * \return the view, which is empty if the node has no points on disk or mapping failed
+         */
+        ConstPointSpan
+        getMappedPoints () const;
+
+        /** \brief Queues this container's node file for asynchronous loading into the
+         * shared node cache. Returns immediately; a later \ref readRange or
+         * \ref readRangeSubSample on this container is then served from memory.
+         * Has no effect if the node cache is disabled or the file does not exist yet.
+         */
+        void
+        prefetch () const;
+
+        /** \brief Set the capacity of the node cache shared by all disk containers
+         * of this point type.
+         * \param[in] bytes maximum amount of decoded point data kept in memory; 0 disables the cache
+         */
+        static void
+        setCacheCapacity (const size_t bytes);
+
+        /** \brief Get the capacity in bytes of the shared node cache */
+        static size_t
+        getCacheCapacity ();
+
+        /** \brief Drop all node files from the shared node cache */
+        static void
+        clearCache ();
+
+        /** \brief Stop the background thread serving \ref prefetch requests, once it has
+         * loaded the node files already queued. A later \ref prefetch starts it again.
+         */
+        static void
+        stopPrefetching ();
+
         /** \brief Returns the total number of points for which this container is responsible, \c filelen_ + points in \c writebuff_ that have not yet been flushed to the disk
          */
         uint64_t
@@ -209,6 +279,7 @@ namespace pcl
           //remove the binary data in the directory
           PCL_DEBUG ("[Octree Disk Container] Removing the point data from disk, in file %s\n",disk_storage_filename_->c_str ());
           boost::filesystem::remove (boost::filesystem::path (disk_storage_filename_->c_str ()));
+          invalidateCache (*disk_storage_filename_);
           //reset the size-of-file counter
           filelen_ = 0;
         }
@@ -278,6 +349,80 @@ namespace pcl
 
         void
         flushWritebuff (const bool force_cache_dealloc);
+
+        /** \brief Returns the points stored in the node file \b path, reading and
+         * decoding the file only if it is not already held by the node cache.
+         */
+        static AlignedPointTVectorConstPtr
+        readCached (const std::string &path);
+
+        /** \brief Writes the flat, mappable copy of the node file \b path to \b flat_path
+         * \return true on success
+         */
+        static bool
+        writeFlatFile (const std::string &path, const std::string &flat_path);
+
+        /** \brief Checks that the flat copy described by \b header was made from the current version of the
+         * node file \b path. Racy copies are checked against the hash of the node file, and reported as
+         * outdated once the node file is old enough to be identified by its stamp alone, so that they are
+         * written again without the racy mark.
+         */
+        static bool
+        isFlatFileCurrent (const std::string &path, const OutofcoreFlatNodeHeader &header);
+
+        /** \brief Removes \b path from the node cache and deletes its flat copy after its file was modified */
+        static void
+        invalidateCache (const std::string &path);
+
+        /** \brief Joinable background thread loading the node files queued by \ref prefetch
+         * into the node cache. It is stopped by \ref stop or when the worker is destroyed.
+         */
+        class PrefetchWorker : boost::noncopyable
+        {
+          public:
+            PrefetchWorker () : queue_ (), thread_ (), mutex_ () {}
+
+            ~PrefetchWorker () { stop (); }
+
+            /** \brief Queue \b path, starting the thread if it is not running */
+            void
+            push (const std::string &path)
+            {
+              boost::mutex::scoped_lock lock (mutex_);
+              if (!thread_)
+                thread_.reset (new boost::thread (&PrefetchWorker::run, this));
+              queue_.push (path);
+            }
+
+            /** \brief Queue the stop token and wait for the thread to exit */
+            void
+            stop ()
+            {
+              boost::mutex::scoped_lock lock (mutex_);
+              if (!thread_)
+                return;
+              queue_.push (std::string ());
+              thread_->join ();
+              thread_.reset ();
+            }
+
+          private:
+            void
+            run ()
+            {
+              // An empty path is the stop token
+              for (std::string path = queue_.pop (); !path.empty (); path = queue_.pop ())
+                readCached (path);
+            }
+
+            MonitorQueue<std::string> queue_;
+            boost::shared_ptr<boost::thread> thread_;
+            boost::mutex mutex_;
+        };
+
+        /** \brief Returns the prefetch worker, created on first use so that it is destroyed before the node cache */
+        static PrefetchWorker&
+        getPrefetchWorker ();
     
         /** \brief Name of the storage file on disk (i.e., the PCD file) */
         boost::shared_ptr<std::string> disk_storage_filename_;
@@ -292,12 +437,39 @@ namespace pcl
 
         const static uint64_t READ_BLOCK_SIZE_;
 
+        /** \brief Appended to the node file name to name its flat, mappable copy */
+        static const std::string FLAT_EXTENSION_;
+
         static const uint64_t WRITE_BUFF_MAX_;
 
         static boost::mutex rng_mutex_;
         static boost::mt19937 rand_gen_;
         static boost::uuids::random_generator uuid_gen_;
 
+        typedef LRUCache<std::string, OutofcoreNodeCacheItem<PointT> > NodeCache;
+
+        /** \brief LRU cache of decoded node files, keyed by file name */
+        static NodeCache node_cache_;
+        static boost::mutex node_cache_mutex_;
+        static size_t node_cache_timestamp_;
+
+        /** \brief A decode of a node file that is in progress */
+        struct PendingRead
+        {
+          PendingRead () : readers (0), generation (0) {}
+
+          /** \brief Number of threads decoding the file */
+          size_t readers;
+          /** \brief Number of times the file was invalidated since the first of them started */
+          uint64_t generation;
+        };
+
+        /** \brief Node files being decoded, so that a file modified during its decode is not put back
+         * into the node cache. Entries are removed when the last decode finishes, so the map only
+         * holds the files being read at the moment.
+         */
+        static std::map<std::string, PendingRead> pending_reads_;
+
     };
   } //namespace outofcore
 } //namespace pcl
@@ -0,0 +1,231 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2010-2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *  $Id$
+ *
+ */
+
+#include <pcl/outofcore/mapped_file.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+# include <io.h>
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif // WIN32_LEAN_AND_MEAN
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif // NOMINMAX
+# include <windows.h>
+#else
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+#ifndef _WIN32
+// Nanosecond part of the timestamps in struct stat
+# ifdef __APPLE__
+#  define PCL_STAT_MTIME_NSEC(st) ((st).st_mtimespec.tv_nsec)
+#  define PCL_STAT_CTIME_NSEC(st) ((st).st_ctimespec.tv_nsec)
+# else
+#  define PCL_STAT_MTIME_NSEC(st) ((st).st_mtim.tv_nsec)
+#  define PCL_STAT_CTIME_NSEC(st) ((st).st_ctim.tv_nsec)
+# endif
+#endif
+
+namespace pcl
+{
+  namespace outofcore
+  {
+    bool
+    getFileStamp (const std::string &path, OutofcoreFileStamp &stamp)
+    {
+#ifdef _WIN32
+      HANDLE file = CreateFileA (path.c_str (), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+      if (file == INVALID_HANDLE_VALUE)
+        return (false);
+
+      BY_HANDLE_FILE_INFORMATION info;
+      FILE_BASIC_INFO basic_info;
+      const bool ok = GetFileInformationByHandle (file, &info) != 0 &&
+                      GetFileInformationByHandleEx (file, FileBasicInfo, &basic_info, sizeof (basic_info)) != 0;
+      CloseHandle (file);
+      if (!ok)
+        return (false);
+
+      // FILETIME counts 100 ns intervals since 1601
+      const boost::int64_t epoch = 116444736000000000LL;
+      stamp.size = (static_cast<boost::uint64_t> (info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+      stamp.inode = (static_cast<boost::uint64_t> (info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+      stamp.mtime = (basic_info.LastWriteTime.QuadPart - epoch) * 100;
+      stamp.ctime = (basic_info.ChangeTime.QuadPart - epoch) * 100;
+#else
+      struct stat st;
+      if (::stat (path.c_str (), &st) != 0)
+        return (false);
+
+      stamp.size = static_cast<boost::uint64_t> (st.st_size);
+      stamp.inode = static_cast<boost::uint64_t> (st.st_ino);
+      stamp.mtime = static_cast<boost::int64_t> (st.st_mtime) * 1000000000 + PCL_STAT_MTIME_NSEC (st);
+      stamp.ctime = static_cast<boost::int64_t> (st.st_ctime) * 1000000000 + PCL_STAT_CTIME_NSEC (st);
+#endif
+      return (true);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool
+    hashFile (const std::string &path, boost::uint64_t &hash)
+    {
+      std::ifstream file (path.c_str (), std::ios::in | std::ios::binary);
+      if (!file)
+        return (false);
+
+      hash = 14695981039346656037ULL;
+      std::vector<char> block (1 << 16);
+      while (file)
+      {
+        file.read (&block[0], static_cast<std::streamsize> (block.size ()));
+        const std::streamsize count = file.gcount ();
+        for (std::streamsize i = 0; i < count; i++)
+        {
+          hash ^= static_cast<unsigned char> (block[i]);
+          hash *= 1099511628211ULL;
+        }
+      }
+      return (file.eof ());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    OutofcoreMappedFile::OutofcoreMappedFile ()
+      : map_ (NULL)
+      , size_ (0)
+#ifdef _WIN32
+      , file_mapping_ (NULL)
+#endif
+    {
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    OutofcoreMappedFile::~OutofcoreMappedFile ()
+    {
+      close ();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool
+    OutofcoreMappedFile::open (const std::string &path)
+    {
+      close ();
+
+      // The size is taken from the opened file, since the path may be replaced at any time
+#ifdef _WIN32
+      HANDLE file = CreateFileA (path.c_str (), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+      if (file == INVALID_HANDLE_VALUE)
+        return (false);
+
+      LARGE_INTEGER size;
+      if (GetFileSizeEx (file, &size) == 0 || size.QuadPart <= 0)
+      {
+        CloseHandle (file);
+        return (false);
+      }
+      const boost::uint64_t file_size = static_cast<boost::uint64_t> (size.QuadPart);
+
+      HANDLE file_mapping = CreateFileMapping (file, NULL, PAGE_READONLY, size.HighPart, size.LowPart, NULL);
+      // The mapping keeps its own reference to the file
+      CloseHandle (file);
+      if (file_mapping == NULL)
+        return (false);
+
+      map_ = static_cast<char*> (MapViewOfFile (file_mapping, FILE_MAP_READ, 0, 0, static_cast<SIZE_T> (file_size)));
+      if (map_ == NULL)
+      {
+        CloseHandle (file_mapping);
+        return (false);
+      }
+      file_mapping_ = file_mapping;
+#else
+      int fd = ::open (path.c_str (), O_RDONLY);
+      if (fd == -1)
+        return (false);
+
+      struct stat st;
+      if (fstat (fd, &st) != 0 || st.st_size <= 0)
+      {
+        ::close (fd);
+        return (false);
+      }
+      const boost::uint64_t file_size = static_cast<boost::uint64_t> (st.st_size);
+
+      void *map = mmap (0, static_cast<size_t> (file_size), PROT_READ, MAP_SHARED, fd, 0);
+      // The mapping stays valid after the descriptor is closed
+      ::close (fd);
+      if (map == MAP_FAILED)
+        return (false);
+
+      map_ = static_cast<char*> (map);
+#endif
+      size_ = static_cast<size_t> (file_size);
+      return (true);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void
+    OutofcoreMappedFile::close ()
+    {
+      if (map_ == NULL)
+        return;
+
+#ifdef _WIN32
+      UnmapViewOfFile (map_);
+      CloseHandle (static_cast<HANDLE> (file_mapping_));
+      file_mapping_ = NULL;
+#else
+      munmap (map_, size_);
+#endif
+      map_ = NULL;
+      size_ = 0;
+    }
+  }
+}
@@ -95,7 +95,8 @@ getCloudFromFile (boost::filesystem::path pcd_path)
 
 int
 outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesystem::path root_dir, 
-                  int depth, double resolution, int build_octree_with, bool gen_lod, bool overwrite, bool multiresolution)
+                  int depth, double resolution, int build_octree_with, bool gen_lod, bool overwrite, bool multiresolution,
+                  int threads)
 {
   // Bounding box min/max pts
   PointT min_pt, max_pt;
@@ -176,6 +177,8 @@ outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesys
     outofcore_octree = new octree_disk (bounding_box_min, bounding_box_max, resolution, octree_path_on_disk, "ECEF");
   }
 
+  outofcore_octree->setNumberOfThreads (static_cast<unsigned int> (std::max (threads, 0)));
+
   uint64_t total_pts = 0;
 
   // Iterate over all pcd files adding points to the octree
@@ -190,6 +193,10 @@ outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesys
     {
       print_info ("  Generating LODs\n");
       pts = outofcore_octree->addPointCloud_and_genLOD (cloud);
+
+      pcl::outofcore::OutofcoreProgress progress = outofcore_octree->getProgress ();
+      print_info ("  Wrote %lu points to %lu nodes in %g s (%g points/s)\n", progress.points_written, progress.nodes_written,
+                  progress.elapsed_seconds, progress.getThroughput ());
     }
     else
     {
@@ -218,6 +225,10 @@ outofcoreProcess (std::vector<boost::filesystem::path> pcd_paths, boost::filesys
     print_info ("Generating LOD...\n");
     outofcore_octree->setSamplePercent (0.25);
     outofcore_octree->buildLOD ();
+
+    pcl::outofcore::OutofcoreProgress progress = outofcore_octree->getProgress ();
+    print_info ("  Wrote %lu LOD points in %g s (%g points/s)\n", progress.points_written,
+                progress.elapsed_seconds, progress.getThroughput ());
   }
 
   //free outofcore data structure; the destructor forces buffer flush to disk
@@ -239,6 +250,7 @@ printHelp (int, char **argv)
   print_info ("\t -gen_lod                      \t Generate octree LODs\n");
   print_info ("\t -overwrite                    \t Overwrite existing octree\n");
   print_info ("\t -multiresolution              \t Generate multiresolutoin LOD\n");
+  print_info ("\t -threads <n>                  \t Number of writer threads for LOD generation (0: all cores)\n");
   print_info ("\t -h                            \t Display help\n");
   print_info ("\n");
 }
@@ -275,6 +287,7 @@ main (int argc, char* argv[])
   bool multiresolution = false;
   bool overwrite = false;
   int build_octree_with = OCTREE_DEPTH;
+  int threads = 1;
 
   // If both depth and resolution specified
   if (find_switch (argc, argv, "-depth") && find_switch (argc, argv, "-resolution"))
@@ -290,6 +303,7 @@ main (int argc, char* argv[])
   // Parse options
   parse_argument (argc, argv, "-depth", depth);
   parse_argument (argc, argv, "-resolution", resolution);
+  parse_argument (argc, argv, "-threads", threads);
   gen_lod = find_switch (argc, argv, "-gen_lod");
   overwrite = find_switch (argc, argv, "-overwrite");
 
@@ -329,5 +343,5 @@ main (int argc, char* argv[])
   if (root_dir.extension () == ".pcd")
     root_dir = root_dir.parent_path () / (root_dir.stem().string() + "_tree").c_str();
 
-  return outofcoreProcess (pcd_paths, root_dir, depth, resolution, build_octree_with, gen_lod, overwrite, multiresolution);
+  return outofcoreProcess (pcd_paths, root_dir, depth, resolution, build_octree_with, gen_lod, overwrite, multiresolution, threads);
 }
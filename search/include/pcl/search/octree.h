@@ -280,6 +280,83 @@ namespace pcl
           return (tree_->approxNearestSearch (query_index, result_index, sqr_distance));
         }
 
+        /** \brief Search for approximate k-nearest neighbors at the query point with a bounded error.
+          * \param[in] p_q the given query point
+          * \param[in] k the number of neighbors to search for
+          * \param[in] eps relative error bound; returned distances are within (1 + eps) of the exact ones (0: exact)
+          * \param[in] max_leaf_visits stop the search after this many leaf voxels were visited (0: disable)
+          * \param[out] k_indices the resultant indices of the neighboring points, sorted by distance
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        inline int
+        approxNearestKSearch (const PointT &p_q, int k, float eps, unsigned int max_leaf_visits,
+                              std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+        {
+          return (tree_->approxNearestKSearch (p_q, k, eps, max_leaf_visits, k_indices, k_sqr_distances));
+        }
+
+        /** \brief Search for approximate k-nearest neighbors at the query point with a bounded error.
+          * \param[in] index index representing the query point in the dataset given by \a setInputCloud.
+          *        If indices were given in setInputCloud, index will be the position in the indices vector.
+          * \param[in] k the number of neighbors to search for
+          * \param[in] eps relative error bound; returned distances are within (1 + eps) of the exact ones (0: exact)
+          * \param[in] max_leaf_visits stop the search after this many leaf voxels were visited (0: disable)
+          * \param[out] k_indices the resultant indices of the neighboring points, sorted by distance
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \return number of neighbors found
+          */
+        inline int
+        approxNearestKSearch (int index, int k, float eps, unsigned int max_leaf_visits,
+                              std::vector<int> &k_indices, std::vector<float> &k_sqr_distances) const
+        {
+          return (tree_->approxNearestKSearch (index, k, eps, max_leaf_visits, k_indices, k_sqr_distances));
+        }
+
+        /** \brief Search for neighbors of the query point within a given radius with a bounded error.
+          * All points closer than radius / (1 + eps) are found, none farther than \a radius is returned.
+          * \param[in] p_q the given query point
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[in] eps relative error bound (0: exact)
+          * \param[in] max_leaf_visits stop the search after this many leaf voxels were visited (0: disable)
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value
+          * \return number of neighbors found in radius
+          */
+        inline int
+        approxRadiusSearch (const PointT &p_q, double radius, float eps, unsigned int max_leaf_visits,
+                            std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+                            unsigned int max_nn = 0) const
+        {
+          tree_->approxRadiusSearch (p_q, radius, eps, max_leaf_visits, k_indices, k_sqr_distances, max_nn);
+          if (sorted_results_)
+            this->sortResults (k_indices, k_sqr_distances);
+          return (static_cast<int> (k_indices.size ()));
+        }
+
+        /** \brief Search for neighbors of the query point within a given radius with a bounded error.
+          * \param[in] index index representing the query point in the dataset given by \a setInputCloud.
+          *        If indices were given in setInputCloud, index will be the position in the indices vector.
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[in] eps relative error bound (0: exact)
+          * \param[in] max_leaf_visits stop the search after this many leaf voxels were visited (0: disable)
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] max_nn if given, bounds the maximum returned neighbors to this value
+          * \return number of neighbors found in radius
+          */
+        inline int
+        approxRadiusSearch (int index, double radius, float eps, unsigned int max_leaf_visits,
+                            std::vector<int> &k_indices, std::vector<float> &k_sqr_distances,
+                            unsigned int max_nn = 0) const
+        {
+          tree_->approxRadiusSearch (index, radius, eps, max_leaf_visits, k_indices, k_sqr_distances, max_nn);
+          if (sorted_results_)
+            this->sortResults (k_indices, k_sqr_distances);
+          return (static_cast<int> (k_indices.size ()));
+        }
+
     };
   }
 }
@@ -81,6 +81,59 @@ namespace pcl
       const boost::shared_ptr<search::Search<PointT> > &tree, float tolerance, std::vector<PointIndices> &clusters, 
       unsigned int min_pts_per_cluster = 1, unsigned int max_pts_per_cluster = (std::numeric_limits<int>::max) ());
 
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief Decompose a region of space into clusters based on the Euclidean distance between points, using several
+    * threads.
+    *
+    * The radius searches for all points in \a indices are run concurrently and the connectivity between points is
+    * merged into a shared union-find forest, instead of growing every cluster with a breadth-first search. The
+    * resultant clusters are identical (in content and in order) to the ones returned by the serial
+    * \ref extractEuclideanClusters over the same indices.
+    * \param cloud the point cloud message
+    * \param indices a list of point indices to use from \a cloud
+    * \param tree the spatial locator (e.g., kd-tree) used for nearest neighbors searching
+    * \note the tree has to be created as a spatial locator on \a cloud and \a indices, and its radiusSearch has to
+    * be safe to call from several threads at once (true for all the pcl::search implementations)
+    * \param tolerance the spatial cluster tolerance as a measure in L2 Euclidean space
+    * \param clusters the resultant clusters containing point indices (as a vector of PointIndices)
+    * \param min_pts_per_cluster minimum number of points that a cluster may contain (default: 1)
+    * \param max_pts_per_cluster maximum number of points that a cluster may contain (default: max int)
+    * \param nr_threads the number of threads to use (0 for automatic, default)
+    * \ingroup segmentation
+    */
+  template <typename PointT> void 
+  extractEuclideanClustersParallel (
+      const PointCloud<PointT> &cloud, const std::vector<int> &indices, 
+      const boost::shared_ptr<search::Search<PointT> > &tree, float tolerance, std::vector<PointIndices> &clusters, 
+      unsigned int min_pts_per_cluster = 1, unsigned int max_pts_per_cluster = (std::numeric_limits<int>::max) (),
+      unsigned int nr_threads = 0);
+
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief Decompose a region of space into clusters based on the Euclidean distance between points, using a voxel
+    * hash instead of a spatial locator.
+    *
+    * The points are binned into cubic cells whose diagonal is (slightly) shorter than \a tolerance, so that all the
+    * points falling into the same cell are connected without testing them. Connectivity between cells is found by
+    * looking up the fixed 5x5x5 stencil of neighboring cells and stopping at the first pair of points closer than
+    * \a tolerance. Cells are processed in parallel and merged into a union-find forest. The resultant clusters are
+    * the same as the ones returned by \ref extractEuclideanClusters with an exact radius search, in the same order.
+    * \param cloud the point cloud message
+    * \param indices a list of point indices to use from \a cloud
+    * \param tolerance the spatial cluster tolerance as a measure in L2 Euclidean space
+    * \param clusters the resultant clusters containing point indices (as a vector of PointIndices)
+    * \param min_pts_per_cluster minimum number of points that a cluster may contain (default: 1)
+    * \param max_pts_per_cluster maximum number of points that a cluster may contain (default: max int)
+    * \param nr_threads the number of threads to use (0 for automatic, default)
+    * \note points with non-finite coordinates are returned as clusters of their own
+    * \ingroup segmentation
+    */
+  template <typename PointT> void 
+  extractEuclideanClustersVoxelHash (
+      const PointCloud<PointT> &cloud, const std::vector<int> &indices, 
+      float tolerance, std::vector<PointIndices> &clusters, 
+      unsigned int min_pts_per_cluster = 1, unsigned int max_pts_per_cluster = (std::numeric_limits<int>::max) (),
+      unsigned int nr_threads = 0);
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   /** \brief Decompose a region of space into clusters based on the euclidean distance between points, and the normal
     * angular deviation
@@ -312,7 +365,9 @@ namespace pcl
       EuclideanClusterExtraction () : tree_ (), 
                                       cluster_tolerance_ (0),
                                       min_pts_per_cluster_ (1), 
-                                      max_pts_per_cluster_ (std::numeric_limits<int>::max ())
+                                      max_pts_per_cluster_ (std::numeric_limits<int>::max ()),
+                                      use_voxel_hash_ (false),
+                                      threads_ (1)
       {};
 
       /** \brief Provide a pointer to the search object.
@@ -381,6 +436,33 @@ namespace pcl
         return (max_pts_per_cluster_); 
       }
 
+      /** \brief Set whether the clusters should be computed with a voxel hash instead of the search object.
+        * \note When enabled, the search object set via setSearchMethod () is not used. See
+        * \ref extractEuclideanClustersVoxelHash for details.
+        * \param[in] use_voxel_hash true to enable the voxel hash (default: false)
+        */
+      inline void 
+      setUseVoxelHash (bool use_voxel_hash) 
+      { 
+        use_voxel_hash_ = use_voxel_hash; 
+      }
+
+      /** \brief Get whether the clusters are computed with a voxel hash instead of the search object. */
+      inline bool 
+      getUseVoxelHash () const 
+      { 
+        return (use_voxel_hash_); 
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
       /** \brief Cluster extraction in a PointCloud given by <setInputCloud (), setIndices ()>
         * \param[out] clusters the resultant point clusters
         */
@@ -406,6 +488,12 @@ namespace pcl
       /** \brief The maximum number of points that a cluster needs to contain in order to be considered valid (default = MAXINT). */
       int max_pts_per_cluster_;
 
+      /** \brief Whether the clusters are computed with a voxel hash instead of the search object (default = false). */
+      bool use_voxel_hash_;
+
+      /** \brief The number of threads the scheduler should use. The default is 1. */
+      unsigned int threads_;
+
       /** \brief Class getName method. */
       virtual std::string getClassName () const { return ("EuclideanClusterExtraction"); }
 
@@ -39,6 +39,101 @@
 #define PCL_SEGMENTATION_IMPL_EXTRACT_CLUSTERS_H_
 
 #include <pcl/segmentation/extract_clusters.h>
+#include <pcl/common/point_tests.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/common/atomic.h>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Find the root of \a x in a union-find forest that other threads may be linking concurrently. Roots are
+      * always linked to a smaller index, so every parent is smaller than or equal to its child and the walk ends.
+      */
+    inline int
+    unionFindRoot (std::vector<int> &parent, int x)
+    {
+      int p = parent[x];
+      while (p != x)
+      {
+        // Path halving: skip one level. The swap may fail if another thread got there first, which is harmless.
+        const int gp = parent[p];
+        if (gp != p)
+          compareAndSwap (&parent[x], p, gp);
+        x = gp;
+        p = parent[x];
+      }
+      return (x);
+    }
+
+    /** \brief Merge the sets of \a a and \a b in a union-find forest, lock-free. The larger root is linked to the
+      * smaller one, and only if it is still a root.
+      */
+    inline void
+    unionFindMerge (std::vector<int> &parent, int a, int b)
+    {
+      while (true)
+      {
+        a = unionFindRoot (parent, a);
+        b = unionFindRoot (parent, b);
+        if (a == b)
+          return;
+        if (a > b)
+          std::swap (a, b);
+        if (compareAndSwap (&parent[b], b, a))
+          return;
+      }
+    }
+
+    /** \brief Gather the connected components of a union-find forest into clusters, ordered by the position of their
+      * first point in \a indices, so that the result matches a breadth-first search seeded in that order.
+      * \param[in] indices the point indices, in seeding order
+      * \param[in] parent the union-find forest
+      * \param[in] node_of the union-find node of each entry of \a indices (-1 for a cluster on its own)
+      * \param[in] header the header to give to every cluster
+      * \param[in] min_pts_per_cluster minimum number of points that a cluster may contain
+      * \param[in] max_pts_per_cluster maximum number of points that a cluster may contain
+      * \param[out] clusters the resultant clusters (appended)
+      */
+    inline void
+    unionFindClusters (const std::vector<int> &indices, std::vector<int> &parent, const std::vector<int> &node_of,
+                       const pcl::PCLHeader &header, 
+                       unsigned int min_pts_per_cluster, unsigned int max_pts_per_cluster,
+                       std::vector<PointIndices> &clusters)
+    {
+      std::vector<int> label (parent.size (), -1);
+      std::vector<std::vector<int> > components;
+      for (size_t i = 0; i < indices.size (); ++i)
+      {
+        if (node_of[i] == -1)
+        {
+          components.push_back (std::vector<int> (1, indices[i]));
+          continue;
+        }
+        const int root = unionFindRoot (parent, node_of[i]);
+        if (label[root] == -1)
+        {
+          label[root] = static_cast<int> (components.size ());
+          components.push_back (std::vector<int> ());
+        }
+        components[label[root]].push_back (indices[i]);
+      }
+
+      for (size_t c = 0; c < components.size (); ++c)
+      {
+        std::vector<int> &component = components[c];
+        std::sort (component.begin (), component.end ());
+        component.erase (std::unique (component.begin (), component.end ()), component.end ());
+        if (component.size () < min_pts_per_cluster || component.size () > max_pts_per_cluster)
+          continue;
+
+        clusters.push_back (pcl::PointIndices ());
+        clusters.back ().indices.swap (component);
+        clusters.back ().header = header;
+      }
+    }
+  }
+}
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -202,6 +297,245 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::extractEuclideanClustersParallel (const PointCloud<PointT> &cloud, 
+                                       const std::vector<int> &indices,
+                                       const boost::shared_ptr<search::Search<PointT> > &tree,
+                                       float tolerance, std::vector<PointIndices> &clusters,
+                                       unsigned int min_pts_per_cluster, 
+                                       unsigned int max_pts_per_cluster,
+                                       unsigned int nr_threads)
+{
+  if (tree->getInputCloud ()->points.size () != cloud.points.size ())
+  {
+    PCL_ERROR ("[pcl::extractEuclideanClustersParallel] Tree built for a different point cloud dataset (%lu) than the input cloud (%lu)!\n", tree->getInputCloud ()->points.size (), cloud.points.size ());
+    return;
+  }
+  if (tree->getIndices ()->size () != indices.size ())
+  {
+    PCL_ERROR ("[pcl::extractEuclideanClustersParallel] Tree built for a different set of indices (%lu) than the input set (%lu)!\n", tree->getIndices ()->size (), indices.size ());
+    return;
+  }
+
+  // One union-find node per point of the cloud; neighbors are returned as cloud indices
+  std::vector<int> parent (cloud.points.size ());
+  for (size_t i = 0; i < parent.size (); ++i)
+    parent[i] = static_cast<int> (i);
+
+  bool failed = false;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nr_threads)
+#endif
+  {
+    std::vector<int> nn_indices;
+    std::vector<float> nn_distances;
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 256)
+#endif
+    for (int i = 0; i < static_cast<int> (indices.size ()); ++i)
+    {
+      // Skip the remaining points once a search failed; the flag is shared, so it is read atomically
+      // (OpenMP 2.0 has no atomic reads, a flush is the closest it offers)
+      bool stop;
+#if defined _OPENMP && _OPENMP >= 201107
+#pragma omp atomic read
+#elif defined _OPENMP
+#pragma omp flush (failed)
+#endif
+      stop = failed;
+      if (stop)
+        continue;
+
+      const int idx = indices[i];
+      // A non-finite query has no neighbors, the point ends up in a cluster of its own
+      if (!isFinite (cloud.points[idx]))
+        continue;
+
+      const int ret = tree->radiusSearch (cloud.points[idx], tolerance, nn_indices, nn_distances);
+      if (ret == -1)
+      {
+#if defined _OPENMP && _OPENMP >= 201107
+#pragma omp atomic write
+#endif
+        failed = true;
+#if defined _OPENMP && _OPENMP < 201107
+#pragma omp flush (failed)
+#endif
+        continue;
+      }
+
+      for (size_t j = 0; j < nn_indices.size (); ++j)
+      {
+        const int nn_idx = nn_indices[j];
+        if (nn_idx == -1 || nn_idx == idx)
+          continue;
+        detail::unionFindMerge (parent, idx, nn_idx);
+      }
+    }
+  }
+
+  if (failed)
+  {
+    PCL_ERROR ("[pcl::extractEuclideanClustersParallel] Received error code -1 from radiusSearch\n");
+    return;
+  }
+
+  detail::unionFindClusters (indices, parent, indices, cloud.header, min_pts_per_cluster, max_pts_per_cluster, clusters);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::extractEuclideanClustersVoxelHash (const PointCloud<PointT> &cloud, 
+                                        const std::vector<int> &indices,
+                                        float tolerance, std::vector<PointIndices> &clusters,
+                                        unsigned int min_pts_per_cluster, 
+                                        unsigned int max_pts_per_cluster,
+                                        unsigned int nr_threads)
+{
+  if (!(tolerance > 0))
+  {
+    PCL_ERROR ("[pcl::extractEuclideanClustersVoxelHash] Invalid cluster tolerance (%f)!\n", tolerance);
+    return;
+  }
+
+  // Bounding box of the finite points
+  Eigen::Array3f min_p = Eigen::Array3f::Constant (std::numeric_limits<float>::max ());
+  Eigen::Array3f max_p = Eigen::Array3f::Constant (-std::numeric_limits<float>::max ());
+  size_t nr_finite = 0;
+  for (size_t i = 0; i < indices.size (); ++i)
+  {
+    const PointT &pt = cloud.points[indices[i]];
+    if (!isFinite (pt))
+      continue;
+    min_p = min_p.min (pt.getArray3fMap ());
+    max_p = max_p.max (pt.getArray3fMap ());
+    ++nr_finite;
+  }
+  if (nr_finite == 0)
+    min_p = max_p = Eigen::Array3f::Zero ();
+
+  // The cell diagonal is kept just below the tolerance, so that all the points of a cell are connected to each other
+  // regardless of rounding. Cells more than 2 steps apart along any axis are then farther than the tolerance.
+  const float leaf_size = 0.999f * tolerance / std::sqrt (3.0f);
+  const float inverse_leaf_size = 1.0f / leaf_size;
+  const Eigen::Array3f extent = (max_p - min_p) * inverse_leaf_size;
+  // Every axis has to fit in an int, the whole grid in a 64 bit key
+  if (extent.maxCoeff () >= static_cast<float> (std::numeric_limits<int>::max () / 2) ||
+      static_cast<double> (extent[0] + 1) * static_cast<double> (extent[1] + 1) * static_cast<double> (extent[2] + 1) >
+      static_cast<double> (std::numeric_limits<int64_t>::max ()))
+  {
+    PCL_ERROR ("[pcl::extractEuclideanClustersVoxelHash] Cluster tolerance is too small for the input dataset. Integer indices would overflow.\n");
+    return;
+  }
+  const uint64_t dx = static_cast<uint64_t> (std::floor (extent[0])) + 1;
+  const uint64_t dy = static_cast<uint64_t> (std::floor (extent[1])) + 1;
+  const uint64_t dz = static_cast<uint64_t> (std::floor (extent[2])) + 1;
+  const uint64_t dxy = dx * dy;
+
+  // Sort the finite points by cell key, so that every cell is a contiguous range
+  std::vector<std::pair<uint64_t, int> > entries;
+  entries.reserve (nr_finite);
+  for (size_t i = 0; i < indices.size (); ++i)
+  {
+    const PointT &pt = cloud.points[indices[i]];
+    if (!isFinite (pt))
+      continue;
+    const Eigen::Array3f cell = ((pt.getArray3fMap () - min_p) * inverse_leaf_size).floor ();
+    const uint64_t key = std::min (static_cast<uint64_t> (cell[0]), dx - 1) + 
+                         std::min (static_cast<uint64_t> (cell[1]), dy - 1) * dx + 
+                         std::min (static_cast<uint64_t> (cell[2]), dz - 1) * dxy;
+    entries.push_back (std::make_pair (key, static_cast<int> (i)));
+  }
+  std::sort (entries.begin (), entries.end ());
+
+  std::vector<uint64_t> cell_keys;
+  std::vector<int> cell_start;
+  std::vector<int> node_of (indices.size (), -1);
+  for (size_t e = 0; e < entries.size (); ++e)
+  {
+    if (cell_keys.empty () || cell_keys.back () != entries[e].first)
+    {
+      cell_keys.push_back (entries[e].first);
+      cell_start.push_back (static_cast<int> (e));
+    }
+    node_of[entries[e].second] = static_cast<int> (cell_keys.size ()) - 1;
+  }
+  cell_start.push_back (static_cast<int> (entries.size ()));
+  const int nr_cells = static_cast<int> (cell_keys.size ());
+
+  // Copy the coordinates in cell order for a cache friendly pairwise test
+  std::vector<Eigen::Vector3f, Eigen::aligned_allocator<Eigen::Vector3f> > points (entries.size ());
+  for (size_t e = 0; e < entries.size (); ++e)
+    points[e] = cloud.points[indices[entries[e].second]].getVector3fMap ();
+
+  // One union-find node per cell
+  std::vector<int> parent (nr_cells);
+  for (int c = 0; c < nr_cells; ++c)
+    parent[c] = c;
+
+  const float sqr_tolerance = tolerance * tolerance;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nr_threads) schedule (dynamic, 64)
+#endif
+  for (int c = 0; c < nr_cells; ++c)
+  {
+    const uint64_t key = cell_keys[c];
+    const int cx = static_cast<int> (key % dx);
+    const int cy = static_cast<int> ((key / dx) % dy);
+    const int cz = static_cast<int> (key / dxy);
+
+    // Half of the 5x5x5 stencil: every pair of cells is visited once, from the one with the smaller key
+    for (int oz = 0; oz <= 2; ++oz)
+    {
+      if (cz + oz >= static_cast<int> (dz))
+        break;
+      for (int oy = (oz == 0 ? 0 : -2); oy <= 2; ++oy)
+      {
+        if (cy + oy < 0 || cy + oy >= static_cast<int> (dy))
+          continue;
+        const int ox_begin = (std::max) ((oz == 0 && oy == 0) ? 1 : -2, -cx);
+        const int ox_end = (std::min) (2, static_cast<int> (dx) - 1 - cx);
+        if (ox_begin > ox_end)
+          continue;
+
+        // The cells of one stencil row have consecutive keys: one lookup per row
+        const uint64_t row_key = static_cast<uint64_t> (cx + ox_begin) + 
+                                 static_cast<uint64_t> (cy + oy) * dx + static_cast<uint64_t> (cz + oz) * dxy;
+        std::vector<uint64_t>::const_iterator it = std::lower_bound (cell_keys.begin (), cell_keys.end (), row_key);
+        for (; it != cell_keys.end () && *it <= row_key + (ox_end - ox_begin); ++it)
+        {
+          const int n = static_cast<int> (it - cell_keys.begin ());
+          const int ox = ox_begin + static_cast<int> (*it - row_key);
+
+          // Skip the cells that cannot hold a point within the tolerance
+          const float gx = static_cast<float> ((std::max) (std::abs (ox) - 1, 0)) * leaf_size;
+          const float gy = static_cast<float> ((std::max) (std::abs (oy) - 1, 0)) * leaf_size;
+          const float gz = static_cast<float> ((std::max) (oz - 1, 0)) * leaf_size;
+          if (gx * gx + gy * gy + gz * gz > sqr_tolerance)
+            continue;
+          if (detail::unionFindRoot (parent, c) == detail::unionFindRoot (parent, n))
+            continue;
+
+          // A single pair of points within the tolerance connects the two cells
+          bool connected = false;
+          for (int a = cell_start[c]; a < cell_start[c + 1] && !connected; ++a)
+            for (int b = cell_start[n]; b < cell_start[n + 1]; ++b)
+              if ((points[a] - points[b]).squaredNorm () <= sqr_tolerance)
+              {
+                connected = true;
+                break;
+              }
+          if (connected)
+            detail::unionFindMerge (parent, c, n);
+        }
+      }
+    }
+  }
+
+  detail::unionFindClusters (indices, parent, node_of, cloud.header, min_pts_per_cluster, max_pts_per_cluster, clusters);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -217,6 +551,14 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
     return;
   }
 
+  if (use_voxel_hash_)
+  {
+    extractEuclideanClustersVoxelHash (*input_, *indices_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_, threads_);
+    std::sort (clusters.rbegin (), clusters.rend (), comparePointClusters);
+    deinitCompute ();
+    return;
+  }
+
   // Initialize the spatial locator
   if (!tree_)
   {
@@ -228,7 +570,10 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
 
   // Send the input dataset to the spatial locator
   tree_->setInputCloud (input_, indices_);
-  extractEuclideanClusters (*input_, *indices_, tree_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_);
+  if (threads_ == 1)
+    extractEuclideanClusters (*input_, *indices_, tree_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_);
+  else
+    extractEuclideanClustersParallel (*input_, *indices_, tree_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_, threads_);
 
   //tree_->setInputCloud (input_);
   //extractEuclideanClusters (*input_, tree_, cluster_tolerance_, clusters, min_pts_per_cluster_, max_pts_per_cluster_);
@@ -242,5 +587,7 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
 #define PCL_INSTANTIATE_EuclideanClusterExtraction(T) template class PCL_EXPORTS pcl::EuclideanClusterExtraction<T>;
 #define PCL_INSTANTIATE_extractEuclideanClusters(T) template void PCL_EXPORTS pcl::extractEuclideanClusters<T>(const pcl::PointCloud<T> &, const boost::shared_ptr<pcl::search::Search<T> > &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int);
 #define PCL_INSTANTIATE_extractEuclideanClusters_indices(T) template void PCL_EXPORTS pcl::extractEuclideanClusters<T>(const pcl::PointCloud<T> &, const std::vector<int> &, const boost::shared_ptr<pcl::search::Search<T> > &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int);
+#define PCL_INSTANTIATE_extractEuclideanClustersParallel(T) template void PCL_EXPORTS pcl::extractEuclideanClustersParallel<T>(const pcl::PointCloud<T> &, const std::vector<int> &, const boost::shared_ptr<pcl::search::Search<T> > &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int, unsigned int);
+#define PCL_INSTANTIATE_extractEuclideanClustersVoxelHash(T) template void PCL_EXPORTS pcl::extractEuclideanClustersVoxelHash<T>(const pcl::PointCloud<T> &, const std::vector<int> &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int, unsigned int);
 
 #endif        // PCL_EXTRACT_CLUSTERS_IMPL_H_
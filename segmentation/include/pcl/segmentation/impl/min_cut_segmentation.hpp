@@ -45,6 +45,11 @@
 #include <pcl/search/kdtree.h>
 #include <stdlib.h>
 #include <cmath>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT>
@@ -68,7 +73,11 @@ pcl::MinCutSegmentation<PointT>::MinCutSegmentation () :
   edge_marker_ (0),
   source_ (),/////////////////////////////////
   sink_ (),///////////////////////////////////
-  max_flow_ (0.0)
+  max_flow_ (0.0),
+  threads_ (1),
+  use_compact_graph_ (false),
+  compact_edges_ (),
+  compact_graph_ ()
 {
 }
 
@@ -231,6 +240,33 @@ pcl::MinCutSegmentation<PointT>::setBackgroundPoints (typename pcl::PointCloud<P
   unary_potentials_are_valid_ = false;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::MinCutSegmentation<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::MinCutSegmentation<PointT>::setUseCompactGraph (bool use_compact_graph)
+{
+  if (use_compact_graph_ != use_compact_graph)
+  {
+    use_compact_graph_ = use_compact_graph;
+    graph_is_valid_ = false;
+    unary_potentials_are_valid_ = false;
+    binary_potentials_are_valid_ = false;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::MinCutSegmentation<PointT>::getUseCompactGraph () const
+{
+  return (use_compact_graph_);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::MinCutSegmentation<PointT>::extract (std::vector <pcl::PointIndices>& clusters)
@@ -255,6 +291,37 @@ pcl::MinCutSegmentation<PointT>::extract (std::vector <pcl::PointIndices>& clust
   clusters_.clear ();
   bool success = true;
 
+  if (use_compact_graph_)
+  {
+    success = buildCompactGraph ();
+    if (success == false)
+    {
+      deinitCompute ();
+      return;
+    }
+    graph_is_valid_ = true;
+    unary_potentials_are_valid_ = true;
+    binary_potentials_are_valid_ = true;
+
+    max_flow_ = compact_graph_.solve ();
+
+    pcl::PointIndices segment;
+    clusters_.resize (2, segment);
+    for (size_t i_point = 0; i_point < indices_->size (); i_point++)
+    {
+      int point_index = (*indices_)[i_point];
+      if (compact_graph_.inSourceTree (point_index))
+        clusters_[1].indices.push_back (point_index);
+      else
+        clusters_[0].indices.push_back (point_index);
+    }
+
+    clusters.reserve (clusters_.size ());
+    std::copy (clusters_.begin (), clusters_.end (), std::back_inserter (clusters));
+    deinitCompute ();
+    return;
+  }
+
   if ( !graph_is_valid_ )
   {
     success = buildGraph ();
@@ -355,36 +422,161 @@ pcl::MinCutSegmentation<PointT>::buildGraph ()
   source_ = vertices_[number_of_points];
   sink_ = vertices_[number_of_points + 1];
 
+  // the potentials and the neighbourhoods are independent for every point, so they are computed in parallel
+  // into flat arrays first; the edges are then inserted in the order of the indices, which keeps the graph
+  // (and thus the cut) identical to the one built by a single thread
+  std::vector<double> source_weights (number_of_indices, 0.0);
+  std::vector<double> sink_weights (number_of_indices, 0.0);
+
+  search_->setInputCloud (input_, indices_);
+  const int nr_neighbours = static_cast<int> (number_of_neighbours_);
+  std::vector<int> slot_size (number_of_indices, 0);
+  std::vector<int> slot_neighbours (static_cast<size_t> (number_of_indices) * nr_neighbours);
+  std::vector<double> slot_weights (slot_neighbours.size ());
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
+  {
+    std::vector<int> neighbours;
+    std::vector<float> distances;
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 256)
+#endif
+    for (int i_point = 0; i_point < number_of_indices; i_point++)
+    {
+      int point_index = (*indices_)[i_point];
+      calculateUnaryPotential (point_index, source_weights[i_point], sink_weights[i_point]);
+
+      neighbours.clear ();
+      distances.clear ();
+      search_->nearestKSearch (i_point, number_of_neighbours_, neighbours, distances);
+      int size = std::min<int> (static_cast<int> (neighbours.size ()), nr_neighbours);
+      size_t slot = static_cast<size_t> (i_point) * nr_neighbours;
+      for (int i_nghbr = 1; i_nghbr < size; i_nghbr++)
+      {
+        slot_neighbours[slot + i_nghbr] = neighbours[i_nghbr];
+        slot_weights[slot + i_nghbr] = calculateBinaryPotential (point_index, neighbours[i_nghbr]);
+      }
+      slot_size[i_point] = size;
+    }
+  }
+
   for (int i_point = 0; i_point < number_of_indices; i_point++)
   {
     int point_index = (*indices_)[i_point];
-    double source_weight = 0.0;
-    double sink_weight = 0.0;
-    calculateUnaryPotential (point_index, source_weight, sink_weight);
-    addEdge (static_cast<int> (source_), point_index, source_weight);
-    addEdge (point_index, static_cast<int> (sink_), sink_weight);
+    addEdge (static_cast<int> (source_), point_index, source_weights[i_point]);
+    addEdge (point_index, static_cast<int> (sink_), sink_weights[i_point]);
   }
 
-  std::vector<int> neighbours;
-  std::vector<float> distances;
-  search_->setInputCloud (input_, indices_);
   for (int i_point = 0; i_point < number_of_indices; i_point++)
   {
     int point_index = (*indices_)[i_point];
-    search_->nearestKSearch (i_point, number_of_neighbours_, neighbours, distances);
-    for (size_t i_nghbr = 1; i_nghbr < neighbours.size (); i_nghbr++)
+    size_t slot = static_cast<size_t> (i_point) * nr_neighbours;
+    for (int i_nghbr = 1; i_nghbr < slot_size[i_point]; i_nghbr++)
     {
-      double weight = calculateBinaryPotential (point_index, neighbours[i_nghbr]);
-      addEdge (point_index, neighbours[i_nghbr], weight);
-      addEdge (neighbours[i_nghbr], point_index, weight);
+      int neighbour = slot_neighbours[slot + i_nghbr];
+      double weight = slot_weights[slot + i_nghbr];
+      addEdge (point_index, neighbour, weight);
+      addEdge (neighbour, point_index, weight);
     }
-    neighbours.clear ();
-    distances.clear ();
   }
 
   return (true);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::MinCutSegmentation<PointT>::buildCompactGraph ()
+{
+  int number_of_points = static_cast<int> (input_->points.size ());
+  int number_of_indices = static_cast<int> (indices_->size ());
+
+  if (input_->points.size () == 0 || number_of_points == 0 || foreground_points_.empty () == true )
+    return (false);
+
+  if (search_ == 0)
+    search_ = boost::shared_ptr<pcl::search::Search<PointT> > (new pcl::search::KdTree<PointT>);
+
+  // the boost graph is not kept next to the compact one
+  graph_.reset ();
+  capacity_.reset ();
+  reverse_edges_.reset ();
+  vertices_.clear ();
+  edge_marker_.clear ();
+
+  // the neighbourhoods only depend on the cloud and on the number of neighbours, so they are searched once and
+  // kept as a sorted list of unique pairs while only the potentials change
+  if (!graph_is_valid_)
+  {
+    search_->setInputCloud (input_, indices_);
+    const int nr_neighbours = static_cast<int> (number_of_neighbours_);
+    std::vector<int> slot_size (number_of_indices, 0);
+    std::vector<int> slot_neighbours (static_cast<size_t> (number_of_indices) * nr_neighbours);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
+    {
+      std::vector<int> neighbours;
+      std::vector<float> distances;
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 256)
+#endif
+      for (int i_point = 0; i_point < number_of_indices; i_point++)
+      {
+        neighbours.clear ();
+        distances.clear ();
+        search_->nearestKSearch (i_point, number_of_neighbours_, neighbours, distances);
+        int size = std::min<int> (static_cast<int> (neighbours.size ()), nr_neighbours);
+        size_t slot = static_cast<size_t> (i_point) * nr_neighbours;
+        for (int i_nghbr = 1; i_nghbr < size; i_nghbr++)
+          slot_neighbours[slot + i_nghbr] = neighbours[i_nghbr];
+        slot_size[i_point] = size;
+      }
+    }
+
+    compact_edges_.clear ();
+    compact_edges_.reserve (slot_neighbours.size ());
+    for (int i_point = 0; i_point < number_of_indices; i_point++)
+    {
+      int point_index = (*indices_)[i_point];
+      size_t slot = static_cast<size_t> (i_point) * nr_neighbours;
+      for (int i_nghbr = 1; i_nghbr < slot_size[i_point]; i_nghbr++)
+      {
+        int neighbour = slot_neighbours[slot + i_nghbr];
+        if (neighbour != point_index)
+          compact_edges_.push_back (std::make_pair (std::min (point_index, neighbour), std::max (point_index, neighbour)));
+      }
+    }
+    std::sort (compact_edges_.begin (), compact_edges_.end ());
+    compact_edges_.erase (std::unique (compact_edges_.begin (), compact_edges_.end ()), compact_edges_.end ());
+  }
+
+  std::vector<double> source_weights (number_of_points, 0.0);
+  std::vector<double> sink_weights (number_of_points, 0.0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (dynamic, 256)
+#endif
+  for (int i_point = 0; i_point < number_of_indices; i_point++)
+  {
+    int point_index = (*indices_)[i_point];
+    calculateUnaryPotential (point_index, source_weights[point_index], sink_weights[point_index]);
+  }
+
+  int number_of_edges = static_cast<int> (compact_edges_.size ());
+  std::vector<double> edge_weights (number_of_edges, 0.0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (dynamic, 256)
+#endif
+  for (int i_edge = 0; i_edge < number_of_edges; i_edge++)
+    edge_weights[i_edge] = calculateBinaryPotential (compact_edges_[i_edge].first, compact_edges_[i_edge].second);
+
+  compact_graph_.build (number_of_points, source_weights, sink_weights, compact_edges_, edge_weights);
+
+  return (true);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::MinCutSegmentation<PointT>::calculateUnaryPotential (int point, double& source_weight, double& sink_weight) const
@@ -490,48 +682,62 @@ pcl::MinCutSegmentation<PointT>::calculateBinaryPotential (int source, int targe
 template <typename PointT> bool
 pcl::MinCutSegmentation<PointT>::recalculateUnaryPotentials ()
 {
+  // only the capacities of the source and sink edges change, so the graph itself is kept; every point owns
+  // its pair of edges, which lets the potentials be written back in parallel
+  std::vector<EdgeDescriptor> source_edges;
+  source_edges.reserve (boost::out_degree (source_, *graph_));
   OutEdgeIterator src_edge_iter;
   OutEdgeIterator src_edge_end;
-  std::pair<EdgeDescriptor, bool> sink_edge;
-
   for (boost::tie (src_edge_iter, src_edge_end) = boost::out_edges (source_, *graph_); src_edge_iter != src_edge_end; src_edge_iter++)
+    source_edges.push_back (*src_edge_iter);
+
+  int number_of_edges = static_cast<int> (source_edges.size ());
+  bool success = true;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (dynamic, 256)
+#endif
+  for (int i_edge = 0; i_edge < number_of_edges; i_edge++)
   {
-    double source_weight = 0.0;
-    double sink_weight = 0.0;
-    sink_edge.second = false;
-    calculateUnaryPotential (static_cast<int> (boost::target (*src_edge_iter, *graph_)), source_weight, sink_weight);
-    sink_edge = boost::lookup_edge (boost::target (*src_edge_iter, *graph_), sink_, *graph_);
+    VertexDescriptor point_vertex = boost::target (source_edges[i_edge], *graph_);
+    std::pair<EdgeDescriptor, bool> sink_edge = boost::lookup_edge (point_vertex, sink_, *graph_);
     if (!sink_edge.second)
-      return (false);
+    {
+      success = false;
+      continue;
+    }
 
-    (*capacity_)[*src_edge_iter] = source_weight;
+    double source_weight = 0.0;
+    double sink_weight = 0.0;
+    calculateUnaryPotential (static_cast<int> (point_vertex), source_weight, sink_weight);
+    (*capacity_)[source_edges[i_edge]] = source_weight;
     (*capacity_)[sink_edge.first] = sink_weight;
   }
 
-  return (true);
+  return (success);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> bool
 pcl::MinCutSegmentation<PointT>::recalculateBinaryPotentials ()
 {
-  int number_of_points = static_cast<int> (indices_->size ());
+  int number_of_vertices = static_cast<int> (boost::num_vertices (*graph_));
 
-  VertexIterator vertex_iter;
-  VertexIterator vertex_end;
-  OutEdgeIterator edge_iter;
-  OutEdgeIterator edge_end;
+  // the new weights are gathered per vertex before any capacity is changed, because deciding which edges are
+  // the fictitious reverse ones reads the capacities of the edges owned by the neighbouring vertices
+  std::vector< std::vector<std::pair<EdgeDescriptor, double> > > new_weights (number_of_vertices);
 
-  std::vector< std::set<VertexDescriptor> > edge_marker;
-  std::set<VertexDescriptor> out_edges_marker;
-  edge_marker.clear ();
-  edge_marker.resize (number_of_points + 2, out_edges_marker);
-
-  for (boost::tie (vertex_iter, vertex_end) = boost::vertices (*graph_); vertex_iter != vertex_end; vertex_iter++)
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (dynamic, 256)
+#endif
+  for (int i_vertex = 0; i_vertex < number_of_vertices; i_vertex++)
   {
-    VertexDescriptor source_vertex = *vertex_iter;
+    VertexDescriptor source_vertex = boost::vertex (i_vertex, *graph_);
     if (source_vertex == source_ || source_vertex == sink_)
       continue;
+
+    std::set<VertexDescriptor> edge_marker;
+    OutEdgeIterator edge_iter;
+    OutEdgeIterator edge_end;
     for (boost::tie (edge_iter, edge_end) = boost::out_edges (source_vertex, *graph_); edge_iter != edge_end; edge_iter++)
     {
       //If this is not the edge of the graph, but the reverse fictitious edge that is needed for the algorithm then continue
@@ -541,20 +747,26 @@ pcl::MinCutSegmentation<PointT>::recalculateBinaryPotentials ()
 
       //If we already changed weight for this edge then continue
       VertexDescriptor target_vertex = boost::target (*edge_iter, *graph_);
-      std::set<VertexDescriptor>::iterator iter_out = edge_marker[static_cast<int> (source_vertex)].find (target_vertex);
-      if ( iter_out != edge_marker[static_cast<int> (source_vertex)].end () )
+      if (edge_marker.find (target_vertex) != edge_marker.end ())
         continue;
 
       if (target_vertex != source_ && target_vertex != sink_)
       {
         //Change weight and remember that this edges were updated
         double weight = calculateBinaryPotential (static_cast<int> (target_vertex), static_cast<int> (source_vertex));
-        (*capacity_)[*edge_iter] = weight;
-        edge_marker[static_cast<int> (source_vertex)].insert (target_vertex);
+        new_weights[i_vertex].push_back (std::make_pair (*edge_iter, weight));
+        edge_marker.insert (target_vertex);
       }
     }
   }
 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (dynamic, 256)
+#endif
+  for (int i_vertex = 0; i_vertex < number_of_vertices; i_vertex++)
+    for (size_t i_edge = 0; i_edge < new_weights[i_vertex].size (); i_edge++)
+      (*capacity_)[new_weights[i_vertex][i_edge].first] = new_weights[i_vertex][i_edge].second;
+
   return (true);
 }
 
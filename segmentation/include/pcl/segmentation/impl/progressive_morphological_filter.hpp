@@ -47,6 +47,10 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT>
 pcl::ProgressiveMorphologicalFilter<PointT>::ProgressiveMorphologicalFilter () :
@@ -56,7 +60,9 @@ pcl::ProgressiveMorphologicalFilter<PointT>::ProgressiveMorphologicalFilter () :
   initial_distance_ (0.15f),
   cell_size_ (1.0f),
   base_ (2.0f),
-  exponential_ (true)
+  exponential_ (true),
+  use_grid_ (false),
+  threads_ (1)
 {
 }
 
@@ -108,6 +114,13 @@ pcl::ProgressiveMorphologicalFilter<PointT>::extract (std::vector<int>& ground)
     iteration++;
   }
 
+  if (use_grid_)
+  {
+    extractFromGrid (window_sizes, height_thresholds, ground);
+    deinitCompute ();
+    return;
+  }
+
   // Ground indices are initially limited to those points in the input cloud we
   // wish to process
   ground = *indices_;
@@ -146,6 +159,134 @@ pcl::ProgressiveMorphologicalFilter<PointT>::extract (std::vector<int>& ground)
   deinitCompute ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::ProgressiveMorphologicalFilter<PointT>::extractFromGrid (const std::vector<float> &window_sizes,
+                                                              const std::vector<float> &height_thresholds,
+                                                              std::vector<int> &ground)
+{
+  // Ground indices are initially limited to the finite points in the input cloud
+  // we wish to process
+  ground.clear ();
+  ground.reserve (indices_->size ());
+  float min_x = std::numeric_limits<float>::max (), min_y = std::numeric_limits<float>::max ();
+  float max_x = -std::numeric_limits<float>::max (), max_y = -std::numeric_limits<float>::max ();
+  for (size_t i = 0; i < indices_->size (); ++i)
+  {
+    const PointT &p = input_->points[(*indices_)[i]];
+    if (!pcl::isFinite (p))
+      continue;
+    min_x = std::min (min_x, p.x);
+    min_y = std::min (min_y, p.y);
+    max_x = std::max (max_x, p.x);
+    max_y = std::max (max_y, p.y);
+    ground.push_back ((*indices_)[i]);
+  }
+  if (ground.empty ())
+    return;
+
+  // setup grid based on scale and extents
+  const double rows_d = std::floor ((max_y - min_y) / cell_size_) + 1.0;
+  const double cols_d = std::floor ((max_x - min_x) / cell_size_) + 1.0;
+  if (rows_d * cols_d > static_cast<double> (std::numeric_limits<int>::max ()))
+  {
+    PCL_ERROR ("[pcl::ProgressiveMorphologicalFilter::extract] Cell size %f is too small for the extent of the cloud!\n", cell_size_);
+    ground.clear ();
+    return;
+  }
+  const int rows = static_cast<int> (rows_d);
+  const int cols = static_cast<int> (cols_d);
+
+  Eigen::MatrixXf grid (rows, cols), grid_open (rows, cols);
+  std::vector<int> cells;
+  std::vector<char> keep;
+  // one grid of minimum elevations per extra thread, merged into grid after the binning
+  std::vector<std::vector<float> > thread_grids;
+  const int nr_cells = rows * cols;
+
+  // Progressively filter ground returns using morphological open
+  for (size_t i = 0; i < window_sizes.size (); ++i)
+  {
+    const int half_size = static_cast<int> ((window_sizes[i] / cell_size_ - 1.0f) / 2.0f + 0.5f);
+    PCL_DEBUG ("      Iteration %d (height threshold = %f, window size = %f, half size = %d)...",
+               i, height_thresholds[i], window_sizes[i], half_size);
+
+    // Bin the points currently considered ground returns into the grid of minimum elevations
+    const int nr_ground = static_cast<int> (ground.size ());
+    cells.resize (nr_ground);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads_)
+#endif
+    for (int p_idx = 0; p_idx < nr_ground; ++p_idx)
+    {
+      const PointT &p = input_->points[ground[p_idx]];
+      const int row = std::min (static_cast<int> ((p.y - min_y) / cell_size_), rows - 1);
+      const int col = std::min (static_cast<int> ((p.x - min_x) / cell_size_), cols - 1);
+      cells[p_idx] = col * rows + row;
+    }
+    grid.setConstant (std::numeric_limits<float>::quiet_NaN ());
+    float *grid_data = grid.data ();
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
+    {
+      float *thread_grid = grid_data;
+#ifdef _OPENMP
+#pragma omp single
+      thread_grids.resize (omp_get_num_threads () - 1);
+      const int thread_id = omp_get_thread_num ();
+      if (thread_id > 0)
+      {
+        thread_grids[thread_id - 1].assign (nr_cells, std::numeric_limits<float>::quiet_NaN ());
+        thread_grid = &thread_grids[thread_id - 1][0];
+      }
+#pragma omp for schedule(static)
+#endif
+      for (int p_idx = 0; p_idx < nr_ground; ++p_idx)
+      {
+        const float z = input_->points[ground[p_idx]].z;
+        if (!(thread_grid[cells[p_idx]] <= z))
+          thread_grid[cells[p_idx]] = z;
+      }
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+      for (int c_idx = 0; c_idx < nr_cells; ++c_idx)
+      {
+        for (size_t t_idx = 0; t_idx < thread_grids.size (); ++t_idx)
+        {
+          const float z = thread_grids[t_idx][c_idx];
+          if (!pcl_isnan (z) && !(grid_data[c_idx] <= z))
+            grid_data[c_idx] = z;
+        }
+      }
+    }
+
+    // Apply the morphological opening operation at the current window size.
+    pcl::applyMorphologicalOperator (grid, half_size, MORPH_OPEN, grid_open, threads_);
+
+    // Find indices of the points whose difference between the source and
+    // filtered elevations is less than the current height threshold.
+    keep.resize (nr_ground);
+    const float *grid_open_data = grid_open.data ();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads_)
+#endif
+    for (int p_idx = 0; p_idx < nr_ground; ++p_idx)
+      keep[p_idx] = (input_->points[ground[p_idx]].z - grid_open_data[cells[p_idx]]) < height_thresholds[i];
+
+    // Ground is now limited to these points
+    size_t nr_kept = 0;
+    for (int p_idx = 0; p_idx < nr_ground; ++p_idx)
+      if (keep[p_idx])
+        ground[nr_kept++] = ground[p_idx];
+    ground.resize (nr_kept);
+
+    PCL_DEBUG ("ground now has %d points\n", ground.size ());
+  }
+}
+
 #define PCL_INSTANTIATE_ProgressiveMorphologicalFilter(T) template class pcl::ProgressiveMorphologicalFilter<T>;
 
 #endif    // PCL_SEGMENTATION_PROGRESSIVE_MORPHOLOGICAL_FILTER_HPP_
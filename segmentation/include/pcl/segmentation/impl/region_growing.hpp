@@ -50,8 +50,13 @@
 #include <queue>
 #include <list>
 #include <cmath>
+#include <numeric>
 #include <time.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT>
 pcl::RegionGrowing<PointT, NormalT>::RegionGrowing () :
@@ -67,11 +72,13 @@ pcl::RegionGrowing<PointT, NormalT>::RegionGrowing () :
   search_ (),
   normals_ (),
   point_neighbours_ (0),
+  neighbour_offsets_ (0),
   point_labels_ (0),
   normal_flag_ (true),
   num_pts_in_segment_ (0),
   clusters_ (0),
-  number_of_segments_ (0)
+  number_of_segments_ (0),
+  threads_ (1)
 {
 }
 
@@ -85,6 +92,7 @@ pcl::RegionGrowing<PointT, NormalT>::~RegionGrowing ()
     normals_.reset ();
 
   point_neighbours_.clear ();
+  neighbour_offsets_.clear ();
   point_labels_.clear ();
   num_pts_in_segment_.clear ();
   clusters_.clear ();
@@ -239,6 +247,13 @@ pcl::RegionGrowing<PointT, NormalT>::setSearchMethod (const KdTreePtr& tree)
   search_ = tree;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT> typename pcl::RegionGrowing<PointT, NormalT>::NormalPtr
 pcl::RegionGrowing<PointT, NormalT>::getInputNormals () const
@@ -263,6 +278,7 @@ pcl::RegionGrowing<PointT, NormalT>::extract (std::vector <pcl::PointIndices>& c
   clusters_.clear ();
   clusters.clear ();
   point_neighbours_.clear ();
+  neighbour_offsets_.clear ();
   point_labels_.clear ();
   num_pts_in_segment_.clear ();
   number_of_segments_ = 0;
@@ -352,33 +368,68 @@ pcl::RegionGrowing<PointT, NormalT>::prepareForSegmentation ()
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowing<PointT, NormalT>::findPointNeighbours ()
+{
+  buildNeighbourGraph (neighbour_number_, !input_->is_dense, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::buildNeighbourGraph (unsigned int nr_neighbours, bool skip_non_finite, std::vector<float>* distances)
 {
   int point_number = static_cast<int> (indices_->size ());
-  std::vector<int> neighbours;
-  std::vector<float> distances;
 
-  point_neighbours_.resize (input_->points.size (), neighbours);
-  if (input_->is_dense)
+  // the searches write to a fixed size slot per point first, the slots are then packed in the order of
+  // the point indices
+  std::vector<int> slot_size (point_number, 0);
+  std::vector<int> slot_neighbours (static_cast<size_t> (point_number) * nr_neighbours);
+  std::vector<float> slot_distances (distances ? slot_neighbours.size () : 0);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
   {
+    std::vector<int> neighbours;
+    std::vector<float> dists;
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic, 256)
+#endif
     for (int i_point = 0; i_point < point_number; i_point++)
     {
       int point_index = (*indices_)[i_point];
+      if (skip_non_finite && !pcl::isFinite (input_->points[point_index]))
+        continue;
       neighbours.clear ();
-      search_->nearestKSearch (i_point, neighbour_number_, neighbours, distances);
-      point_neighbours_[point_index].swap (neighbours);
+      dists.clear ();
+      search_->nearestKSearch (i_point, nr_neighbours, neighbours, dists);
+
+      int size = std::min<int> (static_cast<int> (neighbours.size ()), nr_neighbours);
+      size_t slot = static_cast<size_t> (i_point) * nr_neighbours;
+      std::copy (neighbours.begin (), neighbours.begin () + size, slot_neighbours.begin () + slot);
+      if (distances)
+        std::copy (dists.begin (), dists.begin () + size, slot_distances.begin () + slot);
+      slot_size[i_point] = size;
     }
   }
-  else
+
+  neighbour_offsets_.assign (input_->points.size () + 1, 0);
+  for (int i_point = 0; i_point < point_number; i_point++)
+    neighbour_offsets_[(*indices_)[i_point] + 1] = slot_size[i_point];
+  std::partial_sum (neighbour_offsets_.begin (), neighbour_offsets_.end (), neighbour_offsets_.begin ());
+
+  point_neighbours_.resize (neighbour_offsets_.back ());
+  if (distances)
+    distances->resize (neighbour_offsets_.back ());
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (static)
+#endif
+  for (int i_point = 0; i_point < point_number; i_point++)
   {
-    for (int i_point = 0; i_point < point_number; i_point++)
-    {
-      neighbours.clear ();
-      int point_index = (*indices_)[i_point];
-      if (!pcl::isFinite (input_->points[point_index]))
-        continue;
-      search_->nearestKSearch (i_point, neighbour_number_, neighbours, distances);
-      point_neighbours_[point_index].swap (neighbours);
-    }
+    size_t slot = static_cast<size_t> (i_point) * nr_neighbours;
+    int offset = neighbour_offsets_[(*indices_)[i_point]];
+    std::copy (slot_neighbours.begin () + slot, slot_neighbours.begin () + slot + slot_size[i_point], point_neighbours_.begin () + offset);
+    if (distances)
+      std::copy (slot_distances.begin () + slot, slot_distances.begin () + slot + slot_size[i_point], distances->begin () + offset);
   }
 }
 
@@ -412,6 +463,16 @@ pcl::RegionGrowing<PointT, NormalT>::applySmoothRegionGrowingAlgorithm ()
       point_residual[i_point].second = point_index;
     }
   }
+
+#ifdef _OPENMP
+  int nr_threads = threads_ == 0 ? omp_get_max_threads () : static_cast<int> (threads_);
+  if (nr_threads > 1)
+  {
+    growRegionsConcurrently (point_residual, nr_threads);
+    return;
+  }
+#endif
+
   int seed_counter = 0;
   int seed = point_residual[seed_counter].second;
 
@@ -432,6 +493,7 @@ pcl::RegionGrowing<PointT, NormalT>::applySmoothRegionGrowingAlgorithm ()
       if (point_labels_[index] == -1)
       {
         seed = index;
+        seed_counter = i_seed;
         break;
       }
     }
@@ -454,10 +516,11 @@ pcl::RegionGrowing<PointT, NormalT>::growRegion (int initial_seed, int segment_n
     curr_seed = seeds.front ();
     seeds.pop ();
 
-    size_t i_nghbr = 0;
-    while ( i_nghbr < neighbour_number_ && i_nghbr < point_neighbours_[curr_seed].size () )
+    int i_nghbr = neighbour_offsets_[curr_seed];
+    int nghbr_end = std::min<int> (i_nghbr + neighbour_number_, neighbour_offsets_[curr_seed + 1]);
+    while ( i_nghbr < nghbr_end )
     {
-      int index = point_neighbours_[curr_seed][i_nghbr];
+      int index = point_neighbours_[i_nghbr];
       if (point_labels_[index] != -1)
       {
         i_nghbr++;
@@ -488,6 +551,126 @@ pcl::RegionGrowing<PointT, NormalT>::growRegion (int initial_seed, int segment_n
   return (num_pts_in_segment);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::growRegionsConcurrently (const std::vector< std::pair<float, int> >& point_residual, int nr_threads)
+{
+  int num_of_pts = static_cast<int> (point_residual.size ());
+  int number_of_points = static_cast<int> (input_->points.size ());
+  int max_candidates = 4 * nr_threads;
+
+  std::vector<int> candidate_rank (number_of_points, -1);
+  std::vector<int> candidates;
+  std::vector< std::vector<int> > regions (max_candidates);
+  std::vector<char> complete (max_candidates, 0);
+  std::vector< std::vector<int> > visited (nr_threads, std::vector<int> (number_of_points, -1));
+
+  int number_of_segments = 0;
+  int visit_mark = 0;
+  int seed_counter = 0;
+  while (true)
+  {
+    // the candidates are the next unlabeled points in the order of the seeds
+    while (seed_counter < num_of_pts && point_labels_[point_residual[seed_counter].second] != -1)
+      seed_counter++;
+    if (seed_counter == num_of_pts)
+      break;
+
+    candidates.clear ();
+    for (int i_seed = seed_counter; i_seed < num_of_pts && static_cast<int> (candidates.size ()) < max_candidates; i_seed++)
+    {
+      int index = point_residual[i_seed].second;
+      if (point_labels_[index] != -1 || candidate_rank[index] != -1)
+        continue;
+      candidate_rank[index] = static_cast<int> (candidates.size ());
+      candidates.push_back (index);
+    }
+    int number_of_candidates = static_cast<int> (candidates.size ());
+
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nr_threads) schedule (dynamic, 1)
+#endif
+    for (int i_cand = 0; i_cand < number_of_candidates; i_cand++)
+    {
+      int thread = 0;
+#ifdef _OPENMP
+      thread = omp_get_thread_num ();
+#endif
+      complete[i_cand] = growTentativeRegion (candidates[i_cand], i_cand, candidate_rank,
+                                              visited[thread], visit_mark + i_cand, regions[i_cand]);
+    }
+    visit_mark += number_of_candidates;
+
+    // commit the tentative segments in the order of their seeds. A seed that was taken by a segment
+    // committed before it is not a seed anymore; a segment that overlaps a segment committed before it
+    // has to be grown again, and so do the ones that follow it.
+    for (int i_cand = 0; i_cand < number_of_candidates; i_cand++)
+    {
+      if (point_labels_[candidates[i_cand]] != -1)
+        continue;
+      if (!complete[i_cand])
+        break;
+
+      const std::vector<int>& region = regions[i_cand];
+      bool overlaps = false;
+      for (size_t i_point = 0; i_point < region.size () && !overlaps; i_point++)
+        overlaps = (point_labels_[region[i_point]] != -1);
+      if (overlaps)
+        break;
+
+      for (size_t i_point = 0; i_point < region.size (); i_point++)
+        point_labels_[region[i_point]] = number_of_segments;
+      num_pts_in_segment_.push_back (static_cast<int> (region.size ()));
+      number_of_segments++;
+    }
+
+    for (int i_cand = 0; i_cand < number_of_candidates; i_cand++)
+      candidate_rank[candidates[i_cand]] = -1;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> bool
+pcl::RegionGrowing<PointT, NormalT>::growTentativeRegion (int initial_seed, int rank, const std::vector<int>& candidate_rank,
+                                                          std::vector<int>& visited, int visit_mark, std::vector<int>& region) const
+{
+  // same traversal as growRegion (), the points labeled by the concurrent segments are simply not seen
+  region.clear ();
+  region.push_back (initial_seed);
+  visited[initial_seed] = visit_mark;
+
+  std::queue<int> seeds;
+  seeds.push (initial_seed);
+  while (!seeds.empty ())
+  {
+    int curr_seed = seeds.front ();
+    seeds.pop ();
+
+    int nghbr_end = std::min<int> (neighbour_offsets_[curr_seed] + neighbour_number_, neighbour_offsets_[curr_seed + 1]);
+    for (int i_nghbr = neighbour_offsets_[curr_seed]; i_nghbr < nghbr_end; i_nghbr++)
+    {
+      int index = point_neighbours_[i_nghbr];
+      if (point_labels_[index] != -1 || visited[index] == visit_mark)
+        continue;
+
+      bool is_a_seed = false;
+      if (!validatePoint (initial_seed, curr_seed, index, is_a_seed))
+        continue;
+
+      // the seed of a segment committed before this one is always part of it
+      if (candidate_rank[index] != -1 && candidate_rank[index] < rank)
+        return (false);
+
+      visited[index] = visit_mark;
+      region.push_back (index);
+      if (is_a_seed)
+        seeds.push (index);
+    }
+  }
+
+  return (true);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT> bool
 pcl::RegionGrowing<PointT, NormalT>::validatePoint (int initial_seed, int point, int nghbr, bool& is_a_seed) const
@@ -602,6 +785,7 @@ pcl::RegionGrowing<PointT, NormalT>::getSegmentFromPoint (int index, pcl::PointI
     if (clusters_.empty ())
     {
       point_neighbours_.clear ();
+      neighbour_offsets_.clear ();
       point_labels_.clear ();
       num_pts_in_segment_.clear ();
       number_of_segments_ = 0;
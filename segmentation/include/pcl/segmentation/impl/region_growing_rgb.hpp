@@ -165,6 +165,7 @@ pcl::RegionGrowingRGB<PointT, NormalT>::extract (std::vector <pcl::PointIndices>
   clusters_.clear ();
   clusters.clear ();
   point_neighbours_.clear ();
+  neighbour_offsets_.clear ();
   point_labels_.clear ();
   num_pts_in_segment_.clear ();
   point_distances_.clear ();
@@ -271,22 +272,7 @@ pcl::RegionGrowingRGB<PointT, NormalT>::prepareForSegmentation ()
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowingRGB<PointT, NormalT>::findPointNeighbours ()
 {
-  int point_number = static_cast<int> (indices_->size ());
-  std::vector<int> neighbours;
-  std::vector<float> distances;
-
-  point_neighbours_.resize (input_->points.size (), neighbours);
-  point_distances_.resize (input_->points.size (), distances);
-
-  for (int i_point = 0; i_point < point_number; i_point++)
-  {
-    int point_index = (*indices_)[i_point];
-    neighbours.clear ();
-    distances.clear ();
-    search_->nearestKSearch (i_point, region_neighbour_number_, neighbours, distances);
-    point_neighbours_[point_index].swap (neighbours);
-    point_distances_[point_index].swap (distances);
-  }
+  buildNeighbourGraph (region_neighbour_number_, false, &point_distances_);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -298,14 +284,11 @@ pcl::RegionGrowingRGB<PointT, NormalT>::findSegmentNeighbours ()
   segment_neighbours_.resize (number_of_segments_, neighbours);
   segment_distances_.resize (number_of_segments_, distances);
 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(threads_) schedule (dynamic, 16)
+#endif
   for (int i_seg = 0; i_seg < number_of_segments_; i_seg++)
-  {
-    std::vector<int> nghbrs;
-    std::vector<float> dist;
-    findRegionsKNN (i_seg, region_neighbour_number_, nghbrs, dist);
-    segment_neighbours_[i_seg].swap (nghbrs);
-    segment_distances_[i_seg].swap (dist);
-  }
+    findRegionsKNN (i_seg, region_neighbour_number_, segment_neighbours_[i_seg], segment_distances_[i_seg]);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -315,33 +298,37 @@ pcl::RegionGrowingRGB<PointT, NormalT>::findRegionsKNN (int index, int nghbr_num
   std::vector<float> distances;
   float max_dist = std::numeric_limits<float>::max ();
   distances.resize (clusters_.size (), max_dist);
+  std::vector<int> touched_segments;
 
   int number_of_points = num_pts_in_segment_[index];
   //loop throug every point in this segment and check neighbours
   for (int i_point = 0; i_point < number_of_points; i_point++)
   {
     int point_index = clusters_[index].indices[i_point];
-    int number_of_neighbours = static_cast<int> (point_neighbours_[point_index].size ());
     //loop throug every neighbour of the current point, find out to which segment it belongs
     //and if it belongs to neighbouring segment and is close enough then remember segment and its distance
-    for (int i_nghbr = 0; i_nghbr < number_of_neighbours; i_nghbr++)
+    for (int i_nghbr = neighbour_offsets_[point_index]; i_nghbr < neighbour_offsets_[point_index + 1]; i_nghbr++)
     {
       // find segment
       int segment_index = -1;
-      segment_index = point_labels_[ point_neighbours_[point_index][i_nghbr] ];
+      segment_index = point_labels_[ point_neighbours_[i_nghbr] ];
 
       if ( segment_index != index )
       {
+        if (distances[segment_index] == max_dist)
+          touched_segments.push_back (segment_index);
         // try to push it to the queue
-        if (distances[segment_index] > point_distances_[point_index][i_nghbr])
-          distances[segment_index] = point_distances_[point_index][i_nghbr];
+        if (distances[segment_index] > point_distances_[i_nghbr])
+          distances[segment_index] = point_distances_[i_nghbr];
       }
     }
   }// next point
 
+  // only the segments that were met are candidates, the order in which they are pushed does not matter
   std::priority_queue<std::pair<float, int> > segment_neighbours;
-  for (int i_seg = 0; i_seg < number_of_segments_; i_seg++)
+  for (size_t i_touched = 0; i_touched < touched_segments.size (); i_touched++)
   {
+    int i_seg = touched_segments[i_touched];
     if (distances[i_seg] < max_dist)
     {
       segment_neighbours.push (std::make_pair (distances[i_seg], i_seg) );
@@ -715,6 +702,7 @@ pcl::RegionGrowingRGB<PointT, NormalT>::getSegmentFromPoint (int index, pcl::Poi
     {
       clusters_.clear ();
       point_neighbours_.clear ();
+      neighbour_offsets_.clear ();
       point_labels_.clear ();
       num_pts_in_segment_.clear ();
       point_distances_.clear ();
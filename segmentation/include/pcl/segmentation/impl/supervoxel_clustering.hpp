@@ -51,7 +51,10 @@ pcl::SupervoxelClustering<PointT>::SupervoxelClustering (float voxel_resolution,
   voxel_centroid_cloud_ (),
   color_importance_ (0.1f),
   spatial_importance_ (0.4f),
-  normal_importance_ (1.0f)
+  normal_importance_ (1.0f),
+  use_single_camera_transform_ (use_single_camera_transform),
+  incremental_ (false),
+  threads_ (1)
 {
   adjacency_octree_.reset (new OctreeAdjacencyT (resolution_));
   if (use_single_camera_transform)
@@ -106,6 +109,21 @@ pcl::SupervoxelClustering<PointT>::extract (std::map<uint32_t,typename Supervoxe
     return;
   }
   
+  //Keep the supervoxels of the previous frame before its octree is replaced
+  typename PointCloudT::Ptr previous_voxels;
+  std::vector<uint32_t> previous_labels;
+  if (incremental_ && !supervoxel_helpers_.empty ())
+  {
+    previous_voxels.reset (new PointCloudT);
+    for (typename HelperListT::const_iterator sv_itr = supervoxel_helpers_.cbegin (); sv_itr != supervoxel_helpers_.cend (); ++sv_itr)
+    {
+      typename PointCloudT::Ptr voxels;
+      sv_itr->getVoxels (voxels);
+      *previous_voxels += *voxels;
+      previous_labels.resize (previous_voxels->size (), sv_itr->getLabel ());
+    }
+  }
+
   //std::cout << "Preparing for segmentation \n";
   segmentation_is_possible = prepareForSegmentation ();
   if ( !segmentation_is_possible )
@@ -115,11 +133,18 @@ pcl::SupervoxelClustering<PointT>::extract (std::map<uint32_t,typename Supervoxe
   }
   
   //double t_prep = timer_.getTime ();
-  //std::cout << "Placing Seeds" << std::endl;
-  std::vector<int> seed_indices;
-  selectInitialSupervoxelSeeds (seed_indices);
-  //std::cout << "Creating helpers "<<std::endl;
-  createSupervoxelHelpers (seed_indices);
+  if (previous_voxels && !previous_voxels->empty ())
+  {
+    createSupervoxelHelpers (previous_voxels, previous_labels);
+  }
+  else
+  {
+    //std::cout << "Placing Seeds" << std::endl;
+    std::vector<int> seed_indices;
+    selectInitialSupervoxelSeeds (seed_indices);
+    //std::cout << "Creating helpers "<<std::endl;
+    createSupervoxelHelpers (seed_indices);
+  }
   //double t_seeds = timer_.getTime ();
   
   
@@ -157,10 +182,17 @@ pcl::SupervoxelClustering<PointT>::refineSupervoxels (int num_itr, std::map<uint
   int max_depth = static_cast<int> (1.8f*seed_resolution_/resolution_);
   for (int i = 0; i < num_itr; ++i)
   {
+    //Every supervoxel only changes the normals of its own voxels
+    std::vector<SupervoxelHelper*> helpers;
+    helpers.reserve (supervoxel_helpers_.size ());
     for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
-    {
-      sv_itr->refineNormals ();
-    }
+      helpers.push_back (&(*sv_itr));
+    const int nr_helpers = static_cast<int> (helpers.size ());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 4) num_threads(threads_)
+#endif
+    for (int h = 0; h < nr_helpers; ++h)
+      helpers[h]->refineNormals ();
     
     reseedSupervoxels ();
     expandSupervoxels (max_depth);
@@ -185,6 +217,18 @@ pcl::SupervoxelClustering<PointT>::prepareForSegmentation ()
   if ( input_->points.size () == 0 )
     return (false);
   
+  //A previous cloud was already added, start over with an empty octree
+  if (adjacency_octree_->getLeafCount () > 0)
+  {
+    supervoxel_helpers_.clear ();
+    adjacency_octree_.reset (new OctreeAdjacencyT (resolution_));
+    if (use_single_camera_transform_)
+      adjacency_octree_->setTransformFunction (boost::bind (&SupervoxelClustering::transformFunction, this, _1));
+    adjacency_octree_->setInputCloud (input_);
+  }
+  voxel_kdtree_.reset ();
+  adjacency_octree_->setNumberOfThreads (threads_);
+  
   //Add the new cloud of data to the octree
   //std::cout << "Populating adjacency octree with new cloud \n";
   //double prep_start = timer_.getTime ();
@@ -206,13 +250,15 @@ pcl::SupervoxelClustering<PointT>::computeVoxelData ()
 {
   voxel_centroid_cloud_.reset (new PointCloudT);
   voxel_centroid_cloud_->resize (adjacency_octree_->getLeafCount ());
-  typename LeafVectorT::iterator leaf_itr = adjacency_octree_->begin ();
-  typename PointCloudT::iterator cent_cloud_itr = voxel_centroid_cloud_->begin ();
-  for (int idx = 0 ; leaf_itr != adjacency_octree_->end (); ++leaf_itr, ++cent_cloud_itr, ++idx)
+  const int nr_leaves = static_cast<int> (adjacency_octree_->size ());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads_)
+#endif
+  for (int idx = 0; idx < nr_leaves; ++idx)
   {
-    VoxelData& new_voxel_data = (*leaf_itr)->getData ();
+    VoxelData& new_voxel_data = adjacency_octree_->at (idx)->getData ();
     //Add the point to the centroid cloud
-    new_voxel_data.getPoint (*cent_cloud_itr);
+    new_voxel_data.getPoint (voxel_centroid_cloud_->points[idx]);
     //voxel_centroid_cloud_->push_back(new_voxel_data.getPoint ());
     new_voxel_data.idx_ = idx;
   }
@@ -223,62 +269,85 @@ pcl::SupervoxelClustering<PointT>::computeVoxelData ()
     //Verify that input normal cloud size is same as input cloud size
     assert (input_normals_->size () == input_->size ());
     //For every point in the input cloud, find its corresponding leaf
-    typename NormalCloudT::const_iterator normal_itr = input_normals_->begin ();
-    for (typename PointCloudT::const_iterator input_itr = input_->begin (); input_itr != input_->end (); ++input_itr, ++normal_itr)
+    const int nr_points = static_cast<int> (input_->size ());
+    std::vector<LeafContainerT*> point_leaves (nr_points, static_cast<LeafContainerT*> (0));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads_)
+#endif
+    for (int i = 0; i < nr_points; ++i)
     {
       //If the point is not finite we ignore it
-      if ( !pcl::isFinite<PointT> (*input_itr))
+      if ( !pcl::isFinite<PointT> (input_->points[i]))
         continue;
       //Otherwise look up its leaf container
-        LeafContainerT* leaf = adjacency_octree_->getLeafContainerAtPoint (*input_itr);
-        
-        //Get the voxel data object
-        VoxelData& voxel_data = leaf->getData ();
-        //Add this normal in (we will normalize at the end)
-        voxel_data.normal_ += normal_itr->getNormalVector4fMap ();
-        voxel_data.curvature_ += normal_itr->curvature;
+      point_leaves[i] = adjacency_octree_->getLeafContainerAtPoint (input_->points[i]);
+    }
+    //Sum up the normals in cloud order, several points share a leaf
+    for (int i = 0; i < nr_points; ++i)
+    {
+      if (!point_leaves[i])
+        continue;
+      //Get the voxel data object
+      VoxelData& voxel_data = point_leaves[i]->getData ();
+      //Add this normal in (we will normalize at the end)
+      voxel_data.normal_ += input_normals_->points[i].getNormalVector4fMap ();
+      voxel_data.curvature_ += input_normals_->points[i].curvature;
     }
     //Now iterate through the leaves and normalize 
-    for (leaf_itr = adjacency_octree_->begin (); leaf_itr != adjacency_octree_->end (); ++leaf_itr)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads_)
+#endif
+    for (int idx = 0; idx < nr_leaves; ++idx)
     {
-      VoxelData& voxel_data = (*leaf_itr)->getData ();
+      LeafContainerT* leaf = adjacency_octree_->at (idx);
+      VoxelData& voxel_data = leaf->getData ();
       voxel_data.normal_.normalize ();
       voxel_data.owner_ = 0;
       voxel_data.distance_ = std::numeric_limits<float>::max ();
       //Get the number of points in this leaf
-      int num_points = (*leaf_itr)->getPointCounter ();
+      int num_points = leaf->getPointCounter ();
       voxel_data.curvature_ /= num_points;
     }
   }
   else //Otherwise just compute the normals
   {
-    for (leaf_itr = adjacency_octree_->begin (); leaf_itr != adjacency_octree_->end (); ++leaf_itr)
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
     {
-      VoxelData& new_voxel_data = (*leaf_itr)->getData ();
       //For every point, get its neighbors, build an index vector, compute normal
       std::vector<int> indices;
       indices.reserve (81); 
-      //Push this point
-      indices.push_back (new_voxel_data.idx_);
-      for (typename LeafContainerT::const_iterator neighb_itr=(*leaf_itr)->cbegin (); neighb_itr!=(*leaf_itr)->cend (); ++neighb_itr)
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+      for (int idx = 0; idx < nr_leaves; ++idx)
       {
-        VoxelData& neighb_voxel_data = (*neighb_itr)->getData ();
-        //Push neighbor index
-        indices.push_back (neighb_voxel_data.idx_);
-        //Get neighbors neighbors, push onto cloud
-        for (typename LeafContainerT::const_iterator neighb_neighb_itr=(*neighb_itr)->cbegin (); neighb_neighb_itr!=(*neighb_itr)->cend (); ++neighb_neighb_itr)
+        LeafContainerT* leaf = adjacency_octree_->at (idx);
+        VoxelData& new_voxel_data = leaf->getData ();
+        indices.clear ();
+        //Push this point
+        indices.push_back (new_voxel_data.idx_);
+        for (typename LeafContainerT::const_iterator neighb_itr=leaf->cbegin (); neighb_itr!=leaf->cend (); ++neighb_itr)
         {
-          VoxelData& neighb2_voxel_data = (*neighb_neighb_itr)->getData ();
-          indices.push_back (neighb2_voxel_data.idx_);
+          VoxelData& neighb_voxel_data = (*neighb_itr)->getData ();
+          //Push neighbor index
+          indices.push_back (neighb_voxel_data.idx_);
+          //Get neighbors neighbors, push onto cloud
+          for (typename LeafContainerT::const_iterator neighb_neighb_itr=(*neighb_itr)->cbegin (); neighb_neighb_itr!=(*neighb_itr)->cend (); ++neighb_neighb_itr)
+          {
+            VoxelData& neighb2_voxel_data = (*neighb_neighb_itr)->getData ();
+            indices.push_back (neighb2_voxel_data.idx_);
+          }
         }
+        //Compute normal
+        pcl::computePointNormal (*voxel_centroid_cloud_, indices, new_voxel_data.normal_, new_voxel_data.curvature_);
+        pcl::flipNormalTowardsViewpoint (voxel_centroid_cloud_->points[new_voxel_data.idx_], 0.0f,0.0f,0.0f, new_voxel_data.normal_);
+        new_voxel_data.normal_[3] = 0.0f;
+        new_voxel_data.normal_.normalize ();
+        new_voxel_data.owner_ = 0;
+        new_voxel_data.distance_ = std::numeric_limits<float>::max ();
       }
-      //Compute normal
-      pcl::computePointNormal (*voxel_centroid_cloud_, indices, new_voxel_data.normal_, new_voxel_data.curvature_);
-      pcl::flipNormalTowardsViewpoint (voxel_centroid_cloud_->points[new_voxel_data.idx_], 0.0f,0.0f,0.0f, new_voxel_data.normal_);
-      new_voxel_data.normal_[3] = 0.0f;
-      new_voxel_data.normal_.normalize ();
-      new_voxel_data.owner_ = 0;
-      new_voxel_data.distance_ = std::numeric_limits<float>::max ();
     }
   }
   
@@ -294,12 +363,22 @@ pcl::SupervoxelClustering<PointT>::expandSupervoxels ( int depth )
   for (int i = 1; i < depth; ++i)
   {
       //Expand the the supervoxels by one iteration
-      for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+      size_t nr_changed = 0;
+      if (threads_ == 1)
       {
-        sv_itr->expand ();
+        for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+        {
+          nr_changed += sv_itr->expand ();
+        }
+      }
+      else
+      {
+        nr_changed = expandSupervoxelsConcurrently ();
       }
       
-      //Update the centers to reflect new centers
+      //Remove the empty supervoxels
+      std::vector<SupervoxelHelper*> helpers;
+      helpers.reserve (supervoxel_helpers_.size ());
       for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); )
       {
         if (sv_itr->size () == 0)
@@ -308,15 +387,72 @@ pcl::SupervoxelClustering<PointT>::expandSupervoxels ( int depth )
         }
         else
         {
-          sv_itr->updateCentroid ();
+          helpers.push_back (&(*sv_itr));
           ++sv_itr;
         } 
       }
 
+      //Update the centers to reflect new centers
+      const int nr_helpers = static_cast<int> (helpers.size ());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads_)
+#endif
+      for (int h = 0; h < nr_helpers; ++h)
+        helpers[h]->updateCentroid ();
+
+      //Neither the owners nor the centers changed, so no further iteration would change anything
+      if (nr_changed == 0)
+        break;
   }
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> size_t
+pcl::SupervoxelClustering<PointT>::expandSupervoxelsConcurrently ()
+{
+  std::vector<SupervoxelHelper*> helpers;
+  helpers.reserve (supervoxel_helpers_.size ());
+  for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+    helpers.push_back (&(*sv_itr));
+  const int nr_helpers = static_cast<int> (helpers.size ());
+  const size_t nr_voxels = adjacency_octree_->size ();
+
+  //Distances only decrease during an iteration, so the claims made against the state at its start
+  //contain every voxel the serial expansion would hand to the supervoxel
+  std::vector<typename SupervoxelHelper::ClaimVectorT> claims (nr_helpers);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
+  {
+    std::vector<unsigned int> visited (nr_voxels, 0);
+    unsigned int mark = 0;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 4)
+#endif
+    for (int h = 0; h < nr_helpers; ++h)
+      helpers[h]->findExpansion (claims[h], visited, ++mark);
+  }
+
+  //Hand the voxels over in list order. A supervoxel which lost voxels earlier in this iteration
+  //has a different set of neighbors than it had at the start, so it claims again
+  std::set<SupervoxelHelper*> robbed;
+  std::vector<unsigned int> visited;
+  unsigned int mark = 0;
+  size_t nr_changed = 0;
+  for (int h = 0; h < nr_helpers; ++h)
+  {
+    if (robbed.find (helpers[h]) != robbed.end ())
+    {
+      if (visited.empty ())
+        visited.resize (nr_voxels, 0);
+      helpers[h]->findExpansion (claims[h], visited, ++mark);
+    }
+    nr_changed += helpers[h]->applyExpansion (claims[h], robbed);
+  }
+  return (nr_changed);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SupervoxelClustering<PointT>::makeSupervoxels (std::map<uint32_t,typename Supervoxel<PointT>::Ptr > &supervoxel_clusters)
@@ -357,6 +493,92 @@ pcl::SupervoxelClustering<PointT>::createSupervoxelHelpers (std::vector<int> &se
   }
   
 }
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::createSupervoxelHelpers (const typename PointCloudT::ConstPtr &previous_voxels,
+                                                            const std::vector<uint32_t> &previous_labels)
+{
+  supervoxel_helpers_.clear ();
+  
+  //Find the supervoxel of the closest voxel of the previous frame for every voxel
+  KdTreeT previous_kdtree;
+  previous_kdtree.setInputCloud (previous_voxels);
+  const int nr_voxels = static_cast<int> (voxel_centroid_cloud_->size ());
+  const float max_sqr_distance = resolution_ * resolution_;
+  std::vector<uint32_t> voxel_labels (nr_voxels, 0);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
+  {
+    std::vector<int> closest_index (1);
+    std::vector<float> distance (1);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+    for (int i = 0; i < nr_voxels; ++i)
+    {
+      if (previous_kdtree.nearestKSearch (voxel_centroid_cloud_->points[i], 1, closest_index, distance) > 0 &&
+          distance[0] <= max_sqr_distance)
+        voxel_labels[i] = previous_labels[closest_index[0]];
+    }
+  }
+  
+  //Supervoxels which still have voxels keep their label, in increasing label order
+  std::map<uint32_t, SupervoxelHelper*> label_helpers;
+  for (int i = 0; i < nr_voxels; ++i)
+    if (voxel_labels[i] != 0)
+      label_helpers[voxel_labels[i]] = 0;
+  uint32_t max_label = 0;
+  for (typename std::map<uint32_t, SupervoxelHelper*>::iterator label_itr = label_helpers.begin (); label_itr != label_helpers.end (); ++label_itr)
+  {
+    supervoxel_helpers_.push_back (new SupervoxelHelper (label_itr->first, this));
+    label_itr->second = &supervoxel_helpers_.back ();
+    max_label = label_itr->first;
+  }
+  for (int i = 0; i < nr_voxels; ++i)
+    if (voxel_labels[i] != 0)
+      label_helpers[voxel_labels[i]]->addLeaf (adjacency_octree_->at (i));
+  
+  //Seed the regions which were not covered by the previous frame
+  std::vector<int> seed_indices;
+  selectInitialSupervoxelSeeds (seed_indices);
+  std::vector<int> neighbors;
+  std::vector<float> sqr_distances;
+  float search_radius = 0.5f*seed_resolution_;
+  for (size_t i = 0; i < seed_indices.size (); ++i)
+  {
+    voxel_kdtree_->radiusSearch (seed_indices[i], search_radius, neighbors, sqr_distances);
+    bool covered = false;
+    for (size_t j = 0; j < neighbors.size () && !covered; ++j)
+      covered = (adjacency_octree_->at (neighbors[j])->getData ().owner_ != 0);
+    if (covered)
+      continue;
+    supervoxel_helpers_.push_back (new SupervoxelHelper (++max_label, this));
+    supervoxel_helpers_.back ().addLeaf (adjacency_octree_->at (seed_indices[i]));
+  }
+  
+  //Start the expansion from the distances of the voxels to the centers of their supervoxels
+  std::vector<SupervoxelHelper*> helpers;
+  helpers.reserve (supervoxel_helpers_.size ());
+  for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+    helpers.push_back (&(*sv_itr));
+  const int nr_helpers = static_cast<int> (helpers.size ());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads_)
+#endif
+  for (int h = 0; h < nr_helpers; ++h)
+    helpers[h]->updateCentroid ();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads_)
+#endif
+  for (int i = 0; i < nr_voxels; ++i)
+  {
+    VoxelData& voxel_data = adjacency_octree_->at (i)->getData ();
+    if (voxel_data.owner_)
+      voxel_data.distance_ = voxelDataDistance (voxel_data.owner_->getCentroid (), voxel_data);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SupervoxelClustering<PointT>::selectInitialSupervoxelSeeds (std::vector<int> &seed_indices)
@@ -425,19 +647,39 @@ pcl::SupervoxelClustering<PointT>::reseedSupervoxels ()
     sv_itr->removeAllLeaves ();
   }
   
-  std::vector<int> closest_index;
-  std::vector<float> distance;
-  //Now go through each supervoxel, find voxel closest to its center, add it in
+  std::vector<SupervoxelHelper*> helpers;
+  helpers.reserve (supervoxel_helpers_.size ());
   for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+    helpers.push_back (&(*sv_itr));
+  const int nr_helpers = static_cast<int> (helpers.size ());
+  
+  //Now go through each supervoxel, find voxel closest to its center
+  std::vector<int> seed_indices (nr_helpers);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads_)
+#endif
   {
-    PointT point;
-    sv_itr->getXYZ (point.x, point.y, point.z);
-    voxel_kdtree_->nearestKSearch (point, 1, closest_index, distance);
-    
-    LeafContainerT* seed_leaf = adjacency_octree_->at (closest_index[0]);
+    std::vector<int> closest_index;
+    std::vector<float> distance;
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int h = 0; h < nr_helpers; ++h)
+    {
+      PointT point;
+      helpers[h]->getXYZ (point.x, point.y, point.z);
+      voxel_kdtree_->nearestKSearch (point, 1, closest_index, distance);
+      seed_indices[h] = closest_index[0];
+    }
+  }
+  
+  //Add them in, in list order
+  for (int h = 0; h < nr_helpers; ++h)
+  {
+    LeafContainerT* seed_leaf = adjacency_octree_->at (seed_indices[h]);
     if (seed_leaf)
     {
-      sv_itr->addLeaf (seed_leaf);
+      helpers[h]->addLeaf (seed_leaf);
     }
     else
     {
@@ -672,6 +914,27 @@ pcl::SupervoxelClustering<PointT>::setNormalImportance (float val)
   normal_importance_ = val;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::setUseIncrementalSegmentation (bool incremental)
+{
+  incremental_ = incremental;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SupervoxelClustering<PointT>::getUseIncrementalSegmentation () const
+{
+  return (incremental_);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
 pcl::SupervoxelClustering<PointT>::getMaxLabel () const
@@ -781,7 +1044,7 @@ pcl::SupervoxelClustering<PointT>::SupervoxelHelper::removeAllLeaves ()
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> void
+template <typename PointT> size_t
 pcl::SupervoxelClustering<PointT>::SupervoxelHelper::expand ()
 {
   //std::cout << "Expanding sv "<<label_<<", owns "<<leaves_.size ()<<" voxels\n";
@@ -823,7 +1086,55 @@ pcl::SupervoxelClustering<PointT>::SupervoxelHelper::expand ()
   {
     leaves_.insert (*new_owned_itr);
   }
-  
+  return (new_owned.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::SupervoxelHelper::findExpansion (ClaimVectorT &claims, std::vector<unsigned int> &visited, unsigned int mark) const
+{
+  claims.clear ();
+  //For each leaf belonging to this supervoxel
+  typename SupervoxelHelper::const_iterator leaf_itr;
+  for (leaf_itr = leaves_.begin (); leaf_itr != leaves_.end (); ++leaf_itr)
+  {
+    //for each neighbor of the leaf
+    for (typename LeafContainerT::const_iterator neighb_itr=(*leaf_itr)->cbegin (); neighb_itr!=(*leaf_itr)->cend (); ++neighb_itr)
+    {
+      const VoxelData& neighbor_voxel = ((*neighb_itr)->getData ());
+      //The distance to a neighbor doesn't change during the expansion, so each one is only checked once
+      if (neighbor_voxel.owner_ == this || visited[neighbor_voxel.idx_] == mark)
+        continue;
+      visited[neighbor_voxel.idx_] = mark;
+      float dist = parent_->voxelDataDistance (centroid_, neighbor_voxel);
+      if (dist < neighbor_voxel.distance_)
+        claims.push_back (std::make_pair (*neighb_itr, dist));
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> size_t
+pcl::SupervoxelClustering<PointT>::SupervoxelHelper::applyExpansion (const ClaimVectorT &claims, std::set<SupervoxelHelper*> &robbed)
+{
+  size_t nr_stolen = 0;
+  for (typename ClaimVectorT::const_iterator claim_itr = claims.begin (); claim_itr != claims.end (); ++claim_itr)
+  {
+    VoxelData& neighbor_voxel = (claim_itr->first)->getData ();
+    //A preceding supervoxel may have taken the voxel with a smaller distance in the meantime
+    if (!(claim_itr->second < neighbor_voxel.distance_))
+      continue;
+    neighbor_voxel.distance_ = claim_itr->second;
+    if (neighbor_voxel.owner_)
+    {
+      (neighbor_voxel.owner_)->removeLeaf (claim_itr->first);
+      robbed.insert (neighbor_voxel.owner_);
+    }
+    neighbor_voxel.owner_ = this;
+    leaves_.insert (claim_itr->first);
+    ++nr_stolen;
+  }
+  return (nr_stolen);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
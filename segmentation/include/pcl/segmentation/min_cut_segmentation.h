@@ -47,9 +47,103 @@
 #include <pcl/search/search.h>
 #include <string>
 #include <set>
+#include <vector>
+#include <utility>
 
 namespace pcl
 {
+  namespace segmentation
+  {
+    namespace mincut
+    {
+      /** \brief A max-flow/min-cut problem stored as a compressed sparse row (CSR) graph: the arcs of every
+        * node are contiguous, and every arc knows the index of its reverse arc. It is solved with the
+        * highest-label push-relabel algorithm, with global relabeling and the gap heuristic. Only the first
+        * phase is run, which gives the flow value and the minimum cut but not the flow on every arc.
+        */
+      class PCL_EXPORTS CompactFlowGraph
+      {
+        public:
+          /// construct an empty graph
+          CompactFlowGraph ();
+          /// build the graph over \p nr_nodes nodes plus the source and the sink. Node u is linked to the
+          /// source with capacity \p source_capacities[u] and to the sink with \p sink_capacities[u]; every
+          /// pair (u, v) of \p edges is linked in both directions with capacity \p capacities[i]. The pairs
+          /// must be unique and u != v.
+          void
+          build (int nr_nodes,
+                 const std::vector<double> &source_capacities,
+                 const std::vector<double> &sink_capacities,
+                 const std::vector<std::pair<int, int> > &edges,
+                 const std::vector<double> &capacities);
+          /// get number of nodes in the graph, without the source and the sink
+          int
+          numNodes () const { return (nr_nodes_); }
+          /// solve the max-flow problem and return the flow
+          double
+          solve ();
+          /// return true if \p u is in the s-set after calling \ref solve, i.e. it cannot reach the sink
+          bool
+          inSourceTree (int u) const { return (source_side_[u] != 0); }
+
+        protected:
+          /// add the arc pair (u, v), (v, u) at the next free positions of u and v
+          void
+          addArcPair (int u, int v, double cap_uv, double cap_vu, std::vector<int> &next_arc);
+          /// label every node with its distance to the sink in the residual graph and rebuild the lists
+          void
+          globalRelabel ();
+          /// push the excess of an active node to its neighbours, relabel it if it has excess left
+          void
+          discharge (int v);
+          /// insert \p v in the list of active nodes with its label
+          void
+          addActive (int v);
+          /// insert \p v in the list of inactive nodes with its label
+          void
+          addInactive (int v);
+          /// remove \p v from the list of inactive nodes with its label
+          void
+          removeInactive (int v);
+
+          /// number of nodes, without the terminals; the source is nr_nodes_, the sink nr_nodes_ + 1
+          int nr_nodes_;
+          /// first arc of every node, the arcs of node v are [first_arc_[v], first_arc_[v + 1])
+          std::vector<int> first_arc_;
+          /// node an arc points to
+          std::vector<int> head_;
+          /// index of the reverse arc of an arc
+          std::vector<int> reverse_;
+          /// residual capacity of an arc
+          std::vector<double> residual_;
+          /// capacity of the arcs as built, restored before every solve
+          std::vector<double> capacity_;
+          /// flow in excess at every node
+          std::vector<double> excess_;
+          /// distance label of every node, nodes labeled with the number of nodes cannot reach the sink
+          std::vector<int> label_;
+          /// next arc to scan of every node
+          std::vector<int> current_arc_;
+          /// first active node of every label, -1 if none
+          std::vector<int> active_first_;
+          /// next active node with the same label
+          std::vector<int> active_next_;
+          /// first inactive node of every label, -1 if none
+          std::vector<int> inactive_first_;
+          /// next and previous inactive node with the same label
+          std::vector<int> inactive_next_, inactive_prev_;
+          /// highest label of an active node, -1 if none
+          int max_active_;
+          /// highest label of a node in the lists
+          int max_label_;
+          /// amount of work since the last global relabeling
+          long work_;
+          /// 1 for the nodes in the s-set after solve
+          std::vector<unsigned char> source_side_;
+      };
+    }
+  }
+
   /** \brief This class implements the segmentation algorithm based on minimal cut of the graph.
     * The description can be found in the article:
     * "Min-Cut Based Segmentation of Point Clouds"
@@ -190,6 +284,31 @@ namespace pcl
       void
       setBackgroundPoints (typename pcl::PointCloud<PointT>::Ptr background_points);
 
+      /** \brief Initialize the scheduler and set the number of threads to use. The neighbour search and the
+        * evaluation of the potentials are then run in parallel; the graph and the resulting cut are the same
+        * as with a single thread.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Solve the segmentation on a compact graph instead of the boost graph.
+        * \details The graph is then stored as a compressed sparse row array (see
+        * segmentation::mincut::CompactFlowGraph) and solved with a push-relabel algorithm instead of
+        * boost's Boykov-Kolmogorov. It takes less memory and does not allocate per edge. The neighbourhoods
+        * are kept when only the potentials change. The flow value is the same, up to rounding. The
+        * foreground is the largest source side of a minimum cut, i.e. the points that cannot reach the sink
+        * once the flow is maximal; it contains the foreground of the default path, which only keeps the
+        * points whose source edge is not saturated. getGraph () returns an empty pointer in this mode.
+        * \param[in] use_compact_graph true to use the compact graph (default = false)
+        */
+      void
+      setUseCompactGraph (bool use_compact_graph);
+
+      /** \brief Returns true if the segmentation is solved on a compact graph. */
+      bool
+      getUseCompactGraph () const;
+
       /** \brief This method launches the segmentation algorithm and returns the clusters that were
         * obtained during the segmentation. The indices of points that belong to the object will be stored
         * in the cluster with index 1, other indices will be stored in the cluster with index 0.
@@ -202,7 +321,9 @@ namespace pcl
       double
       getMaxFlow () const;
 
-      /** \brief Returns the graph that was build for finding the minimum cut. */
+      /** \brief Returns the graph that was build for finding the minimum cut. Empty when the compact graph is
+        * used (see setUseCompactGraph).
+        */
       typename boost::shared_ptr<typename pcl::MinCutSegmentation<PointT>::mGraph>
       getGraph () const;
 
@@ -216,6 +337,10 @@ namespace pcl
       bool
       buildGraph ();
 
+      /** \brief Builds the compact graph, the neighbourhoods are only searched again if the graph is invalid. */
+      bool
+      buildCompactGraph ();
+
       /** \brief Returns unary potential(data cost) for the given point index.
         * In other words it calculates weights for (source, point) and (point, sink) edges.
         * \param[in] point index of the point for which weights will be calculated
@@ -317,6 +442,18 @@ namespace pcl
       /** \brief Stores the maximum flow value that was calculated during the segmentation. */
       double max_flow_;
 
+      /** \brief The number of threads the scheduler should use. The default is 1. */
+      unsigned int threads_;
+
+      /** \brief Signalizes if the compact graph is used instead of the boost graph. */
+      bool use_compact_graph_;
+
+      /** \brief The pairs of neighbouring points of the compact graph. */
+      std::vector<std::pair<int, int> > compact_edges_;
+
+      /** \brief The compact graph. */
+      pcl::segmentation::mincut::CompactFlowGraph compact_graph_;
+
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   };
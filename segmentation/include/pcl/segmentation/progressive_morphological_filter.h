@@ -129,6 +129,26 @@ namespace pcl
       inline void
       setExponential (bool exponential) { exponential_ = exponential; }
 
+      /** \brief Get flag indicating whether the openings are computed on a grid of minimum elevations. */
+      inline bool
+      getUseGrid () const { return (use_grid_); }
+
+      /** \brief Set flag indicating whether the openings are computed on a grid of minimum elevations.
+        * The ground points are binned once per iteration into a 2D grid with cells of the cell size, which is
+        * opened with a window of the same number of cells as the window size, in time independent of the
+        * window size. A point stays ground if it is close enough to the opened elevation of its cell. This is
+        * the raster formulation of the original article and is much faster than opening around every point,
+        * which is done otherwise.
+        */
+      inline void
+      setUseGrid (bool use_grid) { use_grid_ = use_grid; }
+
+      /** \brief Initialize the scheduler and set the number of threads to use for the grid openings.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0) { threads_ = nr_threads; }
+
       /** \brief This method launches the segmentation algorithm and returns indices of
         * points determined to be ground returns.
         * \param[out] ground indices of points determined to be ground returns.
@@ -138,6 +158,15 @@ namespace pcl
 
     protected:
 
+      /** \brief Filters the ground returns on a grid of minimum elevations, see setUseGrid().
+        * \param[in] window_sizes the window size of each iteration
+        * \param[in] height_thresholds the height threshold of each iteration
+        * \param[out] ground indices of points determined to be ground returns.
+        */
+      void
+      extractFromGrid (const std::vector<float> &window_sizes, const std::vector<float> &height_thresholds,
+                       std::vector<int> &ground);
+
       /** \brief Maximum window size to be used in filtering ground returns. */
       int max_window_size_;
 
@@ -158,6 +187,12 @@ namespace pcl
 
       /** \brief Exponentially grow window sizes? */
       bool exponential_;
+
+      /** \brief Open a grid of minimum elevations instead of around every point? */
+      bool use_grid_;
+
+      /** \brief The number of threads the scheduler should use. The default is 1. */
+      unsigned int threads_;
   };
 }
 
@@ -190,6 +190,13 @@ namespace pcl
       void
       setSearchMethod (const KdTreePtr& tree);
 
+      /** \brief Initialize the scheduler and set the number of threads to use. The neighbour search and
+        * the growing of the regions are then run in parallel. The segments are the same as with a single thread.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Returns normals. */
       NormalPtr
       getInputNormals () const;
@@ -247,6 +254,16 @@ namespace pcl
       virtual void
       findPointNeighbours ();
 
+      /** \brief This method runs a KNN search for every point (in parallel) and stores the results
+        * in point_neighbours_ and neighbour_offsets_.
+        * \param[in] nr_neighbours number of neighbours to search for
+        * \param[in] skip_non_finite if true then no search is made for the points with non-finite coordinates
+        * \param[out] distances if not null, receives the squared distances to the neighbours, laid out
+        * as point_neighbours_
+        */
+      void
+      buildNeighbourGraph (unsigned int nr_neighbours, bool skip_non_finite, std::vector<float>* distances);
+
       /** \brief This function implements the algorithm described in the article
         * "Segmentation of point clouds using smoothness constraint"
         * by T. Rabbania, F. A. van den Heuvelb, G. Vosselmanc.
@@ -261,6 +278,30 @@ namespace pcl
       int
       growRegion (int initial_seed, int segment_number);
 
+      /** \brief This method grows the segments for several seeds at once. Each candidate seed grows a
+        * tentative segment among the points that are not labeled yet; the tentative segments are then
+        * committed in the order of the seeds, as long as they do not overlap the segments committed before
+        * them. The result is identical to growing the segments one after the other.
+        * \param[in] point_residual the points sorted in the order in which they are used as seeds
+        * \param[in] nr_threads the number of threads to use
+        */
+      void
+      growRegionsConcurrently (const std::vector< std::pair<float, int> >& point_residual, int nr_threads);
+
+      /** \brief This method grows a tentative segment, ignoring the segments that are grown concurrently.
+        * \param[in] initial_seed index of the point that will serve as the seed point
+        * \param[in] rank position of the seed among the concurrent candidate seeds
+        * \param[in] candidate_rank for each point, its position among the candidate seeds (-1 if it is not one)
+        * \param[in,out] visited marks of the points reached so far, by tentative segment
+        * \param[in] visit_mark mark used for the points of this tentative segment
+        * \param[out] region the points of the tentative segment, in the order in which they were reached
+        * \return false if the segment reached the seed of a candidate with a lower rank, i.e. it is going
+        * to overlap a segment committed before it
+        */
+      bool
+      growTentativeRegion (int initial_seed, int rank, const std::vector<int>& candidate_rank,
+                           std::vector<int>& visited, int visit_mark, std::vector<int>& region) const;
+
       /** \brief This function is checking if the point with index 'nghbr' belongs to the segment.
         * If so, then it returns true. It also checks if this point can serve as the seed.
         * \param[in] initial_seed index of the initial point that was passed to the growRegion() function
@@ -312,8 +353,13 @@ namespace pcl
       /** \brief Contains normals of the points that will be segmented. */
       NormalPtr normals_;
 
-      /** \brief Contains neighbours of each point. */
-      std::vector<std::vector<int> > point_neighbours_;
+      /** \brief Contains neighbours of all points, stored one after the other. The neighbours of the point i are
+        * point_neighbours_[neighbour_offsets_[i]] ... point_neighbours_[neighbour_offsets_[i + 1] - 1].
+        */
+      std::vector<int> point_neighbours_;
+
+      /** \brief Position of the neighbours of each point in point_neighbours_ (compressed sparse row layout). */
+      std::vector<int> neighbour_offsets_;
 
       /** \brief Point labels that tells to which segment each point belongs. */
       std::vector<int> point_labels_;
@@ -332,6 +378,9 @@ namespace pcl
       /** \brief Stores the number of segments. */
       int number_of_segments_;
 
+      /** \brief The number of threads the scheduler should use. The default is 1. */
+      unsigned int threads_;
+
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   };
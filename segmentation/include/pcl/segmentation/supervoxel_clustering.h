@@ -225,6 +225,28 @@ namespace pcl
       void
       setNormalImportance (float val);
 
+      /** \brief Initialize the scheduler and set the number of threads to use. The voxel adjacency octree,
+        * the voxel normals and the expansion of the supervoxels are then computed in parallel. The supervoxels
+        * are the same as with a single thread.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Set whether extract() should start from the supervoxels of the previous call to extract().
+        * This is meant for streams of clouds (e.g. RGB-D frames) where consecutive frames only slightly change
+        * the set of voxels: every new voxel close to a voxel of the previous frame starts out in the supervoxel
+        * that owned it, seeds are only placed in regions not covered by the previous supervoxels, and the
+        * expansion stops as soon as no voxel changes its owner. Labels are kept stable between frames.
+        * \param[in] incremental true to segment the next clouds incrementally
+        */
+      void
+      setUseIncrementalSegmentation (bool incremental);
+
+      /** \brief Returns whether extract() starts from the supervoxels of the previous call to extract(). */
+      bool
+      getUseIncrementalSegmentation () const;
+
       /** \brief This method launches the segmentation algorithm and returns the supervoxels that were
        * obtained during the segmentation.
        * \param[out] supervoxel_clusters A map of labels to pointers to supervoxel structures
@@ -341,10 +363,28 @@ namespace pcl
       void
       createSupervoxelHelpers (std::vector<int> &seed_indices);
 
-      /** \brief This performs the superpixel evolution */
+      /** \brief This method creates the internal supervoxel helpers from the supervoxels of the previous frame.
+       *  Voxels within one voxel resolution of a previous voxel are given to the supervoxel which owned it,
+       *  new seeds are only placed where no voxel within half the seed resolution was taken over.
+       *  \param[in] previous_voxels The voxel centroids of the previous frame
+       *  \param[in] previous_labels The supervoxel label of each of the previous voxels
+       */
+      void
+      createSupervoxelHelpers (const typename PointCloudT::ConstPtr &previous_voxels,
+                               const std::vector<uint32_t> &previous_labels);
+
+      /** \brief This performs the superpixel evolution, it stops early once no voxel changes its owner */
       void
       expandSupervoxels (int depth);
 
+      /** \brief Performs one expansion iteration of all supervoxels with threads_ threads.
+       *  The voxels each supervoxel may take are computed concurrently, they are then handed over in list order,
+       *  exactly like the serial expansion. A supervoxel which lost voxels to a preceding one recomputes its claims.
+       *  \returns the number of voxels which changed owner
+       */
+      size_t
+      expandSupervoxelsConcurrently ();
+
       /** \brief This sets the data of the voxels in the tree */
       void 
       computeVoxelData ();
@@ -390,6 +430,15 @@ namespace pcl
       /** \brief Importance of similarity in normals for clustering */
       float normal_importance_;
 
+      /** \brief Whether the voxel density is normalized versus the distance from the camera */
+      bool use_single_camera_transform_;
+
+      /** \brief Whether extract() starts from the supervoxels of the previous call */
+      bool incremental_;
+
+      /** \brief The number of threads the scheduler should use. The default is 1. */
+      unsigned int threads_;
+
       /** \brief Internal storage class for supervoxels 
        * \note Stores pointers to leaves of clustering internal octree, 
        * \note so should not be used outside of clustering class 
@@ -412,6 +461,8 @@ namespace pcl
           typedef std::set<LeafContainerT*, typename SupervoxelHelper::compareLeaves> LeafSetT;
           typedef typename LeafSetT::iterator iterator;
           typedef typename LeafSetT::const_iterator const_iterator;
+          //Voxels a supervoxel may take over in an expansion, with their distance to its centroid
+          typedef std::vector<std::pair<LeafContainerT*, float> > ClaimVectorT;
 
           SupervoxelHelper (uint32_t label, SupervoxelClustering* parent_arg):
             label_ (label),
@@ -427,9 +478,15 @@ namespace pcl
           void
           removeAllLeaves ();
 
-          void 
+          size_t
           expand ();
 
+          void
+          findExpansion (ClaimVectorT &claims, std::vector<unsigned int> &visited, unsigned int mark) const;
+
+          size_t
+          applyExpansion (const ClaimVectorT &claims, std::set<SupervoxelHelper*> &robbed);
+
           void 
           refineNormals ();
 
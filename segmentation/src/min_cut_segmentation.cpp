@@ -43,6 +43,294 @@
 #include <pcl/impl/instantiate.hpp>
 #include <pcl/segmentation/min_cut_segmentation.h>
 #include <pcl/segmentation/impl/min_cut_segmentation.hpp>
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::segmentation::mincut::CompactFlowGraph::CompactFlowGraph () :
+  nr_nodes_ (0),
+  first_arc_ (1, 0),
+  max_active_ (-1),
+  max_label_ (-1),
+  work_ (0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::mincut::CompactFlowGraph::build (int nr_nodes,
+                                                    const std::vector<double> &source_capacities,
+                                                    const std::vector<double> &sink_capacities,
+                                                    const std::vector<std::pair<int, int> > &edges,
+                                                    const std::vector<double> &capacities)
+{
+  nr_nodes_ = nr_nodes;
+  const int source = nr_nodes;
+  const int sink = nr_nodes + 1;
+  const int nr_vertices = nr_nodes + 2;
+
+  // count the arcs of every node, the terminal edges without capacity are left out
+  std::vector<int> degree (nr_vertices, 0);
+  for (int u = 0; u < nr_nodes; ++u)
+  {
+    if (source_capacities[u] > 0.0)
+    {
+      ++degree[u];
+      ++degree[source];
+    }
+    if (sink_capacities[u] > 0.0)
+    {
+      ++degree[u];
+      ++degree[sink];
+    }
+  }
+  for (size_t i = 0; i < edges.size (); ++i)
+  {
+    ++degree[edges[i].first];
+    ++degree[edges[i].second];
+  }
+
+  first_arc_.assign (nr_vertices + 1, 0);
+  for (int v = 0; v < nr_vertices; ++v)
+    first_arc_[v + 1] = first_arc_[v] + degree[v];
+  const int nr_arcs = first_arc_[nr_vertices];
+  head_.resize (nr_arcs);
+  reverse_.resize (nr_arcs);
+  capacity_.resize (nr_arcs);
+
+  std::vector<int> next_arc (first_arc_.begin (), first_arc_.end () - 1);
+  for (int u = 0; u < nr_nodes; ++u)
+  {
+    if (source_capacities[u] > 0.0)
+      addArcPair (source, u, source_capacities[u], 0.0, next_arc);
+    if (sink_capacities[u] > 0.0)
+      addArcPair (u, sink, sink_capacities[u], 0.0, next_arc);
+  }
+  for (size_t i = 0; i < edges.size (); ++i)
+    addArcPair (edges[i].first, edges[i].second, capacities[i], capacities[i], next_arc);
+
+  residual_ = capacity_;
+  source_side_.assign (nr_nodes, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::mincut::CompactFlowGraph::addArcPair (int u, int v, double cap_uv, double cap_vu,
+                                                         std::vector<int> &next_arc)
+{
+  const int uv = next_arc[u]++;
+  const int vu = next_arc[v]++;
+  head_[uv] = v;
+  head_[vu] = u;
+  capacity_[uv] = cap_uv;
+  capacity_[vu] = cap_vu;
+  reverse_[uv] = vu;
+  reverse_[vu] = uv;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::mincut::CompactFlowGraph::addActive (int v)
+{
+  const int d = label_[v];
+  active_next_[v] = active_first_[d];
+  active_first_[d] = v;
+  max_active_ = std::max (max_active_, d);
+  max_label_ = std::max (max_label_, d);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::mincut::CompactFlowGraph::addInactive (int v)
+{
+  const int d = label_[v];
+  inactive_prev_[v] = -1;
+  inactive_next_[v] = inactive_first_[d];
+  if (inactive_first_[d] != -1)
+    inactive_prev_[inactive_first_[d]] = v;
+  inactive_first_[d] = v;
+  max_label_ = std::max (max_label_, d);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::mincut::CompactFlowGraph::removeInactive (int v)
+{
+  if (inactive_prev_[v] != -1)
+    inactive_next_[inactive_prev_[v]] = inactive_next_[v];
+  else
+    inactive_first_[label_[v]] = inactive_next_[v];
+  if (inactive_next_[v] != -1)
+    inactive_prev_[inactive_next_[v]] = inactive_prev_[v];
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::mincut::CompactFlowGraph::globalRelabel ()
+{
+  const int nr_vertices = nr_nodes_ + 2;
+  const int source = nr_nodes_;
+  const int sink = nr_nodes_ + 1;
+
+  std::fill (label_.begin (), label_.end (), nr_vertices);
+  std::fill (active_first_.begin (), active_first_.end (), -1);
+  std::fill (inactive_first_.begin (), inactive_first_.end (), -1);
+  for (int v = 0; v < nr_vertices; ++v)
+    current_arc_[v] = first_arc_[v];
+  max_active_ = -1;
+  max_label_ = 0;
+
+  // breadth first search from the sink along the arcs with residual capacity towards the sink
+  std::vector<int> queue;
+  queue.reserve (nr_vertices);
+  label_[sink] = 0;
+  queue.push_back (sink);
+  for (size_t i_queue = 0; i_queue < queue.size (); ++i_queue)
+  {
+    const int v = queue[i_queue];
+    for (int a = first_arc_[v]; a < first_arc_[v + 1]; ++a)
+    {
+      const int u = head_[a];
+      if (label_[u] == nr_vertices && u != source && residual_[reverse_[a]] > 0.0)
+      {
+        label_[u] = label_[v] + 1;
+        queue.push_back (u);
+        if (excess_[u] > 0.0)
+          addActive (u);
+        else
+          addInactive (u);
+      }
+    }
+  }
+  work_ = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::segmentation::mincut::CompactFlowGraph::discharge (int v)
+{
+  const int nr_vertices = nr_nodes_ + 2;
+  const int sink = nr_nodes_ + 1;
+
+  while (true)
+  {
+    const int d = label_[v];
+    const int last_arc = first_arc_[v + 1];
+
+    // push along the admissible arcs, starting from the current one
+    int a = current_arc_[v];
+    for (; a < last_arc; ++a)
+    {
+      if (residual_[a] <= 0.0)
+        continue;
+      const int u = head_[a];
+      if (label_[u] != d - 1)
+        continue;
+
+      const double delta = std::min (excess_[v], residual_[a]);
+      residual_[a] -= delta;
+      residual_[reverse_[a]] += delta;
+      if (u != sink && excess_[u] == 0.0)
+      {
+        removeInactive (u);
+        addActive (u);
+      }
+      excess_[u] += delta;
+      excess_[v] -= delta;
+      if (excess_[v] == 0.0)
+        break;
+    }
+
+    if (a < last_arc)
+    {
+      current_arc_[v] = a;
+      addInactive (v);
+      return;
+    }
+
+    // v is the last node with its label: the nodes above the gap cannot reach the sink anymore
+    if (active_first_[d] == -1 && inactive_first_[d] == -1)
+    {
+      for (int gap_label = d + 1; gap_label <= max_label_; ++gap_label)
+      {
+        for (int u = inactive_first_[gap_label]; u != -1; u = inactive_next_[u])
+          label_[u] = nr_vertices;
+        inactive_first_[gap_label] = -1;
+      }
+      max_label_ = d - 1;
+      max_active_ = std::min (max_active_, max_label_);
+      label_[v] = nr_vertices;
+      return;
+    }
+
+    // relabel v to one above its lowest neighbour in the residual graph
+    int min_label = nr_vertices;
+    int min_arc = first_arc_[v];
+    for (a = first_arc_[v]; a < last_arc; ++a)
+      if (residual_[a] > 0.0 && label_[head_[a]] + 1 < min_label)
+      {
+        min_label = label_[head_[a]] + 1;
+        min_arc = a;
+      }
+    work_ += 12 + (last_arc - first_arc_[v]);
+    label_[v] = min_label;
+    current_arc_[v] = min_arc;
+    if (min_label >= nr_vertices)
+      return;
+    max_label_ = std::max (max_label_, min_label);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+double
+pcl::segmentation::mincut::CompactFlowGraph::solve ()
+{
+  const int nr_vertices = nr_nodes_ + 2;
+  const int source = nr_nodes_;
+  const int sink = nr_nodes_ + 1;
+
+  residual_ = capacity_;
+  excess_.assign (nr_vertices, 0.0);
+  label_.assign (nr_vertices, nr_vertices);
+  current_arc_.assign (nr_vertices, 0);
+  active_first_.assign (nr_vertices, -1);
+  active_next_.assign (nr_vertices, -1);
+  inactive_first_.assign (nr_vertices, -1);
+  inactive_next_.assign (nr_vertices, -1);
+  inactive_prev_.assign (nr_vertices, -1);
+
+  // saturate the source edges
+  for (int a = first_arc_[source]; a < first_arc_[source + 1]; ++a)
+  {
+    const double delta = residual_[a];
+    residual_[a] = 0.0;
+    residual_[reverse_[a]] += delta;
+    excess_[head_[a]] += delta;
+  }
+
+  // the labels are recomputed from scratch once the relabelings have cost about as much as a search
+  const long global_relabel_work = 6 * static_cast<long> (nr_vertices) + static_cast<long> (head_.size ());
+  globalRelabel ();
+  while (max_active_ >= 0)
+  {
+    const int v = active_first_[max_active_];
+    if (v == -1)
+    {
+      --max_active_;
+      continue;
+    }
+    active_first_[max_active_] = active_next_[v];
+    discharge (v);
+
+    if (work_ > global_relabel_work)
+      globalRelabel ();
+  }
+
+  // the s-set are the nodes that cannot reach the sink in the residual graph
+  globalRelabel ();
+  for (int u = 0; u < nr_nodes_; ++u)
+    source_side_[u] = (label_[u] == nr_vertices);
+  return (excess_[sink]);
+}
 
 // Instantiations of specific point types
 PCL_INSTANTIATE(MinCutSegmentation, PCL_XYZ_POINT_TYPES)
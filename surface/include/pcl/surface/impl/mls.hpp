@@ -92,30 +92,38 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::process (PointCloudOut &output)
   if (!initCompute ())
     return;
 
-
-  // Initialize the spatial locator
-  if (!tree_)
+  if (neighborhoods_ && neighborhoods_->size () != indices_->size ())
   {
-    KdTreePtr tree;
-    if (input_->isOrganized ())
-      tree.reset (new pcl::search::OrganizedNeighbor<PointInT> ());
-    else
-      tree.reset (new pcl::search::KdTree<PointInT> (false));
-    setSearchMethod (tree);
+    PCL_ERROR ("[pcl::%s::process] The number of neighborhoods (%lu) differs from the number of indices (%lu)!\n", getClassName ().c_str (), neighborhoods_->size (), indices_->size ());
+    deinitCompute ();
+    return;
   }
 
-  // Send the surface dataset to the spatial locator
-  tree_->setInputCloud (input_);
+  // The search tree is not needed if the neighborhoods are given, unless samples are projected afterwards
+  if (!neighborhoods_ || upsample_method_ == DISTINCT_CLOUD || upsample_method_ == VOXEL_GRID_DILATION)
+  {
+    // Initialize the spatial locator
+    if (!tree_)
+    {
+      KdTreePtr tree;
+      if (input_->isOrganized ())
+        tree.reset (new pcl::search::OrganizedNeighbor<PointInT> ());
+      else
+        tree.reset (new pcl::search::KdTree<PointInT> (false));
+      setSearchMethod (tree);
+    }
+
+    // Send the surface dataset to the spatial locator
+    tree_->setInputCloud (input_);
+  }
 
   switch (upsample_method_)
   {
     // Initialize random number generator if necessary
     case (RANDOM_UNIFORM_DENSITY):
     {
-      rng_alg_.seed (static_cast<unsigned> (std::time (0)));
-      float tmp = static_cast<float> (search_radius_ / 2.0f);
-      boost::uniform_real<float> uniform_distrib (-tmp, tmp);
-      rng_uniform_distribution_.reset (new boost::variate_generator<boost::mt19937&, boost::uniform_real<float> > (rng_alg_, uniform_distrib));
+      rng_alg_.seed (seed_);
+      rng_seed_ = static_cast<boost::uint32_t> (rng_alg_ ());
 
       mls_results_.resize (1); // Need to have a reference to a single dummy result.
       
@@ -169,6 +177,22 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
                                                                      NormalCloud &projected_points_normals,
                                                                      PointIndices &corresponding_input_indices,
                                                                      MLSResult &mls_result) const
+{
+  MLSWorkspace workspace;
+  computeMLSPointNormal (index, nn_indices, nn_sqr_dists, projected_points, projected_points_normals,
+                         corresponding_input_indices, mls_result, workspace);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
+                                                                     const std::vector<int> &nn_indices,
+                                                                     std::vector<float> &nn_sqr_dists,
+                                                                     PointCloudOut &projected_points,
+                                                                     NormalCloud &projected_points_normals,
+                                                                     PointIndices &corresponding_input_indices,
+                                                                     MLSResult &mls_result,
+                                                                     MLSWorkspace &workspace) const
 {
   // Note: this method is const because it needs to be thread-safe
   //       (MovingLeastSquaresOMP calls it from multiple threads)
@@ -204,7 +228,7 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
   // Get a copy of the plane normal easy access
   Eigen::Vector3d plane_normal = model_coefficients.head<3> ();
   // Vector in which the polynomial coefficients will be put
-  Eigen::VectorXd c_vec;
+  Eigen::VectorXd &c_vec = workspace.c_vec;
   // Local coordinate system (Darboux frame)
   Eigen::Vector3d v_axis (0.0f, 0.0f, 0.0f), u_axis (0.0f, 0.0f, 0.0f);
 
@@ -212,11 +236,14 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
 
   // Perform polynomial fit to update point and normal
   ////////////////////////////////////////////////////
-  if (polynomial_fit_ && static_cast<int> (nn_indices.size ()) >= nr_coeff_)
+  const int nr_neighbors = static_cast<int> (nn_indices.size ());
+  if (polynomial_fit_ && nr_neighbors >= nr_coeff_)
   {
+    workspace.reserve (nr_neighbors, nr_coeff_);
+
     // Update neighborhood, since point was projected, and computing relative
     // positions. Note updating only distances for the weights for speed
-    std::vector<Eigen::Vector3d> de_meaned (nn_indices.size ());
+    std::vector<Eigen::Vector3d> &de_meaned = workspace.de_meaned;
     for (size_t ni = 0; ni < nn_indices.size (); ++ni)
     {
       de_meaned[ni][0] = input_->points[nn_indices[ni]].x - point[0];
@@ -225,12 +252,11 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
       nn_sqr_dists[ni] = static_cast<float> (de_meaned[ni].dot (de_meaned[ni]));
     }
 
-    // Allocate matrices and vectors to hold the data used for the polynomial fit
-    Eigen::VectorXd weight_vec (nn_indices.size ());
-    Eigen::MatrixXd P (nr_coeff_, nn_indices.size ());
-    Eigen::VectorXd f_vec (nn_indices.size ());
-    Eigen::MatrixXd P_weight; // size will be (nr_coeff_, nn_indices.size ());
-    Eigen::MatrixXd P_weight_Pt (nr_coeff_, nr_coeff_);
+    // The matrices and vectors used for the polynomial fit are preallocated in the workspace,
+    // only their first nr_neighbors columns are used
+    Eigen::VectorXd &weight_vec = workspace.weight_vec;
+    Eigen::MatrixXd &P = workspace.P;
+    Eigen::VectorXd &f_vec = workspace.f_vec;
 
     // Get local coordinate system (Darboux frame)
     v_axis = plane_normal.unitOrthogonal ();
@@ -265,11 +291,14 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
     }
 
     // Computing coefficients
-    P_weight = P * weight_vec.asDiagonal ();
-    P_weight_Pt = P_weight * P.transpose ();
-    c_vec = P_weight * f_vec;
-    P_weight_Pt.llt ().solveInPlace (c_vec);
+    workspace.P_weight.leftCols (nr_neighbors) = P.leftCols (nr_neighbors) * weight_vec.head (nr_neighbors).asDiagonal ();
+    workspace.P_weight_Pt.noalias () = workspace.P_weight.leftCols (nr_neighbors) * P.leftCols (nr_neighbors).transpose ();
+    c_vec.noalias () = workspace.P_weight.leftCols (nr_neighbors) * f_vec.head (nr_neighbors);
+    workspace.llt.compute (workspace.P_weight_Pt);
+    workspace.llt.solveInPlace (c_vec);
   }
+  else
+    c_vec.resize (0);
 
   switch (upsample_method_)
   {
@@ -300,8 +329,8 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
         aux_normal.normal_z = static_cast<float> (normal[2]);
         aux_normal.curvature = curvature;
         projected_points_normals.push_back (aux_normal);
-        corresponding_input_indices.indices.push_back (index);
       }
+      corresponding_input_indices.indices.push_back (index);
 
       break;
     }
@@ -365,11 +394,17 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
       }
       else
       {
+        // Seed from the point index so that the samples do not depend on the thread layout
+        workspace.rng.seed (static_cast<boost::uint32_t> (rng_seed_ ^ (static_cast<boost::uint32_t> (index) * 2654435761u)));
+        float tmp = static_cast<float> (search_radius_ / 2.0f);
+        boost::uniform_real<float> uniform_distrib (-tmp, tmp);
+        boost::variate_generator<boost::mt19937&, boost::uniform_real<float> > rng_uniform_distribution (workspace.rng, uniform_distrib);
+
         // Sample the local plane
         for (int num_added = 0; num_added < num_points_to_add;)
         {
-          float u_disp = (*rng_uniform_distribution_) (),
-              v_disp = (*rng_uniform_distribution_) ();
+          float u_disp = rng_uniform_distribution (),
+              v_disp = rng_uniform_distribution ();
           // Check if inside circle; if not, try another coin flip
           if (u_disp * u_disp + v_disp * v_disp > search_radius_ * search_radius_/4)
             continue;
@@ -406,12 +441,12 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
-pcl::MovingLeastSquares<PointInT, PointOutT>::projectPointToMLSSurface (float &u_disp, float &v_disp,
-                                                                        Eigen::Vector3d &u, Eigen::Vector3d &v,
-                                                                        Eigen::Vector3d &plane_normal,
-                                                                        Eigen::Vector3d &mean,
-                                                                        float &curvature,
-                                                                        Eigen::VectorXd &c_vec,
+pcl::MovingLeastSquares<PointInT, PointOutT>::projectPointToMLSSurface (const float &u_disp, const float &v_disp,
+                                                                        const Eigen::Vector3d &u, const Eigen::Vector3d &v,
+                                                                        const Eigen::Vector3d &plane_normal,
+                                                                        const Eigen::Vector3d &mean,
+                                                                        const float &curvature,
+                                                                        const Eigen::VectorXd &c_vec,
                                                                         int num_neighbors,
                                                                         PointOutT &result_point,
                                                                         pcl::Normal &result_normal) const
@@ -461,6 +496,23 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::projectPointToMLSSurface (float &u
   result_normal.curvature = curvature;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> const std::vector<int>*
+pcl::MovingLeastSquares<PointInT, PointOutT>::getNeighborhood (int cp, MLSWorkspace &workspace) const
+{
+  if (neighborhoods_)
+  {
+    // The squared distances are recomputed by the polynomial fit, only their storage is needed
+    const std::vector<int> &nn_indices = (*neighborhoods_)[cp];
+    workspace.nn_sqr_dists.resize (nn_indices.size ());
+    return (&nn_indices);
+  }
+
+  if (!searchForNeighbors ((*indices_)[cp], workspace.nn_indices, workspace.nn_sqr_dists))
+    return (NULL);
+  return (&workspace.nn_indices);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
 pcl::MovingLeastSquares<PointInT, PointOutT>::performProcessing (PointCloudOut &output)
@@ -468,36 +520,37 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::performProcessing (PointCloudOut &
   // Compute the number of coefficients
   nr_coeff_ = (order_ + 1) * (order_ + 2) / 2;
 
-  // Allocate enough space to hold the results of nearest neighbor searches
-  // \note resize is irrelevant for a radiusSearch ().
-  std::vector<int> nn_indices;
-  std::vector<float> nn_sqr_dists;
-  
+  // Neighbor search results and polynomial fit matrices, reused for all points
+  MLSWorkspace workspace;
+
+  PointCloudOut projected_points;
+  NormalCloud projected_points_normals;
   size_t mls_result_index = 0;
 
   // For all points
   for (size_t cp = 0; cp < indices_->size (); ++cp)
   {
     // Get the initial estimates of point positions and their neighborhoods
-    if (!searchForNeighbors ((*indices_)[cp], nn_indices, nn_sqr_dists))
+    const std::vector<int> *nn_indices = getNeighborhood (static_cast<int> (cp), workspace);
+    if (!nn_indices)
       continue;
 
 
     // Check the number of nearest neighbors for normal estimation (and later
     // for polynomial fit as well)
-    if (nn_indices.size () < 3)
+    if (nn_indices->size () < 3)
       continue;
 
 
-    PointCloudOut projected_points;
-    NormalCloud projected_points_normals;
+    projected_points.clear ();
+    projected_points_normals.clear ();
     // Get a plane approximating the local surface's tangent and project point onto it
     int index = (*indices_)[cp];
     
     if (upsample_method_ == VOXEL_GRID_DILATION || upsample_method_ == DISTINCT_CLOUD)
       mls_result_index = index; // otherwise we give it a dummy location.
 
-    computeMLSPointNormal (index, nn_indices, nn_sqr_dists, projected_points, projected_points_normals, *corresponding_input_indices_, mls_results_[mls_result_index]);
+    computeMLSPointNormal (index, *nn_indices, workspace.nn_sqr_dists, projected_points, projected_points_normals, *corresponding_input_indices_, mls_results_[mls_result_index], workspace);
 
 
     // Copy all information from the input cloud to the output points (not doing any interpolation)
@@ -531,111 +584,78 @@ pcl::MovingLeastSquaresOMP<PointInT, PointOutT>::performProcessing (PointCloudOu
   typename NormalCloud::CloudVectorType projected_points_normals (threads);
   std::vector<PointIndices> corresponding_input_indices (threads);
 
-  // For all points
-#pragma omp parallel for schedule (dynamic,1000) num_threads (threads)
-  for (int cp = 0; cp < static_cast<int> (indices_->size ()); ++cp)
+  // Thread and range in that thread's temporaries of the points generated for each query point,
+  // used to concatenate the results in the order of the indices
+  std::vector<int> point_thread (indices_->size (), -1);
+  std::vector<size_t> point_begin (indices_->size (), 0), point_end (indices_->size (), 0);
+
+#pragma omp parallel num_threads (threads)
   {
-    // Allocate enough space to hold the results of nearest neighbor searches
-    // \note resize is irrelevant for a radiusSearch ().
-    std::vector<int> nn_indices;
-    std::vector<float> nn_sqr_dists;
+    // This thread's ID (range 0 to threads-1)
+    const int tn = omp_get_thread_num ();
 
-    // Get the initial estimates of point positions and their neighborhoods
-    if (this->searchForNeighbors ((*indices_)[cp], nn_indices, nn_sqr_dists))
+    // Neighbor search results and polynomial fit matrices, reused for all points of this thread
+    typename MovingLeastSquares<PointInT, PointOutT>::MLSWorkspace workspace;
+
+    // For all points
+#pragma omp for schedule (dynamic,1000)
+    for (int cp = 0; cp < static_cast<int> (indices_->size ()); ++cp)
     {
+      // Get the initial estimates of point positions and their neighborhoods
+      const std::vector<int> *nn_indices = this->getNeighborhood (cp, workspace);
+
       // Check the number of nearest neighbors for normal estimation (and later
       // for polynomial fit as well)
-      if (nn_indices.size () >= 3)
-      {
-        // This thread's ID (range 0 to threads-1)
-        int tn = omp_get_thread_num ();
-
-        // Size of projected points before computeMLSPointNormal () adds points
-        size_t pp_size = projected_points[tn].size ();
-
-        // Get a plane approximating the local surface's tangent and project point onto it
-        int index = (*indices_)[cp];
-        size_t mls_result_index = 0;
-        
-        if (upsample_method_ == VOXEL_GRID_DILATION || upsample_method_ == DISTINCT_CLOUD)
-          mls_result_index = index; // otherwise we give it a dummy location.
-        
-        this->computeMLSPointNormal (index, nn_indices, nn_sqr_dists, projected_points[tn], projected_points_normals[tn], corresponding_input_indices[tn], this->mls_results_[mls_result_index]);
-
-        // Copy all information from the input cloud to the output points (not doing any interpolation)
-        for (size_t pp = pp_size; pp < projected_points[tn].size (); ++pp)
-          this->copyMissingFields (input_->points[(*indices_)[cp]], projected_points[tn][pp]);
-	    }
-	  }
-  }
+      if (!nn_indices || nn_indices->size () < 3)
+        continue;
+
+      // Size of projected points before computeMLSPointNormal () adds points
+      size_t pp_size = projected_points[tn].size ();
+
+      // Get a plane approximating the local surface's tangent and project point onto it
+      int index = (*indices_)[cp];
+      size_t mls_result_index = 0;
 
+      if (upsample_method_ == VOXEL_GRID_DILATION || upsample_method_ == DISTINCT_CLOUD)
+        mls_result_index = index; // otherwise we give it a dummy location.
 
-  // Combine all threads' results into the output vectors
-  for (unsigned int tn = 0; tn < threads; ++tn)
+      this->computeMLSPointNormal (index, *nn_indices, workspace.nn_sqr_dists, projected_points[tn], projected_points_normals[tn], corresponding_input_indices[tn], this->mls_results_[mls_result_index], workspace);
+
+      // Copy all information from the input cloud to the output points (not doing any interpolation)
+      for (size_t pp = pp_size; pp < projected_points[tn].size (); ++pp)
+        this->copyMissingFields (input_->points[(*indices_)[cp]], projected_points[tn][pp]);
+
+      point_thread[cp] = tn;
+      point_begin[cp] = pp_size;
+      point_end[cp] = projected_points[tn].size ();
+    }
+  }
+
+  // Combine all threads' results into the output vectors, in the order of the indices
+  for (size_t cp = 0; cp < indices_->size (); ++cp)
   {
-    output.insert (output.end (), projected_points[tn].begin (), projected_points[tn].end ());
+    const int tn = point_thread[cp];
+    if (tn < 0 || point_begin[cp] == point_end[cp])
+      continue;
+
+    output.insert (output.end (), projected_points[tn].begin () + point_begin[cp], projected_points[tn].begin () + point_end[cp]);
     corresponding_input_indices_->indices.insert (corresponding_input_indices_->indices.end (),
-        corresponding_input_indices[tn].indices.begin (), corresponding_input_indices[tn].indices.end ());
+        corresponding_input_indices[tn].indices.begin () + point_begin[cp], corresponding_input_indices[tn].indices.begin () + point_end[cp]);
     if (compute_normals_)
-      normals_->insert (normals_->end (), projected_points_normals[tn].begin (), projected_points_normals[tn].end ());
+      normals_->insert (normals_->end (), projected_points_normals[tn].begin () + point_begin[cp], projected_points_normals[tn].begin () + point_end[cp]);
   }
 
   // Perform the distinct-cloud or voxel-grid upsampling
-  this->performUpsampling (output);
+  this->performUpsampling (output, threads);
 }
 #endif
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
-pcl::MovingLeastSquares<PointInT, PointOutT>::performUpsampling (PointCloudOut &output)
+pcl::MovingLeastSquares<PointInT, PointOutT>::performUpsampling (PointCloudOut &output, unsigned int nr_threads)
 {
   if (upsample_method_ == DISTINCT_CLOUD)
-  {
-    for (size_t dp_i = 0; dp_i < distinct_cloud_->size (); ++dp_i) // dp_i = distinct_point_i
-    {
-      // Distinct cloud may have nan points, skip them
-      if (!pcl_isfinite (distinct_cloud_->points[dp_i].x))
-        continue;
-
-      // Get 3D position of point
-      //Eigen::Vector3f pos = distinct_cloud_->points[dp_i].getVector3fMap ();
-      std::vector<int> nn_indices;
-      std::vector<float> nn_dists;
-      tree_->nearestKSearch (distinct_cloud_->points[dp_i], 1, nn_indices, nn_dists);
-      int input_index = nn_indices.front ();
-
-      // If the closest point did not have a valid MLS fitting result
-      // OR if it is too far away from the sampled point
-      if (mls_results_[input_index].valid == false)
-        continue;
-
-      Eigen::Vector3d add_point = distinct_cloud_->points[dp_i].getVector3fMap ().template cast<double> ();
-
-      float u_disp = static_cast<float> ((add_point - mls_results_[input_index].mean).dot (mls_results_[input_index].u_axis)),
-            v_disp = static_cast<float> ((add_point - mls_results_[input_index].mean).dot (mls_results_[input_index].v_axis));
-
-      PointOutT result_point;
-      pcl::Normal result_normal;
-      projectPointToMLSSurface (u_disp, v_disp,
-                                mls_results_[input_index].u_axis, mls_results_[input_index].v_axis,
-                                mls_results_[input_index].plane_normal,
-                                mls_results_[input_index].mean,
-                                mls_results_[input_index].curvature,
-                                mls_results_[input_index].c_vec,
-                                mls_results_[input_index].num_neighbors,
-                                result_point, result_normal);
-
-      // Copy additional point information if available
-      copyMissingFields (input_->points[input_index], result_point);
-
-      // Store the id of the original point
-      corresponding_input_indices_->indices.push_back (input_index);
-
-      output.push_back (result_point);
-      if (compute_normals_)
-        normals_->push_back (result_normal);
-    }
-  }
+    projectSamples (*distinct_cloud_, output, nr_threads);
 
   // For the voxel grid upsampling method, generate the voxel grid and dilate it
   // Then, project the newly obtained points to the MLS surface
@@ -645,6 +665,8 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::performUpsampling (PointCloudOut &
     for (int iteration = 0; iteration < dilation_iteration_num_; ++iteration)
       voxel_grid.dilate ();
 
+    PointCloudIn samples;
+    samples.points.reserve (voxel_grid.voxel_grid_.size ());
     for (typename MLSVoxelGrid::HashMap::iterator m_it = voxel_grid.voxel_grid_.begin (); m_it != voxel_grid.voxel_grid_.end (); ++m_it)
     {
       // Get 3D position of point
@@ -655,44 +677,104 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::performUpsampling (PointCloudOut &
       p.x = pos[0];
       p.y = pos[1];
       p.z = pos[2];
+      samples.points.push_back (p);
+    }
+
+    projectSamples (samples, output, nr_threads);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::MovingLeastSquares<PointInT, PointOutT>::projectSamples (const PointCloudIn &samples, PointCloudOut &output, unsigned int nr_threads)
+{
+  // Project every sample into its own slot, then append the valid ones in the order of the samples
+  const int nr_samples = static_cast<int> (samples.size ());
+  PointCloudOut projected (nr_samples, 1);
+  NormalCloud projected_normals (compute_normals_ ? nr_samples : 0, 1);
+  std::vector<int> input_indices (nr_samples, -1);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads (nr_threads)
+#endif
+  {
+    std::vector<int> nn_indices;
+    std::vector<float> nn_dists;
+
+#ifdef _OPENMP
+#pragma omp for schedule (dynamic,1000)
+#endif
+    for (int si = 0; si < nr_samples; ++si)
+    {
+      // Samples may have nan points, skip them
+      if (!pcl_isfinite (samples.points[si].x))
+        continue;
 
-      std::vector<int> nn_indices;
-      std::vector<float> nn_dists;
-      tree_->nearestKSearch (p, 1, nn_indices, nn_dists);
+      if (tree_->nearestKSearch (samples.points[si], 1, nn_indices, nn_dists) == 0)
+        continue;
       int input_index = nn_indices.front ();
 
       // If the closest point did not have a valid MLS fitting result
       // OR if it is too far away from the sampled point
-      if (mls_results_[input_index].valid == false)
+      const MLSResult &mls_result = mls_results_[input_index];
+      if (mls_result.valid == false)
         continue;
 
-      Eigen::Vector3d add_point = p.getVector3fMap ().template cast<double> ();
-      float u_disp = static_cast<float> ((add_point - mls_results_[input_index].mean).dot (mls_results_[input_index].u_axis)),
-            v_disp = static_cast<float> ((add_point - mls_results_[input_index].mean).dot (mls_results_[input_index].v_axis));
+      Eigen::Vector3d add_point = samples.points[si].getVector3fMap ().template cast<double> ();
+      float u_disp = static_cast<float> ((add_point - mls_result.mean).dot (mls_result.u_axis)),
+            v_disp = static_cast<float> ((add_point - mls_result.mean).dot (mls_result.v_axis));
 
-      PointOutT result_point;
       pcl::Normal result_normal;
       projectPointToMLSSurface (u_disp, v_disp,
-                                mls_results_[input_index].u_axis, mls_results_[input_index].v_axis,
-                                mls_results_[input_index].plane_normal,
-                                mls_results_[input_index].mean,
-                                mls_results_[input_index].curvature,
-                                mls_results_[input_index].c_vec,
-                                mls_results_[input_index].num_neighbors,
-                                result_point, result_normal);
+                                mls_result.u_axis, mls_result.v_axis,
+                                mls_result.plane_normal,
+                                mls_result.mean,
+                                mls_result.curvature,
+                                mls_result.c_vec,
+                                mls_result.num_neighbors,
+                                projected.points[si], result_normal);
 
       // Copy additional point information if available
-      copyMissingFields (input_->points[input_index], result_point);
+      copyMissingFields (input_->points[input_index], projected.points[si]);
+      if (compute_normals_)
+        projected_normals.points[si] = result_normal;
 
       // Store the id of the original point
-      corresponding_input_indices_->indices.push_back (input_index);
+      input_indices[si] = input_index;
+    }
+  }
 
-      output.push_back (result_point);
+  for (int si = 0; si < nr_samples; ++si)
+  {
+    if (input_indices[si] < 0)
+      continue;
 
-      if (compute_normals_)
-        normals_->push_back (result_normal);
-    }
+    corresponding_input_indices_->indices.push_back (input_indices[si]);
+    output.push_back (projected.points[si]);
+    if (compute_normals_)
+      normals_->push_back (projected_normals.points[si]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::MovingLeastSquares<PointInT, PointOutT>::MLSWorkspace::reserve (int nr_neighbors, int nr_coeff)
+{
+  // Only grow the buffers, so that they stop reallocating after the largest neighborhood was seen
+  if (static_cast<int> (de_meaned.size ()) < nr_neighbors)
+    de_meaned.resize (nr_neighbors);
+  if (P.rows () != nr_coeff || P.cols () < nr_neighbors)
+  {
+    const int cols = std::max (nr_neighbors, static_cast<int> (P.cols ()));
+    P.resize (nr_coeff, cols);
+    P_weight.resize (nr_coeff, cols);
+  }
+  if (weight_vec.size () < nr_neighbors)
+  {
+    weight_vec.resize (nr_neighbors);
+    f_vec.resize (nr_neighbors);
   }
+  P_weight_Pt.resize (nr_coeff, nr_coeff);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
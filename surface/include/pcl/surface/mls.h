@@ -49,6 +49,7 @@
 #include <pcl/surface/eigen.h>
 #include <pcl/surface/processing.h>
 #include <map>
+#include <ctime>
 
 namespace pcl
 {
@@ -89,6 +90,8 @@ namespace pcl
 
       typedef boost::function<int (int, double, std::vector<int> &, std::vector<float> &)> SearchMethod;
 
+      typedef boost::shared_ptr<const std::vector<std::vector<int> > > NeighborhoodsConstPtr;
+
       enum UpsamplingMethod {NONE, DISTINCT_CLOUD, SAMPLE_LOCAL_PLANE, RANDOM_UNIFORM_DENSITY, VOXEL_GRID_DILATION};
 
       /** \brief Empty constructor. */
@@ -111,8 +114,10 @@ namespace pcl
                               dilation_iteration_num_ (0),
                               nr_coeff_ (),
                               corresponding_input_indices_ (),
+                              neighborhoods_ (),
                               rng_alg_ (),
-                              rng_uniform_distribution_ ()
+                              rng_seed_ (0),
+                              seed_ (static_cast<unsigned int> (time (NULL)))
                               {};
       
       /** \brief Empty destructor */
@@ -141,6 +146,19 @@ namespace pcl
       inline KdTreePtr 
       getSearchMethod () { return (tree_); }
 
+      /** \brief Provide precomputed neighborhoods, e.g. the ones of a previous normal estimation run with the same
+        * radius, so that no radius search is needed. Unless the DISTINCT_CLOUD or VOXEL_GRID_DILATION upsampling
+        * methods are used, no search tree is built either.
+        * \param[in] neighborhoods the indices of the neighbors within the search radius of every point given by
+        * <setInputCloud (), setIndices ()>, in the same order as the indices (set to an empty pointer to search again)
+        */
+      inline void
+      setNeighborhoods (const NeighborhoodsConstPtr &neighborhoods) { neighborhoods_ = neighborhoods; }
+
+      /** \brief Get the precomputed neighborhoods, if any. */
+      inline NeighborhoodsConstPtr
+      getNeighborhoods () const { return (neighborhoods_); }
+
       /** \brief Set the order of the polynomial to be fit.
         * \param[in] order the order of the polynomial
         */
@@ -256,6 +274,20 @@ namespace pcl
       inline int
       getPointDensity () { return desired_num_points_in_radius_; }
 
+      /** \brief Set the seed of the random samples. Two calls of process () with the same seed and the same
+        * input give the same output, whatever the number of threads. The default seed is the time of construction.
+        * \note Used only in the case of RANDOM_UNIFORM_DENSITY upsampling
+        * \param[in] seed the seed of the random number generator
+        */
+      inline void
+      setSeed (unsigned int seed) { seed_ = seed; }
+
+      /** \brief Get the seed of the random samples.
+        * \note Used only in the case of RANDOM_UNIFORM_DENSITY upsampling
+        */
+      inline unsigned int
+      getSeed () const { return (seed_); }
+
       /** \brief Set the voxel size for the voxel grid
         * \note Used only in the VOXEL_GRID_DILATION upsampling method
         * \param[in] voxel_size the edge length of a cubic voxel in the voxel grid
@@ -438,6 +470,38 @@ namespace pcl
       /** \brief Collects for each point in output the corrseponding point in the input. */
       PointIndicesPtr corresponding_input_indices_;
 
+      /** \brief Precomputed neighborhoods of the points given by indices_, if set. */
+      NeighborhoodsConstPtr neighborhoods_;
+
+      /** \brief Scratch space for the polynomial fit, reused for all the points processed by one thread. */
+      struct MLSWorkspace
+      {
+        MLSWorkspace () : nn_indices (), nn_sqr_dists (), de_meaned (), weight_vec (), f_vec (), c_vec (), 
+                          P (), P_weight (), P_weight_Pt (), llt (), rng () {}
+
+        /** \brief Make room for the fit of \a nr_neighbors neighbors with \a nr_coeff coefficients. */
+        void
+        reserve (int nr_neighbors, int nr_coeff);
+
+        std::vector<int> nn_indices;
+        std::vector<float> nn_sqr_dists;
+        std::vector<Eigen::Vector3d> de_meaned;
+        Eigen::VectorXd weight_vec, f_vec, c_vec;
+        Eigen::MatrixXd P, P_weight, P_weight_Pt;
+        Eigen::LLT<Eigen::MatrixXd> llt;
+        boost::mt19937 rng;
+      };
+
+      /** \brief Get the neighborhood of the cp-th point of indices_, either from the precomputed neighborhoods or
+        * by a radius search.
+        * \param[in] cp the position of the query point in indices_
+        * \param[in,out] workspace the workspace holding the search results; its squared distances are resized to
+        * the number of neighbors
+        * \return a pointer to the neighbor indices, or NULL if the search failed
+        */
+      const std::vector<int>*
+      getNeighborhood (int cp, MLSWorkspace &workspace) const;
+
       /** \brief Search for the closest nearest neighbors of a given point using a radius search
         * \param[in] index the index of the query point
         * \param[out] indices the resultant vector of indices representing the k-nearest neighbors
@@ -470,6 +534,27 @@ namespace pcl
                              PointIndices &corresponding_input_indices,
                              MLSResult &mls_result) const;
 
+      /** \brief Smooth a given point and its neighborghood using Moving Least Squares, reusing the matrices of
+        * \a workspace for the polynomial fit instead of allocating them.
+        * \param[in] index the inex of the query point in the input cloud
+        * \param[in] nn_indices the set of nearest neighbors indices for pt
+        * \param[in] nn_sqr_dists the set of nearest neighbors squared distances for pt
+        * \param[out] projected_points the set of points projected points around the query point
+        * \param[out] projected_points_normals the normals corresponding to the projected points
+        * \param[out] corresponding_input_indices the set of indices with each point in output having the corresponding point in input
+        * \param[out] mls_result stores the MLS result for each point in the input cloud
+        * \param[in,out] workspace the scratch space of the calling thread
+        */
+      void
+      computeMLSPointNormal (int index,
+                             const std::vector<int> &nn_indices,
+                             std::vector<float> &nn_sqr_dists,
+                             PointCloudOut &projected_points,
+                             NormalCloud &projected_points_normals,
+                             PointIndices &corresponding_input_indices,
+                             MLSResult &mls_result,
+                             MLSWorkspace &workspace) const;
+
       /** \brief Fits a point (sample point) given in the local plane coordinates of an input point (query point) to
         * the MLS surface of the input point
         * \param[in] u_disp the u coordinate of the sample point in the local plane of the query point
@@ -485,12 +570,12 @@ namespace pcl
         * \param[out] result_normal the normal of the resulting projected point
         */
       void
-      projectPointToMLSSurface (float &u_disp, float &v_disp,
-                                Eigen::Vector3d &u_axis, Eigen::Vector3d &v_axis,
-                                Eigen::Vector3d &n_axis,
-                                Eigen::Vector3d &mean,
-                                float &curvature,
-                                Eigen::VectorXd &c_vec,
+      projectPointToMLSSurface (const float &u_disp, const float &v_disp,
+                                const Eigen::Vector3d &u_axis, const Eigen::Vector3d &v_axis,
+                                const Eigen::Vector3d &n_axis,
+                                const Eigen::Vector3d &mean,
+                                const float &curvature,
+                                const Eigen::VectorXd &c_vec,
                                 int num_neighbors,
                                 PointOutT &result_point,
                                 pcl::Normal &result_normal) const;
@@ -506,19 +591,31 @@ namespace pcl
 
       /** \brief Perform upsampling for the distinct-cloud and voxel-grid methods
         * \param[out] output the result of the reconstruction
+        * \param[in] nr_threads the number of threads used to project the samples to the MLS surface
        */
-      void performUpsampling (PointCloudOut &output);
+      void performUpsampling (PointCloudOut &output, unsigned int nr_threads = 1);
+
+      /** \brief Project sample points to the MLS surface of their closest input point and append them to the output
+        * \param[in] samples the sample points; non-finite ones are skipped
+        * \param[out] output the result of the reconstruction
+        * \param[in] nr_threads the number of threads to use
+        */
+      void projectSamples (const PointCloudIn &samples, PointCloudOut &output, unsigned int nr_threads);
 
     private:
       /** \brief Boost-based random number generator algorithm. */
       boost::mt19937 rng_alg_;
 
-      /** \brief Random number generator using an uniform distribution of floats
+      /** \brief Seed drawn from \a rng_alg_ for every call of process (); the random samples of each point are
+        * generated from this seed and the point index, so that they do not depend on the thread layout.
+        * \note Used only in the case of RANDOM_UNIFORM_DENSITY upsampling
+        */
+      boost::uint32_t rng_seed_;
+
+      /** \brief Seed of \a rng_alg_, set with setSeed ().
         * \note Used only in the case of RANDOM_UNIFORM_DENSITY upsampling
         */
-      boost::shared_ptr<boost::variate_generator<boost::mt19937&, 
-                                                 boost::uniform_real<float> > 
-                       > rng_uniform_distribution_;
+      unsigned int seed_;
 
       /** \brief Abstract class get name method. */
       std::string getClassName () const { return ("MovingLeastSquares"); }
@@ -530,7 +627,8 @@ namespace pcl
 #ifdef _OPENMP
   /** \brief MovingLeastSquaresOMP is a parallelized version of MovingLeastSquares, using the OpenMP standard.
    * \note Compared to MovingLeastSquares, an overhead is incurred in terms of runtime and memory usage.
-   * \note The upsampling methods DISTINCT_CLOUD and VOXEL_GRID_DILATION are not parallelized completely, i.e. parts of the algorithm run on a single thread only.
+   * \note The output points are in the same order as with MovingLeastSquares. For the VOXEL_GRID_DILATION upsampling
+   * method only the construction and dilation of the voxel grid run on a single thread.
    * \author Robert Huitl
    * \ingroup surface
    */
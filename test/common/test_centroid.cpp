@@ -779,6 +779,60 @@ TEST (PCL, computeMeanAndCovariance)
   EXPECT_EQ (covariance_matrix (2, 2), 1);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, computeMeanAndCovarianceBatch)
+{
+  PointCloud<PointXYZ> cloud;
+  for (int i = 0; i < 200; ++i)
+    cloud.push_back (PointXYZ (static_cast<float> (i % 7) * 0.3f + 10.0f,
+                               static_cast<float> (i % 11) * 0.1f,
+                               static_cast<float> ((i * i) % 13) * 0.2f - 5.0f));
+  cloud.points[17].x = std::numeric_limits<float>::quiet_NaN ();
+  cloud.is_dense = false;
+
+  // neighborhoods of varying size, including an empty one and one with invalid points only
+  std::vector<int> indices;
+  std::vector<int> offsets (1, 0);
+  for (int n = 0; n < 3 * PCL_COVARIANCE_BATCH_WIDTH + 1; ++n)
+  {
+    int size = (n == 2) ? 0 : (n * 5) % 23;
+    for (int i = 0; i < size; ++i)
+      indices.push_back ((n * 13 + i * 3) % static_cast<int> (cloud.size ()));
+    if (n == 4)
+      indices.push_back (17);
+    if (n == 5)
+    {
+      indices.resize (offsets.back ());
+      indices.push_back (17);
+    }
+    offsets.push_back (static_cast<int> (indices.size ()));
+  }
+
+  std::vector<Eigen::Matrix3f> covariance_matrices;
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > centroids;
+  std::vector<unsigned int> point_counts;
+  computeMeanAndCovarianceMatrixBatch (cloud, indices, offsets, covariance_matrices, centroids, point_counts);
+  ASSERT_EQ (covariance_matrices.size (), offsets.size () - 1);
+
+  Eigen::Matrix3f covariance_matrix;
+  Eigen::Vector4f centroid;
+  for (size_t n = 0; n + 1 < offsets.size (); ++n)
+  {
+    std::vector<int> neighborhood (indices.begin () + offsets[n], indices.begin () + offsets[n + 1]);
+    unsigned int count = computeMeanAndCovarianceMatrix (cloud, neighborhood, covariance_matrix, centroid);
+    EXPECT_EQ (point_counts[n], count);
+    if (count == 0)
+    {
+      EXPECT_FALSE (pcl_isfinite (centroids[n][0]));
+      continue;
+    }
+    for (int i = 0; i < 9; ++i)
+      EXPECT_NEAR (covariance_matrices[n].coeff (i), covariance_matrix.coeff (i), 1e-4);
+    for (int i = 0; i < 4; ++i)
+      EXPECT_NEAR (centroids[n][i], centroid[i], 1e-4);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, CentroidPoint)
 {
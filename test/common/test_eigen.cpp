@@ -799,6 +799,42 @@ TEST (PCL, eigen33f)
   EXPECT_LE (float(r_fail_count) / float(iterations), 0.01);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, eigen33Batch)
+{
+  typedef double Scalar;
+  typedef Eigen::Matrix<Scalar, 3, 3> Matrix;
+  typedef Eigen::Matrix<Scalar, 3, 1> Vector;
+
+  // not a multiple of the batch width, so the last batch is partially filled
+  const unsigned count = 1000 * PCL_COVARIANCE_BATCH_WIDTH + 3;
+  std::vector<Matrix> matrices (count);
+  for (unsigned idx = 0; idx < count; ++idx)
+    generateSymPosMatrix3x3 (matrices[idx]);
+  matrices[0].setZero ();
+  matrices[1] = Matrix::Identity ();
+
+  std::vector<Vector> eigenvalues, smallest, largest;
+  eigen33Batch (matrices, eigenvalues, smallest, 0);
+  eigen33Batch (matrices, eigenvalues, largest, 2);
+  ASSERT_EQ (eigenvalues.size (), count);
+  ASSERT_EQ (smallest.size (), count);
+
+  const Scalar epsilon = 2e-5;
+  Vector values;
+  for (unsigned idx = 0; idx < count; ++idx)
+  {
+    eigen33 (matrices[idx], values);
+    EXPECT_LE ((eigenvalues[idx] - values).cwiseAbs ().sum (), epsilon);
+
+    // eigenvectors of repeated eigenvalues are not unique, so test M * v = lambda * v
+    EXPECT_NEAR (smallest[idx].norm (), 1.0, epsilon);
+    EXPECT_NEAR (largest[idx].norm (), 1.0, epsilon);
+    EXPECT_LE ((matrices[idx] * smallest[idx] - eigenvalues[idx][0] * smallest[idx]).cwiseAbs ().sum (), epsilon);
+    EXPECT_LE ((matrices[idx] * largest[idx] - eigenvalues[idx][2] * largest[idx]).cwiseAbs ().sum (), epsilon);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, transformLine)
 {
@@ -152,6 +152,94 @@ TEST (PCL, BaseFeature)
   EXPECT_NEAR (curvature, 0.0693136, 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Minimal estimator for the parallel driver: counts the points of every thread in its scratch buffers, and raises
+// an InitFailedException at one point
+class ParallelFeatureTester : public Feature<PointXYZ, PointXYZ>
+{
+  public:
+    ParallelFeatureTester (int fail_index = -1) : nr_scratch_ (0), fail_index_ (fail_index)
+    {
+      feature_name_ = "ParallelFeatureTester";
+    }
+
+    mutable int nr_scratch_;
+
+  protected:
+    struct Scratch : public ThreadScratch
+    {
+      Scratch () : nr_points (0) {}
+
+      int nr_points;
+    };
+
+    virtual ThreadScratchPtr
+    createThreadScratch () const
+    {
+#pragma omp critical (parallel_feature_tester)
+      ++nr_scratch_;
+      return (ThreadScratchPtr (new Scratch));
+    }
+
+    virtual bool
+    computePointFeature (size_t index, ThreadContext &context, PointXYZ &output_point) const
+    {
+      if (static_cast<int> (index) == fail_index_)
+        throw InitFailedException ("point failed");
+      Scratch &scratch = static_cast<Scratch&> (*context.scratch);
+      output_point.x = static_cast<float> (++scratch.nr_points);
+      output_point.y = output_point.z = 0.0f;
+      return (true);
+    }
+
+  private:
+    virtual void
+    computeFeature (PointCloudOut &output)
+    {
+      computeFeatureParallel (output, 4);
+    }
+
+    int fail_index_;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, FeatureParallelDriver)
+{
+  PointCloud<PointXYZ> output;
+  ParallelFeatureTester tester;
+  tester.setInputCloud (cloud.makeShared ());
+  tester.setSearchMethod (tree);
+  tester.setKSearch (1);
+  tester.compute (output);
+
+  // One scratch per thread, reused for all of the points of that thread
+  ASSERT_EQ (output.size (), cloud.size ());
+  EXPECT_GE (tester.nr_scratch_, 1);
+  EXPECT_LE (tester.nr_scratch_, 4);
+  float nr_points = 0.0f;
+  for (size_t i = 0; i < output.size (); ++i)
+  {
+    EXPECT_GE (output[i].x, 1.0f);
+    nr_points = std::max (nr_points, output[i].x);
+  }
+  EXPECT_GE (nr_points, static_cast<float> (cloud.size ()) / static_cast<float> (tester.nr_scratch_));
+
+  // The exception of a thread reaches the caller with its own class
+  ParallelFeatureTester failing_tester (static_cast<int> (cloud.size ()) / 2);
+  failing_tester.setInputCloud (cloud.makeShared ());
+  failing_tester.setSearchMethod (tree);
+  failing_tester.setKSearch (1);
+  EXPECT_THROW (failing_tester.compute (output), InitFailedException);
+  try
+  {
+    failing_tester.compute (output);
+  }
+  catch (const PCLException &e)
+  {
+    EXPECT_NE (std::string (e.what ()).find ("point failed"), std::string::npos);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
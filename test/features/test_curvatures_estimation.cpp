@@ -41,6 +41,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/principal_curvatures.h>
+#include <pcl/features/principal_curvatures_omp.h>
 #include <pcl/io/pcd_io.h>
 
 using namespace pcl;
@@ -143,6 +144,48 @@ TEST (PCL, PrincipalCurvaturesEstimation)
   EXPECT_NEAR (pcs->points[indices.size () - 1].pc2, 0.17906941473484039, 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PrincipalCurvaturesEstimationOpenMP)
+{
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  n.setInputCloud (cloud.makeShared ());
+  boost::shared_ptr<vector<int> > indicesptr (new vector<int> (indices));
+  n.setIndices (indicesptr);
+  n.setSearchMethod (tree);
+  n.setKSearch (10);
+  n.compute (*normals);
+
+  PrincipalCurvaturesEstimation<PointXYZ, Normal, PrincipalCurvatures> pc;
+  pc.setInputCloud (cloud.makeShared ());
+  pc.setInputNormals (normals);
+  pc.setIndices (indicesptr);
+  pc.setSearchMethod (tree);
+  pc.setKSearch (10);
+
+  PrincipalCurvaturesEstimationOMP<PointXYZ, Normal, PrincipalCurvatures> pc_omp (4);
+  pc_omp.setInputCloud (cloud.makeShared ());
+  pc_omp.setInputNormals (normals);
+  pc_omp.setIndices (indicesptr);
+  pc_omp.setSearchMethod (tree);
+  pc_omp.setKSearch (10);
+
+  PointCloud<PrincipalCurvatures> pcs, pcs_omp;
+  pc.compute (pcs);
+  pc_omp.compute (pcs_omp);
+
+  ASSERT_EQ (pcs_omp.points.size (), pcs.points.size ());
+  EXPECT_EQ (pcs_omp.is_dense, pcs.is_dense);
+  for (size_t i = 0; i < pcs.points.size (); ++i)
+  {
+    EXPECT_EQ (pcs_omp.points[i].principal_curvature[0], pcs.points[i].principal_curvature[0]);
+    EXPECT_EQ (pcs_omp.points[i].principal_curvature[1], pcs.points[i].principal_curvature[1]);
+    EXPECT_EQ (pcs_omp.points[i].principal_curvature[2], pcs.points[i].principal_curvature[2]);
+    EXPECT_EQ (pcs_omp.points[i].pc1, pcs.points[i].pc1);
+    EXPECT_EQ (pcs_omp.points[i].pc2, pcs.points[i].pc2);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
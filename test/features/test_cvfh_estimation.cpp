@@ -41,6 +41,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/cvfh.h>
+#include <pcl/features/batch_global_feature.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/filters/voxel_grid.h>
 
@@ -119,6 +120,75 @@ TEST (PCL, CVFHEstimationMilk)
   EXPECT_EQ (static_cast<int>(vfhs->points.size ()), 2);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+search::Search<PointXYZ>::Ptr
+makeKdTree ()
+{
+  return (search::Search<PointXYZ>::Ptr (new search::KdTree<PointXYZ> ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, CVFHEstimationBatch)
+{
+  typedef CVFHEstimation<PointXYZ, Normal, VFHSignature308> CVFH;
+
+  vector<PointCloud<PointXYZ>::ConstPtr> clouds;
+  clouds.push_back (cloud.makeShared ());
+  clouds.push_back (cloud_milk);
+  clouds.push_back (cloud_milk);
+
+  vector<PointCloud<Normal>::ConstPtr> normals;
+  for (size_t i = 0; i < clouds.size (); ++i)
+  {
+    NormalEstimation<PointXYZ, Normal> n;
+    PointCloud<Normal>::Ptr cloud_normals (new PointCloud<Normal> ());
+    n.setInputCloud (clouds[i]);
+    n.setRadiusSearch (leaf_size_ * 4);
+    n.compute (*cloud_normals);
+    normals.push_back (cloud_normals);
+  }
+
+  CVFH cvfh;
+  cvfh.setClusterTolerance (leaf_size_ * 3);
+  cvfh.setEPSAngleThreshold (0.13f);
+  cvfh.setCurvatureThreshold (0.025f);
+  cvfh.setNormalizeBins (false);
+  cvfh.setRadiusNormals (leaf_size_ * 4);
+
+  BatchGlobalFeatureEstimation<PointXYZ, VFHSignature308, CVFH> batch;
+  batch.setEstimator (cvfh);
+  batch.setNumberOfThreads (2);
+  vector<PointCloud<VFHSignature308> > batch_vfhs;
+  batch.compute (clouds, normals, batch_vfhs);
+  ASSERT_EQ (batch_vfhs.size (), clouds.size ());
+
+  // Every copy of the estimator gets its own kd-tree from the factory
+  batch.setSearchMethodFactory (&makeKdTree);
+  vector<PointCloud<VFHSignature308> > kdtree_vfhs;
+  batch.compute (clouds, normals, kdtree_vfhs);
+  ASSERT_EQ (kdtree_vfhs.size (), clouds.size ());
+
+  // The same estimator is reused for all clouds, which must not leak state between calls
+  for (size_t i = 0; i < clouds.size (); ++i)
+  {
+    PointCloud<VFHSignature308> vfhs;
+    cvfh.setInputCloud (clouds[i]);
+    cvfh.setInputNormals (normals[i]);
+    cvfh.compute (vfhs);
+
+    ASSERT_EQ (batch_vfhs[i].points.size (), vfhs.points.size ());
+    for (size_t j = 0; j < vfhs.points.size (); ++j)
+      for (int d = 0; d < 308; ++d)
+        EXPECT_NEAR (batch_vfhs[i].points[j].histogram[d], vfhs.points[j].histogram[d], 1e-4);
+
+    ASSERT_EQ (kdtree_vfhs[i].points.size (), vfhs.points.size ());
+    for (size_t j = 0; j < vfhs.points.size (); ++j)
+      for (int d = 0; d < 308; ++d)
+        EXPECT_NEAR (kdtree_vfhs[i].points[j].histogram[d], vfhs.points[j].histogram[d], 1e-4);
+  }
+  EXPECT_EQ (static_cast<int> (batch_vfhs[1].points.size ()), 2);
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
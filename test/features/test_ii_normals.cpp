@@ -506,6 +506,142 @@ TEST (PCL, IINormalEstimationSimple3DGradientUnorganized)
   EXPECT_EQ (output.height, 0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IntegralImageSinglePrecision)
+{
+  const unsigned width = 640;
+  const unsigned height = 480;
+  IntegralImage2D<float, 1> integral_image_double (true);
+  IntegralImage2D<float, 1, float> integral_image_float (true);
+
+  // small, roughly zero mean values as produced by image derivatives
+  std::vector<float> data (width * height);
+  for (unsigned yIdx = 0; yIdx < height; ++yIdx)
+    for (unsigned xIdx = 0; xIdx < width; ++xIdx)
+      data[width * yIdx + xIdx] = 0.01f * sinf (0.1f * static_cast<float> (xIdx)) * cosf (0.07f * static_cast<float> (yIdx)) + 0.001f;
+
+  integral_image_double.setInput (&data[0], width, height, 1, width);
+  integral_image_float.setNumberOfThreads (4);
+  integral_image_float.setInput (&data[0], width, height, 1, width);
+
+  // the error of a rectangle sum is a few float ulps of the prefix sums at its corners, not of the sum itself:
+  // here the prefix sums grow to about 300 (first order) and 8 (second order)
+  for (unsigned yIdx = 0; yIdx < height - 7; yIdx += 3)
+  {
+    for (unsigned xIdx = 0; xIdx < width - 7; xIdx += 3)
+    {
+      EXPECT_EQ (integral_image_double.getFiniteElementsCount (xIdx, yIdx, 7, 7), integral_image_float.getFiniteElementsCount (xIdx, yIdx, 7, 7));
+      EXPECT_NEAR (integral_image_double.getFirstOrderSum (xIdx, yIdx, 7, 7), integral_image_float.getFirstOrderSum (xIdx, yIdx, 7, 7), 5e-4);
+      EXPECT_NEAR (integral_image_double.getSecondOrderSum (xIdx, yIdx, 7, 7), integral_image_float.getSecondOrderSum (xIdx, yIdx, 7, 7), 1e-5);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IINormalEstimationOpenMP)
+{
+  // a slanted, curved surface with a missing patch and a depth discontinuity
+  PointCloud<PointXYZ>::Ptr surface (new PointCloud<PointXYZ> (320, 240));
+  for (unsigned v = 0; v < surface->height; ++v)
+  {
+    for (unsigned u = 0; u < surface->width; ++u)
+    {
+      PointXYZ &point = (*surface) (u, v);
+      point.z = 1.5f + 0.2f * sinf (0.02f * static_cast<float> (u)) * cosf (0.03f * static_cast<float> (v));
+      if (u > 160 && v > 120)
+        point.z += 0.5f;
+      point.x = (static_cast<float> (u) - 160.0f) * point.z / 525.0f;
+      point.y = (static_cast<float> (v) - 120.0f) * point.z / 525.0f;
+      if (u > 10 && u < 30 && v > 50 && v < 70)
+        point.x = point.y = point.z = std::numeric_limits<float>::quiet_NaN ();
+    }
+  }
+  surface->is_dense = false;
+
+  IntegralImageNormalEstimation<PointXYZ, Normal>::NormalEstimationMethod methods[] =
+    { ne.COVARIANCE_MATRIX, ne.AVERAGE_3D_GRADIENT, ne.AVERAGE_DEPTH_CHANGE, ne.SIMPLE_3D_GRADIENT };
+  for (int method = 0; method < 4; ++method)
+  {
+    for (int mirror = 0; mirror < 2; ++mirror)
+    {
+      if (methods[method] == ne.SIMPLE_3D_GRADIENT && mirror)
+        continue;
+
+      PointCloud<Normal> serial, parallel;
+      IntegralImageNormalEstimation<PointXYZ, Normal> ne_serial, ne_parallel;
+      ne_serial.setNormalEstimationMethod (methods[method]);
+      ne_parallel.setNormalEstimationMethod (methods[method]);
+      ne_serial.setBorderPolicy (mirror ? ne.BORDER_POLICY_MIRROR : ne.BORDER_POLICY_IGNORE);
+      ne_parallel.setBorderPolicy (mirror ? ne.BORDER_POLICY_MIRROR : ne.BORDER_POLICY_IGNORE);
+      ne_serial.setDepthDependentSmoothing (true);
+      ne_parallel.setDepthDependentSmoothing (true);
+      ne_parallel.setNumberOfThreads (4);
+      ne_serial.setInputCloud (surface);
+      ne_parallel.setInputCloud (surface);
+      ne_serial.compute (serial);
+      ne_parallel.compute (parallel);
+
+      ASSERT_EQ (serial.points.size (), parallel.points.size ());
+      for (size_t i = 0; i < serial.points.size (); ++i)
+      {
+        if (!pcl_isfinite (serial.points[i].normal_x))
+        {
+          EXPECT_FALSE (pcl_isfinite (parallel.points[i].normal_x));
+          continue;
+        }
+        // the result does not depend on the number of threads
+        EXPECT_EQ (serial.points[i].normal_x, parallel.points[i].normal_x);
+        EXPECT_EQ (serial.points[i].normal_y, parallel.points[i].normal_y);
+        EXPECT_EQ (serial.points[i].normal_z, parallel.points[i].normal_z);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IINormalEstimationSinglePrecisionVGA)
+{
+  // the surface of IINormalEstimationOpenMP on a full VGA frame, where the prefix sums are the largest
+  PointCloud<PointXYZ>::Ptr surface (new PointCloud<PointXYZ> (640, 480));
+  for (unsigned v = 0; v < surface->height; ++v)
+  {
+    for (unsigned u = 0; u < surface->width; ++u)
+    {
+      PointXYZ &point = (*surface) (u, v);
+      point.z = 1.5f + 0.2f * sinf (0.01f * static_cast<float> (u)) * cosf (0.015f * static_cast<float> (v));
+      if (u > 320 && v > 240)
+        point.z += 0.5f;
+      point.x = (static_cast<float> (u) - 320.0f) * point.z / 525.0f;
+      point.y = (static_cast<float> (v) - 240.0f) * point.z / 525.0f;
+      if (u > 20 && u < 60 && v > 100 && v < 140)
+        point.x = point.y = point.z = std::numeric_limits<float>::quiet_NaN ();
+    }
+  }
+  surface->is_dense = false;
+
+  // single precision gradient images stay close to the double precision ones
+  PointCloud<Normal> normals_double, normals_float;
+  IntegralImageNormalEstimation<PointXYZ, Normal> ne_double, ne_float;
+  ne_double.setNormalEstimationMethod (ne.AVERAGE_3D_GRADIENT);
+  ne_float.setNormalEstimationMethod (ne.AVERAGE_3D_GRADIENT);
+  ne_float.setSinglePrecisionGradients (true);
+  ne_float.setNumberOfThreads (4);
+  ne_double.setInputCloud (surface);
+  ne_float.setInputCloud (surface);
+  ne_double.compute (normals_double);
+  ne_float.compute (normals_float);
+
+  ASSERT_EQ (normals_double.points.size (), normals_float.points.size ());
+  for (size_t i = 0; i < normals_double.points.size (); ++i)
+  {
+    if (!pcl_isfinite (normals_double.points[i].normal_x))
+      continue;
+    EXPECT_NEAR (normals_double.points[i].normal_x, normals_float.points[i].normal_x, 5e-3);
+    EXPECT_NEAR (normals_double.points[i].normal_y, normals_float.points[i].normal_y, 5e-3);
+    EXPECT_NEAR (normals_double.points[i].normal_z, normals_float.points[i].normal_z, 5e-3);
+  }
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -41,6 +41,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/normal_3d_omp.h>
+#include <pcl/features/normal_3d_multiscale.h>
 #include <pcl/io/pcd_io.h>
 
 using namespace pcl;
@@ -213,6 +214,94 @@ TEST (PCL, NormalEstimationOpenMP)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, NormalEstimationBatch)
+{
+  NormalEstimation<PointXYZ, Normal> n;
+  NormalEstimationOMP<PointXYZ, Normal> n_omp (4);
+  PointCloud<Normal> normals, normals_batch, normals_omp_batch;
+
+  n.setInputCloud (cloud.makeShared ());
+  n.setSearchMethod (tree);
+  n.setKSearch (10);
+  n.compute (normals);
+
+  EXPECT_EQ (n.getBatchSize (), 0u);
+  n.setBatchSize (17);
+  EXPECT_EQ (n.getBatchSize (), 17u);
+  n.compute (normals_batch);
+
+  n_omp.setInputCloud (cloud.makeShared ());
+  n_omp.setSearchMethod (tree);
+  n_omp.setKSearch (10);
+  n_omp.setBatchSize (64);
+  n_omp.compute (normals_omp_batch);
+
+  ASSERT_EQ (normals_batch.size (), normals.size ());
+  ASSERT_EQ (normals_omp_batch.size (), normals.size ());
+  for (size_t i = 0; i < normals.size (); ++i)
+  {
+    for (int d = 0; d < 3; ++d)
+    {
+      EXPECT_NEAR (normals_batch[i].normal[d], normals[i].normal[d], 1e-3);
+      EXPECT_NEAR (normals_omp_batch[i].normal[d], normals[i].normal[d], 1e-3);
+    }
+    EXPECT_NEAR (normals_batch[i].curvature, normals[i].curvature, 1e-3);
+    EXPECT_NEAR (normals_omp_batch[i].curvature, normals[i].curvature, 1e-3);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MultiscaleNormalEstimation)
+{
+  std::vector<float> scales;
+  scales.push_back (0.02f);
+  scales.push_back (0.005f);
+  scales.push_back (0.01f);
+
+  MultiscaleNormalEstimation<PointXYZ, Normal> n_multi;
+  n_multi.setInputCloud (cloud.makeShared ());
+  n_multi.setSearchMethod (tree);
+  n_multi.setScales (scales);
+  EXPECT_EQ (n_multi.getScales ().size (), scales.size ());
+
+  std::vector<PointCloud<Normal>::Ptr> normals_multi;
+  n_multi.compute (normals_multi);
+  ASSERT_EQ (normals_multi.size (), scales.size ());
+
+  // Every scale must match a separate estimation at that radius
+  NormalEstimation<PointXYZ, Normal> n;
+  n.setInputCloud (cloud.makeShared ());
+  n.setSearchMethod (tree);
+  for (size_t s = 0; s < scales.size (); ++s)
+  {
+    PointCloud<Normal> normals;
+    n.setRadiusSearch (scales[s]);
+    n.compute (normals);
+
+    // The moments are accumulated in double precision around the query point, which differs from the single
+    // precision covariance of NormalEstimation by up to 1e-2 for neighborhoods of only three points
+    ASSERT_EQ (normals_multi[s]->size (), normals.size ());
+    for (size_t i = 0; i < normals.size (); ++i)
+    {
+      if (!pcl_isfinite (normals[i].curvature))
+      {
+        EXPECT_FALSE (pcl_isfinite ((*normals_multi[s])[i].curvature));
+        EXPECT_FALSE (normals_multi[s]->is_dense);
+        continue;
+      }
+      for (int d = 0; d < 3; ++d)
+        EXPECT_NEAR ((*normals_multi[s])[i].normal[d], normals[i].normal[d], 1e-2);
+      EXPECT_NEAR ((*normals_multi[s])[i].curvature, normals[i].curvature, 1e-3);
+    }
+  }
+
+  // Without scales there is nothing to compute
+  n_multi.setScales (std::vector<float> ());
+  n_multi.compute (normals_multi);
+  EXPECT_EQ (normals_multi.size (), 0u);
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
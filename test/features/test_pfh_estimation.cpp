@@ -41,8 +41,10 @@
 #include <pcl/point_cloud.h>
 #include <pcl/features/normal_3d.h>
 #include <pcl/features/pfh.h>
+#include <pcl/features/pfh_omp.h>
 #include <pcl/features/fpfh.h>
 #include <pcl/features/fpfh_omp.h>
+#include <pcl/features/fpfh_incremental.h>
 #include <pcl/features/vfh.h>
 #include <pcl/features/gfpfh.h>
 #include <pcl/io/pcd_io.h>
@@ -262,6 +264,70 @@ TEST (PCL, PFHEstimation)
   (cloud.makeShared (), normals, test_indices, 125);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PFHEstimationOpenMP)
+{
+  // Estimate normals first
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  // set parameters
+  n.setInputCloud (cloud.makeShared ());
+  boost::shared_ptr<vector<int> > indicesptr (new vector<int> (indices));
+  n.setIndices (indicesptr);
+  n.setSearchMethod (tree);
+  n.setKSearch (10); // Use 10 nearest neighbors to estimate the normals
+  // estimate
+  n.compute (*normals);
+
+  PFHEstimation<PointXYZ, Normal, PFHSignature125> pfh;
+  PFHEstimationOMP<PointXYZ, Normal, PFHSignature125> pfh_omp (4); // instantiate 4 threads
+  PointCloud<PFHSignature125> pfhs, pfhs_omp, pfhs_omp_cached;
+
+  pfh.setInputCloud (cloud.makeShared ());
+  pfh.setInputNormals (normals);
+  pfh.setIndices (indicesptr);
+  pfh.setSearchMethod (tree);
+  pfh.setKSearch (30);
+  pfh.compute (pfhs);
+
+  pfh_omp.setInputCloud (cloud.makeShared ());
+  pfh_omp.setInputNormals (normals);
+  pfh_omp.setIndices (indicesptr);
+  pfh_omp.setSearchMethod (tree);
+  pfh_omp.setKSearch (30);
+  pfh_omp.compute (pfhs_omp);
+
+  // the shared pair cache must not change the result, whatever the number of threads
+  PointCloud<PFHSignature125> pfhs_omp_serial;
+  pfh_omp.setNumberOfThreads (1);
+  pfh_omp.compute (pfhs_omp_serial);
+  pfh_omp.setNumberOfThreads (4);
+  pfh_omp.setUseInternalCache (true);
+  pfh_omp.compute (pfhs_omp_cached);
+
+  ASSERT_EQ (pfhs_omp.points.size (), pfhs.points.size ());
+  ASSERT_EQ (pfhs_omp_serial.points.size (), pfhs.points.size ());
+  ASSERT_EQ (pfhs_omp_cached.points.size (), pfhs.points.size ());
+  for (size_t i = 0; i < pfhs.points.size (); ++i)
+  {
+    for (int d = 0; d < 125; ++d)
+    {
+      EXPECT_NEAR (pfhs_omp.points[i].histogram[d], pfhs.points[i].histogram[d], 1e-4);
+      EXPECT_EQ (pfhs_omp.points[i].histogram[d], pfhs_omp_serial.points[i].histogram[d]);
+      EXPECT_EQ (pfhs_omp_cached.points[i].histogram[d], pfhs_omp_serial.points[i].histogram[d]);
+    }
+  }
+
+  // Test results when setIndices and/or setSearchSurface are used
+
+  boost::shared_ptr<vector<int> > test_indices (new vector<int> (0));
+  for (size_t i = 0; i < cloud.size (); i+=3)
+    test_indices->push_back (static_cast<int> (i));
+
+  testIndicesAndSearchSurface<PFHEstimationOMP<PointXYZ, Normal, PFHSignature125>, PointXYZ, Normal, PFHSignature125>
+  (cloud.makeShared (), normals, test_indices, 125);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, FPFHEstimation)
 {
@@ -499,6 +565,194 @@ TEST (PCL, FPFHEstimationOpenMP)
   (cloud.makeShared (), normals, test_indices, 33);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PFHPairFeatureCacheConcurrent)
+{
+  // Few slots and many keys, so that the threads keep overwriting each other's entries. A hit must always return
+  // the tuple that was stored for its own pair, never a mix of two writes.
+  PFHPairFeatureCache cache;
+  cache.resize (64);
+  EXPECT_EQ (cache.capacity (), 64u);
+
+  const int nr_points = 200;
+  int nr_wrong = 0, nr_hits = 0;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(8) schedule(static, 1) reduction(+:nr_wrong, nr_hits)
+#endif
+  for (int round = 0; round < 64; ++round)
+  {
+    for (int p = 0; p < nr_points; ++p)
+    {
+      const int q = (p * 7 + round % 4) % nr_points;
+      if (p == q)
+        continue;
+      const Eigen::Vector4f expected (float (p), float (q), float (p + q), float (p - q));
+      Eigen::Vector4f tuple;
+      if (cache.find (p, q, tuple))
+      {
+        ++nr_hits;
+        if (tuple != expected)
+          ++nr_wrong;
+      }
+      else
+        cache.insert (p, q, expected);
+    }
+  }
+  EXPECT_EQ (nr_wrong, 0);
+  EXPECT_GT (nr_hits, 0);
+
+  cache.clear ();
+  EXPECT_EQ (cache.capacity (), 0u);
+  Eigen::Vector4f tuple;
+  EXPECT_FALSE (cache.find (1, 2, tuple));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IncrementalFPFHEstimation)
+{
+  // Estimate normals first
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  n.setInputCloud (cloud.makeShared ());
+  n.setSearchMethod (tree);
+  n.setKSearch (10);
+  n.compute (*normals);
+
+  for (int radius_search = 0; radius_search < 2; ++radius_search)
+  {
+    IncrementalFPFHEstimation<PointXYZ, Normal, FPFHSignature33> incremental;
+    if (radius_search)
+      incremental.setRadiusSearch (0.01);
+    else
+      incremental.setKSearch (15);
+
+    // Slide a window of 300 points over the cloud, 20 points at a time
+    const size_t window_size = 300;
+    for (size_t start = 0; start + window_size <= cloud.points.size (); start += 20)
+    {
+      PointCloud<PointXYZ>::Ptr window (new PointCloud<PointXYZ> ());
+      PointCloud<Normal>::Ptr window_normals (new PointCloud<Normal> ());
+      boost::shared_ptr<vector<int> > ids (new vector<int> ());
+      for (size_t i = start; i < start + window_size; ++i)
+      {
+        window->push_back (cloud.points[i]);
+        window_normals->push_back (normals->points[i]);
+        ids->push_back (static_cast<int> (i));
+      }
+      KdTreePtr window_tree (new search::KdTree<PointXYZ> (false));
+
+      incremental.setInputCloud (window);
+      incremental.setInputNormals (window_normals);
+      incremental.setSearchMethod (window_tree);
+      incremental.setPointIds (ids);
+      PointCloud<FPFHSignature33> incremental_output;
+      incremental.compute (incremental_output);
+
+      FPFHEstimation<PointXYZ, Normal, FPFHSignature33> fpfh;
+      if (radius_search)
+        fpfh.setRadiusSearch (0.01);
+      else
+        fpfh.setKSearch (15);
+      fpfh.setInputCloud (window);
+      fpfh.setInputNormals (window_normals);
+      fpfh.setSearchMethod (window_tree);
+      PointCloud<FPFHSignature33> output;
+      fpfh.compute (output);
+
+      // Only the neighborhoods touched by the 20 removed and 20 inserted points are recomputed
+      if (start > 0)
+        EXPECT_LT (incremental.getNumberOfSPFHUpdates (), window_size / 2);
+      else
+        EXPECT_EQ (incremental.getNumberOfSPFHUpdates (), window_size);
+
+      ASSERT_EQ (incremental_output.points.size (), output.points.size ());
+      EXPECT_EQ (incremental_output.is_dense, output.is_dense);
+      for (size_t i = 0; i < output.points.size (); ++i)
+      {
+        for (int d = 0; d < 33; ++d)
+        {
+          if (!pcl_isfinite (output.points[i].histogram[d]))
+          {
+            EXPECT_FALSE (pcl_isfinite (incremental_output.points[i].histogram[d]));
+            continue;
+          }
+          EXPECT_NEAR (incremental_output.points[i].histogram[d], output.points[i].histogram[d], 1e-3);
+        }
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IncrementalFPFHEstimationNaN)
+{
+  NormalEstimation<PointXYZ, Normal> n;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  n.setInputCloud (cloud.makeShared ());
+  n.setSearchMethod (tree);
+  n.setKSearch (10);
+  n.compute (*normals);
+
+  // A window of 300 points with a few invalid ones, which must not make every k-neighborhood reachable
+  PointCloud<PointXYZ>::Ptr window (new PointCloud<PointXYZ> ());
+  PointCloud<Normal>::Ptr window_normals (new PointCloud<Normal> ());
+  boost::shared_ptr<vector<int> > ids (new vector<int> ());
+  for (size_t i = 0; i < 300; ++i)
+  {
+    window->push_back (cloud.points[i]);
+    window_normals->push_back (normals->points[i]);
+    ids->push_back (static_cast<int> (i));
+  }
+  for (size_t i = 10; i < 300; i += 100)
+    window->points[i].x = window->points[i].y = window->points[i].z = std::numeric_limits<float>::quiet_NaN ();
+  window->is_dense = false;
+
+  IncrementalFPFHEstimation<PointXYZ, Normal, FPFHSignature33> incremental;
+  incremental.setKSearch (15);
+  incremental.setInputCloud (window);
+  incremental.setInputNormals (window_normals);
+  incremental.setSearchMethod (KdTreePtr (new search::KdTree<PointXYZ> (false)));
+  incremental.setPointIds (ids);
+  PointCloud<FPFHSignature33> incremental_output;
+  incremental.compute (incremental_output);
+  EXPECT_EQ (incremental.getNumberOfSPFHUpdates (), 300u);
+
+  // Inserting one point only recomputes the neighborhoods it enters
+  window->push_back (cloud.points[300]);
+  window_normals->push_back (normals->points[300]);
+  ids->push_back (300);
+  KdTreePtr window_tree (new search::KdTree<PointXYZ> (false));
+  incremental.setInputCloud (window);
+  incremental.setInputNormals (window_normals);
+  incremental.setSearchMethod (window_tree);
+  incremental.setPointIds (ids);
+  incremental.compute (incremental_output);
+  EXPECT_LT (incremental.getNumberOfSPFHUpdates (), 30u);
+
+  // The result is the one of an estimation from scratch, which skips the invalid points in the same way
+  IncrementalFPFHEstimation<PointXYZ, Normal, FPFHSignature33> fresh;
+  fresh.setKSearch (15);
+  fresh.setInputCloud (window);
+  fresh.setInputNormals (window_normals);
+  fresh.setSearchMethod (window_tree);
+  fresh.setPointIds (ids);
+  PointCloud<FPFHSignature33> output;
+  fresh.compute (output);
+  ASSERT_EQ (incremental_output.points.size (), output.points.size ());
+  for (size_t i = 0; i < output.points.size (); ++i)
+  {
+    for (int d = 0; d < 33; ++d)
+    {
+      if (!pcl_isfinite (output.points[i].histogram[d]))
+      {
+        EXPECT_FALSE (pcl_isfinite (incremental_output.points[i].histogram[d]));
+        continue;
+      }
+      EXPECT_NEAR (incremental_output.points[i].histogram[d], output.points[i].histogram[d], 1e-3);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, VFHEstimation)
 {
@@ -40,6 +40,7 @@
 #include <gtest/gtest.h>
 #include <pcl/point_cloud.h>
 #include <pcl/features/rops_estimation.h>
+#include <pcl/features/rops_estimation_omp.h>
 #include <pcl/io/pcd_io.h>
 
 pcl::PointCloud <pcl::PointXYZ>::Ptr cloud;
@@ -117,6 +118,40 @@ TEST (ROPSFeature, InvalidParameters)
   EXPECT_EQ (0, histograms->points.size ());
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (ROPSFeature, FeatureExtractionOpenMP)
+{
+  float support_radius = 0.0285f;
+
+  pcl::search::KdTree<pcl::PointXYZ>::Ptr search_method (new pcl::search::KdTree<pcl::PointXYZ>);
+  search_method->setInputCloud (cloud);
+
+  pcl::ROPSEstimation <pcl::PointXYZ, pcl::Histogram <135> > feature_estimator;
+  pcl::ROPSEstimationOMP <pcl::PointXYZ, pcl::Histogram <135> > feature_estimator_omp (4);
+  pcl::Feature <pcl::PointXYZ, pcl::Histogram <135> >* estimators[2] = { &feature_estimator, &feature_estimator_omp };
+  pcl::PointCloud<pcl::Histogram <135> > histograms[2];
+  for (int i = 0; i < 2; i++)
+  {
+    estimators[i]->setSearchMethod (search_method);
+    estimators[i]->setSearchSurface (cloud);
+    estimators[i]->setInputCloud (cloud);
+    estimators[i]->setIndices (indices);
+    estimators[i]->setRadiusSearch (support_radius);
+  }
+  feature_estimator.setTriangles (triangles);
+  feature_estimator.setSupportRadius (support_radius);
+  feature_estimator_omp.setTriangles (triangles);
+  feature_estimator_omp.setSupportRadius (support_radius);
+
+  feature_estimator.compute (histograms[0]);
+  feature_estimator_omp.compute (histograms[1]);
+
+  ASSERT_EQ (histograms[0].points.size (), histograms[1].points.size ());
+  for (size_t i_point = 0; i_point < histograms[0].points.size (); i_point++)
+    for (int i_dim = 0; i_dim < 135; i_dim++)
+      EXPECT_EQ (histograms[0].points[i_point].histogram[i_dim], histograms[1].points[i_point].histogram[i_dim]);
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -46,6 +46,8 @@
 #include "pcl/features/shot_lrf.h"
 #include <pcl/features/3dsc.h>
 #include <pcl/features/usc.h>
+#include <pcl/features/3dsc_omp.h>
+#include <pcl/features/usc_omp.h>
 
 using namespace pcl;
 using namespace pcl::io;
@@ -978,6 +980,213 @@ TEST (PCL, USCEstimation)
   testSHOTLocalReferenceFrame<UniqueShapeContext<PointXYZ, UniqueShapeContext1960>, PointXYZ, Normal, UniqueShapeContext1960> (cloud.makeShared (), normals, test_indices);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, 3DSCEstimationOpenMP)
+{
+  float meshRes = 0.002f;
+  float radius = 20.0f * meshRes;
+  float rmin = radius / 10.0f;
+  float ptDensityRad = radius / 5.0f;
+
+  PointCloud<PointXYZ>::Ptr cloudptr = cloud.makeShared ();
+
+  NormalEstimation<PointXYZ, Normal> ne;
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal> ());
+  ne.setInputCloud (cloudptr);
+  ne.setSearchMethod (tree);
+  ne.setRadiusSearch (radius);
+  ne.compute (*normals);
+
+  // The random x axis is drawn per point, so the result must not depend on the number of threads
+  PointCloud<ShapeContext1980> sc3ds[2];
+  for (int i = 0; i < 2; ++i)
+  {
+    ShapeContext3DEstimationOMP<PointXYZ, Normal, ShapeContext1980> sc3d (false, i == 0 ? 1 : 4);
+    sc3d.setInputCloud (cloudptr);
+    sc3d.setInputNormals (normals);
+    sc3d.setSearchMethod (tree);
+    sc3d.setRadiusSearch (radius);
+    sc3d.setMinimalRadius (rmin);
+    sc3d.setPointDensityRadius (ptDensityRad);
+    sc3d.compute (sc3ds[i]);
+    EXPECT_EQ (sc3ds[i].size (), cloud.size ());
+  }
+
+  for (size_t i = 0; i < cloud.size (); ++i)
+  {
+    for (int j = 0; j < 9; ++j)
+      EXPECT_EQ (sc3ds[0][i].rf[j], 0.0f);
+    for (int j = 0; j < 1980; ++j)
+      EXPECT_EQ (sc3ds[0][i].descriptor[j], sc3ds[1][i].descriptor[j]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, USCEstimationOpenMP)
+{
+  float meshRes = 0.002f;
+  float radius = 20.0f * meshRes;
+  float rmin = radius / 10.0f;
+  float ptDensityRad = radius / 5.0f;
+
+  UniqueShapeContext<PointXYZ, UniqueShapeContext1960> uscd;
+  UniqueShapeContextOMP<PointXYZ, UniqueShapeContext1960> uscd_omp (4);
+  UniqueShapeContext<PointXYZ, UniqueShapeContext1960>* estimators[2] = { &uscd, &uscd_omp };
+  PointCloud<UniqueShapeContext1960> uscds[2];
+  for (int i = 0; i < 2; ++i)
+  {
+    estimators[i]->setInputCloud (cloud.makeShared ());
+    estimators[i]->setSearchMethod (tree);
+    estimators[i]->setRadiusSearch (radius);
+    estimators[i]->setMinimalRadius (rmin);
+    estimators[i]->setPointDensityRadius (ptDensityRad);
+    estimators[i]->setLocalRadius (radius);
+    estimators[i]->compute (uscds[i]);
+  }
+
+  ASSERT_EQ (uscds[1].size (), uscds[0].size ());
+  for (size_t i = 0; i < uscds[0].size (); ++i)
+  {
+    for (int j = 0; j < 9; ++j)
+      EXPECT_EQ (uscds[1][i].rf[j], uscds[0][i].rf[j]);
+    for (int j = 0; j < 1960; ++j)
+      EXPECT_EQ (uscds[1][i].descriptor[j], uscds[0][i].descriptor[j]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A 25x25 grid on z = 0.02 sin (20x) cos (15y), with analytic normals and a color gradient
+void
+createWavySurface (PointCloud<PointXYZRGBA> &surface, PointCloud<Normal> &normals)
+{
+  for (int i = 0; i < 25; ++i)
+    for (int j = 0; j < 25; ++j)
+    {
+      PointXYZRGBA p;
+      p.x = 0.01f * static_cast<float> (i);
+      p.y = 0.01f * static_cast<float> (j);
+      p.z = 0.02f * sinf (20.0f * p.x) * cosf (15.0f * p.y);
+      p.r = static_cast<uint8_t> ((i * 10) % 256);
+      p.g = static_cast<uint8_t> ((j * 10) % 256);
+      p.b = static_cast<uint8_t> (((i + j) * 5) % 256);
+      p.a = 255;
+      surface.push_back (p);
+      const float dzdx = 0.4f * cosf (20.0f * p.x) * cosf (15.0f * p.y);
+      const float dzdy = -0.3f * sinf (20.0f * p.x) * sinf (15.0f * p.y);
+      const float norm = sqrtf (dzdx * dzdx + dzdy * dzdy + 1.0f);
+      normals.push_back (Normal (-dzdx / norm, -dzdy / norm, 1.0f / norm));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Exposes both spatial binning paths of SHOT
+class SHOTSpatialBinsTest : public SHOTEstimation<PointXYZRGBA, Normal, SHOT352>
+{
+  public:
+    void
+    compareSpatialBins ()
+    {
+      ASSERT_TRUE (initCompute ());
+      radius1_2_ = search_radius_ / 2;
+      radius1_4_ = search_radius_ / 4;
+      radius3_4_ = (search_radius_ * 3) / 4;
+
+      std::vector<int> nn_indices;
+      std::vector<float> nn_dists;
+      for (size_t idx = 0; idx < indices_->size (); ++idx)
+      {
+        ASSERT_GT (searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists), 0);
+        SpatialBins bins, scalar_bins;
+        computeSpatialBins (nn_indices, nn_dists, static_cast<int> (idx), bins);
+        computeSpatialBinsScalar (nn_indices, nn_dists, static_cast<int> (idx), scalar_bins);
+        ASSERT_EQ (scalar_bins.volume.size (), bins.volume.size ());
+        for (size_t i = 0; i < nn_indices.size (); ++i)
+        {
+          ASSERT_EQ (scalar_bins.volume[i], bins.volume[i]);
+          if (bins.volume[i] < 0)
+            continue;
+          EXPECT_EQ (scalar_bins.radial_volume[i], bins.radial_volume[i]);
+          EXPECT_EQ (scalar_bins.inclination_volume[i], bins.inclination_volume[i]);
+          EXPECT_EQ (scalar_bins.azimuth_volume[i], bins.azimuth_volume[i]);
+          EXPECT_NEAR (scalar_bins.weight[i], bins.weight[i], 1e-5);
+          EXPECT_NEAR (scalar_bins.radial_weight[i], bins.radial_weight[i], 1e-5);
+          EXPECT_NEAR (scalar_bins.inclination_weight[i], bins.inclination_weight[i], 1e-5);
+          EXPECT_NEAR (scalar_bins.azimuth_weight[i], bins.azimuth_weight[i], 1e-5);
+        }
+      }
+      deinitCompute ();
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, SHOTSpatialBins)
+{
+  PointCloud<PointXYZRGBA>::Ptr surface (new PointCloud<PointXYZRGBA>);
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal>);
+  createWavySurface (*surface, *normals);
+
+  SHOTSpatialBinsTest shot;
+  shot.setInputCloud (surface);
+  shot.setInputNormals (normals);
+  shot.setSearchMethod (search::KdTree<PointXYZRGBA>::Ptr (new search::KdTree<PointXYZRGBA>));
+  shot.setRadiusSearch (0.06);
+  shot.compareSpatialBins ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, SHOTReferenceDescriptors)
+{
+  PointCloud<PointXYZRGBA>::Ptr surface (new PointCloud<PointXYZRGBA>);
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal>);
+  createWavySurface (*surface, *normals);
+  search::KdTree<PointXYZRGBA>::Ptr rgba_tree (new search::KdTree<PointXYZRGBA>);
+
+  // Reference values computed with the per-neighbor implementation that predates the SSE2 binning
+  SHOTEstimation<PointXYZRGBA, Normal, SHOT352> shot;
+  shot.setInputCloud (surface);
+  shot.setInputNormals (normals);
+  shot.setSearchMethod (rgba_tree);
+  shot.setRadiusSearch (0.06);
+  PointCloud<SHOT352> shots;
+  shot.compute (shots);
+  ASSERT_EQ (surface->size (), shots.size ());
+
+  EXPECT_NEAR (shots[312].descriptor[32 ], 0.31287837, 1e-5);
+  EXPECT_NEAR (shots[312].descriptor[87 ], 0.35022166, 1e-5);
+  EXPECT_NEAR (shots[312].descriptor[131], 0.32760093, 1e-5);
+  EXPECT_NEAR (shots[312].descriptor[164], 0.33381245, 1e-5);
+  EXPECT_NEAR (shots[312].descriptor[263], 0.35832620, 1e-5);
+  EXPECT_NEAR (shots[312].descriptor[307], 0.34796059, 1e-5);
+  EXPECT_NEAR (shots[100].descriptor[33 ], 0.28039679, 1e-5);
+  EXPECT_NEAR (shots[100].descriptor[66 ], 0.35289565, 1e-5);
+  EXPECT_NEAR (shots[100].descriptor[77 ], 0.31577814, 1e-5);
+  EXPECT_NEAR (shots[100].descriptor[110], 0.44894341, 1e-5);
+  EXPECT_NEAR (shots[100].descriptor[165], 0.51211375, 1e-5);
+  EXPECT_NEAR (shots[100].descriptor[209], 0.25805670, 1e-5);
+
+  SHOTColorEstimation<PointXYZRGBA, Normal, SHOT1344> shot_color;
+  shot_color.setInputCloud (surface);
+  shot_color.setInputNormals (normals);
+  shot_color.setSearchMethod (rgba_tree);
+  shot_color.setRadiusSearch (0.06);
+  PointCloud<SHOT1344> shots_color;
+  shot_color.compute (shots_color);
+  ASSERT_EQ (surface->size (), shots_color.size ());
+
+  EXPECT_NEAR (shots_color[312].descriptor[32  ], 0.25424212, 1e-5);
+  EXPECT_NEAR (shots_color[312].descriptor[87  ], 0.28458694, 1e-5);
+  EXPECT_NEAR (shots_color[312].descriptor[263 ], 0.29117262, 1e-5);
+  EXPECT_NEAR (shots_color[312].descriptor[416 ], 0.17706874, 1e-5);
+  EXPECT_NEAR (shots_color[312].descriptor[695 ], 0.16265179, 1e-5);
+  EXPECT_NEAR (shots_color[312].descriptor[1191], 0.17087880, 1e-5);
+  EXPECT_NEAR (shots_color[100].descriptor[66  ], 0.28488079, 1e-5);
+  EXPECT_NEAR (shots_color[100].descriptor[110 ], 0.36241692, 1e-5);
+  EXPECT_NEAR (shots_color[100].descriptor[165 ], 0.41341224, 1e-5);
+  EXPECT_NEAR (shots_color[100].descriptor[446 ], 0.19997758, 1e-5);
+  EXPECT_NEAR (shots_color[100].descriptor[819 ], 0.29957861, 1e-5);
+  EXPECT_NEAR (shots_color[100].descriptor[943 ], 0.16677870, 1e-5);
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
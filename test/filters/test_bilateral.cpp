@@ -40,6 +40,7 @@
 
 #include <gtest/gtest.h>
 #include <pcl/io/pcd_io.h>
+#include <pcl/filters/bilateral.h>
 #include <pcl/filters/fast_bilateral.h>
 #include <pcl/filters/fast_bilateral_omp.h>
 #include <pcl/console/time.h>
@@ -127,6 +128,52 @@ TEST (FastBilateralFilterOMP, Filters_Bilateral)
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (BilateralFilter, Filters_Bilateral)
+{
+  // A noisy intensity step on a plane
+  PointCloud<PointXYZI>::Ptr input (new PointCloud<PointXYZI>);
+  srand (0);
+  for (int i = 0; i < 2000; ++i)
+  {
+    PointXYZI point;
+    point.x = static_cast<float> (rand ()) / static_cast<float> (RAND_MAX);
+    point.y = static_cast<float> (rand ()) / static_cast<float> (RAND_MAX);
+    point.z = 0.0f;
+    point.intensity = (point.x > 0.5f ? 100.0f : 20.0f) + 10.0f * (static_cast<float> (rand ()) / static_cast<float> (RAND_MAX) - 0.5f);
+    input->push_back (point);
+  }
+
+  BilateralFilter<PointXYZI> bf;
+  bf.setInputCloud (input);
+  bf.setHalfSize (0.05);
+  bf.setStdDev (15.0);
+  PointCloud<PointXYZI> output;
+  bf.filter (output);
+  ASSERT_EQ (output.points.size (), input->points.size ());
+
+  // The result does not depend on the number of threads
+  PointCloud<PointXYZI> output_threads;
+  bf.setNumberOfThreads (4);
+  bf.filter (output_threads);
+  for (size_t i = 0; i < output.points.size (); ++i)
+    EXPECT_EQ (output[i].intensity, output_threads[i].intensity);
+
+  // The lattice approximates the exact response much better than the noise it removes, and keeps the step
+  PointCloud<PointXYZI> output_lattice;
+  bf.setUsePermutohedralLattice (true);
+  bf.filter (output_lattice);
+  ASSERT_EQ (output_lattice.points.size (), input->points.size ());
+  double error = 0, smoothing = 0;
+  for (size_t i = 0; i < output.points.size (); ++i)
+  {
+    error += fabs (output_lattice[i].intensity - output[i].intensity);
+    smoothing += fabs (output[i].intensity - (*input)[i].intensity);
+    EXPECT_NEAR ((*input)[i].x > 0.5f ? 100.0f : 20.0f, output_lattice[i].intensity, 10.0f);
+  }
+  EXPECT_LT (error, 0.25 * smoothing);
+}
+
 /* ---[ */
 int
 main (int argc,
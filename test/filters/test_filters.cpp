@@ -49,12 +49,15 @@
 #include <pcl/filters/sampling_surface_normal.h>
 #include <pcl/filters/voxel_grid.h>
 #include <pcl/filters/voxel_grid_covariance.h>
+#include <pcl/filters/voxel_grid_occlusion_estimation.h>
 #include <pcl/filters/extract_indices.h>
 #include <pcl/filters/project_inliers.h>
 #include <pcl/filters/radius_outlier_removal.h>
 #include <pcl/filters/statistical_outlier_removal.h>
 #include <pcl/filters/conditional_removal.h>
 #include <pcl/filters/crop_box.h>
+#include <pcl/filters/crop_hull.h>
+#include <pcl/filters/filter_pipeline.h>
 #include <pcl/filters/median_filter.h>
 #include <pcl/filters/normal_refinement.h>
 
@@ -1056,6 +1059,73 @@ TEST (VoxelGridCovariance, Filters)
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGridOcclusionEstimation, Filters)
+{
+  // A wall at x = 1 in front of a floor at z = 0, seen from a sensor at the origin
+  PointCloud<PointXYZ>::Ptr input (new PointCloud<PointXYZ>);
+  for (int i = 0; i < 20; ++i)
+    for (int j = 0; j < 20; ++j)
+    {
+      input->push_back (PointXYZ (1.025f, -0.475f + 0.05f * float (i), 0.025f + 0.05f * float (j)));
+      input->push_back (PointXYZ (0.525f + 0.05f * float (i), -0.475f + 0.05f * float (j), 0.025f));
+    }
+  input->sensor_origin_ = Eigen::Vector4f (0.0f, 0.0f, 0.5f, 0.0f);
+
+  VoxelGridOcclusionEstimation<PointXYZ> occlusion;
+  occlusion.setInputCloud (input);
+  occlusion.setLeafSize (0.1f, 0.1f, 0.1f);
+  occlusion.initializeVoxelGrid ();
+
+  // Every voxel has the state of a single ray cast towards it
+  std::vector<Eigen::Vector3i> occluded_free, occluded_occupied;
+  occlusion.occlusionEstimationAll (occluded_free);
+  occlusion.occlusionEstimationOccupied (occluded_occupied);
+  EXPECT_GT (occluded_free.size (), size_t (0));
+  EXPECT_GT (occluded_occupied.size (), size_t (0));
+
+  // Reference: walk the voxels of the ray towards every voxel and look each of them up in the grid, a voxel is
+  // occluded if an occupied one lies before it on its ray
+  std::vector<Eigen::Vector3i> expected_free, expected_occupied;
+  const Eigen::Vector3i min_b = occlusion.getMinBoxCoordinates ().head<3> ();
+  const Eigen::Vector3i max_b = occlusion.getMaxBoxCoordinates ().head<3> ();
+  for (int k = min_b[2]; k <= max_b[2]; ++k)
+    for (int j = min_b[1]; j <= max_b[1]; ++j)
+      for (int i = min_b[0]; i <= max_b[0]; ++i)
+      {
+        const Eigen::Vector3i ijk (i, j, k);
+        int state;
+        std::vector<Eigen::Vector3i> ray;
+        ASSERT_EQ (occlusion.occlusionEstimation (state, ray, ijk), 0);
+        bool occluded = false;
+        for (size_t r = 0; r < ray.size () && ray[r] != ijk; ++r)
+          if (occlusion.getCentroidIndexAt (ray[r]) != -1)
+            occluded = true;
+        if (!occluded)
+          continue;
+        if (occlusion.getCentroidIndexAt (ijk) == -1)
+          expected_free.push_back (ijk);
+        else
+          expected_occupied.push_back (ijk);
+      }
+  EXPECT_TRUE (occluded_free == expected_free);
+  EXPECT_TRUE (occluded_occupied == expected_occupied);
+
+  // Behind the wall (i = 10) is hidden, both in the air and on the floor; in front of it nothing is
+  EXPECT_NE (occlusion.getCentroidIndexAt (Eigen::Vector3i (10, 0, 5)), -1);
+  EXPECT_NE (occlusion.getCentroidIndexAt (Eigen::Vector3i (12, 0, 0)), -1);
+  EXPECT_TRUE (std::find (occluded_free.begin (), occluded_free.end (), Eigen::Vector3i (12, 0, 5)) != occluded_free.end ());
+  EXPECT_TRUE (std::find (occluded_free.begin (), occluded_free.end (), Eigen::Vector3i (7, 0, 5)) == occluded_free.end ());
+  EXPECT_TRUE (std::find (occluded_occupied.begin (), occluded_occupied.end (), Eigen::Vector3i (12, 0, 0)) != occluded_occupied.end ());
+  EXPECT_TRUE (std::find (occluded_occupied.begin (), occluded_occupied.end (), Eigen::Vector3i (10, 0, 5)) == occluded_occupied.end ());
+
+  // The result does not depend on the number of threads
+  occluded_free.clear ();
+  occlusion.setNumberOfThreads (4);
+  occlusion.occlusionEstimationAll (occluded_free);
+  EXPECT_TRUE (occluded_free == expected_free);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
 TEST (ProjectInliers, Filters)
 {
   // Test the PointCloud<PointT> method
@@ -1111,6 +1181,19 @@ TEST (RadiusOutlierRemoval, Filters)
   EXPECT_NEAR (cloud_out.points[cloud_out.points.size () - 1].y, 0.16039, 1e-4);
   EXPECT_NEAR (cloud_out.points[cloud_out.points.size () - 1].z, -0.021299, 1e-4);
 
+  // The classification does not depend on the number of threads, nor on whether
+  // the nearest-k (dense input) or the capped radius search (non-dense input) is used
+  PointCloud<PointXYZ>::Ptr cloud_not_dense (new PointCloud<PointXYZ> (*cloud));
+  cloud_not_dense->is_dense = false;
+  outrem.setInputCloud (cloud_not_dense);
+  outrem.setNumberOfThreads (4);
+  outrem.filter (cloud_out);
+
+  EXPECT_EQ (int (cloud_out.points.size ()), 307);
+  EXPECT_NEAR (cloud_out.points[cloud_out.points.size () - 1].x, -0.077893, 1e-4);
+  EXPECT_NEAR (cloud_out.points[cloud_out.points.size () - 1].y, 0.16039, 1e-4);
+  EXPECT_NEAR (cloud_out.points[cloud_out.points.size () - 1].z, -0.021299, 1e-4);
+
   // Test the pcl::PCLPointCloud2 method
   PCLPointCloud2 cloud_out2;
   RadiusOutlierRemoval<PCLPointCloud2> outrem2;
@@ -1476,6 +1559,65 @@ TEST (CropBox, Filters)
   cropBoxFilter2.filter (cloud_out2);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (CropHull, Filters)
+{
+  // a 10x10x10 grid of points, 7 of the 10 coordinates along each axis are inside [-1, 1]
+  PointCloud<PointXYZ>::Ptr input (new PointCloud<PointXYZ> ());
+  for (int i = 0; i < 10; ++i)
+    for (int j = 0; j < 10; ++j)
+      for (int k = 0; k < 10; ++k)
+        input->push_back (PointXYZ (-1.45f + 0.3f * i, -1.45f + 0.3f * j, -1.45f + 0.3f * k));
+
+  // the cube [-1, 1]^3, vertex i has the coordinates given by its bits
+  PointCloud<PointXYZ>::Ptr hull_cloud (new PointCloud<PointXYZ> ());
+  for (int i = 0; i < 8; ++i)
+    hull_cloud->push_back (PointXYZ (i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f));
+  const uint32_t faces[12][3] = { {0, 1, 3}, {0, 3, 2}, {4, 6, 7}, {4, 7, 5}, {0, 4, 5}, {0, 5, 1},
+                                  {2, 3, 7}, {2, 7, 6}, {0, 2, 6}, {0, 6, 4}, {1, 5, 7}, {1, 7, 3} };
+  std::vector<Vertices> polygons (12);
+  for (int i = 0; i < 12; ++i)
+    polygons[i].vertices.assign (faces[i], faces[i] + 3);
+
+  CropHull<PointXYZ> crop_hull;
+  crop_hull.setHullCloud (hull_cloud);
+  crop_hull.setHullIndices (polygons);
+  crop_hull.setDim (3);
+  crop_hull.setInputCloud (input);
+
+  std::vector<int> indices;
+  crop_hull.filter (indices);
+  EXPECT_EQ (343, int (indices.size ()));
+  for (size_t i = 0; i < indices.size (); ++i)
+    EXPECT_TRUE (input->points[indices[i]].getVector3fMap ().cwiseAbs ().maxCoeff () < 1.0f);
+
+  std::vector<int> indices_parallel;
+  crop_hull.setNumberOfThreads (4);
+  crop_hull.filter (indices_parallel);
+  EXPECT_TRUE (indices == indices_parallel);
+
+  // the square [-1, 1]^2 in the z = 0 plane
+  PointCloud<PointXYZ>::Ptr input_2d (new PointCloud<PointXYZ> ());
+  for (int i = 0; i < 10; ++i)
+    for (int j = 0; j < 10; ++j)
+      input_2d->push_back (PointXYZ (-1.45f + 0.3f * i, -1.45f + 0.3f * j, 0.0f));
+  std::vector<Vertices> square (1);
+  const uint32_t square_vertices[4] = {0, 1, 3, 2};
+  square[0].vertices.assign (square_vertices, square_vertices + 4);
+
+  crop_hull.setHullIndices (square);
+  crop_hull.setDim (2);
+  crop_hull.setInputCloud (input_2d);
+  std::vector<int> indices_2d;
+  crop_hull.filter (indices_2d);
+  EXPECT_EQ (49, int (indices_2d.size ()));
+
+  PointCloud<PointXYZ> cloud_out;
+  crop_hull.setCropOutside (false);
+  crop_hull.filter (cloud_out);
+  EXPECT_EQ (51, int (cloud_out.size ()));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (StatisticalOutlierRemoval, Filters)
 {
@@ -1495,6 +1637,15 @@ TEST (StatisticalOutlierRemoval, Filters)
   EXPECT_NEAR (output.points[output.points.size () - 1].y, 0.15131, 1e-4);
   EXPECT_NEAR (output.points[output.points.size () - 1].z, -0.00071029, 1e-4);
 
+  // The classification does not depend on the number of threads
+  outrem.setNumberOfThreads (4);
+  outrem.filter (output);
+
+  EXPECT_EQ (int (output.points.size ()), 352);
+  EXPECT_NEAR (output.points[output.points.size () - 1].x, -0.034667, 1e-4);
+  EXPECT_NEAR (output.points[output.points.size () - 1].y, 0.15131, 1e-4);
+  EXPECT_NEAR (output.points[output.points.size () - 1].z, -0.00071029, 1e-4);
+
   outrem.setNegative (true);
   outrem.filter (output);
 
@@ -1505,6 +1656,23 @@ TEST (StatisticalOutlierRemoval, Filters)
   EXPECT_NEAR (output.points[output.points.size () - 1].y, 0.17516, 1e-4);
   EXPECT_NEAR (output.points[output.points.size () - 1].z, -0.0444, 1e-4);
 
+  // A given search method is set up again on every call unless index reuse is requested, so a cloud
+  // edited in place is not searched with a stale index
+  PointCloud<PointXYZ>::Ptr edited (new PointCloud<PointXYZ> (*cloud));
+  search::KdTree<PointXYZ>::Ptr tree (new search::KdTree<PointXYZ>);
+  tree->setInputCloud (edited);
+  for (size_t i = 0; i < edited->points.size (); ++i)
+    edited->points[i].z *= 10.0f;
+  std::vector<int> kept, kept_fresh;
+  StatisticalOutlierRemoval<PointXYZ> outrem_fresh;
+  outrem_fresh.setInputCloud (edited);
+  outrem_fresh.setMeanK (50);
+  outrem_fresh.setStddevMulThresh (1.0);
+  outrem_fresh.filter (kept_fresh);
+  outrem_fresh.setSearchMethod (tree);
+  outrem_fresh.filter (kept);
+  EXPECT_EQ (kept, kept_fresh);
+
   // Test the pcl::PCLPointCloud2 method
   PCLPointCloud2 output2;
   StatisticalOutlierRemoval<PCLPointCloud2> outrem2;
@@ -1804,6 +1972,81 @@ TEST (ConditionalRemovalSetIndices, Filters)
   EXPECT_EQ (num_not_nan, int (indices->size ()) - int (condrem2_.getRemovedIndices ()->size ()));
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (FilterPipeline, Filters)
+{
+  PassThrough<PointXYZ>::Ptr pass (new PassThrough<PointXYZ>);
+  pass->setFilterFieldName ("z");
+  pass->setFilterLimits (-0.03f, 0.03f);
+  CropBox<PointXYZ>::Ptr box (new CropBox<PointXYZ>);
+  box->setMin (Eigen::Vector4f (-0.08f, 0.05f, -1.0f, 1.0f));
+  box->setMax (Eigen::Vector4f (0.05f, 0.18f, 1.0f, 1.0f));
+  boost::shared_ptr<VoxelGrid<PointXYZ> > grid (new VoxelGrid<PointXYZ>);
+  grid->setLeafSize (0.005f, 0.005f, 0.005f);
+  StatisticalOutlierRemoval<PointXYZ>::Ptr outrem (new StatisticalOutlierRemoval<PointXYZ>);
+  outrem->setMeanK (10);
+  outrem->setStddevMulThresh (1.0);
+  ConditionAnd<PointXYZ>::Ptr condition (new ConditionAnd<PointXYZ>);
+  condition->addComparison (FieldComparison<PointXYZ>::ConstPtr (new FieldComparison<PointXYZ> ("x", ComparisonOps::GT, -0.07)));
+
+  // Reference: the filters applied one after the other
+  PointCloud<PointXYZ>::Ptr passed (new PointCloud<PointXYZ>), cropped (new PointCloud<PointXYZ>);
+  PointCloud<PointXYZ>::Ptr conditioned (new PointCloud<PointXYZ>), downsampled (new PointCloud<PointXYZ>);
+  PointCloud<PointXYZ> reference;
+  pass->setInputCloud (cloud);
+  pass->filter (*passed);
+  box->setInputCloud (passed);
+  box->filter (*cropped);
+  ConditionalRemoval<PointXYZ> condrem;
+  condrem.setCondition (condition);
+  condrem.setInputCloud (cropped);
+  condrem.filter (*conditioned);
+  grid->setInputCloud (conditioned);
+  grid->filter (*downsampled);
+  outrem->setInputCloud (downsampled);
+  outrem->filter (reference);
+  ASSERT_GT (int (reference.points.size ()), 0);
+
+  search::KdTree<PointXYZ>::Ptr tree (new search::KdTree<PointXYZ>);
+  outrem->setSearchMethod (tree, true);
+
+  FilterPipeline<PointXYZ> pipeline;
+  pipeline.addPointFilter ("pass", pass);
+  pipeline.addPointFilter ("box", box);
+  pipeline.addCondition ("condition", condition);
+  pipeline.addReduction ("grid", grid);
+  pipeline.addNeighborhoodFilter ("outliers", outrem);
+  pipeline.setSearchMethod (tree);
+  pipeline.setInputCloud (cloud);
+
+  for (unsigned int threads = 1; threads <= 4; threads *= 4)
+  {
+    PointCloud<PointXYZ> output;
+    pipeline.setNumberOfThreads (threads);
+    pipeline.filter (output);
+
+    ASSERT_EQ (output.points.size (), reference.points.size ());
+    for (size_t i = 0; i < output.points.size (); ++i)
+    {
+      EXPECT_EQ (output.points[i].x, reference.points[i].x);
+      EXPECT_EQ (output.points[i].y, reference.points[i].y);
+      EXPECT_EQ (output.points[i].z, reference.points[i].z);
+    }
+
+    // The shared search method was set up on the downsampled points
+    EXPECT_EQ (tree->getInputCloud ()->points.size (), downsampled->points.size ());
+
+    // The PassThrough, the CropBox and the condition are fused into one stage
+    const std::vector<FilterPipeline<PointXYZ>::StageReport> &reports = pipeline.getStageReports ();
+    ASSERT_EQ (reports.size (), size_t (3));
+    EXPECT_EQ (reports[0].name, "pass + box + condition");
+    EXPECT_EQ (reports[0].points_in, cloud->points.size ());
+    EXPECT_EQ (reports[0].points_out, conditioned->points.size ());
+    EXPECT_EQ (reports[1].points_out, downsampled->points.size ());
+    EXPECT_EQ (reports[2].points_out, reference.points.size ());
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SamplingSurfaceNormal, Filters)
 {
@@ -1980,6 +2223,130 @@ TEST (FrustumCulling, Filters)
 
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (FrustumCullingVisibility, Filters)
+{
+  // A dense grid, stored in scan order so that blocks of consecutive points are small
+  PointCloud<PointXYZ>::Ptr input (new PointCloud<PointXYZ> ());
+  for (int i = 0; i < 40; i++)
+    for (int j = 0; j < 40; j++)
+      for (int k = 0; k < 40; k++)
+        input->points.push_back (PointXYZ (0.25f * float (i) - 5.0f, 0.25f * float (j) - 5.0f, 0.25f * float (k) - 5.0f));
+  input->points[1000].x = std::numeric_limits<float>::quiet_NaN ();
+  input->width = static_cast<uint32_t> (input->points.size ());
+  input->height = 1;
+  input->is_dense = false;
+
+  pcl::FrustumCulling<pcl::PointXYZ>::CameraPoses camera_poses;
+  for (int c = 0; c < 8; c++)
+  {
+    Eigen::Matrix4f camera_pose (Eigen::Matrix4f::Identity ());
+    camera_pose.block (0, 0, 3, 3) = Eigen::Matrix3f (Eigen::AngleAxisf (float (c) * 0.785f, Eigen::Vector3f::UnitY ()) *
+                                                      Eigen::AngleAxisf (0.3f, Eigen::Vector3f::UnitZ ()));
+    camera_pose (1, 3) = float (c % 3) - 1.0f;
+    camera_poses.push_back (camera_pose);
+  }
+
+  pcl::FrustumCulling<pcl::PointXYZ> fc;
+  fc.setInputCloud (input);
+  fc.setVerticalFOV (45);
+  fc.setHorizontalFOV (60);
+  fc.setNearPlaneDistance (0.5);
+  fc.setFarPlaneDistance (4);
+
+  // Reference masks computed here from the camera frames: the x axis of a pose is the view direction, y is up
+  // and z is right. The planes point out of the frustum and have unit normals, so points closer than the
+  // rounding error to one of them are left out of the comparison.
+  const float tan_v = std::tan (float (45 * M_PI / 360));
+  const float tan_h = std::tan (float (60 * M_PI / 360));
+  std::vector<std::vector<char> > reference (camera_poses.size (), std::vector<char> (input->size (), 0));
+  std::vector<std::vector<char> > ambiguous (camera_poses.size (), std::vector<char> (input->size (), 0));
+  size_t nr_ambiguous = 0;
+  for (size_t c = 0; c < camera_poses.size (); c++)
+  {
+    const Eigen::Vector3f view = camera_poses[c].block<3, 1> (0, 0);
+    const Eigen::Vector3f up = camera_poses[c].block<3, 1> (0, 1);
+    const Eigen::Vector3f right = camera_poses[c].block<3, 1> (0, 2);
+    const Eigen::Vector3f position = camera_poses[c].block<3, 1> (0, 3);
+    Eigen::Vector3f normals[6] = {-view, view, up - tan_v * view, -up - tan_v * view,
+                                  right - tan_h * view, -right - tan_h * view};
+    float offsets[6] = {0.5f, -4.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > planes (6);
+    for (int k = 0; k < 6; k++)
+    {
+      const float norm = normals[k].norm ();
+      planes[k].head<3> () = normals[k] / norm;
+      planes[k] (3) = (offsets[k] - normals[k].dot (position)) / norm;
+    }
+
+    for (size_t i = 0; i < input->size (); i++)
+    {
+      if (!pcl_isfinite (input->points[i].x))
+        continue;
+      const Eigen::Vector4f pt (input->points[i].x, input->points[i].y, input->points[i].z, 1.0f);
+      bool inside = true;
+      for (int k = 0; k < 6; k++)
+      {
+        const float dist = pt.dot (planes[k]);
+        if (std::fabs (dist) < 1e-4f)
+          ambiguous[c][i] = 1;
+        if (dist > 0.0f)
+          inside = false;
+      }
+      reference[c][i] = inside;
+      nr_ambiguous += ambiguous[c][i];
+    }
+  }
+  EXPECT_LT (nr_ambiguous, input->size () / 100);
+
+  // Testing every point against one frustum at a time
+  fc.setUseBlockCulling (false);
+  std::vector<std::vector<int> > visible (camera_poses.size ());
+  for (size_t c = 0; c < camera_poses.size (); c++)
+  {
+    fc.setCameraPose (camera_poses[c]);
+    fc.filter (visible[c]);
+    EXPECT_GT (int (visible[c].size ()), 0);
+    EXPECT_LT (visible[c].size (), input->size ());
+
+    std::vector<char> in_filter (input->size (), 0);
+    for (size_t i = 0; i < visible[c].size (); i++)
+      in_filter[visible[c][i]] = 1;
+    for (size_t i = 0; i < input->size (); i++)
+      if (!ambiguous[c][i])
+        EXPECT_EQ (reference[c][i], in_filter[i]) << "camera " << c << ", point " << i;
+  }
+
+  for (int block_culling = 0; block_culling < 2; block_culling++)
+  {
+    fc.setUseBlockCulling (block_culling != 0);
+    for (unsigned int nr_threads = 1; nr_threads <= 2; nr_threads++)
+    {
+      fc.setNumberOfThreads (nr_threads);
+      std::vector<boost::dynamic_bitset<> > visibility;
+      fc.computeVisibility (camera_poses, visibility);
+      ASSERT_EQ (visibility.size (), camera_poses.size ());
+      for (size_t c = 0; c < camera_poses.size (); c++)
+      {
+        ASSERT_EQ (visibility[c].size (), input->size ());
+        EXPECT_EQ (visibility[c].count (), visible[c].size ());
+        for (size_t i = 0; i < visible[c].size (); i++)
+          EXPECT_TRUE (visibility[c][visible[c][i]]);
+        for (size_t i = 0; i < input->size (); i++)
+          if (!ambiguous[c][i])
+            EXPECT_EQ (reference[c][i] != 0, visibility[c][i]);
+        EXPECT_FALSE (visibility[c][1000]);
+      }
+
+      // The single camera filter goes through the same blocks
+      fc.setCameraPose (camera_poses[3]);
+      std::vector<int> indices;
+      fc.filter (indices);
+      EXPECT_EQ (indices, visible[3]);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (ConditionalRemovalTfQuadraticXYZComparison, Filters)
 {
@@ -2183,6 +2550,27 @@ TEST (MedianFilter, Filters)
   EXPECT_NEAR (1.177000045f, out_3(128, 128).z, 1e-5);
   EXPECT_NEAR (0.778999984f, out_3(256, 256).z, 1e-5);
   EXPECT_NEAR (0.703000009f, out_3(428, 300).z, 1e-5);
+
+  // The result does not depend on the number of threads
+  PointCloud<PointXYZRGB> out_4;
+  median_filter_xyzrgb.setNumberOfThreads (4);
+  median_filter_xyzrgb.filter (out_4);
+  ASSERT_EQ (out_3.points.size (), out_4.points.size ());
+  for (size_t i = 0; i < out_3.points.size (); ++i)
+    if (pcl_isfinite (out_3[i].z))
+      EXPECT_EQ (out_3[i].z, out_4[i].z);
+
+  // A window larger than the cloud takes the median of all the depths, which is 7
+  PointCloud<PointXYZ> out_5;
+  median_filter.setWindowSize (11);
+  median_filter.filter (out_5);
+  for (size_t i = 0; i < 5 * 4; ++i)
+    EXPECT_NEAR (7.f, out_5[i].z, 1e-5);
+  EXPECT_NEAR (50.f, out_5 (0, 4).z, 1e-5);
+  EXPECT_NEAR (50.f, out_5 (1, 4).z, 1e-5);
+  EXPECT_NEAR (450.f, out_5 (2, 4).z, 1e-5);
+  EXPECT_NEAR (50.f, out_5 (3, 4).z, 1e-5);
+  EXPECT_NEAR (50.f, out_5 (4, 4).z, 1e-5);
 }
 
 
@@ -158,6 +158,63 @@ TEST (Morphological, Unsupported)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (Morphological, Grid)
+{
+  // Random elevations with some empty cells, compared to erosion and dilation by brute force
+  const int rows = 23, cols = 17;
+  Eigen::MatrixXf grid (rows, cols);
+  srand (7);
+  for (int r = 0; r < rows; ++r)
+    for (int c = 0; c < cols; ++c)
+      grid (r, c) = (rand () % 5 == 0) ? std::numeric_limits<float>::quiet_NaN () : static_cast<float> (rand () % 100);
+
+  for (int half_size = 0; half_size < 12; half_size += 3)
+  {
+    Eigen::MatrixXf eroded (rows, cols), dilated (rows, cols);
+    for (int r = 0; r < rows; ++r)
+    {
+      for (int c = 0; c < cols; ++c)
+      {
+        float min_z = std::numeric_limits<float>::max (), max_z = -std::numeric_limits<float>::max ();
+        for (int j = std::max (0, r - half_size); j <= std::min (rows - 1, r + half_size); ++j)
+          for (int k = std::max (0, c - half_size); k <= std::min (cols - 1, c + half_size); ++k)
+            if (!pcl_isnan (grid (j, k)))
+            {
+              min_z = std::min (min_z, grid (j, k));
+              max_z = std::max (max_z, grid (j, k));
+            }
+        eroded (r, c) = (min_z == std::numeric_limits<float>::max ()) ? std::numeric_limits<float>::quiet_NaN () : min_z;
+        dilated (r, c) = (max_z == -std::numeric_limits<float>::max ()) ? std::numeric_limits<float>::quiet_NaN () : max_z;
+      }
+    }
+
+    Eigen::MatrixXf grid_out;
+    applyMorphologicalOperator (grid, half_size, MORPH_ERODE, grid_out);
+    for (int r = 0; r < rows; ++r)
+      for (int c = 0; c < cols; ++c)
+        EXPECT_TRUE (grid_out (r, c) == eroded (r, c) || (pcl_isnan (grid_out (r, c)) && pcl_isnan (eroded (r, c))));
+
+    applyMorphologicalOperator (grid, half_size, MORPH_DILATE, grid_out, 4);
+    for (int r = 0; r < rows; ++r)
+      for (int c = 0; c < cols; ++c)
+        EXPECT_TRUE (grid_out (r, c) == dilated (r, c) || (pcl_isnan (grid_out (r, c)) && pcl_isnan (dilated (r, c))));
+
+    // Opening is dilation of the erosion, it never raises a non-empty cell
+    Eigen::MatrixXf opened;
+    applyMorphologicalOperator (eroded, half_size, MORPH_DILATE, grid_out);
+    applyMorphologicalOperator (grid, half_size, MORPH_OPEN, opened, 4);
+    for (int r = 0; r < rows; ++r)
+      for (int c = 0; c < cols; ++c)
+      {
+        EXPECT_TRUE (opened (r, c) == grid_out (r, c) || (pcl_isnan (opened (r, c)) && pcl_isnan (grid_out (r, c))));
+        if (!pcl_isnan (grid (r, c)))
+          EXPECT_LE (opened (r, c), grid (r, c));
+      }
+  }
+}
+
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -1081,6 +1081,100 @@ TEST (PCL, Octree_Pointcloud_Change_Detector_Test)
 
 }
 
+TEST (PCL, Octree_Pointcloud_Change_Detector_Added_Removed_Test)
+{
+  // instantiate point clouds
+  PointCloud<PointXYZ>::Ptr cloudA (new PointCloud<PointXYZ> ());
+  PointCloud<PointXYZ>::Ptr cloudB (new PointCloud<PointXYZ> ());
+
+  OctreePointCloudChangeDetector<PointXYZ> octree (0.01f);
+  octree.defineBoundingBox (0.0, 0.0, 0.0, 64.0, 64.0, 64.0);
+  octree.enableNodePool (true);
+  octree.setNumberOfThreads (4);
+
+  size_t i;
+
+  srand (static_cast<unsigned int> (time (NULL)));
+
+  // static points are part of both frames, points of cloud A with x >= 5 vanish and cloud B gets new points
+  cloudA->width = 2000;
+  cloudA->height = 1;
+  cloudA->points.resize (cloudA->width * cloudA->height);
+  cloudB->width = 2000;
+  cloudB->height = 1;
+  cloudB->points.resize (cloudB->width * cloudB->height);
+
+  for (i = 0; i < 1000; i++)
+  {
+    PointXYZ static_point (static_cast<float> (5.0 * rand () / RAND_MAX),
+                           static_cast<float> (10.0 * rand () / RAND_MAX),
+                           static_cast<float> (10.0 * rand () / RAND_MAX));
+    cloudA->points[i] = static_point;
+    cloudB->points[i] = static_point;
+
+    cloudA->points[1000 + i] = PointXYZ (static_cast<float> (50.0 + 5.0 * rand () / RAND_MAX),
+                                         static_cast<float> (10.0 * rand () / RAND_MAX),
+                                         static_cast<float> (10.0 * rand () / RAND_MAX));
+    cloudB->points[1000 + i] = PointXYZ (static_cast<float> (5.0 * rand () / RAND_MAX),
+                                         static_cast<float> (50.0 + 10.0 * rand () / RAND_MAX),
+                                         static_cast<float> (10.0 * rand () / RAND_MAX));
+  }
+
+  // run several frames to recycle pooled nodes
+  for (unsigned int frame = 0; frame < 4; frame++)
+  {
+    octree.setInputCloud (cloudA);
+    octree.addPointsFromInputCloud ();
+    octree.switchBuffers ();
+
+    octree.setInputCloud (cloudB);
+    octree.addPointsFromInputCloud ();
+
+    vector<int> newPointIdxVector;
+    vector<int> removedPointIdxVector;
+    octree.getPointIndicesFromChangedVoxels (newPointIdxVector, removedPointIdxVector);
+
+    // added points refer to cloud B, removed points to cloud A
+    ASSERT_EQ (newPointIdxVector.size (), static_cast<std::size_t> (1000));
+    ASSERT_EQ (removedPointIdxVector.size (), static_cast<std::size_t> (1000));
+    for (i = 0; i < 1000; i++)
+    {
+      ASSERT_GE (newPointIdxVector[i], 1000);
+      ASSERT_GE (removedPointIdxVector[i], 1000);
+    }
+
+    // voxel centers match the indices
+    OctreePointCloudChangeDetector<PointXYZ>::AlignedPointTVector newCenters;
+    OctreePointCloudChangeDetector<PointXYZ>::AlignedPointTVector removedCenters;
+    octree.getChangedVoxelCenters (newCenters, removedCenters);
+    ASSERT_GT (newCenters.size (), static_cast<std::size_t> (0));
+    ASSERT_GT (removedCenters.size (), static_cast<std::size_t> (0));
+    for (i = 0; i < newCenters.size (); i++)
+      ASSERT_GT (newCenters[i].y, 49.0f);
+    for (i = 0; i < removedCenters.size (); i++)
+      ASSERT_GT (removedCenters[i].x, 49.0f);
+
+    // the serial comparison yields the same result
+    vector<int> serialNewPointIdxVector;
+    vector<int> serialRemovedPointIdxVector;
+    octree.setNumberOfThreads (1);
+    octree.getPointIndicesFromChangedVoxels (serialNewPointIdxVector, serialRemovedPointIdxVector);
+    octree.setNumberOfThreads (4);
+    ASSERT_EQ (serialNewPointIdxVector, newPointIdxVector);
+    ASSERT_EQ (serialRemovedPointIdxVector, removedPointIdxVector);
+
+    // leafs that are reused from the previous buffer only hold points of the current frame
+    vector<OctreeContainerPointIndices*> leafs;
+    octree.serializeLeafs (leafs);
+    size_t pointCount = 0;
+    for (i = 0; i < leafs.size (); i++)
+      pointCount += leafs[i]->getSize ();
+    ASSERT_EQ (pointCount, cloudB->points.size ());
+
+    octree.switchBuffers ();
+  }
+}
+
 TEST (PCL, Octree_Pointcloud_Voxel_Centroid_Test)
 {
 
@@ -1445,6 +1539,108 @@ TEST(PCL, Octree_Pointcloud_Approx_Nearest_Neighbour_Search)
 
 }
 
+TEST (PCL, Octree_Pointcloud_Approx_Nearest_K_Neighbour_Search)
+{
+  const unsigned int test_runs = 20;
+  unsigned int test_id;
+
+  // instantiate point cloud
+  PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+
+  size_t i;
+  srand (static_cast<unsigned int> (time (NULL)));
+
+  // generate point cloud
+  cloudIn->width = 2000;
+  cloudIn->height = 1;
+  cloudIn->points.resize (cloudIn->width * cloudIn->height);
+  for (i = 0; i < cloudIn->points.size (); i++)
+  {
+    cloudIn->points[i] = PointXYZ (static_cast<float> (5.0 * rand () / RAND_MAX),
+                                   static_cast<float> (10.0 * rand () / RAND_MAX),
+                                   static_cast<float> (10.0 * rand () / RAND_MAX));
+  }
+
+  OctreePointCloudSearch<PointXYZ> octree (0.3);
+  octree.setInputCloud (cloudIn);
+  octree.addPointsFromInputCloud ();
+
+  const int K = 10;
+  const float eps = 0.5f;
+  const double radius = 1.5;
+
+  for (test_id = 0; test_id < test_runs; test_id++)
+  {
+    // define a random search point
+    PointXYZ searchPoint (static_cast<float> (10.0 * rand () / RAND_MAX),
+                          static_cast<float> (10.0 * rand () / RAND_MAX),
+                          static_cast<float> (10.0 * rand () / RAND_MAX));
+
+    // brute force search
+    std::vector<float> bf_distances (cloudIn->points.size ());
+    for (i = 0; i < cloudIn->points.size (); i++)
+    {
+      bf_distances[i] = ((cloudIn->points[i].x - searchPoint.x) * (cloudIn->points[i].x - searchPoint.x)
+          + (cloudIn->points[i].y - searchPoint.y) * (cloudIn->points[i].y - searchPoint.y)
+          + (cloudIn->points[i].z - searchPoint.z) * (cloudIn->points[i].z - searchPoint.z));
+    }
+    std::vector<float> bf_sorted (bf_distances);
+    std::sort (bf_sorted.begin (), bf_sorted.end ());
+
+    std::vector<int> k_indices;
+    std::vector<float> k_sqr_distances;
+
+    // without error bound and budget the result is exact
+    ASSERT_EQ (octree.approxNearestKSearch (searchPoint, K, 0.0f, 0, k_indices, k_sqr_distances), K);
+    for (i = 0; i < static_cast<size_t> (K); i++)
+    {
+      EXPECT_NEAR (k_sqr_distances[i], bf_sorted[i], 1e-4);
+      EXPECT_NEAR (k_sqr_distances[i], bf_distances[k_indices[i]], 1e-4);
+    }
+
+    // each neighbor is within (1 + eps) of the exact neighbor of the same rank
+    ASSERT_EQ (octree.approxNearestKSearch (searchPoint, K, eps, 0, k_indices, k_sqr_distances), K);
+    for (i = 0; i < static_cast<size_t> (K); i++)
+    {
+      EXPECT_LE (k_sqr_distances[i], bf_sorted[i] * (1.0f + eps) * (1.0f + eps) + 1e-4);
+      if (i > 0)
+        EXPECT_GE (k_sqr_distances[i], k_sqr_distances[i - 1]);
+    }
+
+    // a leaf budget bounds the work but still returns valid, sorted candidates
+    int found = octree.approxNearestKSearch (searchPoint, K, 0.0f, 1, k_indices, k_sqr_distances);
+    ASSERT_LE (found, K);
+    for (i = 0; i < static_cast<size_t> (found); i++)
+      EXPECT_NEAR (k_sqr_distances[i], bf_distances[k_indices[i]], 1e-4);
+
+    // radius search: exact without error bound
+    size_t bf_in_radius = 0;
+    size_t bf_in_pruned_radius = 0;
+    const double pruned_radius = radius / (1.0 + eps);
+    for (i = 0; i < bf_distances.size (); i++)
+    {
+      if (bf_distances[i] <= radius * radius)
+        bf_in_radius++;
+      if (bf_distances[i] <= pruned_radius * pruned_radius)
+        bf_in_pruned_radius++;
+    }
+
+    ASSERT_EQ (static_cast<size_t> (octree.approxRadiusSearch (searchPoint, radius, 0.0f, 0, k_indices,
+                                                               k_sqr_distances)), bf_in_radius);
+
+    // with error bound all points within radius / (1 + eps) and none beyond radius are returned
+    octree.approxRadiusSearch (searchPoint, radius, eps, 0, k_indices, k_sqr_distances);
+    size_t in_pruned_radius = 0;
+    for (i = 0; i < k_indices.size (); i++)
+    {
+      EXPECT_LE (bf_distances[k_indices[i]], radius * radius);
+      if (bf_distances[k_indices[i]] <= pruned_radius * pruned_radius)
+        in_pruned_radius++;
+    }
+    ASSERT_EQ (in_pruned_radius, bf_in_pruned_radius);
+  }
+}
+
 TEST (PCL, Octree_Pointcloud_Neighbours_Within_Radius_Search)
 {
 
@@ -317,6 +317,134 @@ TEST (PCL, Outofcore_Point_Query)
   point_test(treeB);
 }
 
+TEST (PCL, Outofcore_Disk_Container_Cached_Read)
+{
+  const boost::filesystem::path container_path ("disk_container_test/node.pcd");
+  boost::filesystem::remove_all (container_path.parent_path ());
+  boost::filesystem::create_directory (container_path.parent_path ());
+
+  AlignedPointTVector src;
+  for (int i = 0; i < 100; i++)
+    src.push_back (PointT (static_cast<float> (i), static_cast<float> (2*i), static_cast<float> (3*i)));
+
+  OutofcoreOctreeDiskContainer<PointT> container (container_path);
+  container.insertRange (src);
+  ASSERT_EQ (src.size (), container.size ());
+
+  //sub-ranges are served in order out of the cached node data
+  AlignedPointTVector range;
+  container.readRange (10, 20, range);
+  ASSERT_EQ (20, range.size ());
+  for (size_t i = 0; i < range.size (); i++)
+    EXPECT_TRUE (compPt (src[10 + i], range[i]));
+
+  //appending invalidates the cached node data
+  AlignedPointTVector more (src.begin (), src.begin () + 10);
+  container.insertRange (more);
+  range.clear ();
+  container.readRange (95, 15, range);
+  ASSERT_EQ (15, range.size ());
+  EXPECT_TRUE (compPt (src[95], range[0]));
+  EXPECT_TRUE (compPt (src[9], range[14]));
+
+  //reads behave the same with the cache disabled and after a prefetch
+  const size_t capacity = OutofcoreOctreeDiskContainer<PointT>::getCacheCapacity ();
+  OutofcoreOctreeDiskContainer<PointT>::setCacheCapacity (0);
+  AlignedPointTVector uncached;
+  container.readRange (0, container.size (), uncached);
+  EXPECT_EQ (container.size (), uncached.size ());
+
+  OutofcoreOctreeDiskContainer<PointT>::setCacheCapacity (capacity);
+  container.prefetch ();
+  AlignedPointTVector prefetched;
+  container.readRange (0, container.size (), prefetched);
+  ASSERT_EQ (uncached.size (), prefetched.size ());
+  for (size_t i = 0; i < prefetched.size (); i++)
+    EXPECT_TRUE (compPt (uncached[i], prefetched[i]));
+
+  //the prefetch thread can be stopped and is restarted by the next prefetch
+  OutofcoreOctreeDiskContainer<PointT>::stopPrefetching ();
+  OutofcoreOctreeDiskContainer<PointT>::clearCache ();
+  container.prefetch ();
+  OutofcoreOctreeDiskContainer<PointT>::stopPrefetching ();
+  prefetched.clear ();
+  container.readRange (0, container.size (), prefetched);
+  EXPECT_EQ (uncached.size (), prefetched.size ());
+
+  AlignedPointTVector sample;
+  container.readRangeSubSample (0, 100, 0.5, sample);
+  EXPECT_EQ (50, sample.size ());
+  for (size_t i = 0; i < sample.size (); i++)
+    EXPECT_EQ (2.0f * sample[i].x, sample[i].y);
+
+  //a node file that cannot be read is not cached as an empty node
+  OutofcoreOctreeDiskContainer<PointT>::clearCache ();
+  const boost::filesystem::path backup_path ("disk_container_test/node_backup.pcd");
+  boost::filesystem::copy_file (container_path, backup_path);
+  {
+    std::ofstream corrupt (container_path.string ().c_str (), std::ios::out | std::ios::trunc);
+    corrupt << "not a pcd file";
+  }
+  AlignedPointTVector unreadable;
+  container.readRange (0, container.size (), unreadable);
+  EXPECT_EQ (0, unreadable.size ());
+  boost::filesystem::remove (container_path);
+  boost::filesystem::copy_file (backup_path, container_path);
+  AlignedPointTVector restored;
+  container.readRange (0, container.size (), restored);
+  EXPECT_EQ (uncached.size (), restored.size ());
+
+  OutofcoreOctreeDiskContainer<PointT>::clearCache ();
+  boost::filesystem::remove_all (container_path.parent_path ());
+}
+
+TEST (PCL, Outofcore_Disk_Container_Mapped_Points)
+{
+  const boost::filesystem::path container_path ("disk_container_test/node.pcd");
+  boost::filesystem::remove_all (container_path.parent_path ());
+  boost::filesystem::create_directory (container_path.parent_path ());
+
+  AlignedPointTVector src;
+  for (int i = 0; i < 100; i++)
+    src.push_back (PointT (static_cast<float> (i), static_cast<float> (2*i), static_cast<float> (3*i)));
+
+  OutofcoreOctreeDiskContainer<PointT> container (container_path);
+  EXPECT_TRUE (container.getMappedPoints ().empty ());
+
+  container.insertRange (src);
+  OutofcoreConstPointSpan<PointT> span = container.getMappedPoints ();
+  ASSERT_EQ (src.size (), span.size ());
+  for (size_t i = 0; i < span.size (); i++)
+    EXPECT_TRUE (compPt (src[i], span[i]));
+
+  //the flat copy follows modifications of the node, old views stay valid
+  container.insertRange (src);
+  OutofcoreConstPointSpan<PointT> grown = container.getMappedPoints ();
+  ASSERT_EQ (2 * src.size (), grown.size ());
+  EXPECT_TRUE (compPt (src[0], grown[src.size ()]));
+  EXPECT_EQ (src.size (), span.size ());
+  EXPECT_TRUE (compPt (src[99], span[99]));
+
+  //a node file rewritten elsewhere with the same number of points is not served from the stale flat copy,
+  //even if it is rewritten in place with the same size right after the flat copy was made
+  pcl::PointCloud<PointT> rewritten;
+  for (size_t i = 0; i < grown.size (); i++)
+    rewritten.push_back (PointT (-1.0f, static_cast<float> (i), 0.0f));
+  pcl::PCDWriter writer;
+  for (int run = 0; run < 2; run++)
+  {
+    for (size_t i = 0; i < rewritten.size (); i++)
+      rewritten.points[i].z = static_cast<float> (run);
+    ASSERT_EQ (0, writer.writeBinary (container_path.string (), rewritten));
+    OutofcoreConstPointSpan<PointT> updated = container.getMappedPoints ();
+    ASSERT_EQ (rewritten.size (), updated.size ());
+    for (size_t i = 0; i < updated.size (); i++)
+      EXPECT_TRUE (compPt (rewritten[i], updated[i]));
+  }
+
+  boost::filesystem::remove_all (container_path.parent_path ());
+}
+
 #if 0 //this class will be deprecated soon.
 TEST (PCL, Outofcore_Ram_Tree)
 {
@@ -703,6 +831,80 @@ TEST_F (OutofcoreTest, Outofcore_PointCloudInput_LOD)
   cleanUpFilesystem ();
 }
 
+TEST_F (OutofcoreTest, Outofcore_PointCloudInput_LOD_Parallel)
+{
+  cleanUpFilesystem ();
+
+  const Eigen::Vector3d min (-1024,-1024,-1024);
+  const Eigen::Vector3d max (1024,1024,1024);
+
+  boost::mt19937 rand_gen (rngseed);
+  boost::uniform_real<float> dist (-1023.0f, 1023.0f);
+  boost::variate_generator<boost::mt19937&, boost::uniform_real<float> > gen (rand_gen, dist);
+
+  pcl::PointCloud<PointT> test_cloud;
+  for (size_t i=0; i < numPts; i++)
+    test_cloud.points.push_back (PointT (gen (), gen (), gen ()));
+  test_cloud.width = static_cast<uint32_t> (test_cloud.points.size ());
+  test_cloud.height = 1;
+
+  pcl::PCLPointCloud2::Ptr test_blob (new pcl::PCLPointCloud2 ());
+  pcl::toPCLPointCloud2 (test_cloud, *test_blob);
+
+  octree_disk octreeA (4, min, max, outofcore_path, "ECEF");
+  octreeA.setNumberOfThreads (4);
+  EXPECT_EQ (4, octreeA.getNumberOfThreads ());
+
+  boost::uint64_t points_added = octreeA.addPointCloud_and_genLOD (test_blob);
+  EXPECT_EQ (numPts, points_added);
+
+  //every point ends up in exactly one node, either as LOD sample or at the leaves
+  boost::uint64_t points_in_tree = 0;
+  for (boost::uint64_t i=0; i <= octreeA.getDepth (); i++)
+    points_in_tree += octreeA.getNumPointsAtDepth (i);
+  EXPECT_EQ (numPts, points_in_tree);
+
+  OutofcoreProgress progress = octreeA.getProgress ();
+  EXPECT_EQ (numPts, progress.points_written);
+  EXPECT_GT (progress.nodes_written, 0);
+  EXPECT_GE (progress.getThroughput (), 0.0);
+
+  pcl::PCLPointCloud2::Ptr query_result (new pcl::PCLPointCloud2 ());
+  octreeA.queryBBIncludes (min, max, int (octreeA.getDepth ()), query_result);
+  EXPECT_GT (query_result->width*query_result->height, 0);
+
+  //mapped views of the leaves cover the same points as a copying query
+  AlignedPointTVector leaf_points;
+  octreeA.queryBBIncludes (min, max, octreeA.getDepth (), leaf_points);
+  std::vector<OutofcoreConstPointSpan<PointT> > spans;
+  octreeA.queryBBIntersects (min, max, static_cast<boost::uint32_t> (octreeA.getDepth ()), spans);
+  size_t mapped_points = 0;
+  for (size_t i = 0; i < spans.size (); i++)
+    mapped_points += spans[i].size ();
+  EXPECT_EQ (leaf_points.size (), mapped_points);
+
+  cleanUpFilesystem ();
+
+  //the parallel LOD build only depends on the filter seed, not on the number of threads
+  octree_disk octreeB (2, min, max, outofcore_path, "ECEF");
+  ASSERT_EQ (numPts, octreeB.addPointCloud (test_cloud.makeShared ()));
+  boost::dynamic_pointer_cast<pcl::RandomSample<pcl::PCLPointCloud2> > (octreeB.getLODFilter ())->setSeed (42);
+  std::vector<AlignedPointTVector> lods (2);
+  for (size_t run = 0; run < lods.size (); run++)
+  {
+    octreeB.setNumberOfThreads (run == 0 ? 4 : 2);
+    octreeB.buildLOD ();
+    for (boost::uint64_t i = 0; i < octreeB.getDepth (); i++)
+      octreeB.queryBBIncludes (min, max, i, lods[run]);
+  }
+  ASSERT_EQ (lods[0].size (), lods[1].size ());
+  EXPECT_GT (lods[0].size (), 0);
+  for (size_t i = 0; i < lods[0].size (); i++)
+    EXPECT_TRUE (compPt (lods[0][i], lods[1][i]));
+
+  cleanUpFilesystem ();
+}
+
 TEST_F (OutofcoreTest, PointCloud2_Constructors)
 {
   cleanUpFilesystem ();
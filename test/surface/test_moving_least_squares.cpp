@@ -87,6 +87,29 @@ TEST (PCL, MovingLeastSquares)
   EXPECT_NEAR (fabs (mls_normals->points[0].normal[2]), 0.795969, 1e-3);
   EXPECT_NEAR (mls_normals->points[0].curvature, 0.012019, 1e-3);
 
+  PointCloud<PointNormal> mls_serial = *mls_normals;
+
+  // Testing precomputed neighborhoods
+  boost::shared_ptr<vector<vector<int> > > neighborhoods (new vector<vector<int> > (cloud->size ()));
+  vector<float> sqr_distances;
+  for (size_t i = 0; i < cloud->size (); ++i)
+    tree->radiusSearch (cloud->points[i], 0.03, (*neighborhoods)[i], sqr_distances);
+  MovingLeastSquares<PointXYZ, PointNormal> mls_neighborhoods;
+  mls_neighborhoods.setInputCloud (cloud);
+  mls_neighborhoods.setComputeNormals (true);
+  mls_neighborhoods.setPolynomialFit (true);
+  mls_neighborhoods.setSearchRadius (0.03);
+  mls_neighborhoods.setNeighborhoods (neighborhoods);
+  mls_normals->clear ();
+  mls_neighborhoods.process (*mls_normals);
+  ASSERT_EQ (mls_normals->size (), mls_serial.size ());
+  for (size_t i = 0; i < mls_normals->size (); ++i)
+  {
+    EXPECT_NEAR (mls_normals->points[i].x, mls_serial.points[i].x, 1e-6);
+    EXPECT_NEAR (mls_normals->points[i].y, mls_serial.points[i].y, 1e-6);
+    EXPECT_NEAR (mls_normals->points[i].z, mls_serial.points[i].z, 1e-6);
+  }
+
 #ifdef _OPENMP
   // Testing OpenMP version
   MovingLeastSquaresOMP<PointXYZ, PointNormal> mls_omp;
@@ -116,6 +139,26 @@ TEST (PCL, MovingLeastSquares)
 
   EXPECT_EQ (count, 1);
 
+  // The output is in the same order as the one of the serial version
+  ASSERT_EQ (mls_normals->size (), mls_serial.size ());
+  for (size_t i = 0; i < mls_normals->size (); ++i)
+  {
+    EXPECT_NEAR (mls_normals->points[i].x, mls_serial.points[i].x, 1e-6);
+    EXPECT_NEAR (mls_normals->points[i].y, mls_serial.points[i].y, 1e-6);
+    EXPECT_NEAR (mls_normals->points[i].z, mls_serial.points[i].z, 1e-6);
+  }
+
+  // Testing OpenMP version with upsampling
+  mls_omp.setUpsamplingMethod (MovingLeastSquares<PointXYZ, PointNormal>::VOXEL_GRID_DILATION);
+  mls_omp.setDilationIterations (5);
+  mls_omp.setDilationVoxelSize (0.005f);
+  mls_normals->clear ();
+  mls_omp.process (*mls_normals);
+  EXPECT_NEAR (mls_normals->points[10].x, -0.070005938410758972, 2e-3);
+  EXPECT_NEAR (mls_normals->points[10].y, 0.028887597844004631, 2e-3);
+  EXPECT_NEAR (mls_normals->points[10].z, 0.01788550429046154, 2e-3);
+  EXPECT_NEAR (double (mls_normals->size ()), 29394, 2);
+
 #endif
 
   // Testing upsampling
@@ -143,23 +186,57 @@ TEST (PCL, MovingLeastSquares)
   EXPECT_EQ (mls_normals->size (), 6352);
 
 
-  /// TODO Would need to set a seed point here for the random number generator
-  /// But as long as the other 2 upsampling methods work fine, this should have no issues.
-  /// The RANDOM_UNIFORM_DENSITY upsampling will be changed soon anyway, hopefully in PCL 1.6.1
-//  mls_upsampling.setUpsamplingMethod (MovingLeastSquares<PointXYZ, PointNormal>::RANDOM_UNIFORM_DENSITY);
-//  mls_upsampling.setPointDensity (100);
-//  mls_normals->clear ();
-//  mls_upsampling.process (*mls_normals);
-//
-//  EXPECT_NEAR (mls_normals->points[10].x, 0.018806, 1e-3);
-//  EXPECT_NEAR (mls_normals->points[10].y, 0.114685, 1e-3);
-//  EXPECT_NEAR (mls_normals->points[10].z, 0.037500, 1e-3);
-//  EXPECT_NEAR (fabs (mls_normals->points[10].normal[0]), 0.351352, 1e-3);
-//  EXPECT_NEAR (fabs (mls_normals->points[10].normal[1]), 0.537741, 1e-3);
-//  EXPECT_NEAR (fabs (mls_normals->points[10].normal[2]), 0.766411, 1e-3);
-//  EXPECT_NEAR (mls_normals->points[10].curvature, 0.019003, 1e-3);
-//  EXPECT_EQ (mls_normals->size (), 457);
+  // The random samples only depend on the seed, so two runs with the same seed give the same cloud
+  mls_upsampling.setUpsamplingMethod (MovingLeastSquares<PointXYZ, PointNormal>::RANDOM_UNIFORM_DENSITY);
+  mls_upsampling.setPointDensity (100);
+  mls_upsampling.setSeed (42);
+  EXPECT_EQ (42u, mls_upsampling.getSeed ());
+  mls_normals->clear ();
+  mls_upsampling.process (*mls_normals);
+  PointCloud<PointNormal> mls_random;
+  mls_upsampling.process (mls_random);
+  EXPECT_LT (0u, mls_normals->size ());
+  ASSERT_EQ (mls_normals->size (), mls_random.size ());
+  for (size_t i = 0; i < mls_normals->size (); ++i)
+  {
+    EXPECT_EQ (mls_normals->points[i].x, mls_random.points[i].x);
+    EXPECT_EQ (mls_normals->points[i].y, mls_random.points[i].y);
+    EXPECT_EQ (mls_normals->points[i].z, mls_random.points[i].z);
+  }
+
+#ifdef _OPENMP
+  // The samples of each point are seeded from its index, not from the thread that processes it
+  MovingLeastSquaresOMP<PointXYZ, PointNormal> mls_random_omp;
+  mls_random_omp.setInputCloud (cloud);
+  mls_random_omp.setComputeNormals (true);
+  mls_random_omp.setPolynomialFit (true);
+  mls_random_omp.setSearchMethod (tree);
+  mls_random_omp.setSearchRadius (0.03);
+  mls_random_omp.setUpsamplingMethod (MovingLeastSquares<PointXYZ, PointNormal>::RANDOM_UNIFORM_DENSITY);
+  mls_random_omp.setPointDensity (100);
+  mls_random_omp.setSeed (42);
+  mls_random_omp.setNumberOfThreads (4);
+  mls_random.clear ();
+  mls_random_omp.process (mls_random);
+  ASSERT_EQ (mls_normals->size (), mls_random.size ());
+  for (size_t i = 0; i < mls_normals->size (); ++i)
+  {
+    EXPECT_EQ (mls_normals->points[i].x, mls_random.points[i].x);
+    EXPECT_EQ (mls_normals->points[i].y, mls_random.points[i].y);
+    EXPECT_EQ (mls_normals->points[i].z, mls_random.points[i].z);
+  }
+#endif
 
+  // Another seed gives other samples
+  mls_upsampling.setSeed (43);
+  mls_random.clear ();
+  mls_upsampling.process (mls_random);
+  ASSERT_EQ (mls_normals->size (), mls_random.size ());
+  int nr_moved = 0;
+  for (size_t i = 0; i < mls_normals->size (); ++i)
+    if (mls_normals->points[i].x != mls_random.points[i].x)
+      nr_moved++;
+  EXPECT_LT (0, nr_moved);
 
   mls_upsampling.setUpsamplingMethod (MovingLeastSquares<PointXYZ, PointNormal>::VOXEL_GRID_DILATION);
   mls_upsampling.setDilationIterations (5);
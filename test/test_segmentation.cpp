@@ -45,11 +45,14 @@
 #include <pcl/search/search.h>
 #include <pcl/features/normal_3d.h>
 
+#include <pcl/segmentation/extract_clusters.h>
 #include <pcl/segmentation/extract_polygonal_prism_data.h>
 #include <pcl/segmentation/segment_differences.h>
 #include <pcl/segmentation/region_growing.h>
 #include <pcl/segmentation/region_growing_rgb.h>
 #include <pcl/segmentation/min_cut_segmentation.h>
+#include <pcl/segmentation/progressive_morphological_filter.h>
+#include <pcl/segmentation/supervoxel_clustering.h>
 
 using namespace pcl;
 using namespace pcl::io;
@@ -93,6 +96,40 @@ TEST (RegionGrowingTest, Segment)
   EXPECT_NE (0, num_of_segments);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (RegionGrowingTest, SegmentParallel)
+{
+  pcl::RegionGrowing<pcl::PointXYZ, pcl::Normal> rg;
+  rg.setInputCloud (another_cloud_);
+  rg.setInputNormals (another_normals_);
+
+  std::vector <pcl::PointIndices> clusters;
+  rg.extract (clusters);
+
+  std::vector <pcl::PointIndices> clusters_parallel;
+  rg.setNumberOfThreads (4);
+  rg.extract (clusters_parallel);
+
+  ASSERT_EQ (clusters.size (), clusters_parallel.size ());
+  for (size_t i = 0; i < clusters.size (); ++i)
+    EXPECT_TRUE (clusters[i].indices == clusters_parallel[i].indices);
+
+  RegionGrowingRGB<pcl::PointXYZRGB> rg_rgb;
+  rg_rgb.setInputCloud (colored_cloud);
+  rg_rgb.setDistanceThreshold (10);
+  rg_rgb.setRegionColorThreshold (5);
+  rg_rgb.setPointColorThreshold (6);
+  rg_rgb.setMinClusterSize (20);
+  rg_rgb.extract (clusters);
+
+  rg_rgb.setNumberOfThreads (4);
+  rg_rgb.extract (clusters_parallel);
+
+  ASSERT_EQ (clusters.size (), clusters_parallel.size ());
+  for (size_t i = 0; i < clusters.size (); ++i)
+    EXPECT_TRUE (clusters[i].indices == clusters_parallel[i].indices);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (RegionGrowingTest, SegmentWithoutCloud)
 {
@@ -335,8 +372,222 @@ TEST (MinCutSegmentationTest, SegmentWithWrongParameters)
   int num_of_segments = static_cast<int> (clusters.size ());
   EXPECT_EQ (2, num_of_segments);
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (MinCutSegmentationTest, SegmentParallelAndReuseGraph)
+{
+  pcl::PointCloud<pcl::PointXYZ>::Ptr foreground_points(new pcl::PointCloud<pcl::PointXYZ> ());
+  foreground_points->points.push_back (pcl::PointXYZ (-36.01f, -64.73f, -6.18f));
+
+  pcl::MinCutSegmentation<pcl::PointXYZ> serial_seg;
+  serial_seg.setForegroundPoints (foreground_points);
+  serial_seg.setInputCloud (another_cloud_);
+  serial_seg.setRadius (3.8003856);
+
+  pcl::MinCutSegmentation<pcl::PointXYZ> parallel_seg;
+  parallel_seg.setNumberOfThreads (4);
+  parallel_seg.setForegroundPoints (foreground_points);
+  parallel_seg.setInputCloud (another_cloud_);
+  parallel_seg.setRadius (3.8003856);
+
+  std::vector <pcl::PointIndices> serial_clusters;
+  std::vector <pcl::PointIndices> parallel_clusters;
+  serial_seg.extract (serial_clusters);
+  parallel_seg.extract (parallel_clusters);
+  ASSERT_EQ (2, static_cast<int> (parallel_clusters.size ()));
+  EXPECT_DOUBLE_EQ (serial_seg.getMaxFlow (), parallel_seg.getMaxFlow ());
+  for (size_t i_cluster = 0; i_cluster < serial_clusters.size (); i_cluster++)
+    EXPECT_EQ (serial_clusters[i_cluster].indices, parallel_clusters[i_cluster].indices);
+
+  // only the potentials change, so the graph of parallel_seg is reused
+  parallel_seg.setRadius (2.0);
+  parallel_seg.setSigma (0.3);
+  parallel_seg.extract (parallel_clusters);
+
+  pcl::MinCutSegmentation<pcl::PointXYZ> fresh_seg;
+  fresh_seg.setForegroundPoints (foreground_points);
+  fresh_seg.setInputCloud (another_cloud_);
+  fresh_seg.setRadius (2.0);
+  fresh_seg.setSigma (0.3);
+  std::vector <pcl::PointIndices> fresh_clusters;
+  fresh_seg.extract (fresh_clusters);
+  ASSERT_EQ (2, static_cast<int> (parallel_clusters.size ()));
+  EXPECT_DOUBLE_EQ (fresh_seg.getMaxFlow (), parallel_seg.getMaxFlow ());
+  for (size_t i_cluster = 0; i_cluster < fresh_clusters.size (); i_cluster++)
+    EXPECT_EQ (fresh_clusters[i_cluster].indices, parallel_clusters[i_cluster].indices);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (MinCutSegmentationTest, SegmentCompactGraph)
+{
+  pcl::PointCloud<pcl::PointXYZ>::Ptr foreground_points(new pcl::PointCloud<pcl::PointXYZ> ());
+  foreground_points->points.push_back (pcl::PointXYZ (-36.01f, -64.73f, -6.18f));
+
+  pcl::MinCutSegmentation<pcl::PointXYZ> boost_seg;
+  boost_seg.setForegroundPoints (foreground_points);
+  boost_seg.setInputCloud (another_cloud_);
+  boost_seg.setRadius (3.8003856);
+
+  pcl::MinCutSegmentation<pcl::PointXYZ> compact_seg;
+  compact_seg.setUseCompactGraph (true);
+  compact_seg.setNumberOfThreads (4);
+  compact_seg.setForegroundPoints (foreground_points);
+  compact_seg.setInputCloud (another_cloud_);
+  compact_seg.setRadius (3.8003856);
+
+  std::vector <pcl::PointIndices> boost_clusters;
+  std::vector <pcl::PointIndices> compact_clusters;
+  boost_seg.extract (boost_clusters);
+  compact_seg.extract (compact_clusters);
+  ASSERT_EQ (2, static_cast<int> (compact_clusters.size ()));
+  EXPECT_NEAR (boost_seg.getMaxFlow (), compact_seg.getMaxFlow (), 1e-9 * boost_seg.getMaxFlow ());
+  EXPECT_EQ (another_cloud_->points.size (), compact_clusters[0].indices.size () + compact_clusters[1].indices.size ());
+  EXPECT_TRUE (boost_seg.getGraph () != 0);
+  EXPECT_TRUE (compact_seg.getGraph () == 0);
+
+  // the points whose source edge is not saturated are on the source side of every minimum cut
+  std::set<int> compact_foreground (compact_clusters[1].indices.begin (), compact_clusters[1].indices.end ());
+  for (size_t i_point = 0; i_point < boost_clusters[1].indices.size (); i_point++)
+    EXPECT_EQ (1, static_cast<int> (compact_foreground.count (boost_clusters[1].indices[i_point])));
+
+  // only the potentials change, so the neighbourhoods of compact_seg are reused
+  compact_seg.setRadius (2.0);
+  compact_seg.setSigma (0.3);
+  compact_seg.extract (compact_clusters);
+
+  pcl::MinCutSegmentation<pcl::PointXYZ> fresh_seg;
+  fresh_seg.setUseCompactGraph (true);
+  fresh_seg.setForegroundPoints (foreground_points);
+  fresh_seg.setInputCloud (another_cloud_);
+  fresh_seg.setRadius (2.0);
+  fresh_seg.setSigma (0.3);
+  std::vector <pcl::PointIndices> fresh_clusters;
+  fresh_seg.extract (fresh_clusters);
+  ASSERT_EQ (2, static_cast<int> (compact_clusters.size ()));
+  EXPECT_DOUBLE_EQ (fresh_seg.getMaxFlow (), compact_seg.getMaxFlow ());
+  for (size_t i_cluster = 0; i_cluster < fresh_clusters.size (); i_cluster++)
+    EXPECT_EQ (fresh_clusters[i_cluster].indices, compact_clusters[i_cluster].indices);
+}
 #endif
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (EuclideanClusterExtraction, ParallelAndVoxelHash)
+{
+  EuclideanClusterExtraction<PointXYZ> ec;
+  ec.setInputCloud (another_cloud_);
+  ec.setClusterTolerance (0.05);
+  ec.setMinClusterSize (2);
+
+  std::vector<PointIndices> clusters;
+  ec.extract (clusters);
+  EXPECT_GT (clusters.size (), 1u);
+
+  std::vector<PointIndices> clusters_parallel;
+  ec.setNumberOfThreads (4);
+  ec.extract (clusters_parallel);
+
+  std::vector<PointIndices> clusters_voxel;
+  ec.setUseVoxelHash (true);
+  ec.extract (clusters_voxel);
+
+  ASSERT_EQ (clusters.size (), clusters_parallel.size ());
+  ASSERT_EQ (clusters.size (), clusters_voxel.size ());
+  for (size_t i = 0; i < clusters.size (); ++i)
+  {
+    EXPECT_TRUE (clusters[i].indices == clusters_parallel[i].indices);
+    EXPECT_TRUE (clusters[i].indices == clusters_voxel[i].indices);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SupervoxelClustering, ParallelAndIncremental)
+{
+  SupervoxelClustering<PointXYZ> super (0.005f, 0.02f, false);
+  super.setInputCloud (cloud_);
+
+  std::map<uint32_t, Supervoxel<PointXYZ>::Ptr> supervoxels;
+  super.extract (supervoxels);
+  EXPECT_GT (supervoxels.size (), 1u);
+  PointCloud<PointXYZL>::Ptr labels = super.getLabeledCloud ();
+
+  std::map<uint32_t, Supervoxel<PointXYZ>::Ptr> supervoxels_parallel;
+  super.setNumberOfThreads (4);
+  super.extract (supervoxels_parallel);
+  PointCloud<PointXYZL>::Ptr labels_parallel = super.getLabeledCloud ();
+
+  ASSERT_EQ (supervoxels.size (), supervoxels_parallel.size ());
+  ASSERT_EQ (labels->size (), labels_parallel->size ());
+  for (size_t i = 0; i < labels->size (); ++i)
+    EXPECT_EQ (labels->points[i].label, labels_parallel->points[i].label);
+
+  // The same frame again: every voxel is taken over, so no new supervoxels are seeded
+  std::map<uint32_t, Supervoxel<PointXYZ>::Ptr> supervoxels_incremental;
+  super.setUseIncrementalSegmentation (true);
+  super.extract (supervoxels_incremental);
+  EXPECT_GT (supervoxels_incremental.size (), 1u);
+  std::map<uint32_t, Supervoxel<PointXYZ>::Ptr>::const_iterator sv_itr;
+  for (sv_itr = supervoxels_incremental.begin (); sv_itr != supervoxels_incremental.end (); ++sv_itr)
+    EXPECT_EQ (1u, supervoxels_parallel.count (sv_itr->first));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (ProgressiveMorphologicalFilter, GridMatchesExact)
+{
+  // gently rolling terrain sampled every 0.5 m, with a 6 x 6 m building and a few trees on top of it
+  pcl::PointCloud<pcl::PointXYZ>::Ptr terrain (new pcl::PointCloud<pcl::PointXYZ>);
+  std::vector<bool> is_object;
+  for (int i_x = 0; i_x < 80; i_x++)
+    for (int i_y = 0; i_y < 80; i_y++)
+    {
+      pcl::PointXYZ point;
+      point.x = 0.5f * static_cast<float> (i_x) + 0.1f * static_cast<float> ((i_x * 7 + i_y * 3) % 5) / 5.0f;
+      point.y = 0.5f * static_cast<float> (i_y) + 0.1f * static_cast<float> ((i_x * 3 + i_y * 11) % 5) / 5.0f;
+      point.z = 0.5f * std::sin (0.1f * point.x) + 0.3f * std::cos (0.15f * point.y);
+      bool object = false;
+      if (point.x > 12.0f && point.x < 18.0f && point.y > 20.0f && point.y < 26.0f)
+      {
+        point.z += 5.0f;
+        object = true;
+      }
+      else if ((i_x % 23 == 5) && (i_y % 19 == 7))
+      {
+        point.z += 3.0f;
+        object = true;
+      }
+      terrain->points.push_back (point);
+      is_object.push_back (object);
+    }
+  terrain->width = static_cast<uint32_t> (terrain->points.size ());
+  terrain->height = 1;
+
+  pcl::ProgressiveMorphologicalFilter<pcl::PointXYZ> pmf;
+  pmf.setInputCloud (terrain);
+  pmf.setMaxWindowSize (16);
+  pmf.setSlope (1.0f);
+  pmf.setInitialDistance (0.5f);
+  pmf.setMaxDistance (3.0f);
+  pmf.setCellSize (0.5f);
+
+  std::vector<int> exact_ground;
+  pmf.extract (exact_ground);
+
+  pmf.setUseGrid (true);
+  pmf.setNumberOfThreads (4);
+  std::vector<int> grid_ground;
+  pmf.extract (grid_ground);
+
+  size_t nr_ground = 0;
+  for (size_t i_point = 0; i_point < is_object.size (); i_point++)
+    if (!is_object[i_point])
+      nr_ground++;
+  EXPECT_EQ (nr_ground, exact_ground.size ());
+  std::sort (exact_ground.begin (), exact_ground.end ());
+  std::sort (grid_ground.begin (), grid_ground.end ());
+  EXPECT_EQ (exact_ground, grid_ground);
+  for (size_t i_point = 0; i_point < grid_ground.size (); i_point++)
+    EXPECT_FALSE (is_object[grid_ground[i_point]]);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SegmentDifferences, Segmentation)
 {